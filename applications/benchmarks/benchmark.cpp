@@ -0,0 +1,387 @@
+/* Copyright (c) <2003-2016> <Newton Game Dynamics>
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely
+*/
+
+// headless benchmark runner.
+// steps each scene a fixed number of frames at a list of thread counts and writes a json
+// report with the average time of each phase of the update, the work counters, the peak
+// memory used by the engine and a hash of the final body matrices, so that runs can be
+// compared across commits, plugins and machines.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include "benchmarkScenes.h"
+
+#define BENCHMARK_MAX_THREAD_COUNTS	16
+#define BENCHMARK_MAX_PLUGINS		8
+
+struct BenchmarkOptions
+{
+	BenchmarkOptions()
+		:m_scene ("all")
+		,m_output (NULL)
+		,m_pluginPath (NULL)
+		,m_pluginCount (1)
+		,m_solver (-1)
+		,m_iterations (0)
+		,m_frames (600)
+		,m_warmup (60)
+		,m_scale (1)
+		,m_threadCounts (3)
+		,m_timestep (dFloat (1.0f / 60.0f))
+	{
+		m_threads[0] = 1;
+		m_threads[1] = 2;
+		m_threads[2] = 4;
+		m_plugins[0] = NULL;
+	}
+
+	const char* m_scene;
+	const char* m_output;
+	const char* m_pluginPath;
+	int m_pluginCount;
+	const char* m_plugins[BENCHMARK_MAX_PLUGINS];
+	int m_solver;
+	int m_iterations;
+	int m_frames;
+	int m_warmup;
+	int m_scale;
+	int m_threadCounts;
+	int m_threads[BENCHMARK_MAX_THREAD_COUNTS];
+	dFloat m_timestep;
+};
+
+struct BenchmarkResult
+{
+	BenchmarkResult()
+	{
+		memset (this, 0, sizeof (BenchmarkResult));
+	}
+
+	NewtonWorldStats m_stats;
+	NewtonWorldStats m_last;
+	double m_totalTime;
+	double m_minFrameTime;
+	double m_maxFrameTime;
+	long long m_memoryPeak;
+	long long m_memoryFinal;
+	unsigned long long m_hash;
+	double m_buildTime;
+	int m_bodies;
+	int m_threads;
+	int m_frames;
+	int m_solver;
+	char m_plugin[64];
+};
+
+// all engine allocations go through these two callbacks so that the peak can be tracked
+static std::atomic<long long> memoryInUse (0);
+static std::atomic<long long> memoryPeak (0);
+
+static void* AllocMemory (int sizeInBytes)
+{
+	const long long inUse = memoryInUse.fetch_add (sizeInBytes) + sizeInBytes;
+	long long peak = memoryPeak.load ();
+	while ((inUse > peak) && !memoryPeak.compare_exchange_weak (peak, inUse));
+	return malloc (size_t (sizeInBytes));
+}
+
+static void FreeMemory (void* const ptr, int sizeInBytes)
+{
+	memoryInUse.fetch_sub (sizeInBytes);
+	free (ptr);
+}
+
+// fnv-1a over the bits of every body matrix, identical runs must produce identical hashes
+static unsigned long long HashWorld (const NewtonWorld* const world)
+{
+	unsigned long long hash = 14695981039346656037ull;
+	for (NewtonBody* body = NewtonWorldGetFirstBody (world); body; body = NewtonWorldGetNextBody (world, body)) {
+		dFloat matrix[16];
+		NewtonBodyGetMatrix (body, matrix);
+		const unsigned char* const bytes = (unsigned char*) matrix;
+		for (size_t i = 0; i < sizeof (matrix); i ++) {
+			hash = (hash ^ bytes[i]) * 1099511628211ull;
+		}
+	}
+	return hash;
+}
+
+static void SelectPlugin (NewtonWorld* const world, const BenchmarkOptions& options, const char* const pluginName, BenchmarkResult& result)
+{
+	strcpy (result.m_plugin, "default");
+	if (options.m_pluginPath) {
+		NewtonLoadPlugins (world, options.m_pluginPath);
+	}
+	if (pluginName) {
+		for (void* plugin = NewtonGetFirstPlugin (world); plugin; plugin = NewtonGetNextPlugin (world, plugin)) {
+			const char* const name = NewtonGetPluginString (world, plugin);
+			if (strstr (name, pluginName)) {
+				NewtonSelectPlugin (world, plugin);
+				strncpy (result.m_plugin, name, sizeof (result.m_plugin) - 1);
+				break;
+			}
+		}
+	}
+}
+
+static void AccumulateStats (NewtonWorldStats& sum, const NewtonWorldStats& stats)
+{
+	sum.m_updateTime += stats.m_updateTime;
+	sum.m_skeletonsTime += stats.m_skeletonsTime;
+	sum.m_broadPhaseTime += stats.m_broadPhaseTime;
+	sum.m_forceAndTorqueTime += stats.m_forceAndTorqueTime;
+	sum.m_collidingPairsTime += stats.m_collidingPairsTime;
+	sum.m_contactsTime += stats.m_contactsTime;
+	sum.m_clustersTime += stats.m_clustersTime;
+	sum.m_solverTime += stats.m_solverTime;
+	sum.m_transformsTime += stats.m_transformsTime;
+}
+
+static void RunScene (const BenchmarkScene& scene, int threads, const char* const pluginName, const BenchmarkOptions& options, BenchmarkResult& result)
+{
+	memoryPeak.store (memoryInUse.load ());
+
+	NewtonWorld* const world = NewtonCreate ();
+	NewtonSetThreadsCount (world, threads);
+	if (options.m_solver >= 0) {
+		NewtonSetParallelSolverOnLargeIsland (world, options.m_solver);
+	}
+	if (options.m_iterations > 0) {
+		NewtonSetSolverIterations (world, options.m_iterations);
+	}
+	SelectPlugin (world, options, pluginName, result);
+
+	// scene construction includes building the collision meshes, so it is reported as well
+	const std::chrono::high_resolution_clock::time_point buildStart (std::chrono::high_resolution_clock::now ());
+	scene.m_build (world, options.m_scale);
+	result.m_buildTime = std::chrono::duration<double> (std::chrono::high_resolution_clock::now () - buildStart).count ();
+
+	result.m_threads = NewtonGetThreadsCount (world);
+	result.m_solver = NewtonGetParallelSolverOnLargeIsland (world);
+	result.m_bodies = NewtonWorldGetBodyCount (world);
+	result.m_frames = options.m_frames;
+	result.m_minFrameTime = 1.0e10;
+
+	for (int i = 0; i < options.m_warmup; i ++) {
+		NewtonUpdate (world, options.m_timestep);
+	}
+
+	for (int i = 0; i < options.m_frames; i ++) {
+		const std::chrono::high_resolution_clock::time_point start (std::chrono::high_resolution_clock::now ());
+		NewtonUpdate (world, options.m_timestep);
+		const double frameTime = std::chrono::duration<double> (std::chrono::high_resolution_clock::now () - start).count ();
+
+		result.m_totalTime += frameTime;
+		result.m_minFrameTime = (frameTime < result.m_minFrameTime) ? frameTime : result.m_minFrameTime;
+		result.m_maxFrameTime = (frameTime > result.m_maxFrameTime) ? frameTime : result.m_maxFrameTime;
+
+		NewtonWorldGetStats (world, &result.m_last);
+		AccumulateStats (result.m_stats, result.m_last);
+	}
+
+	result.m_hash = HashWorld (world);
+	result.m_memoryFinal = memoryInUse.load ();
+	result.m_memoryPeak = memoryPeak.load ();
+	NewtonDestroy (world);
+}
+
+static void WriteResult (FILE* const file, const char* const sceneName, const BenchmarkResult& result, bool last)
+{
+	const double scale = 1000.0 / ((result.m_frames > 0) ? result.m_frames : 1);
+	const NewtonWorldStats& stats = result.m_stats;
+	const NewtonWorldStats& counters = result.m_last;
+
+	fprintf (file, "\t\t{\n");
+	fprintf (file, "\t\t\t\"scene\": \"%s\",\n", sceneName);
+	fprintf (file, "\t\t\t\"threads\": %d,\n", result.m_threads);
+	fprintf (file, "\t\t\t\"plugin\": \"%s\",\n", result.m_plugin);
+	fprintf (file, "\t\t\t\"parallelSolver\": %d,\n", result.m_solver);
+	fprintf (file, "\t\t\t\"bodies\": %d,\n", result.m_bodies);
+	fprintf (file, "\t\t\t\"hash\": \"%016llx\",\n", result.m_hash);
+	fprintf (file, "\t\t\t\"buildMs\": %.4f,\n", result.m_buildTime * 1000.0);
+	fprintf (file, "\t\t\t\"frameMs\": {\"average\": %.4f, \"min\": %.4f, \"max\": %.4f},\n", result.m_totalTime * scale, result.m_minFrameTime * 1000.0, result.m_maxFrameTime * 1000.0);
+	fprintf (file, "\t\t\t\"phasesMs\": {\"update\": %.4f, \"skeletons\": %.4f, \"broadPhase\": %.4f, \"forceAndTorque\": %.4f, \"collidingPairs\": %.4f, \"contacts\": %.4f, \"clusters\": %.4f, \"solver\": %.4f, \"transforms\": %.4f},\n",
+			 stats.m_updateTime * scale, stats.m_skeletonsTime * scale, stats.m_broadPhaseTime * scale, stats.m_forceAndTorqueTime * scale, stats.m_collidingPairsTime * scale,
+			 stats.m_contactsTime * scale, stats.m_clustersTime * scale, stats.m_solverTime * scale, stats.m_transformsTime * scale);
+	fprintf (file, "\t\t\t\"lastFrame\": {\"substeps\": %d, \"activeBodies\": %d, \"pairsTested\": %d, \"narrowPhasePairs\": %d, \"newContacts\": %d, \"contacts\": %d, \"activeContacts\": %d, \"contactPoints\": %d, \"islands\": %d, \"parallelIslands\": %d, \"joints\": %d, \"rows\": %d, \"solverIterations\": %d, \"stolenJobs\": %d},\n",
+			 counters.m_substeps, counters.m_activeBodies, counters.m_pairsTested, counters.m_narrowPhasePairs, counters.m_newContacts, counters.m_contacts,
+			 counters.m_activeContacts, counters.m_contactPoints, counters.m_islands, counters.m_parallelIslands, counters.m_joints, counters.m_rows, counters.m_solverIterations, counters.m_stolenJobs);
+	fprintf (file, "\t\t\t\"memoryBytes\": {\"peak\": %lld, \"final\": %lld}\n", result.m_memoryPeak, result.m_memoryFinal);
+	fprintf (file, "\t\t}%s\n", last ? "" : ",");
+}
+
+static void Usage ()
+{
+	fprintf (stderr, "usage: newtonBenchmarks [options]\n");
+	fprintf (stderr, "  --scene name     scene to run, or \"all\" (default all)\n");
+	fprintf (stderr, "  --frames n       measured frames per run (default 600)\n");
+	fprintf (stderr, "  --warmup n       frames stepped before measuring (default 60)\n");
+	fprintf (stderr, "  --threads list   comma separated thread counts (default 1,2,4)\n");
+	fprintf (stderr, "  --scale n        multiply the number of objects in each scene (default 1)\n");
+	fprintf (stderr, "  --plugin-path p  directory to load solver plugins from\n");
+	fprintf (stderr, "  --plugin list    comma separated plugin names, each run selects the first plugin whose name\n");
+	fprintf (stderr, "                   contains the string, \"default\" runs without a plugin\n");
+	fprintf (stderr, "  --solver n       parallel solver on large islands, 0 off, 1 jacobi, 2 graph coloring\n");
+	fprintf (stderr, "  --iterations n   solver iterations (default engine setting)\n");
+	fprintf (stderr, "  --output file    write the json report to a file instead of stdout\n");
+	fprintf (stderr, "  --media dir      folder with the demo assets (default ../media)\n");
+	fprintf (stderr, "  --list           print the available scenes\n");
+	fprintf (stderr, "scenes:");
+	for (int i = 0; benchmarkScenes[i].m_name; i ++) {
+		fprintf (stderr, " %s", benchmarkScenes[i].m_name);
+	}
+	fprintf (stderr, "\n");
+}
+
+static bool ParseThreads (const char* list, BenchmarkOptions& options)
+{
+	options.m_threadCounts = 0;
+	while (*list && (options.m_threadCounts < BENCHMARK_MAX_THREAD_COUNTS)) {
+		char* end;
+		const long count = strtol (list, &end, 10);
+		if ((end == list) || (count <= 0)) {
+			return false;
+		}
+		options.m_threads[options.m_threadCounts] = int (count);
+		options.m_threadCounts ++;
+		list = (*end == ',') ? end + 1 : end;
+	}
+	return options.m_threadCounts > 0;
+}
+
+// splits the list in place, the strings point into the command line
+static bool ParsePlugins (char* list, BenchmarkOptions& options)
+{
+	options.m_pluginCount = 0;
+	while (*list && (options.m_pluginCount < BENCHMARK_MAX_PLUGINS)) {
+		char* const end = strchr (list, ',');
+		if (end) {
+			*end = 0;
+		}
+		options.m_plugins[options.m_pluginCount] = strcmp (list, "default") ? list : NULL;
+		options.m_pluginCount ++;
+		if (!end) {
+			break;
+		}
+		list = end + 1;
+	}
+	return options.m_pluginCount > 0;
+}
+
+static bool ParseOptions (int argc, char** argv, BenchmarkOptions& options)
+{
+	for (int i = 1; i < argc; i ++) {
+		const char* const arg = argv[i];
+		char* const value = (i + 1 < argc) ? argv[i + 1] : NULL;
+		if (!strcmp (arg, "--list")) {
+			for (int j = 0; benchmarkScenes[j].m_name; j ++) {
+				printf ("%s\n", benchmarkScenes[j].m_name);
+			}
+			exit (0);
+		} else if (!value) {
+			return false;
+		} else if (!strcmp (arg, "--scene")) {
+			options.m_scene = value;
+		} else if (!strcmp (arg, "--frames")) {
+			options.m_frames = atoi (value);
+		} else if (!strcmp (arg, "--warmup")) {
+			options.m_warmup = atoi (value);
+		} else if (!strcmp (arg, "--scale")) {
+			options.m_scale = atoi (value);
+		} else if (!strcmp (arg, "--threads")) {
+			if (!ParseThreads (value, options)) {
+				return false;
+			}
+		} else if (!strcmp (arg, "--plugin-path")) {
+			options.m_pluginPath = value;
+		} else if (!strcmp (arg, "--plugin")) {
+			if (!ParsePlugins (value, options)) {
+				return false;
+			}
+		} else if (!strcmp (arg, "--solver")) {
+			options.m_solver = atoi (value);
+		} else if (!strcmp (arg, "--iterations")) {
+			options.m_iterations = atoi (value);
+		} else if (!strcmp (arg, "--output")) {
+			options.m_output = value;
+		} else if (!strcmp (arg, "--media")) {
+			SetBenchmarkMediaPath (value);
+		} else {
+			return false;
+		}
+		i ++;
+	}
+	return (options.m_frames > 0) && (options.m_warmup >= 0) && (options.m_scale > 0);
+}
+
+int main (int argc, char** argv)
+{
+	BenchmarkOptions options;
+	if (!ParseOptions (argc, argv, options)) {
+		Usage ();
+		return 1;
+	}
+
+	const BenchmarkScene* scenes = benchmarkScenes;
+	int sceneCount = 0;
+	if (strcmp (options.m_scene, "all")) {
+		scenes = FindBenchmarkScene (options.m_scene);
+		if (!scenes) {
+			fprintf (stderr, "unknown scene \"%s\"\n", options.m_scene);
+			Usage ();
+			return 1;
+		}
+		sceneCount = 1;
+	} else {
+		for (; benchmarkScenes[sceneCount].m_name; sceneCount ++);
+	}
+
+	FILE* const file = options.m_output ? fopen (options.m_output, "wt") : stdout;
+	if (!file) {
+		fprintf (stderr, "can't open \"%s\"\n", options.m_output);
+		return 1;
+	}
+
+	// must be installed before the first world is created
+	NewtonSetMemorySystem (AllocMemory, FreeMemory);
+
+	fprintf (file, "{\n");
+	fprintf (file, "\t\"version\": %d,\n", NewtonWorldGetVersion ());
+	fprintf (file, "\t\"floatSize\": %d,\n", NewtonWorldFloatSize ());
+	fprintf (file, "\t\"frames\": %d,\n", options.m_frames);
+	fprintf (file, "\t\"warmup\": %d,\n", options.m_warmup);
+	fprintf (file, "\t\"timestep\": %f,\n", options.m_timestep);
+	fprintf (file, "\t\"scale\": %d,\n", options.m_scale);
+	fprintf (file, "\t\"runs\": [\n");
+	for (int i = 0; i < sceneCount; i ++) {
+		for (int k = 0; k < options.m_pluginCount; k ++) {
+			const char* const plugin = options.m_plugins[k];
+			for (int j = 0; j < options.m_threadCounts; j ++) {
+				BenchmarkResult result;
+				fprintf (stderr, "%s, %s, %d threads\n", scenes[i].m_name, plugin ? plugin : "default", options.m_threads[j]);
+				RunScene (scenes[i], options.m_threads[j], plugin, options, result);
+				const bool last = (i == sceneCount - 1) && (k == options.m_pluginCount - 1) && (j == options.m_threadCounts - 1);
+				WriteResult (file, scenes[i].m_name, result, last);
+				fflush (file);
+			}
+		}
+	}
+	fprintf (file, "\t]\n");
+	fprintf (file, "}\n");
+
+	if (file != stdout) {
+		fclose (file);
+	}
+	return 0;
+}
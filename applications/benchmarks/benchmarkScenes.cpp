@@ -0,0 +1,706 @@
+/* Copyright (c) <2003-2016> <Newton Game Dynamics>
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "benchmarkScenes.h"
+
+// the scenes below reproduce the body counts, shapes and joint layouts of the matching
+// demosSandbox demos, but without any of the rendering, meshes or asset loading.
+// everything is created procedurally so that the results only depends on the engine,
+// except for the level mesh of MeshCollisionBuild, which is read from the media folder
+// when it is available.
+
+#define BENCHMARK_PI			dFloat (3.141592f)
+#define BENCHMARK_GRAVITY		dFloat (-10.0f)
+#define BENCHMARK_SHAPE_COUNT	8
+#define BENCHMARK_LEVEL_MESH	"raceTrack1.ngd"
+#define BENCHMARK_MAX_FACE_SIZE	64
+
+static const char* benchmarkMediaPath = "../media";
+
+
+static void ApplyGravity (const NewtonBody* const body, dFloat timestep, int threadIndex)
+{
+	dFloat Ixx;
+	dFloat Iyy;
+	dFloat Izz;
+	dFloat mass;
+
+	NewtonBodyGetMass (body, &mass, &Ixx, &Iyy, &Izz);
+	dFloat force[4] = {dFloat (0.0f), mass * BENCHMARK_GRAVITY, dFloat (0.0f), dFloat (0.0f)};
+	NewtonBodySetForce (body, force);
+}
+
+// matrix rotated by angle around one of the principal axis (0 = x, 1 = y, 2 = z) and translated to x, y, z
+static void MakeMatrix (dFloat* const matrix, int axis, dFloat angle, dFloat x, dFloat y, dFloat z)
+{
+	const dFloat c = dFloat (cos (angle));
+	const dFloat s = dFloat (sin (angle));
+	const int i = (axis + 1) % 3;
+	const int j = (axis + 2) % 3;
+
+	memset (matrix, 0, 16 * sizeof (dFloat));
+	matrix[axis * 4 + axis] = dFloat (1.0f);
+	matrix[i * 4 + i] = c;
+	matrix[i * 4 + j] = s;
+	matrix[j * 4 + i] = -s;
+	matrix[j * 4 + j] = c;
+	matrix[12] = x;
+	matrix[13] = y;
+	matrix[14] = z;
+	matrix[15] = dFloat (1.0f);
+}
+
+static NewtonBody* CreateRigidBody (NewtonWorld* const world, const NewtonCollision* const collision, const dFloat* const matrix, dFloat mass)
+{
+	NewtonBody* const body = NewtonCreateDynamicBody (world, collision, matrix);
+	if (mass > dFloat (0.0f)) {
+		NewtonBodySetMassProperties (body, mass, collision);
+		NewtonBodySetForceAndTorqueCallback (body, ApplyGravity);
+	}
+	return body;
+}
+
+static void AddFloor (NewtonWorld* const world)
+{
+	dFloat matrix[16];
+	MakeMatrix (matrix, 0, dFloat (0.0f), dFloat (0.0f), dFloat (-0.5f), dFloat (0.0f));
+	NewtonCollision* const collision = NewtonCreateBox (world, dFloat (400.0f), dFloat (1.0f), dFloat (400.0f), 0, NULL);
+	CreateRigidBody (world, collision, matrix, dFloat (0.0f));
+	NewtonDestroyCollision (collision);
+}
+
+// out = a * b, row vector convention
+static void MultiplyMatrix (dFloat* const out, const dFloat* const a, const dFloat* const b)
+{
+	dFloat tmp[16];
+	for (int i = 0; i < 4; i ++) {
+		for (int j = 0; j < 4; j ++) {
+			tmp[i * 4 + j] = a[i * 4 + 0] * b[0 * 4 + j] + a[i * 4 + 1] * b[1 * 4 + j] + a[i * 4 + 2] * b[2 * 4 + j] + a[i * 4 + 3] * b[3 * 4 + j];
+		}
+	}
+	memcpy (out, tmp, sizeof (tmp));
+}
+
+static dFloat TerrainElevation (dFloat x, dFloat z)
+{
+	return dFloat (2.0f * sin (x * 0.11f) * cos (z * 0.07f) + 0.5f * sin ((x + z) * 0.37f));
+}
+
+// the same set of convex primitives used by the demos AddPrimitiveArray helper
+static void CreatePrimitiveShapes (NewtonWorld* const world, NewtonCollision** const shapes)
+{
+	dFloat offset[16];
+	dFloat points[24][3];
+
+	shapes[0] = NewtonCreateSphere (world, dFloat (0.5f), 0, NULL);
+	shapes[1] = NewtonCreateBox (world, dFloat (1.0f), dFloat (0.75f), dFloat (0.85f), 0, NULL);
+	shapes[2] = NewtonCreateCapsule (world, dFloat (0.35f), dFloat (0.35f), dFloat (1.2f), 0, NULL);
+	shapes[3] = NewtonCreateCylinder (world, dFloat (0.5f), dFloat (0.5f), dFloat (0.8f), 0, NULL);
+	shapes[4] = NewtonCreateChamferCylinder (world, dFloat (0.5f), dFloat (0.4f), 0, NULL);
+	shapes[5] = NewtonCreateCone (world, dFloat (0.5f), dFloat (1.0f), 0, NULL);
+
+	// an irregular hull from a deterministic point cloud on a squashed sphere
+	unsigned seed = 12345;
+	for (int i = 0; i < 24; i ++) {
+		seed = seed * 1664525u + 1013904223u;
+		const dFloat u = dFloat (seed >> 8) / dFloat (1 << 24);
+		seed = seed * 1664525u + 1013904223u;
+		const dFloat v = dFloat (seed >> 8) / dFloat (1 << 24);
+		const dFloat theta = dFloat (2.0f) * BENCHMARK_PI * u;
+		const dFloat phi = dFloat (acos (2.0f * v - 1.0f));
+		points[i][0] = dFloat (0.6f * sin (phi) * cos (theta));
+		points[i][1] = dFloat (0.4f * cos (phi));
+		points[i][2] = dFloat (0.5f * sin (phi) * sin (theta));
+	}
+	shapes[6] = NewtonCreateConvexHull (world, 24, &points[0][0], 3 * sizeof (dFloat), dFloat (0.01f), 0, NULL);
+
+	// a cross made of three bars
+	NewtonCollision* const compound = NewtonCreateCompoundCollision (world, 0);
+	NewtonCompoundCollisionBeginAddRemove (compound);
+	for (int i = 0; i < 3; i ++) {
+		MakeMatrix (offset, i, dFloat (0.0f), dFloat (0.0f), dFloat (0.0f), dFloat (0.0f));
+		const dFloat size[3] = {(i == 0) ? dFloat (1.2f) : dFloat (0.3f), (i == 1) ? dFloat (1.2f) : dFloat (0.3f), (i == 2) ? dFloat (1.2f) : dFloat (0.3f)};
+		NewtonCollision* const bar = NewtonCreateBox (world, size[0], size[1], size[2], 0, offset);
+		NewtonCompoundCollisionAddSubCollision (compound, bar);
+		NewtonDestroyCollision (bar);
+	}
+	NewtonCompoundCollisionEndAddRemove (compound);
+	shapes[7] = compound;
+}
+
+static void AddPrimitiveArray (NewtonWorld* const world, int side, int layers, dFloat elevation)
+{
+	NewtonCollision* shapes[BENCHMARK_SHAPE_COUNT];
+	CreatePrimitiveShapes (world, shapes);
+
+	dFloat matrix[16];
+	const dFloat spacing = dFloat (2.5f);
+	const dFloat origin = -dFloat (side) * spacing * dFloat (0.5f);
+	int index = 0;
+	for (int layer = 0; layer < layers; layer ++) {
+		for (int i = 0; i < side; i ++) {
+			for (int j = 0; j < side; j ++) {
+				const dFloat x = origin + i * spacing;
+				const dFloat z = origin + j * spacing;
+				const dFloat y = TerrainElevation (x, z) + elevation + layer * dFloat (2.0f);
+				MakeMatrix (matrix, index % 3, dFloat (0.3f) * dFloat (index % 7), x, y, z);
+				CreateRigidBody (world, shapes[index % BENCHMARK_SHAPE_COUNT], matrix, dFloat (10.0f));
+				index ++;
+			}
+		}
+	}
+
+	for (int i = 0; i < BENCHMARK_SHAPE_COUNT; i ++) {
+		NewtonDestroyCollision (shapes[i]);
+	}
+}
+
+// returns a pointer to the value of attribute name inside the xml tag, or NULL
+static const char* FindAttribute (const char* const tag, const char* const name)
+{
+	if (!tag) {
+		return NULL;
+	}
+	char pattern[64];
+	snprintf (pattern, sizeof (pattern), " %s=\"", name);
+	const char* const end = strchr (tag, '>');
+	const char* const value = strstr (tag, pattern);
+	return (value && (value < end)) ? value + strlen (pattern) : NULL;
+}
+
+static bool ReadFloats (const char* text, dFloat* const values, int count)
+{
+	for (int i = 0; text && (i < count); i ++) {
+		char* end;
+		values[i] = dFloat (strtod (text, &end));
+		if (end == text) {
+			return false;
+		}
+		text = end;
+	}
+	return text ? true : false;
+}
+
+// minimal reader for the first mesh node of a dScene .ngd file, only the positions and the
+// face lists are read. the benchmark does not link dScene, so the node transform is assumed
+// to be a uniform scale followed by the euler rotation, the same as dSceneNodeInfo::GetTransform.
+// surface is the height of the mesh at the origin. returns false if the file can not be read,
+// so that the caller can fall back to a procedural mesh
+static bool AddLevelMesh (NewtonWorld* const world, const char* const name, dFloat& surface)
+{
+	char path[1024];
+	snprintf (path, sizeof (path), "%s/%s", benchmarkMediaPath, name);
+	FILE* const file = fopen (path, "rb");
+	if (!file) {
+		return false;
+	}
+	fseek (file, 0, SEEK_END);
+	const long size = ftell (file);
+	fseek (file, 0, SEEK_SET);
+	char* const text = new char[size + 1];
+	const size_t read = fread (text, 1, size_t (size), file);
+	text[read] = 0;
+	fclose (file);
+
+	const char* const node = strstr (text, "<dSceneNodeInfo>");
+	const char* const mesh = node ? strstr (node, "<dMeshNodeInfo>") : NULL;
+	const char* const transform = mesh ? strstr (node, "<transform ") : NULL;
+	const char* const pivot = mesh ? strstr (mesh, "<pivotMatrix ") : NULL;
+	const char* const points = mesh ? strstr (mesh, "<position float4=") : NULL;
+	const char* const polygons = mesh ? strstr (mesh, "<polygons ") : NULL;
+	const char* const faceIndices = polygons ? strstr (polygons, "<position index=") : NULL;
+
+	dFloat position[4];
+	dFloat euler[4];
+	dFloat scale[4];
+	dFloat matrix[16];
+	dFloat rotation[16];
+	bool ok = faceIndices && (transform < mesh) &&
+			  ReadFloats (FindAttribute (transform, "position"), position, 4) &&
+			  ReadFloats (FindAttribute (transform, "eulerAngles"), euler, 4) &&
+			  ReadFloats (FindAttribute (transform, "localScale"), scale, 4) &&
+			  ReadFloats (FindAttribute (pivot, "float16"), matrix, 16);
+
+	const int pointCount = ok ? atoi (FindAttribute (points, "float4")) : 0;
+	const int faceCount = ok ? atoi (FindAttribute (polygons, "count")) : 0;
+	dFloat* const vertex = new dFloat[4 * pointCount + 1];
+	ok = ok && (pointCount > 0) && (faceCount > 0) && ReadFloats (FindAttribute (points, "floats"), vertex, 4 * pointCount);
+
+	NewtonCollision* const collision = ok ? NewtonCreateTreeCollision (world, 0) : NULL;
+	if (ok) {
+		// geometry pivot, then scale, then pitch, yaw and roll, then the node position
+		for (int i = 0; i < 4; i ++) {
+			for (int j = 0; j < 3; j ++) {
+				matrix[i * 4 + j] *= scale[j];
+			}
+		}
+		for (int axis = 0; axis < 3; axis ++) {
+			MakeMatrix (rotation, axis, euler[axis], dFloat (0.0f), dFloat (0.0f), dFloat (0.0f));
+			MultiplyMatrix (matrix, matrix, rotation);
+		}
+		matrix[12] += position[0];
+		matrix[13] += position[1];
+		matrix[14] += position[2];
+
+		dFloat bottom = dFloat (1.0e10f);
+		dFloat top = dFloat (-1.0e10f);
+		for (int i = 0; i < pointCount; i ++) {
+			dFloat* const p = &vertex[i * 4];
+			const dFloat x = p[0] * matrix[0] + p[1] * matrix[4] + p[2] * matrix[8] + matrix[12];
+			const dFloat y = p[0] * matrix[1] + p[1] * matrix[5] + p[2] * matrix[9] + matrix[13];
+			const dFloat z = p[0] * matrix[2] + p[1] * matrix[6] + p[2] * matrix[10] + matrix[14];
+			p[0] = x;
+			p[1] = y;
+			p[2] = z;
+			top = (y > top) ? y : top;
+			bottom = (y < bottom) ? y : bottom;
+		}
+
+		NewtonTreeCollisionBeginBuild (collision);
+		const char* faceSize = FindAttribute (polygons, "faceIndexCount");
+		const char* index = FindAttribute (faceIndices, "index");
+		for (int i = 0; ok && (i < faceCount); i ++) {
+			char* end;
+			const int count = int (strtol (faceSize, &end, 10));
+			faceSize = end;
+			ok = (count >= 3) && (count <= BENCHMARK_MAX_FACE_SIZE);
+
+			dFloat face[BENCHMARK_MAX_FACE_SIZE][3];
+			for (int j = 0; ok && (j < count); j ++) {
+				const int k = int (strtol (index, &end, 10));
+				ok = (end != index) && (k >= 0) && (k < pointCount);
+				index = end;
+				if (ok) {
+					face[j][0] = vertex[k * 4 + 0];
+					face[j][1] = vertex[k * 4 + 1];
+					face[j][2] = vertex[k * 4 + 2];
+				}
+			}
+			if (ok) {
+				NewtonTreeCollisionAddFace (collision, count, &face[0][0], 3 * sizeof (dFloat), 0);
+			}
+		}
+		NewtonTreeCollisionEndBuildParallel (world, collision, 1);
+
+		dLong attribute;
+		dFloat normal[3];
+		const dFloat p0[3] = {dFloat (0.0f), top + dFloat (1.0f), dFloat (0.0f)};
+		const dFloat p1[3] = {dFloat (0.0f), bottom - dFloat (1.0f), dFloat (0.0f)};
+		const dFloat param = NewtonCollisionRayCast (collision, p0, p1, normal, &attribute);
+		surface = (param < dFloat (1.0f)) ? p0[1] + (p1[1] - p0[1]) * param : top;
+	}
+
+	if (ok) {
+		MakeMatrix (matrix, 0, dFloat (0.0f), dFloat (0.0f), dFloat (0.0f), dFloat (0.0f));
+		CreateRigidBody (world, collision, matrix, dFloat (0.0f));
+	}
+	if (collision) {
+		NewtonDestroyCollision (collision);
+	}
+	delete[] vertex;
+	delete[] text;
+	return ok;
+}
+
+static void AddTerrainMesh (NewtonWorld* const world, int cells, dFloat cellSize)
+{
+	NewtonCollision* const collision = NewtonCreateTreeCollision (world, 0);
+	NewtonTreeCollisionBeginBuild (collision);
+
+	const dFloat origin = -dFloat (cells) * cellSize * dFloat (0.5f);
+	for (int i = 0; i < cells; i ++) {
+		for (int j = 0; j < cells; j ++) {
+			dFloat quad[4][3];
+			for (int k = 0; k < 4; k ++) {
+				const dFloat x = origin + (i + ((k == 1) || (k == 2))) * cellSize;
+				const dFloat z = origin + (j + (k >= 2)) * cellSize;
+				quad[k][0] = x;
+				quad[k][1] = TerrainElevation (x, z);
+				quad[k][2] = z;
+			}
+			const dFloat face0[3][3] = {{quad[0][0], quad[0][1], quad[0][2]}, {quad[3][0], quad[3][1], quad[3][2]}, {quad[2][0], quad[2][1], quad[2][2]}};
+			const dFloat face1[3][3] = {{quad[0][0], quad[0][1], quad[0][2]}, {quad[2][0], quad[2][1], quad[2][2]}, {quad[1][0], quad[1][1], quad[1][2]}};
+			NewtonTreeCollisionAddFace (collision, 3, &face0[0][0], 3 * sizeof (dFloat), 0);
+			NewtonTreeCollisionAddFace (collision, 3, &face1[0][0], 3 * sizeof (dFloat), 0);
+		}
+	}
+	NewtonTreeCollisionEndBuildParallel (world, collision, 1);
+
+	dFloat matrix[16];
+	MakeMatrix (matrix, 0, dFloat (0.0f), dFloat (0.0f), dFloat (0.0f), dFloat (0.0f));
+	CreateRigidBody (world, collision, matrix, dFloat (0.0f));
+	NewtonDestroyCollision (collision);
+}
+
+static void AddTerrainHeightField (NewtonWorld* const world, int size, dFloat cellSize)
+{
+	float* const elevation = new float[size * size];
+	char* const attributes = new char[size * size];
+
+	const dFloat origin = -dFloat (size - 1) * cellSize * dFloat (0.5f);
+	for (int z = 0; z < size; z ++) {
+		for (int x = 0; x < size; x ++) {
+			elevation[z * size + x] = float (TerrainElevation (origin + x * cellSize, origin + z * cellSize));
+			attributes[z * size + x] = 0;
+		}
+	}
+
+	NewtonCollision* const collision = NewtonCreateHeightFieldCollision (world, size, size, 1, 0, elevation, attributes, dFloat (1.0f), cellSize, cellSize, 0);
+	delete[] attributes;
+	delete[] elevation;
+
+	dFloat matrix[16];
+	MakeMatrix (matrix, 0, dFloat (0.0f), origin, dFloat (0.0f), origin);
+	CreateRigidBody (world, collision, matrix, dFloat (0.0f));
+	NewtonDestroyCollision (collision);
+}
+
+static void BuildPyramid (NewtonWorld* const world, const NewtonCollision* const collision, const dFloat* const rotation, dFloat step, dFloat height, int count, dFloat x0, dFloat z0)
+{
+	dFloat matrix[16];
+	memcpy (matrix, rotation, sizeof (matrix));
+	for (int level = 0; level < count; level ++) {
+		const dFloat y = (dFloat (level) + dFloat (0.5f)) * height;
+		const dFloat x = x0 + dFloat (level) * step * dFloat (0.5f);
+		for (int i = 0; i < count - level; i ++) {
+			matrix[12] = x + dFloat (i) * step;
+			matrix[13] = y;
+			matrix[14] = z0;
+			CreateRigidBody (world, collision, matrix, dFloat (10.0f));
+		}
+	}
+}
+
+static void BasicStacking (NewtonWorld* const world, int scale)
+{
+	// BasicStacking.cpp: pyramids of boxes and of standing cylinders
+	const int high = 20;
+	const int pyramids = 4 * scale;
+
+	AddFloor (world);
+
+	dFloat boxRotation[16];
+	dFloat cylinderRotation[16];
+	MakeMatrix (boxRotation, 0, dFloat (0.0f), dFloat (0.0f), dFloat (0.0f), dFloat (0.0f));
+	MakeMatrix (cylinderRotation, 2, dFloat (0.5f) * BENCHMARK_PI, dFloat (0.0f), dFloat (0.0f), dFloat (0.0f));
+
+	NewtonCollision* const box = NewtonCreateBox (world, dFloat (0.5f), dFloat (0.25f), dFloat (0.8f), 0, NULL);
+	NewtonCollision* const cylinder = NewtonCreateCylinder (world, dFloat (0.375f), dFloat (0.375f), dFloat (0.35f), 0, NULL);
+	for (int i = 0; i < pyramids; i ++) {
+		const dFloat z = dFloat (i) * dFloat (3.0f) - dFloat (pyramids) * dFloat (1.5f);
+		BuildPyramid (world, box, boxRotation, dFloat (0.5f), dFloat (0.25f), high, dFloat (-12.0f), z);
+		BuildPyramid (world, cylinder, cylinderRotation, dFloat (0.76f), dFloat (0.35f), high, dFloat (2.0f), z);
+	}
+	NewtonDestroyCollision (box);
+	NewtonDestroyCollision (cylinder);
+}
+
+static void MeshCollision (NewtonWorld* const world, int scale)
+{
+	// MeshCollision.cpp: a primitive array dropped on a static polygon soup
+	AddTerrainMesh (world, 64 * scale, dFloat (2.0f));
+	AddPrimitiveArray (world, 16 * scale, 2, dFloat (4.0f));
+}
+
+static void MeshCollisionBuild (NewtonWorld* const world, int scale)
+{
+	// MeshCollision.cpp at level size, the build time of the polygon soup dominates this scene.
+	// the demo loads a level from the media folder, sponza.ngd is not shipped so the largest
+	// level that is gets used, a procedural soup of similar size replaces it if it is missing
+	dFloat surface;
+	if (AddLevelMesh (world, BENCHMARK_LEVEL_MESH, surface)) {
+		AddPrimitiveArray (world, 4 * scale, 1, surface + dFloat (4.0f));
+	} else {
+		fprintf (stderr, "MeshCollisionBuild: %s/%s not found, using a procedural mesh\n", benchmarkMediaPath, BENCHMARK_LEVEL_MESH);
+		AddTerrainMesh (world, 256 * scale, dFloat (0.5f));
+		AddPrimitiveArray (world, 4 * scale, 1, dFloat (4.0f));
+	}
+}
+
+static void HeightFieldCollision (NewtonWorld* const world, int scale)
+{
+	// HeightFieldCollision.cpp: a primitive array dropped on a height field
+	AddTerrainHeightField (world, 128 * scale + 1, dFloat (1.0f));
+	AddPrimitiveArray (world, 16 * scale, 2, dFloat (4.0f));
+}
+
+static NewtonJoint* LinkBones (NewtonWorld* const world, NewtonBody* const child, NewtonBody* const parent, const dFloat* const pivot, const dFloat* const pin, dFloat coneAngle, dFloat twistAngle)
+{
+	NewtonJoint* const joint = NewtonConstraintCreateBall (world, pivot, child, parent);
+	NewtonBallSetConeLimits (joint, pin, coneAngle, twistAngle);
+	NewtonJointSetCollisionState (joint, 0);
+	return joint;
+}
+
+static void AddRagdoll (NewtonWorld* const world, NewtonCollision** const shapes, dFloat x, dFloat y, dFloat z)
+{
+	enum {
+		m_pelvis,
+		m_torso,
+		m_head,
+		m_upperArm,
+		m_lowerArm,
+		m_upperLeg,
+		m_lowerLeg,
+	};
+
+	dFloat matrix[16];
+	const dFloat up[3] = {dFloat (0.0f), dFloat (1.0f), dFloat (0.0f)};
+	const dFloat down[3] = {dFloat (0.0f), dFloat (-1.0f), dFloat (0.0f)};
+
+	MakeMatrix (matrix, 0, dFloat (0.0f), x, y, z);
+	NewtonBody* const pelvis = CreateRigidBody (world, shapes[m_pelvis], matrix, dFloat (8.0f));
+
+	MakeMatrix (matrix, 0, dFloat (0.0f), x, y + dFloat (0.45f), z);
+	NewtonBody* const torso = CreateRigidBody (world, shapes[m_torso], matrix, dFloat (12.0f));
+	const dFloat waist[3] = {x, y + dFloat (0.15f), z};
+	LinkBones (world, torso, pelvis, waist, up, dFloat (0.4f), dFloat (0.3f));
+
+	MakeMatrix (matrix, 0, dFloat (0.0f), x, y + dFloat (0.9f), z);
+	NewtonBody* const head = CreateRigidBody (world, shapes[m_head], matrix, dFloat (4.0f));
+	const dFloat neck[3] = {x, y + dFloat (0.75f), z};
+	LinkBones (world, head, torso, neck, up, dFloat (0.5f), dFloat (0.5f));
+
+	for (int side = -1; side <= 1; side += 2) {
+		const dFloat dir[3] = {dFloat (side), dFloat (0.0f), dFloat (0.0f)};
+
+		// arms are capsules along the x axis
+		MakeMatrix (matrix, 0, dFloat (0.0f), x + side * dFloat (0.5f), y + dFloat (0.6f), z);
+		NewtonBody* const upperArm = CreateRigidBody (world, shapes[m_upperArm], matrix, dFloat (3.0f));
+		const dFloat shoulder[3] = {x + side * dFloat (0.28f), y + dFloat (0.6f), z};
+		LinkBones (world, upperArm, torso, shoulder, dir, dFloat (1.2f), dFloat (0.4f));
+
+		MakeMatrix (matrix, 0, dFloat (0.0f), x + side * dFloat (0.95f), y + dFloat (0.6f), z);
+		NewtonBody* const lowerArm = CreateRigidBody (world, shapes[m_lowerArm], matrix, dFloat (2.0f));
+		const dFloat elbow[3] = {x + side * dFloat (0.73f), y + dFloat (0.6f), z};
+		LinkBones (world, lowerArm, upperArm, elbow, dir, dFloat (1.0f), dFloat (0.2f));
+
+		// legs are capsules rotated to stand along the y axis
+		MakeMatrix (matrix, 2, dFloat (0.5f) * BENCHMARK_PI, x + side * dFloat (0.12f), y - dFloat (0.4f), z);
+		NewtonBody* const upperLeg = CreateRigidBody (world, shapes[m_upperLeg], matrix, dFloat (6.0f));
+		const dFloat hip[3] = {x + side * dFloat (0.12f), y - dFloat (0.1f), z};
+		LinkBones (world, upperLeg, pelvis, hip, down, dFloat (0.9f), dFloat (0.3f));
+
+		MakeMatrix (matrix, 2, dFloat (0.5f) * BENCHMARK_PI, x + side * dFloat (0.12f), y - dFloat (1.0f), z);
+		NewtonBody* const lowerLeg = CreateRigidBody (world, shapes[m_lowerLeg], matrix, dFloat (4.0f));
+		const dFloat knee[3] = {x + side * dFloat (0.12f), y - dFloat (0.7f), z};
+		LinkBones (world, lowerLeg, upperLeg, knee, down, dFloat (0.8f), dFloat (0.1f));
+	}
+}
+
+static void DynamicRagdoll (NewtonWorld* const world, int scale)
+{
+	// DynamicRagdoll.cpp: piles of ball and socket ragdolls with cone and twist limits
+	AddFloor (world);
+
+	NewtonCollision* shapes[7];
+	shapes[0] = NewtonCreateBox (world, dFloat (0.4f), dFloat (0.2f), dFloat (0.25f), 0, NULL);
+	shapes[1] = NewtonCreateBox (world, dFloat (0.45f), dFloat (0.5f), dFloat (0.25f), 0, NULL);
+	shapes[2] = NewtonCreateSphere (world, dFloat (0.13f), 0, NULL);
+	shapes[3] = NewtonCreateCapsule (world, dFloat (0.07f), dFloat (0.07f), dFloat (0.44f), 0, NULL);
+	shapes[4] = NewtonCreateCapsule (world, dFloat (0.06f), dFloat (0.06f), dFloat (0.44f), 0, NULL);
+	shapes[5] = NewtonCreateCapsule (world, dFloat (0.09f), dFloat (0.09f), dFloat (0.6f), 0, NULL);
+	shapes[6] = NewtonCreateCapsule (world, dFloat (0.07f), dFloat (0.07f), dFloat (0.6f), 0, NULL);
+
+	const int side = 6 * scale;
+	for (int layer = 0; layer < 2; layer ++) {
+		for (int i = 0; i < side; i ++) {
+			for (int j = 0; j < side; j ++) {
+				const dFloat x = (dFloat (i) - dFloat (side) * dFloat (0.5f)) * dFloat (2.5f) + layer * dFloat (0.6f);
+				const dFloat z = (dFloat (j) - dFloat (side) * dFloat (0.5f)) * dFloat (1.5f);
+				AddRagdoll (world, shapes, x, dFloat (1.5f) + layer * dFloat (2.5f), z);
+			}
+		}
+	}
+
+	for (int i = 0; i < 7; i ++) {
+		NewtonDestroyCollision (shapes[i]);
+	}
+}
+
+// wheels are attached with a user joint, the legacy hinge is not part of the core library.
+// the joint frame front is the axle, the up and right rows keep it aligned, and a motor row drives it
+struct WheelJoint
+{
+	dFloat m_localMatrix0[16];
+	dFloat m_localMatrix1[16];
+};
+
+static dFloat DotProduct (const dFloat* const a, const dFloat* const b)
+{
+	return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+static void MatrixMultiply (const dFloat* const a, const dFloat* const b, dFloat* const out)
+{
+	for (int i = 0; i < 4; i ++) {
+		for (int j = 0; j < 4; j ++) {
+			out[i * 4 + j] = a[i * 4 + 0] * b[0 * 4 + j] + a[i * 4 + 1] * b[1 * 4 + j] + a[i * 4 + 2] * b[2 * 4 + j] + a[i * 4 + 3] * b[3 * 4 + j];
+		}
+	}
+}
+
+// inverse of a matrix made of a rotation and a translation
+static void MatrixInverse (const dFloat* const matrix, dFloat* const out)
+{
+	for (int i = 0; i < 3; i ++) {
+		for (int j = 0; j < 3; j ++) {
+			out[i * 4 + j] = matrix[j * 4 + i];
+		}
+		out[i * 4 + 3] = dFloat (0.0f);
+	}
+	for (int i = 0; i < 3; i ++) {
+		out[12 + i] = -(matrix[12] * out[i] + matrix[13] * out[4 + i] + matrix[14] * out[8 + i]);
+	}
+	out[15] = dFloat (1.0f);
+}
+
+// angle of dir around sinDir, measured from cosDir, same as dCustomJoint::CalculateAngle
+static dFloat CalculateAngle (const dFloat* const dir, const dFloat* const cosDir, const dFloat* const sinDir)
+{
+	const dFloat dot = DotProduct (dir, sinDir);
+	const dFloat project[3] = {dir[0] - sinDir[0] * dot, dir[1] - sinDir[1] * dot, dir[2] - sinDir[2] * dot};
+	const dFloat cross[3] = {project[1] * cosDir[2] - project[2] * cosDir[1], project[2] * cosDir[0] - project[0] * cosDir[2], project[0] * cosDir[1] - project[1] * cosDir[0]};
+	return dFloat (atan2 (DotProduct (sinDir, cross), DotProduct (project, cosDir)));
+}
+
+static void WheelJointSubmitConstraints (const NewtonJoint* const joint, dFloat timestep, int threadIndex)
+{
+	const dFloat targetOmega = dFloat (-8.0f);
+	const dFloat maxTorque = dFloat (4000.0f);
+	const WheelJoint* const wheelJoint = (WheelJoint*) NewtonJointGetUserData (joint);
+	NewtonBody* const wheel = NewtonJointGetBody0 (joint);
+	NewtonBody* const chassis = NewtonJointGetBody1 (joint);
+
+	dFloat bodyMatrix[16];
+	dFloat matrix0[16];
+	dFloat matrix1[16];
+	NewtonBodyGetMatrix (wheel, bodyMatrix);
+	MatrixMultiply (wheelJoint->m_localMatrix0, bodyMatrix, matrix0);
+	NewtonBodyGetMatrix (chassis, bodyMatrix);
+	MatrixMultiply (wheelJoint->m_localMatrix1, bodyMatrix, matrix1);
+
+	for (int i = 0; i < 3; i ++) {
+		NewtonUserJointAddLinearRow (joint, &matrix0[12], &matrix1[12], &matrix1[i * 4]);
+	}
+	NewtonUserJointAddAngularRow (joint, CalculateAngle (&matrix0[0], &matrix1[0], &matrix1[4]), &matrix1[4]);
+	NewtonUserJointAddAngularRow (joint, CalculateAngle (&matrix0[0], &matrix1[0], &matrix1[8]), &matrix1[8]);
+
+	dFloat omega0[4];
+	dFloat omega1[4];
+	NewtonBodyGetOmega (wheel, omega0);
+	NewtonBodyGetOmega (chassis, omega1);
+	const dFloat relOmega[3] = {omega0[0] - omega1[0], omega0[1] - omega1[1], omega0[2] - omega1[2]};
+	const dFloat omega = DotProduct (&matrix0[0], relOmega);
+
+	NewtonUserJointAddAngularRow (joint, dFloat (0.0f), &matrix0[0]);
+	NewtonUserJointSetRowAcceleration (joint, (targetOmega - omega) / timestep);
+	NewtonUserJointSetRowMinimumFriction (joint, -maxTorque);
+	NewtonUserJointSetRowMaximumFriction (joint, maxTorque);
+}
+
+static void WheelJointDestructor (const NewtonJoint* const joint)
+{
+	delete (WheelJoint*) NewtonJointGetUserData (joint);
+}
+
+static void AddWheelJoint (NewtonWorld* const world, NewtonBody* const wheel, NewtonBody* const chassis, const dFloat* const pivot)
+{
+	// front along the axle (world z), up along world y
+	dFloat jointMatrix[16];
+	MakeMatrix (jointMatrix, 1, dFloat (-0.5f) * BENCHMARK_PI, pivot[0], pivot[1], pivot[2]);
+
+	dFloat bodyMatrix[16];
+	dFloat inverse[16];
+	WheelJoint* const wheelJoint = new WheelJoint;
+	NewtonBodyGetMatrix (wheel, bodyMatrix);
+	MatrixInverse (bodyMatrix, inverse);
+	MatrixMultiply (jointMatrix, inverse, wheelJoint->m_localMatrix0);
+	NewtonBodyGetMatrix (chassis, bodyMatrix);
+	MatrixInverse (bodyMatrix, inverse);
+	MatrixMultiply (jointMatrix, inverse, wheelJoint->m_localMatrix1);
+
+	NewtonJoint* const joint = NewtonConstraintCreateUserJoint (world, 6, WheelJointSubmitConstraints, wheel, chassis);
+	NewtonJointSetUserData (joint, wheelJoint);
+	NewtonJointSetDestructor (joint, WheelJointDestructor);
+	NewtonJointSetCollisionState (joint, 0);
+}
+
+static void HeavyVehicles (NewtonWorld* const world, int scale)
+{
+	// HeavyVehicles.cpp: multi axle vehicles with motorized wheels driving over uneven terrain
+	AddTerrainHeightField (world, 128 * scale + 1, dFloat (1.0f));
+
+	NewtonCollision* const chassisShape = NewtonCreateBox (world, dFloat (5.0f), dFloat (1.0f), dFloat (2.2f), 0, NULL);
+	NewtonCollision* const wheelShape = NewtonCreateChamferCylinder (world, dFloat (0.6f), dFloat (0.4f), 0, NULL);
+
+	dFloat matrix[16];
+	const int side = 4 * scale;
+	for (int i = 0; i < side; i ++) {
+		for (int j = 0; j < side; j ++) {
+			const dFloat x = (dFloat (i) - dFloat (side) * dFloat (0.5f)) * dFloat (10.0f);
+			const dFloat z = (dFloat (j) - dFloat (side) * dFloat (0.5f)) * dFloat (6.0f);
+			const dFloat y = TerrainElevation (x, z) + dFloat (3.0f);
+
+			MakeMatrix (matrix, 0, dFloat (0.0f), x, y, z);
+			NewtonBody* const chassis = CreateRigidBody (world, chassisShape, matrix, dFloat (1000.0f));
+
+			for (int axle = 0; axle < 3; axle ++) {
+				for (int k = -1; k <= 1; k += 2) {
+					const dFloat wheelX = x + (dFloat (axle) - dFloat (1.0f)) * dFloat (1.9f);
+					const dFloat wheelY = y - dFloat (0.6f);
+					const dFloat wheelZ = z + k * dFloat (1.35f);
+
+					// chamfer cylinders spin around their x axis, turn it to the axle direction
+					MakeMatrix (matrix, 1, dFloat (0.5f) * BENCHMARK_PI, wheelX, wheelY, wheelZ);
+					NewtonBody* const wheel = CreateRigidBody (world, wheelShape, matrix, dFloat (60.0f));
+
+					const dFloat pivot[3] = {wheelX, wheelY, wheelZ};
+					AddWheelJoint (world, wheel, chassis, pivot);
+				}
+			}
+		}
+	}
+
+	NewtonDestroyCollision (chassisShape);
+	NewtonDestroyCollision (wheelShape);
+}
+
+
+const BenchmarkScene benchmarkScenes[] =
+{
+	{"BasicStacking", BasicStacking},
+	{"MeshCollision", MeshCollision},
+	{"MeshCollisionBuild", MeshCollisionBuild},
+	{"HeightFieldCollision", HeightFieldCollision},
+	{"DynamicRagdoll", DynamicRagdoll},
+	{"HeavyVehicles", HeavyVehicles},
+	{NULL, NULL},
+};
+
+void SetBenchmarkMediaPath (const char* const path)
+{
+	benchmarkMediaPath = path;
+}
+
+const BenchmarkScene* FindBenchmarkScene (const char* const name)
+{
+	for (int i = 0; benchmarkScenes[i].m_name; i ++) {
+		if (!strcmp (benchmarkScenes[i].m_name, name)) {
+			return &benchmarkScenes[i];
+		}
+	}
+	return NULL;
+}
@@ -0,0 +1,35 @@
+/* Copyright (c) <2003-2016> <Newton Game Dynamics>
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely
+*/
+
+#ifndef __BENCHMARK_SCENES_H__
+#define __BENCHMARK_SCENES_H__
+
+#include <Newton.h>
+
+// headless versions of the demosSandbox workloads, built with the core sdk only.
+// each builder populates an empty world, scale multiplies the number of dynamic objects
+typedef void (*BenchmarkSceneBuilder) (NewtonWorld* const world, int scale);
+
+struct BenchmarkScene
+{
+	const char* m_name;
+	BenchmarkSceneBuilder m_build;
+};
+
+// null terminated list of all available scenes
+extern const BenchmarkScene benchmarkScenes[];
+
+const BenchmarkScene* FindBenchmarkScene (const char* const name);
+
+// folder the scenes load their assets from, the default is ../media
+void SetBenchmarkMediaPath (const char* const path);
+
+#endif
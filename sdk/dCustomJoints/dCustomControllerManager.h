@@ -20,6 +20,9 @@
 #include "dCustomJointLibraryStdAfx.h"
 #include "dCustomAlloc.h"
 
+// number of consecutive controllers claimed by a worker thread at the time
+#define D_CUSTOM_CONTROLLER_GRAIN_SIZE	8
+
 
 class dCustomControllerConvexCastPreFilter
 {	
@@ -98,6 +101,8 @@ class dCustomControllerManagerBase
 	dCustomControllerManagerBase(NewtonWorld* const world)
 		:m_world(world)
 		,m_curTimestep(0.0f)
+		,m_grainSize(D_CUSTOM_CONTROLLER_GRAIN_SIZE)
+		,m_batchIndex(0)
 	{
 	}
 
@@ -111,8 +116,20 @@ class dCustomControllerManagerBase
 		return m_curTimestep;
 	}
 
+	int GetGrainSize() const
+	{
+		return m_grainSize;
+	}
+
+	void SetGrainSize(int grainSize)
+	{
+		m_grainSize = dMax (grainSize, 1);
+	}
+
 	NewtonWorld* m_world;
 	dFloat m_curTimestep;
+	int m_grainSize;
+	int m_batchIndex;
 };
 
 
@@ -187,6 +204,7 @@ class dCustomControllerManager: public dCustomControllerManagerBase, public dLis
 
 	private:
 	void DestroyAllController ();
+	void UpdateControllersArray ();
 
 	static void Destroy (const NewtonWorld* const world, void* const listenerUserData);
 	static void Debug (const NewtonWorld* const world, void* const listenerUserData, void* const debugContext);
@@ -196,6 +214,10 @@ class dCustomControllerManager: public dCustomControllerManagerBase, public dLis
 
 	static void PreUpdateKernel (NewtonWorld* const world, void* const context, int threadIndex);
 	static void PostUpdateKernel (NewtonWorld* const world, void* const context, int threadIndex);
+
+	dArray<CONTROLLER_BASE*> m_controllersArray;
+	int m_controllersCount;
+	bool m_controllersDirty;
 };
 
 
@@ -203,6 +225,9 @@ template<class CONTROLLER_BASE>
 dCustomControllerManager<CONTROLLER_BASE>::dCustomControllerManager(NewtonWorld* const world, const char* const managerName)
 	:dCustomControllerManagerBase(world)
 	,dList<CONTROLLER_BASE>()
+	,m_controllersArray()
+	,m_controllersCount(0)
+	,m_controllersDirty(false)
 {
 	void* const listener = NewtonWorldAddListener(world, managerName, this);
 
@@ -226,22 +251,53 @@ void dCustomControllerManager<CONTROLLER_BASE>::DestroyAllController ()
 	}
 }
 
+template<class CONTROLLER_BASE>
+void dCustomControllerManager<CONTROLLER_BASE>::UpdateControllersArray ()
+{
+	// the controllers are updated from a flat array, so that the worker threads can claim them in batches
+	const int count = dList<CONTROLLER_BASE>::GetCount();
+	if (m_controllersDirty || (count != m_controllersCount)) {
+		if (m_controllersArray.GetSize() < count) {
+			m_controllersArray.Resize(count);
+		}
+		int index = 0;
+		for (typename dList<CONTROLLER_BASE>::dListNode* node = dList<CONTROLLER_BASE>::GetFirst(); node; node = node->GetNext()) {
+			m_controllersArray[index] = &node->GetInfo();
+			index ++;
+		}
+		m_controllersCount = count;
+		m_controllersDirty = false;
+	}
+}
+
 template<class CONTROLLER_BASE>
 void dCustomControllerManager<CONTROLLER_BASE>::PreUpdate(dFloat timestep)
 {
-	for (typename dCustomControllerManager<CONTROLLER_BASE>::dListNode* node = dCustomControllerManager<CONTROLLER_BASE>::GetFirst(); node; node = node->GetNext()) {
-		NewtonDispachThreadJob(m_world, PreUpdateKernel, &node->GetInfo(), __FUNCTION__);
+	UpdateControllersArray ();
+	if (m_controllersCount) {
+		m_batchIndex = 0;
+		const int batchCount = (m_controllersCount + m_grainSize - 1) / m_grainSize;
+		const int jobsCount = dMin (NewtonGetThreadsCount(m_world), batchCount);
+		for (int i = 0; i < jobsCount; i ++) {
+			NewtonDispachThreadJob(m_world, PreUpdateKernel, this, __FUNCTION__);
+		}
+		NewtonSyncThreadJobs(m_world);
 	}
-	NewtonSyncThreadJobs(m_world);
 }
 
 template<class CONTROLLER_BASE>
 void dCustomControllerManager<CONTROLLER_BASE>::PostUpdate(dFloat timestep)
 {
-	for (typename dList<CONTROLLER_BASE>::dListNode* node = dList<CONTROLLER_BASE>::GetFirst(); node; node = node->GetNext()) {
-		NewtonDispachThreadJob(m_world, PostUpdateKernel, &node->GetInfo(), __FUNCTION__);
+	UpdateControllersArray ();
+	if (m_controllersCount) {
+		m_batchIndex = 0;
+		const int batchCount = (m_controllersCount + m_grainSize - 1) / m_grainSize;
+		const int jobsCount = dMin (NewtonGetThreadsCount(m_world), batchCount);
+		for (int i = 0; i < jobsCount; i ++) {
+			NewtonDispachThreadJob(m_world, PostUpdateKernel, this, __FUNCTION__);
+		}
+		NewtonSyncThreadJobs(m_world);
 	}
-	NewtonSyncThreadJobs(m_world);
 }
 
 
@@ -292,15 +348,37 @@ void dCustomControllerManager<CONTROLLER_BASE>::OnBodyDestroy (const NewtonWorld
 template<class CONTROLLER_BASE>
 void dCustomControllerManager<CONTROLLER_BASE>::PreUpdateKernel (NewtonWorld* const world, void* const context, int threadIndex)
 {
-	dCustomControllerBase* const controller = (dCustomControllerBase*) context;
-	controller->PreUpdate(((dCustomControllerManager*)controller->m_manager)->GetTimeStep(), threadIndex);
+	D_TRACKTIME();
+	dCustomControllerManager* const me = (dCustomControllerManager*) context;
+	const dFloat timestep = me->GetTimeStep();
+	const int count = me->m_controllersCount;
+	const int grainSize = me->m_grainSize;
+	CONTROLLER_BASE** const controllers = &me->m_controllersArray[0];
+	for (int i = NewtonAtomicAdd(&me->m_batchIndex, grainSize); i < count; i = NewtonAtomicAdd(&me->m_batchIndex, grainSize)) {
+		const int end = dMin (i + grainSize, count);
+		for (int j = i; j < end; j ++) {
+			dCustomControllerBase* const controller = controllers[j];
+			controller->PreUpdate(timestep, threadIndex);
+		}
+	}
 }
 
 template<class CONTROLLER_BASE>
 void dCustomControllerManager<CONTROLLER_BASE>::PostUpdateKernel (NewtonWorld* const world, void* const context, int threadIndex)
 {
-	class dCustomControllerBase* const controller = (dCustomControllerBase*) context;
-	controller->PostUpdate(((dCustomControllerManager*)controller->m_manager)->GetTimeStep(), threadIndex);
+	D_TRACKTIME();
+	dCustomControllerManager* const me = (dCustomControllerManager*) context;
+	const dFloat timestep = me->GetTimeStep();
+	const int count = me->m_controllersCount;
+	const int grainSize = me->m_grainSize;
+	CONTROLLER_BASE** const controllers = &me->m_controllersArray[0];
+	for (int i = NewtonAtomicAdd(&me->m_batchIndex, grainSize); i < count; i = NewtonAtomicAdd(&me->m_batchIndex, grainSize)) {
+		const int end = dMin (i + grainSize, count);
+		for (int j = i; j < end; j ++) {
+			dCustomControllerBase* const controller = controllers[j];
+			controller->PostUpdate(timestep, threadIndex);
+		}
+	}
 }
 
 template<class CONTROLLER_BASE>
@@ -308,6 +386,7 @@ CONTROLLER_BASE* dCustomControllerManager<CONTROLLER_BASE>::CreateController ()
 {
 	CONTROLLER_BASE* const controller = &dCustomControllerManager<CONTROLLER_BASE>::Append()->GetInfo();
 	controller->m_manager = this;
+	m_controllersDirty = true;
 	return controller;
 }
 
@@ -317,6 +396,7 @@ void dCustomControllerManager<CONTROLLER_BASE>::DestroyController (CONTROLLER_BA
 	dAssert (dCustomControllerManager<CONTROLLER_BASE>::GetNodeFromInfo (*controller));
 	typename dCustomControllerManager<CONTROLLER_BASE>::dListNode* const node = dCustomControllerManager<CONTROLLER_BASE>::GetNodeFromInfo (*controller);
 	dCustomControllerManager<CONTROLLER_BASE>::Remove (node);
+	m_controllersDirty = true;
 }
 
 
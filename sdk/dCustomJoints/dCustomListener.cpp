@@ -66,6 +66,8 @@ void dCustomListener::OnDestroyBody (const NewtonWorld* const world, void* const
 dCustomParallelListener::dCustomParallelListener(NewtonWorld* const world, const char* const listenerName)
 	:dCustomListener(world, listenerName)
 	,m_timestep(0.0f)
+	,m_grainSize(D_CUSTOM_LISTENER_GRAIN_SIZE)
+	,m_batchIndex(0)
 {
 }
 
@@ -90,6 +92,7 @@ void dCustomParallelListener::ParallerListenPostUpdateCallback(NewtonWorld* cons
 void dCustomParallelListener::PreUpdate(dFloat timestep)
 {
 	m_timestep = timestep;
+	m_batchIndex = 0;
 	NewtonWorld* const world = GetWorld();
 
 	int threadCount = NewtonGetThreadsCount(world);
@@ -102,6 +105,7 @@ void dCustomParallelListener::PreUpdate(dFloat timestep)
 void dCustomParallelListener::PostUpdate(dFloat timestep)
 {
 	m_timestep = timestep;
+	m_batchIndex = 0;
 	NewtonWorld* const world = GetWorld();
 
 	int threadCount = NewtonGetThreadsCount(world);
@@ -16,6 +16,9 @@
 #include "dCustomJoint.h"
 #include "dCustomAlloc.h"
 
+// number of consecutive items claimed by a worker thread at the time
+#define D_CUSTOM_LISTENER_GRAIN_SIZE	8
+
 
 class dCustomListener: public dCustomAlloc
 {
@@ -51,6 +54,9 @@ class dCustomParallelListener: public dCustomListener
 	virtual void PreUpdate(dFloat timestep, int threadID) {};
 	virtual void PostUpdate(dFloat timestep, int threadID) {};
 
+	int GetGrainSize() const {return m_grainSize;}
+	void SetGrainSize(int grainSize) {m_grainSize = dMax (grainSize, 1);}
+
 	private:
 	static void ParallerListenPreUpdateCallback (NewtonWorld* const world, void* const userData, int threadIndex);
 	static void ParallerListenPostUpdateCallback(NewtonWorld* const world, void* const userData, int threadIndex);
@@ -58,7 +64,13 @@ class dCustomParallelListener: public dCustomListener
 	protected:
 	CUSTOM_JOINTS_API virtual void PreUpdate(dFloat timestep);
 	CUSTOM_JOINTS_API virtual void PostUpdate(dFloat timestep);
+
+	// returns the index of the first item of the next batch, the update is done when the index passes the items count
+	int GetNextBatch() {return NewtonAtomicAdd(&m_batchIndex, m_grainSize);}
+
 	dFloat m_timestep;
+	int m_grainSize;
+	int m_batchIndex;
 };
 
 #endif
\ No newline at end of file
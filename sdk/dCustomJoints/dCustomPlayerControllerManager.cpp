@@ -182,6 +182,9 @@ class dCustomPlayerController::dImpulseSolver
 dCustomPlayerControllerManager::dCustomPlayerControllerManager(NewtonWorld* const world)
 	:dCustomParallelListener(world, PLAYER_PLUGIN_NAME)
 	,m_playerList()
+	,m_playersArray()
+	,m_playersCount(0)
+	,m_playersDirty(false)
 {
 }
 
@@ -191,25 +194,41 @@ dCustomPlayerControllerManager::~dCustomPlayerControllerManager()
 	dAssert(m_playerList.GetCount() == 0);
 }
 
-void dCustomPlayerControllerManager::PreUpdate(dFloat timestep, int threadID)
+void dCustomPlayerControllerManager::UpdatePlayersArray()
 {
-	D_TRACKTIME();
-	NewtonWorld* const world = GetWorld();
-	const int threadCount = NewtonGetThreadsCount(world);
+	if (m_playersDirty) {
+		const int count = m_playerList.GetCount();
+		if (m_playersArray.GetSize() < count) {
+			m_playersArray.Resize(count);
+		}
+		int index = 0;
+		for (dList<dCustomPlayerController>::dListNode* node = m_playerList.GetFirst(); node; node = node->GetNext()) {
+			m_playersArray[index] = &node->GetInfo();
+			index ++;
+		}
+		m_playersCount = count;
+		m_playersDirty = false;
+	}
+}
 
-	dList<dCustomPlayerController>::dListNode* node = m_playerList.GetFirst();
-	for (int i = 0; i < threadID; i++) {
-		node = node ? node->GetNext() : NULL;
+void dCustomPlayerControllerManager::PreUpdate(dFloat timestep)
+{
+	UpdatePlayersArray();
+	if (m_playersCount) {
+		dCustomParallelListener::PreUpdate(timestep);
 	}
+}
 
-	if (node) {
-		dCustomPlayerController* const controller = &node->GetInfo();
-		controller->PreUpdate(timestep);
-		do {
-			for (int i = 0; i < threadCount; i++) {
-				node = node ? node->GetNext() : NULL;
-			}
-		} while (node);
+void dCustomPlayerControllerManager::PreUpdate(dFloat timestep, int threadID)
+{
+	D_TRACKTIME();
+	const int count = m_playersCount;
+	dCustomPlayerController** const players = &m_playersArray[0];
+	for (int i = GetNextBatch(); i < count; i = GetNextBatch()) {
+		const int end = dMin (i + m_grainSize, count);
+		for (int j = i; j < end; j ++) {
+			players[j]->PreUpdate(timestep);
+		}
 	}
 }
 
@@ -239,6 +258,7 @@ dCustomPlayerController* dCustomPlayerControllerManager::CreateController(const
 	NewtonDestroyCollision(bodyCapsule);
 
 	dCustomPlayerController& controller = m_playerList.Append()->GetInfo();
+	m_playersDirty = true;
 
 	shapeMatrix.m_posit = dVector (0.0f, dFloat (0.0f), dFloat (0.0f), 1.0f);
 	controller.m_localFrame = shapeMatrix;
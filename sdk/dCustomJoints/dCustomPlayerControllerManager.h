@@ -128,10 +128,16 @@ class dCustomPlayerControllerManager: public dCustomParallelListener
 
 	protected:
 	void PostUpdate(dFloat timestep) {}
+	CUSTOM_JOINTS_API virtual void PreUpdate(dFloat timestep);
 	CUSTOM_JOINTS_API virtual void PreUpdate(dFloat timestep, int threadID);
 
 	private:
+	void UpdatePlayersArray();
+
 	dList<dCustomPlayerController> m_playerList;
+	dArray<dCustomPlayerController*> m_playersArray;
+	int m_playersCount;
+	bool m_playersDirty;
 	friend class dCustomPlayerController;
 };
 
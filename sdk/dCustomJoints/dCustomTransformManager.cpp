@@ -80,6 +80,10 @@ void dCustomTransformController::PostUpdate(dCustomTransformManager* const manag
 
 dCustomTransformManager::dCustomTransformManager(NewtonWorld* const world, const char* const name)
 	:dCustomParallelListener(world, name)
+	,m_controllerList()
+	,m_controllersArray()
+	,m_controllersCount(0)
+	,m_controllersDirty(false)
 {
 }
 
@@ -92,60 +96,66 @@ dCustomTransformController* dCustomTransformManager::CreateController(NewtonBody
 	dCustomTransformController* const controller = &m_controllerList.Append()->GetInfo();
 	controller->m_body = body;
 	controller->m_bindMatrix = bindMatrix;
+	m_controllersDirty = true;
 	return controller;
 }
 
-//void dCustomTransformManager::PreUpdate(dFloat timestep)
-void dCustomTransformManager::PreUpdate(dFloat timestep, int threadID)
+void dCustomTransformManager::UpdateControllersArray()
 {
-//	for (dList<dCustomTransformController>::dListNode* node = m_controllerList.GetFirst(); node; node = node->GetNext()) {
-//		dCustomTransformController* const controller = &node->GetInfo();
-//		OnPreUpdate(controller, timestep, 0);
-//	}
+	if (m_controllersDirty) {
+		const int count = m_controllerList.GetCount();
+		if (m_controllersArray.GetSize() < count) {
+			m_controllersArray.Resize(count);
+		}
+		int index = 0;
+		for (dList<dCustomTransformController>::dListNode* node = m_controllerList.GetFirst(); node; node = node->GetNext()) {
+			m_controllersArray[index] = &node->GetInfo();
+			index ++;
+		}
+		m_controllersCount = count;
+		m_controllersDirty = false;
+	}
+}
 
-	D_TRACKTIME();
-	NewtonWorld* const world = GetWorld();
-	const int threadCount = NewtonGetThreadsCount(world);
+void dCustomTransformManager::PreUpdate(dFloat timestep)
+{
+	UpdateControllersArray();
+	if (m_controllersCount) {
+		dCustomParallelListener::PreUpdate(timestep);
+	}
+}
 
-	dList<dCustomTransformController>::dListNode* node = m_controllerList.GetFirst();
-	for (int i = 0; i < threadID; i++) {
-		node = node ? node->GetNext() : NULL;
+void dCustomTransformManager::PostUpdate(dFloat timestep)
+{
+	UpdateControllersArray();
+	if (m_controllersCount) {
+		dCustomParallelListener::PostUpdate(timestep);
 	}
-	if (node) {
-		dCustomTransformController* const controller = &node->GetInfo();
-		OnPreUpdate(controller, timestep, threadID);
-		do {
-			for (int i = 0; i < threadCount; i++) {
-				node = node ? node->GetNext() : NULL;
-			}
-		} while (node);
+}
+
+void dCustomTransformManager::PreUpdate(dFloat timestep, int threadID)
+{
+	D_TRACKTIME();
+	const int count = m_controllersCount;
+	dCustomTransformController** const controllers = &m_controllersArray[0];
+	for (int i = GetNextBatch(); i < count; i = GetNextBatch()) {
+		const int end = dMin (i + m_grainSize, count);
+		for (int j = i; j < end; j ++) {
+			OnPreUpdate(controllers[j], timestep, threadID);
+		}
 	}
 }
 
-//void dCustomTransformManager::PostUpdate(dFloat timestep)
 void dCustomTransformManager::PostUpdate(dFloat timestep, int threadID)
 {
-//	for (dList<dCustomTransformController>::dListNode* node = m_controllerList.GetFirst(); node; node = node->GetNext()) {
-//		dCustomTransformController* const controller = &node->GetInfo();
-//		controller->PostUpdate(this, timestep);
-//	}
-
 	D_TRACKTIME();
-	NewtonWorld* const world = GetWorld();
-	const int threadCount = NewtonGetThreadsCount(world);
-
-	dList<dCustomTransformController>::dListNode* node = m_controllerList.GetFirst();
-	for (int i = 0; i < threadID; i++) {
-		node = node ? node->GetNext() : NULL;
-	}
-	if (node) {
-		dCustomTransformController* const controller = &node->GetInfo();
-		controller->PostUpdate(this, timestep);
-		do {
-			for (int i = 0; i < threadCount; i++) {
-				node = node ? node->GetNext() : NULL;
-			}
-		} while (node);
+	const int count = m_controllersCount;
+	dCustomTransformController** const controllers = &m_controllersArray[0];
+	for (int i = GetNextBatch(); i < count; i = GetNextBatch()) {
+		const int end = dMin (i + m_grainSize, count);
+		for (int j = i; j < end; j ++) {
+			controllers[j]->PostUpdate(this, timestep);
+		}
 	}
 }
 
@@ -162,6 +172,7 @@ void dCustomTransformManager::DestroyController (dCustomTransformController* con
 {
 	dList<dCustomTransformController>::dListNode* const node = m_controllerList.GetNodeFromInfo(*controller);
 	m_controllerList.Remove(node);
+	m_controllersDirty = true;
 }
 
 /*
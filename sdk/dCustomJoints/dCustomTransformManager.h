@@ -98,13 +98,18 @@ class dCustomTransformManager: public dCustomParallelListener
 
 	protected:
 	CUSTOM_JOINTS_API virtual void OnDestroy();
-//	CUSTOM_JOINTS_API virtual void PreUpdate(dFloat timestep);
-//	CUSTOM_JOINTS_API virtual void PostUpdate(dFloat timestep);
+	CUSTOM_JOINTS_API virtual void PreUpdate(dFloat timestep);
+	CUSTOM_JOINTS_API virtual void PostUpdate(dFloat timestep);
 	CUSTOM_JOINTS_API virtual void PreUpdate(dFloat timestep, int threadID);
 	CUSTOM_JOINTS_API virtual void PostUpdate(dFloat timestep, int threadID);
 
 	private: 
+	void UpdateControllersArray();
+
 	dList<dCustomTransformController> m_controllerList;
+	dArray<dCustomTransformController*> m_controllersArray;
+	int m_controllersCount;
+	bool m_controllersDirty;
 };
 
 
@@ -29,6 +29,10 @@
 
 
 #define DG_STACK_DEPTH 512
+#define DG_POLYSOUP_PARALLEL_BUILD		(1024 * 4)
+#define DG_POLYSOUP_MIN_BOXES_PER_JOB	256
+#define DG_POLYSOUP_FACE_BATCH_SIZE		256
+#define DG_POLYSOUP_IMAGE_ALIGN(x)		(((x) + 15) & -16)
 
 
 DG_MSC_VECTOR_ALIGMENT
@@ -234,18 +238,73 @@ class dgAABBPolygonSoup::dgSpliteInfo
 
 
 
+class dgAABBPolygonSoup::dgTreeBuildDescriptor
+{
+	public:
+	class dgBuildJob
+	{
+		public:
+		dgNodeBuilder** m_slot;
+		dgNodeBuilder* m_parent;
+		dgNodeBuilder* m_nodeArray;
+		dgInt32 m_firstBox;
+		dgInt32 m_lastBox;
+	};
+
+	dgTreeBuildDescriptor (const dgAABBPolygonSoup* const me, dgNodeBuilder* const leafArray, dgBuildJob* const jobs, dgInt32 maxBoxesPerJob)
+		:m_me(me)
+		,m_leafArray(leafArray)
+		,m_jobs(jobs)
+		,m_jobsCount(0)
+		,m_atomicIndex(0)
+		,m_maxBoxesPerJob(maxBoxesPerJob)
+	{
+	}
+
+	const dgAABBPolygonSoup* m_me;
+	dgNodeBuilder* m_leafArray;
+	dgBuildJob* m_jobs;
+	dgInt32 m_jobsCount;
+	dgInt32 m_atomicIndex;
+	dgInt32 m_maxBoxesPerJob;
+};
+
+class dgAABBPolygonSoup::dgFaceBatchDescriptor
+{
+	public:
+	dgFaceBatchDescriptor (dgAABBPolygonSoup* const me, const dgNode::dgLeafNodePtr* const faces, dgInt32 count, const dgVector* const vertex)
+		:m_me(me)
+		,m_faces(faces)
+		,m_vertex(vertex)
+		,m_count(count)
+		,m_atomicIndex(0)
+	{
+	}
+
+	dgAABBPolygonSoup* m_me;
+	const dgNode::dgLeafNodePtr* m_faces;
+	const dgVector* m_vertex;
+	dgInt32 m_count;
+	dgInt32 m_atomicIndex;
+};
+
+
 dgAABBPolygonSoup::dgAABBPolygonSoup ()
 	:dgPolygonSoupDatabase()
 	,m_nodesCount(0)
 	,m_indexCount(0)
 	,m_aabb(NULL)
 	,m_indices(NULL)
+	,m_mapped(false)
 {
 }
 
 dgAABBPolygonSoup::~dgAABBPolygonSoup ()
 {
-	if (m_aabb) {
+	if (m_mapped) {
+		// the arrays belong to the image
+		m_localVertex = NULL;
+	} else if (m_aabb) {
 		dgFreeStack (m_aabb);
 		dgFreeStack (m_indices);
 	}
@@ -441,13 +500,74 @@ void dgAABBPolygonSoup::GetAABB (dgVector& p0, dgVector& p1) const
 	}
 }
 
-void dgAABBPolygonSoup::CalculateAdjacendy ()
+dgInt32 dgAABBPolygonSoup::GetLeafFaces (dgNode::dgLeafNodePtr* const faceArray) const
 {
-	dgVector p0;
-	dgVector p1;
-	GetAABB (p0, p1);
-	dgFastAABBInfo box (p0, p1);
-	ForAllSectors (box, dgVector (dgFloat32 (0.0f)), dgFloat32 (1.0f), CalculateAllFaceEdgeNormals, this);
+	dgInt32 count = 0;
+	for (dgInt32 i = 0; i < m_nodesCount; i ++) {
+		const dgNode* const node = &m_aabb[i];
+		if (node->m_left.IsLeaf() && node->m_left.GetCount()) {
+			faceArray[count] = node->m_left;
+			count ++;
+		}
+		if (node->m_right.IsLeaf() && node->m_right.GetCount()) {
+			faceArray[count] = node->m_right;
+			count ++;
+		}
+	}
+	return count;
+}
+
+void dgAABBPolygonSoup::RunFaceBatch (dgFaceBatchDescriptor* const descriptor, dgWorkerThreadTaskCallback kernel, dgThreadHive* const threadPool) const
+{
+	const dgInt32 threadsCount = threadPool ? threadPool->GetThreadCount() : 1;
+	if ((threadsCount > 1) && (descriptor->m_count > DG_POLYSOUP_FACE_BATCH_SIZE)) {
+		for (dgInt32 i = 0; i < threadsCount; i ++) {
+			threadPool->QueueJob (kernel, descriptor, NULL, "dgAABBPolygonSoup::FaceBatch");
+		}
+		threadPool->SynchronizationBarrier();
+	} else {
+		kernel (descriptor, NULL, 0);
+	}
+}
+
+void dgAABBPolygonSoup::CalculateFaceMaxSizeKernel (void* const context, void* const, dgInt32 threadID)
+{
+	dgFaceBatchDescriptor* const descriptor = (dgFaceBatchDescriptor*) context;
+	dgAABBPolygonSoup* const me = descriptor->m_me;
+	const dgInt32 count = descriptor->m_count;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_POLYSOUP_FACE_BATCH_SIZE); i < count; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_POLYSOUP_FACE_BATCH_SIZE)) {
+		const dgInt32 batchEnd = dgMin (i + DG_POLYSOUP_FACE_BATCH_SIZE, count);
+		for (dgInt32 j = i; j < batchEnd; j ++) {
+			const dgInt32 index = dgInt32 (descriptor->m_faces[j].GetIndex());
+			const dgInt32 indexCount = dgInt32 (descriptor->m_faces[j].GetCount());
+			dgInt32* const face = &me->m_indices[index];
+			face[indexCount * 2 + 2] = dgInt32 (me->CalculateFaceMaxSize (descriptor->m_vertex, indexCount, face));
+		}
+	}
+}
+
+void dgAABBPolygonSoup::CalculateAllFaceEdgeNormalsKernel (void* const context, void* const, dgInt32 threadID)
+{
+	// each face only writes its own edge normals, so faces can be processed in any order
+	dgFaceBatchDescriptor* const descriptor = (dgFaceBatchDescriptor*) context;
+	dgAABBPolygonSoup* const me = descriptor->m_me;
+	const dgInt32 count = descriptor->m_count;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_POLYSOUP_FACE_BATCH_SIZE); i < count; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_POLYSOUP_FACE_BATCH_SIZE)) {
+		const dgInt32 batchEnd = dgMin (i + DG_POLYSOUP_FACE_BATCH_SIZE, count);
+		for (dgInt32 j = i; j < batchEnd; j ++) {
+			const dgInt32 index = dgInt32 (descriptor->m_faces[j].GetIndex());
+			const dgInt32 indexCount = dgInt32 (descriptor->m_faces[j].GetCount());
+			CalculateAllFaceEdgeNormals (me, me->m_localVertex, sizeof (dgTriplex), &me->m_indices[index], indexCount, dgFloat32 (0.0f));
+		}
+	}
+}
+
+void dgAABBPolygonSoup::CalculateAdjacendy (dgThreadHive* const threadPool)
+{
+	dgStack<dgNode::dgLeafNodePtr> faceArray (m_nodesCount * 2);
+	const dgInt32 faceCount = GetLeafFaces (&faceArray[0]);
+	dgFaceBatchDescriptor descriptor (this, &faceArray[0], faceCount, NULL);
+	RunFaceBatch (&descriptor, CalculateAllFaceEdgeNormalsKernel, threadPool);
 
 	dgStack<dgTriplex> pool ((m_indexCount / 2) - 1);
 	const dgTriplex* const vertexArray = (dgTriplex*)GetLocalVertexPool();
@@ -714,30 +834,82 @@ dgIntersectStatus dgAABBPolygonSoup::CalculateDisjointedFaceEdgeNormals (void* c
 
 
 
-dgAABBPolygonSoup::dgNodeBuilder* dgAABBPolygonSoup::BuildTopDown (dgNodeBuilder* const leafArray, dgInt32 firstBox, dgInt32 lastBox, dgNodeBuilder** const allocator) const
+dgAABBPolygonSoup::dgNodeBuilder* dgAABBPolygonSoup::BuildTopDown (dgNodeBuilder* const leafArray, dgInt32 firstBox, dgInt32 lastBox, dgNodeBuilder* const nodeArray, dgTreeBuildDescriptor* const descriptor) const
 {
 	dgAssert (firstBox >= 0);
-	dgAssert (lastBox >= 0);
+	dgAssert (lastBox >= firstBox);
 
 	if (lastBox == firstBox) {
 		return &leafArray[firstBox];
 	} else {
+		// a sub tree of n leafs uses n - 1 nodes, the parent takes the first one, 
+		// the left branch the next leftCount - 1 and the right branch the rest.
 		dgSpliteInfo info (&leafArray[firstBox], lastBox - firstBox + 1);
 
-		dgNodeBuilder* const parent = new (*allocator) dgNodeBuilder (info.m_p0, info.m_p1);
-		*allocator = *allocator + 1;
-
+		dgNodeBuilder* const parent = new (&nodeArray[0]) dgNodeBuilder (info.m_p0, info.m_p1);
 		dgAssert (parent);
-		parent->m_right = BuildTopDown (leafArray, firstBox + info.m_axis, lastBox, allocator);
-		parent->m_right->m_parent = parent;
 
-		parent->m_left = BuildTopDown (leafArray, firstBox, firstBox + info.m_axis - 1, allocator);
-		parent->m_left->m_parent = parent;
+		const dgInt32 leftCount = info.m_axis;
+		dgNodeBuilder** const slots[] = {&parent->m_right, &parent->m_left};
+		const dgInt32 first[] = {firstBox + leftCount, firstBox};
+		const dgInt32 last[] = {lastBox, firstBox + leftCount - 1};
+		dgNodeBuilder* const nodes[] = {&nodeArray[leftCount], &nodeArray[1]};
+		for (dgInt32 i = 0; i < 2; i ++) {
+			const dgInt32 count = last[i] - first[i] + 1;
+			if (descriptor && (count > 1) && (count <= descriptor->m_maxBoxesPerJob)) {
+				// defer this branch to the worker threads
+				dgTreeBuildDescriptor::dgBuildJob& job = descriptor->m_jobs[descriptor->m_jobsCount];
+				job.m_slot = slots[i];
+				job.m_parent = parent;
+				job.m_nodeArray = nodes[i];
+				job.m_firstBox = first[i];
+				job.m_lastBox = last[i];
+				descriptor->m_jobsCount ++;
+			} else {
+				dgNodeBuilder* const child = BuildTopDown (leafArray, first[i], last[i], nodes[i], descriptor);
+				child->m_parent = parent;
+				*slots[i] = child;
+			}
+		}
 		return parent;
 	}
 }
 
-void dgAABBPolygonSoup::Create (const dgPolygonSoupDatabaseBuilder& builder, bool optimizedBuild)
+void dgAABBPolygonSoup::BuildTopDownKernel (void* const context, void* const, dgInt32 threadID)
+{
+	dgTreeBuildDescriptor* const descriptor = (dgTreeBuildDescriptor*) context;
+	const dgAABBPolygonSoup* const me = descriptor->m_me;
+	const dgInt32 jobsCount = descriptor->m_jobsCount;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, 1); i < jobsCount; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, 1)) {
+		const dgTreeBuildDescriptor::dgBuildJob& job = descriptor->m_jobs[i];
+		dgNodeBuilder* const child = me->BuildTopDown (descriptor->m_leafArray, job.m_firstBox, job.m_lastBox, job.m_nodeArray, NULL);
+		child->m_parent = job.m_parent;
+		*job.m_slot = child;
+	}
+}
+
+dgAABBPolygonSoup::dgNodeBuilder* dgAABBPolygonSoup::BuildTopDownParallel (dgNodeBuilder* const leafArray, dgInt32 firstBox, dgInt32 lastBox, dgNodeBuilder* const nodeArray, dgThreadHive* const threadPool) const
+{
+	dgNodeBuilder* root = NULL;
+	const dgInt32 boxCount = lastBox - firstBox + 1;
+	const dgInt32 threadsCount = threadPool ? threadPool->GetThreadCount() : 1;
+	if ((threadsCount > 1) && (boxCount >= DG_POLYSOUP_PARALLEL_BUILD)) {
+		// build the top levels here and let the worker threads build the branches
+		const dgInt32 maxBoxesPerJob = dgMax (boxCount / (threadsCount * 8), DG_POLYSOUP_MIN_BOXES_PER_JOB);
+		dgStack<dgTreeBuildDescriptor::dgBuildJob> jobs (boxCount / 2 + 1);
+		dgTreeBuildDescriptor descriptor (this, leafArray, &jobs[0], maxBoxesPerJob);
+		root = BuildTopDown (leafArray, firstBox, lastBox, nodeArray, &descriptor);
+		for (dgInt32 i = 0; i < threadsCount; i ++) {
+			threadPool->QueueJob (BuildTopDownKernel, &descriptor, NULL, "dgAABBPolygonSoup::BuildTopDown");
+		}
+		threadPool->SynchronizationBarrier();
+	} else {
+		root = BuildTopDown (leafArray, firstBox, lastBox, nodeArray, (dgTreeBuildDescriptor*)NULL);
+	}
+	return root;
+}
+
+void dgAABBPolygonSoup::Create (const dgPolygonSoupDatabaseBuilder& builder, bool optimizedBuild, dgThreadHive* const threadPool)
 {
 	if (builder.m_faceCount == 0) {
 		return;
@@ -779,8 +951,7 @@ void dgAABBPolygonSoup::Create (const dgPolygonSoupDatabaseBuilder& builder, boo
 		polygonIndex += (indexCount + 1);
 	}
 
-	dgNodeBuilder* contructorAllocator = &constructor[allocatorIndex];
-	dgNodeBuilder* root = BuildTopDown (&constructor[0], 0, allocatorIndex - 1, &contructorAllocator);
+	dgNodeBuilder* root = BuildTopDownParallel (&constructor[0], 0, allocatorIndex - 1, &constructor[allocatorIndex], threadPool);
 
 	dgAssert (root);
 	if (root->m_left) {
@@ -847,6 +1018,8 @@ void dgAABBPolygonSoup::Create (const dgPolygonSoupDatabaseBuilder& builder, boo
 
 	dgVector* const aabbPoints = &tmpVertexArray[aabbBase];
 
+	dgInt32 faceCount = 0;
+	dgStack<dgNode::dgLeafNodePtr> faceArray (allocatorIndex);
 
 	dgInt32 vertexIndex = 0;
 	dgInt32 aabbNodeIndex = 0;
@@ -904,8 +1077,9 @@ void dgAABBPolygonSoup::Create (const dgPolygonSoupDatabaseBuilder& builder, boo
 			m_indices[indexMap + node->m_indexCount] = node->m_faceIndices[node->m_indexCount];
 			// face normal
 			m_indices[indexMap + node->m_indexCount + 1] = builder.m_vertexCount + builder.m_normalIndex[node->m_faceIndex];
-			// face size
-			m_indices[indexMap + node->m_indexCount * 2 + 2] = dgInt32 (CalculateFaceMaxSize (&tmpVertexArray[0], node->m_indexCount, node->m_faceIndices));
+			// face size is calculated after all faces are placed
+			faceArray[faceCount] = dgNode::dgLeafNodePtr (dgUnsigned32(node->m_indexCount), dgUnsigned32(indexMap));
+			faceCount ++;
 
 			indexMap += node->m_indexCount * 2 + 3;
 		}
@@ -917,8 +1091,11 @@ void dgAABBPolygonSoup::Create (const dgPolygonSoupDatabaseBuilder& builder, boo
 		}
 	}
 
+	dgFaceBatchDescriptor faceSizeDescriptor (this, &faceArray[0], faceCount, &tmpVertexArray[0]);
+	RunFaceBatch (&faceSizeDescriptor, CalculateFaceMaxSizeKernel, threadPool);
+
 	dgStack<dgInt32> indexArray (vertexIndex);
-	dgInt32 aabbPointCount = dgVertexListToIndexList (&aabbPoints[0].m_x, sizeof (dgVector), sizeof (dgTriplex), 0, vertexIndex, &indexArray[0], dgFloat32 (1.0e-6f));
+	dgInt32 aabbPointCount = dgVertexListToIndexList (&aabbPoints[0].m_x, sizeof (dgVector), sizeof (dgTriplex), 0, vertexIndex, &indexArray[0], dgFloat32 (1.0e-6f), threadPool);
 
 	m_vertexCount = aabbBase + aabbPointCount;
 	m_localVertex = (dgFloat32*) dgMallocStack (sizeof (dgTriplex) * m_vertexCount);
@@ -982,6 +1159,83 @@ void dgAABBPolygonSoup::Deserialize (dgDeserialize callback, void* const userDat
 	}
 }
 
+dgInt32 dgAABBPolygonSoup::GetImageSize () const
+{
+	dgInt32 size = DG_POLYSOUP_IMAGE_ALIGN (dgInt32 (sizeof (dgImage)));
+	size += DG_POLYSOUP_IMAGE_ALIGN (dgInt32 (sizeof (dgTriplex) * m_vertexCount));
+	size += DG_POLYSOUP_IMAGE_ALIGN (dgInt32 (sizeof (dgInt32) * m_indexCount));
+	size += DG_POLYSOUP_IMAGE_ALIGN (dgInt32 (sizeof (dgNode) * m_nodesCount));
+	return size;
+}
+
+void dgAABBPolygonSoup::SerializeImage (dgSerialize callback, void* const userData) const
+{
+	const dgInt32 vertexSize = dgInt32 (sizeof (dgTriplex) * m_vertexCount);
+	const dgInt32 indexSize = dgInt32 (sizeof (dgInt32) * m_indexCount);
+	const dgInt32 nodesSize = dgInt32 (sizeof (dgNode) * m_nodesCount);
+
+	dgImage image;
+	memset (&image, 0, sizeof (image));
+	image.m_vertexCount = m_vertexCount;
+	image.m_indexCount = m_indexCount;
+	image.m_nodesCount = m_aabb ? m_nodesCount : 0;
+	image.m_vertexOffset = DG_POLYSOUP_IMAGE_ALIGN (dgInt32 (sizeof (dgImage)));
+	image.m_indexOffset = image.m_vertexOffset + DG_POLYSOUP_IMAGE_ALIGN (vertexSize);
+	image.m_nodesOffset = image.m_indexOffset + DG_POLYSOUP_IMAGE_ALIGN (indexSize);
+	image.m_sizeInBytes = GetImageSize();
+	dgAssert (image.m_sizeInBytes == (image.m_nodesOffset + DG_POLYSOUP_IMAGE_ALIGN (nodesSize)));
+
+	// every section starts at a 16 byte boundary relative to the header
+	const dgInt32 zeros[4] = {0, 0, 0, 0};
+	callback (userData, &image, sizeof (dgImage));
+	callback (userData, zeros, image.m_vertexOffset - dgInt32 (sizeof (dgImage)));
+	if (m_aabb) {
+		callback (userData, m_localVertex, vertexSize);
+		callback (userData, zeros, DG_POLYSOUP_IMAGE_ALIGN (vertexSize) - vertexSize);
+		callback (userData, m_indices, indexSize);
+		callback (userData, zeros, DG_POLYSOUP_IMAGE_ALIGN (indexSize) - indexSize);
+		callback (userData, m_aabb, nodesSize);
+		callback (userData, zeros, DG_POLYSOUP_IMAGE_ALIGN (nodesSize) - nodesSize);
+	}
+}
+
+bool dgAABBPolygonSoup::MapImage (const dgImage* const image, dgInt32 sizeInBytes)
+{
+	dgAssert (!m_aabb && !m_localVertex);
+	if ((sizeInBytes < dgInt32 (sizeof (dgImage))) || (image->m_sizeInBytes < dgInt32 (sizeof (dgImage))) || (image->m_sizeInBytes > sizeInBytes)) {
+		return false;
+	}
+	if ((image->m_vertexCount < 0) || (image->m_indexCount < 0) || (image->m_nodesCount < 0)) {
+		return false;
+	}
+
+	// the arrays are only mapped when the image has nodes, and each one must start past the header, 
+	// at a 16 byte boundary, and end inside the image
+	if (image->m_nodesCount) {
+		const dgInt32 minOffset = dgInt32 (sizeof (dgImage));
+		const dgInt32 offsets[] = {image->m_vertexOffset, image->m_indexOffset, image->m_nodesOffset};
+		const dgInt64 sizes[] = {dgInt64 (sizeof (dgTriplex)) * image->m_vertexCount, dgInt64 (sizeof (dgInt32)) * image->m_indexCount, dgInt64 (sizeof (dgNode)) * image->m_nodesCount};
+		for (dgInt32 i = 0; i < 3; i ++) {
+			if ((offsets[i] < minOffset) || (offsets[i] & 15) || ((offsets[i] + sizes[i]) > image->m_sizeInBytes)) {
+				return false;
+			}
+		}
+	}
+
+	const char* const base = (const char*) image;
+	m_mapped = true;
+	m_strideInBytes = sizeof (dgTriplex);
+	m_vertexCount = image->m_vertexCount;
+	m_indexCount = image->m_indexCount;
+	m_nodesCount = image->m_nodesCount;
+	if (m_nodesCount) {
+		// the image is never written, the const is only dropped to share the arrays with the allocated path
+		m_localVertex = (dgFloat32*) (base + image->m_vertexOffset);
+		m_indices = (dgInt32*) (base + image->m_indexOffset);
+		m_aabb = (dgNode*) (base + image->m_nodesOffset);
+	}
+	return true;
+}
 
 dgVector dgAABBPolygonSoup::ForAllSectorsSupportVectex (const dgVector& dir) const
 {
@@ -23,6 +23,7 @@
 #define __DG_AABB_POLYGON_SOUP_H_
 
 #include "dgStdafx.h"
+#include "dgThreadHive.h"
 #include "dgIntersections.h"
 #include "dgPolygonSoupDatabase.h"
 
@@ -186,19 +187,43 @@ class dgAABBPolygonSoup: public dgPolygonSoupDatabase
 		dgLeafNodePtr m_right;
 	};
 
+	// position independent image of the soup, the offsets are relative to the image header
+	// so the block can be used in place at any address, for example from a read only file mapping.
+	class dgImage
+	{
+		public:
+		dgInt32 m_vertexCount;
+		dgInt32 m_indexCount;
+		dgInt32 m_nodesCount;
+		dgInt32 m_vertexOffset;
+		dgInt32 m_indexOffset;
+		dgInt32 m_nodesOffset;
+		dgInt32 m_sizeInBytes;
+		dgInt32 m_reserved;
+	};
+
 	class dgSpliteInfo;
 	class dgNodeBuilder;
+	class dgTreeBuildDescriptor;
+	class dgFaceBatchDescriptor;
 
 	virtual void GetAABB (dgVector& p0, dgVector& p1) const;
 	virtual void Serialize (dgSerialize callback, void* const userData) const;
 	virtual void Deserialize (dgDeserialize callback, void* const userData, dgInt32 revisionNumber);
 
+	dgInt32 GetImageSize () const;
+	void SerializeImage (dgSerialize callback, void* const userData) const;
+	bool IsMapped () const {return m_mapped;}
+
 	protected:
 	dgAABBPolygonSoup ();
 	virtual ~dgAABBPolygonSoup ();
 
-	void Create (const dgPolygonSoupDatabaseBuilder& builder, bool optimizedBuild);
-	void CalculateAdjacendy ();
+	void Create (const dgPolygonSoupDatabaseBuilder& builder, bool optimizedBuild, dgThreadHive* const threadPool = NULL);
+	void CalculateAdjacendy (dgThreadHive* const threadPool = NULL);
+
+	// the soup references the image memory, it must stay valid and unchanged for the life of the soup
+	bool MapImage (const dgImage* const image, dgInt32 sizeInBytes);
 	virtual void ForAllSectorsRayHit (const dgFastRayTest& ray, dgFloat32 maxT, dgRayIntersectCallback callback, void* const context) const;
 	virtual void ForAllSectors (const dgFastAABBInfo& obbAabb, const dgVector& boxDistanceTravel, dgFloat32 m_maxT, dgAABBIntersectCallback callback, void* const context) const;
 	
@@ -232,17 +257,25 @@ class dgAABBPolygonSoup: public dgPolygonSoupDatabase
 	virtual dgVector ForAllSectorsSupportVectex (const dgVector& dir) const;
 
 	private:
-	dgNodeBuilder* BuildTopDown (dgNodeBuilder* const leafArray, dgInt32 firstBox, dgInt32 lastBox, dgNodeBuilder** const allocator) const;
+	dgNodeBuilder* BuildTopDown (dgNodeBuilder* const leafArray, dgInt32 firstBox, dgInt32 lastBox, dgNodeBuilder* const nodeArray, dgTreeBuildDescriptor* const descriptor) const;
+	dgNodeBuilder* BuildTopDownParallel (dgNodeBuilder* const leafArray, dgInt32 firstBox, dgInt32 lastBox, dgNodeBuilder* const nodeArray, dgThreadHive* const threadPool) const;
+	dgInt32 GetLeafFaces (dgNode::dgLeafNodePtr* const faceArray) const;
+	void RunFaceBatch (dgFaceBatchDescriptor* const descriptor, dgWorkerThreadTaskCallback kernel, dgThreadHive* const threadPool) const;
 	dgFloat32 CalculateFaceMaxSize (const dgVector* const vertex, dgInt32 indexCount, const dgInt32* const indexArray) const;
 //	static dgIntersectStatus CalculateManifoldFaceEdgeNormals (void* const context, const dgFloat32* const polygon, dgInt32 strideInBytes, const dgInt32* const indexArray, dgInt32 indexCount);
 	static dgIntersectStatus CalculateDisjointedFaceEdgeNormals (void* const context, const dgFloat32* const polygon, dgInt32 strideInBytes, const dgInt32* const indexArray, dgInt32 indexCount, dgFloat32 hitDistance);
 	static dgIntersectStatus CalculateAllFaceEdgeNormals (void* const context, const dgFloat32* const polygon, dgInt32 strideInBytes, const dgInt32* const indexArray, dgInt32 indexCount, dgFloat32 hitDistance);
 	void ImproveNodeFitness (dgNodeBuilder* const node) const;
 
+	static void BuildTopDownKernel (void* const context, void* const, dgInt32 threadID);
+	static void CalculateFaceMaxSizeKernel (void* const context, void* const, dgInt32 threadID);
+	static void CalculateAllFaceEdgeNormalsKernel (void* const context, void* const, dgInt32 threadID);
+
 	dgInt32 m_nodesCount;
 	dgInt32 m_indexCount;
 	dgNode* m_aabb;
 	dgInt32* m_indices;
+	bool m_mapped;
 };
 
 
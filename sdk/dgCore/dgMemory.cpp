@@ -369,6 +369,111 @@ dgInt32 dgMemoryAllocator::GetGlobalMemoryUsed ()
 	return dgGlobalAllocator::GetGlobalAllocator().GetMemoryUsed();
 }
 
+class dgArenaMemoryAllocator::dgArenaPage
+{
+	public:
+	dgArenaPage* m_next;
+	dgInt32 m_size;
+	dgInt32 m_pad;
+};
+
+dgArenaMemoryAllocator::dgArenaMemoryAllocator(dgMemoryAllocator* const parent, dgInt32 pageSize)
+	:dgMemoryAllocator (false)
+	,m_parent(parent)
+	,m_pages(NULL)
+	,m_pool(NULL)
+	,m_index(0)
+	,m_size(0)
+	,m_usedInFullPages(0)
+	,m_pageSize(pageSize)
+	,m_highWaterMark(0)
+{
+	dgAssert (m_parent);
+}
+
+dgArenaMemoryAllocator::~dgArenaMemoryAllocator()
+{
+	FreePages();
+}
+
+void dgArenaMemoryAllocator::FreePages()
+{
+	for (dgArenaPage* page = m_pages; page; ) {
+		dgArenaPage* const next = page->m_next;
+		m_parent->FreeLow(page);
+		page = next;
+	}
+	m_pages = NULL;
+	m_pool = NULL;
+	m_index = 0;
+	m_size = 0;
+}
+
+void* dgArenaMemoryAllocator::AllocPage(dgInt32 size)
+{
+	// the current page is full, chain a new one, allocations never move.
+	m_usedInFullPages += m_index;
+	const dgInt32 pageSize = dgMax (m_pageSize, size + 16);
+	dgArenaPage* const page = (dgArenaPage*) m_parent->MallocLow(dgInt32 (sizeof (dgArenaPage)) + pageSize);
+	page->m_next = m_pages;
+	page->m_size = pageSize;
+	m_pages = page;
+
+	m_pool = (dgInt8*) (page + 1);
+	m_size = pageSize;
+	m_index = 0;
+	return Alloc(size);
+}
+
+void dgArenaMemoryAllocator::Reset()
+{
+	const dgInt32 used = m_usedInFullPages + m_index;
+	m_highWaterMark = dgMax (m_highWaterMark, used);
+	if (m_pages && m_pages->m_next) {
+		// this update needed more than one page, replace them all with a 
+		// single page big enough for the peak so that next update does not chain pages.
+		FreePages();
+		m_pageSize = dgMax (m_pageSize, (m_highWaterMark + m_highWaterMark / 4 + 4095) & -4096);
+	}
+	m_usedInFullPages = 0;
+	m_index = 0;
+}
+
+void* dgArenaMemoryAllocator::MallocLow(dgInt32 size, dgInt32 alignment)
+{
+	// save an allocation header, so that memory coming from here can be released by dgFree. 
+	alignment = dgMax (alignment, 16);
+	dgAssert (((-alignment) & (alignment - 1)) == 0);
+	const dgInt32 headerSize = dgInt32 (sizeof (dgMemoryInfo));
+	dgInt8* const ptr = (dgInt8*) Alloc(size + headerSize + alignment);
+	void* const retPtr = (void*) ((reinterpret_cast<uintptr_t>(ptr + headerSize) + alignment - 1) & -alignment);
+
+	dgMemoryInfo* const info = ((dgMemoryInfo*) (retPtr)) - 1;
+	info->SaveInfo(this, ptr, size, m_enumerator, size);
+	return retPtr;
+}
+
+void* dgArenaMemoryAllocator::Malloc(dgInt32 size)
+{
+	return MallocLow(size, 16);
+}
+
+void dgArenaMemoryAllocator::FreeLow(void* const retPtr)
+{
+	dgAssert ((((dgMemoryInfo*) (retPtr)) - 1)->m_allocator == this);
+}
+
+void dgArenaMemoryAllocator::Free(void* const retPtr)
+{
+	dgAssert ((((dgMemoryInfo*) (retPtr)) - 1)->m_allocator == this);
+}
+
+dgInt32 dgArenaMemoryAllocator::GetSize(void* const retPtr)
+{
+	dgMemoryInfo* const info = ((dgMemoryInfo*)(retPtr)) - 1;
+	return info->m_size;
+}
+
 // this can be used by function that allocates large memory pools memory locally on the stack
 // this by pases the pool allocation because this should only be used for very large memory blocks.
 // this was using virtual memory on windows but 
@@ -173,6 +173,61 @@ class dgStackMemoryAllocator: public dgMemoryAllocator
 	dgInt32 m_size;
 };
 
+// growable bump allocator for transient data that only lives for one world update.
+// it is not thread safe, the world keeps one arena per worker thread.
+// Free is a no op, all the memory is recycled at once by calling Reset.
+class dgArenaMemoryAllocator: public dgMemoryAllocator 
+{
+	#define DG_ARENA_MEMORY_PAGE_SIZE	(1024 * 64)
+
+	public:
+	dgArenaMemoryAllocator(dgMemoryAllocator* const parent, dgInt32 pageSize = DG_ARENA_MEMORY_PAGE_SIZE);
+	~dgArenaMemoryAllocator();
+
+	DG_INLINE void* Alloc(dgInt32 size)
+	{
+		dgInt8* const ptr = (dgInt8*) (reinterpret_cast<uintptr_t>(m_pool + m_index + 15) & -0x10);
+		const dgInt32 index = dgInt32 (ptr - m_pool) + size;
+		if (index > m_size) {
+			return AllocPage(size);
+		}
+		m_index = index;
+		return ptr;
+	}
+
+	template<class T>
+	DG_INLINE T* AllocArray(dgInt32 count)
+	{
+		return (T*) Alloc(dgInt32 (count * sizeof (T)));
+	}
+
+	void* Malloc(dgInt32 size);
+	void* MallocLow(dgInt32 size, dgInt32 alignment);
+	void Free(void* const retPtr);
+	void FreeLow(void* const retPtr);
+	dgInt32 GetSize (void* const retPtr);
+
+	void Reset();
+	dgInt32 GetHighWaterMark() const
+	{
+		return m_highWaterMark;
+	}
+
+	private:
+	class dgArenaPage;
+	void* AllocPage(dgInt32 size);
+	void FreePages();
+
+	dgMemoryAllocator* m_parent;
+	dgArenaPage* m_pages;
+	dgInt8* m_pool;
+	dgInt32 m_index;
+	dgInt32 m_size;
+	dgInt32 m_usedInFullPages;
+	dgInt32 m_pageSize;
+	dgInt32 m_highWaterMark;
+};
+
 #else
 
 
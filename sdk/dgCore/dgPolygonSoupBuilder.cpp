@@ -296,13 +296,13 @@ void dgPolygonSoupDatabaseBuilder::PackArray()
 	m_run = DG_POINTS_RUN;
 }
 
-void dgPolygonSoupDatabaseBuilder::Finalize()
+void dgPolygonSoupDatabaseBuilder::Finalize(dgThreadHive* const threadPool)
 {
 	if (m_faceCount) {
 		dgStack<dgInt32> indexMapPool (m_indexCount + m_vertexCount);
 
 		dgInt32* const indexMap = &indexMapPool[0];
-		m_vertexCount = dgVertexListToIndexList (&m_vertexPoints[0].m_x, sizeof (dgBigVector), 3, m_vertexCount, &indexMap[0], dgFloat32 (1.0e-4f));
+		m_vertexCount = dgVertexListToIndexList (&m_vertexPoints[0].m_x, sizeof (dgBigVector), 3, m_vertexCount, &indexMap[0], dgFloat32 (1.0e-4f), threadPool);
 
 		dgInt32 k = 0;
 		for (dgInt32 i = 0; i < m_faceCount; i ++) {
@@ -467,7 +467,7 @@ void dgPolygonSoupDatabaseBuilder::OptimizeByIndividualFaces()
 }
 
 
-void dgPolygonSoupDatabaseBuilder::End(bool optimize)
+void dgPolygonSoupDatabaseBuilder::End(bool optimize, dgThreadHive* const threadPool)
 {
 	if (optimize) {
 		dgPolygonSoupDatabaseBuilder copy (*this);
@@ -480,7 +480,7 @@ void dgPolygonSoupDatabaseBuilder::End(bool optimize)
 			Optimize(iter.GetNode()->GetKey(), bucket, copy);
 		}
 	}
-	Finalize();
+	Finalize(threadPool);
 
 	// build the normal array and adjacency array
 	// calculate all face the normals
@@ -510,7 +510,7 @@ void dgPolygonSoupDatabaseBuilder::End(bool optimize)
 	}
 	// compress normals array
 	m_normalIndex[m_faceCount] = 0;
-	m_normalCount = dgVertexListToIndexList(&m_normalPoints[0].m_x, sizeof (dgBigVector), 3, m_faceCount, &m_normalIndex[0], dgFloat32 (1.0e-6f));
+	m_normalCount = dgVertexListToIndexList(&m_normalPoints[0].m_x, sizeof (dgBigVector), 3, m_faceCount, &m_normalIndex[0], dgFloat32 (1.0e-6f), threadPool);
 }
 
 
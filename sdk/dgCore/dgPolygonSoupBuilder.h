@@ -58,14 +58,14 @@ class dgPolygonSoupDatabaseBuilder
 	DG_CLASS_ALLOCATOR(allocator)
 
 	void Begin();
-	void End(bool optimize);
+	void End(bool optimize, dgThreadHive* const threadPool = NULL);
 	void AddMesh (const dgFloat32* const vertex, dgInt32 vertexCount, dgInt32 strideInBytes, dgInt32 faceCount, 
 		          const dgInt32* const faceArray, const dgInt32* const indexArray, const dgInt32* const faceTagsData, const dgMatrix& worldMatrix); 
 
 	private:
 	void Optimize(dgInt32 faceId, const dgFaceBucket& faceBucket, const dgPolygonSoupDatabaseBuilder& source);
 
-	void Finalize();
+	void Finalize(dgThreadHive* const threadPool = NULL);
 	void FinalizeAndOptimize();
 	void OptimizeByIndividualFaces();
 	dgInt32 FilterFace (dgInt32 count, dgInt32* const indexArray);
@@ -32,6 +32,9 @@ dgThreadHive::dgWorkerThread::dgWorkerThread()
 	,m_allocator(NULL)
 	,m_isBusy(0)
 	,m_jobsCount(0)
+	,m_stealableHead(0)
+	,m_stealableTail(0)
+	,m_stealableLock(0)
 	,m_workerSemaphore()
 {
 }
@@ -97,6 +100,74 @@ void dgThreadHive::dgWorkerThread::RunNextJobInQueue(dgInt32 threadId)
 		job.m_callback (job.m_context0, job.m_context1, m_id);
 	}
 	m_jobsCount = 0;
+	RunStealableJobs();
+}
+
+bool dgThreadHive::dgWorkerThread::PushStealableJob(const dgThreadJob& job)
+{
+	dgScopeSpinLock lock (&m_stealableLock);
+	if (m_stealableTail >= DG_THREAD_POOL_JOB_SIZE) {
+		return false;
+	}
+	m_stealablePool[m_stealableTail] = job;
+	m_stealableTail ++;
+	return true;
+}
+
+bool dgThreadHive::dgWorkerThread::PopStealableJob(dgThreadJob& job)
+{
+	// the owner takes the newest job, nested jobs are then run depth first while their data is still in cache
+	dgScopeSpinLock lock (&m_stealableLock);
+	if (m_stealableTail > m_stealableHead) {
+		m_stealableTail --;
+		job = m_stealablePool[m_stealableTail];
+		if (m_stealableTail == m_stealableHead) {
+			m_stealableHead = 0;
+			m_stealableTail = 0;
+		}
+		return true;
+	}
+	return false;
+}
+
+bool dgThreadHive::dgWorkerThread::StealJob(dgThreadJob& job)
+{
+	// thieves take the oldest job, which is usually the biggest one
+	dgScopeSpinLock lock (&m_stealableLock);
+	if (m_stealableTail > m_stealableHead) {
+		job = m_stealablePool[m_stealableHead];
+		m_stealableHead ++;
+		if (m_stealableTail == m_stealableHead) {
+			m_stealableHead = 0;
+			m_stealableTail = 0;
+		}
+		return true;
+	}
+	return false;
+}
+
+void dgThreadHive::dgWorkerThread::RunStealableJobs()
+{
+	// keep running the own deque and stealing from the others until every stealable job has completed, 
+	// a job is only counted as done after it returns, so jobs nested in it keep the workers in the loop
+	dgThreadHive* const hive = m_hive;
+	const dgInt32 threadCount = hive->m_workerThreadsCount;
+	dgThreadJob job;
+	while (dgAtomicExchangeAndAdd(&hive->m_pendingJobs, 0)) {
+		bool executed = PopStealableJob(job);
+		for (dgInt32 i = 1; !executed && (i < threadCount); i ++) {
+			executed = hive->m_workerThreads[(m_id + i) % threadCount].StealJob(job);
+			if (executed) {
+				dgAtomicExchangeAndAdd(&hive->m_stolenJobs, 1);
+			}
+		}
+		if (executed) {
+			job.m_callback (job.m_context0, job.m_context1, m_id);
+			dgAtomicExchangeAndAdd(&hive->m_pendingJobs, -1);
+		} else {
+			dgThreadPause();
+		}
+	}
 }
 
 dgThreadHive::dgThreadHive(dgMemoryAllocator* const allocator)
@@ -104,6 +175,8 @@ dgThreadHive::dgThreadHive(dgMemoryAllocator* const allocator)
 	,m_workerThreads(NULL)
 	,m_allocator(allocator)
 	,m_jobsCount(0)
+	,m_pendingJobs(0)
+	,m_stolenJobs(0)
 	,m_workerThreadsCount(0)
 	,m_globalCriticalSection(0)
 {
@@ -170,6 +243,45 @@ void dgThreadHive::QueueJob (dgWorkerThreadTaskCallback callback, void* const co
 	m_jobsCount ++;
 }
 
+void dgThreadHive::QueueStealableJob (dgWorkerThreadTaskCallback callback, void* const context0, void* const context1, const char* const functionName)
+{
+	if (!m_workerThreadsCount) {
+		callback (context0, context1, 0);
+	} else {
+		dgInt32 workerTreadEntry = m_jobsCount % m_workerThreadsCount;
+		#ifdef DG_USE_THREAD_EMULATION
+			callback (context0, context1, workerTreadEntry);
+		#else 
+			const dgThreadJob job (context0, context1, callback, functionName);
+			dgAtomicExchangeAndAdd(&m_pendingJobs, 1);
+			if (!m_workerThreads[workerTreadEntry].PushStealableJob(job)) {
+				dgAssert (0);
+				dgAtomicExchangeAndAdd(&m_pendingJobs, -1);
+				SynchronizationBarrier ();
+				dgAtomicExchangeAndAdd(&m_pendingJobs, 1);
+				m_workerThreads[workerTreadEntry].PushStealableJob(job);
+			}
+		#endif
+	}
+	m_jobsCount ++;
+}
+
+void dgThreadHive::QueueNestedJob (dgWorkerThreadTaskCallback callback, void* const context0, void* const context1, dgInt32 threadID, const char* const functionName)
+{
+	// only legal from a job running on worker threadID, the job goes to its deque where idle workers can steal it
+	#ifndef DG_USE_THREAD_EMULATION
+	if (m_workerThreadsCount) {
+		dgAtomicExchangeAndAdd(&m_pendingJobs, 1);
+		if (m_workerThreads[threadID].PushStealableJob(dgThreadJob (context0, context1, callback, functionName))) {
+			return;
+		}
+		dgAtomicExchangeAndAdd(&m_pendingJobs, -1);
+	}
+	#endif
+	// the deque is full or there are no workers, run it in place
+	callback (context0, context1, threadID);
+}
+
 void dgThreadHive::OnBeginWorkerThread (dgInt32 threadId)
 {
 }
@@ -186,6 +298,7 @@ void dgThreadHive::SynchronizationBarrier ()
 			m_workerThreads[i].m_workerSemaphore.Release();
 		}
 		m_parentThread->Wait(m_workerThreadsCount, m_beginSectionSemaphores);
+		dgAssert (!m_pendingJobs);
 	}
 	m_jobsCount = 0;
 }
@@ -200,6 +313,9 @@ dgThreadHive::dgWorkerThread::dgWorkerThread()
 	,m_concurrentWork(0)
 	,m_pendingWork(0)
 	,m_jobsCount(0)
+	,m_stealableHead(0)
+	,m_stealableTail(0)
+	,m_stealableLock(0)
 {
 }
 
@@ -223,6 +339,74 @@ void dgThreadHive::dgWorkerThread::RunNextJobInQueue(dgInt32 threadId)
 		const dgThreadJob& job = m_jobPool[i];
 		job.m_callback(job.m_context0, job.m_context1, m_id);
 	}
+	RunStealableJobs();
+}
+
+bool dgThreadHive::dgWorkerThread::PushStealableJob(const dgThreadJob& job)
+{
+	dgScopeSpinLock lock(&m_stealableLock);
+	if (m_stealableTail >= DG_THREAD_POOL_JOB_SIZE) {
+		return false;
+	}
+	m_stealablePool[m_stealableTail] = job;
+	m_stealableTail++;
+	return true;
+}
+
+bool dgThreadHive::dgWorkerThread::PopStealableJob(dgThreadJob& job)
+{
+	// the owner takes the newest job, nested jobs are then run depth first while their data is still in cache
+	dgScopeSpinLock lock(&m_stealableLock);
+	if (m_stealableTail > m_stealableHead) {
+		m_stealableTail--;
+		job = m_stealablePool[m_stealableTail];
+		if (m_stealableTail == m_stealableHead) {
+			m_stealableHead = 0;
+			m_stealableTail = 0;
+		}
+		return true;
+	}
+	return false;
+}
+
+bool dgThreadHive::dgWorkerThread::StealJob(dgThreadJob& job)
+{
+	// thieves take the oldest job, which is usually the biggest one
+	dgScopeSpinLock lock(&m_stealableLock);
+	if (m_stealableTail > m_stealableHead) {
+		job = m_stealablePool[m_stealableHead];
+		m_stealableHead++;
+		if (m_stealableTail == m_stealableHead) {
+			m_stealableHead = 0;
+			m_stealableTail = 0;
+		}
+		return true;
+	}
+	return false;
+}
+
+void dgThreadHive::dgWorkerThread::RunStealableJobs()
+{
+	// keep running the own deque and stealing from the others until every stealable job has completed, 
+	// a job is only counted as done after it returns, so jobs nested in it keep the workers in the loop
+	dgThreadHive* const hive = m_hive;
+	const dgInt32 threadCount = hive->m_workerThreadsCount;
+	dgThreadJob job;
+	while (dgAtomicExchangeAndAdd(&hive->m_pendingJobs, 0)) {
+		bool executed = PopStealableJob(job);
+		for (dgInt32 i = 1; !executed &&(i < threadCount); i++) {
+			executed = hive->m_workerThreads[(m_id + i) % threadCount].StealJob(job);
+			if (executed) {
+				dgAtomicExchangeAndAdd(&hive->m_stolenJobs, 1);
+			}
+		}
+		if (executed) {
+			job.m_callback(job.m_context0, job.m_context1, m_id);
+			dgAtomicExchangeAndAdd(&hive->m_pendingJobs, -1);
+		} else {
+			dgThreadPause();
+		}
+	}
 }
 
 dgInt32 dgThreadHive::dgWorkerThread::PushJob(const dgThreadJob& job)
@@ -270,6 +454,8 @@ dgThreadHive::dgThreadHive(dgMemoryAllocator* const allocator)
 	,m_allocator(allocator)
 	,m_syncLock(0)
 	,m_jobsCount(0)
+	,m_pendingJobs(0)
+	,m_stolenJobs(0)
 	,m_workerThreadsCount(0)
 	,m_globalCriticalSection(0)
 {
@@ -336,6 +522,45 @@ void dgThreadHive::QueueJob(dgWorkerThreadTaskCallback callback, void* const con
 	m_jobsCount++;
 }
 
+void dgThreadHive::QueueStealableJob(dgWorkerThreadTaskCallback callback, void* const context0, void* const context1, const char* const functionName)
+{
+	if (!m_workerThreadsCount) {
+		callback(context0, context1, 0);
+	} else {
+		dgInt32 workerTreadEntry = m_jobsCount % m_workerThreadsCount;
+		#ifdef DG_USE_THREAD_EMULATION
+			callback(context0, context1, workerTreadEntry);
+		#else 
+			const dgThreadJob job(context0, context1, callback, functionName);
+			dgAtomicExchangeAndAdd(&m_pendingJobs, 1);
+			if (!m_workerThreads[workerTreadEntry].PushStealableJob(job)) {
+				dgAssert(0);
+				dgAtomicExchangeAndAdd(&m_pendingJobs, -1);
+				SynchronizationBarrier();
+				dgAtomicExchangeAndAdd(&m_pendingJobs, 1);
+				m_workerThreads[workerTreadEntry].PushStealableJob(job);
+			}
+		#endif
+	}
+	m_jobsCount++;
+}
+
+void dgThreadHive::QueueNestedJob(dgWorkerThreadTaskCallback callback, void* const context0, void* const context1, dgInt32 threadID, const char* const functionName)
+{
+	// only legal from a job running on worker threadID, the job goes to its deque where idle workers can steal it
+	#ifndef DG_USE_THREAD_EMULATION
+	if (m_workerThreadsCount) {
+		dgAtomicExchangeAndAdd(&m_pendingJobs, 1);
+		if (m_workerThreads[threadID].PushStealableJob(dgThreadJob(context0, context1, callback, functionName))) {
+			return;
+		}
+		dgAtomicExchangeAndAdd(&m_pendingJobs, -1);
+	}
+	#endif
+	// the deque is full or there are no workers, run it in place
+	callback(context0, context1, threadID);
+}
+
 void dgThreadHive::SetThreadsCount(dgInt32 threads)
 {
 	DestroyThreads();
@@ -369,6 +594,7 @@ void dgThreadHive::SynchronizationBarrier()
 		while (dgInterlockedTest(&m_syncLock, 0)) {
 			dgThreadYield();
 		}
+		dgAssert(!m_pendingJobs);
 		#endif
 	}
 	m_jobsCount = 0;
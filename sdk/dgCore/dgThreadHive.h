@@ -28,6 +28,13 @@
 #include "dgFastQueue.h"
 
 #define DG_THREAD_POOL_JOB_SIZE (256)
+
+// jobs queued with QueueJob are pinned, they run on the worker they were queued to and get its id.
+// jobs queued with QueueStealableJob go to a per worker deque, the owner runs them newest first and 
+// idle workers steal the oldest ones, they get the id of the worker that runs them. Only kernels that 
+// take their work from an atomic index and use the thread id just for per thread scratch memory can 
+// be stealable. A running job can spawn more stealable work with QueueNestedJob, and the barrier does 
+// not return until every stealable job, stolen or nested, has completed.
 typedef void (*dgWorkerThreadTaskCallback) (void* const context0, void* const context1, dgInt32 threadID);
 
 #ifndef WIN32
@@ -72,14 +79,22 @@ typedef void (*dgWorkerThreadTaskCallback) (void* const context0, void* const co
 			virtual void Execute (dgInt32 threadId);
 
 			dgInt32 PushJob(const dgThreadJob& job);
+			bool PushStealableJob(const dgThreadJob& job);
+			bool PopStealableJob(dgThreadJob& job);
+			bool StealJob(dgThreadJob& job);
 			void RunNextJobInQueue(dgInt32 threadId);
+			void RunStealableJobs();
 
 			dgThreadHive* m_hive;
 			dgMemoryAllocator* m_allocator; 
 			dgInt32 m_isBusy;
 			dgInt32 m_jobsCount;
+			dgInt32 m_stealableHead;
+			dgInt32 m_stealableTail;
+			dgInt32 m_stealableLock;
 			dgSemaphore m_workerSemaphore;
 			dgThreadJob m_jobPool[DG_THREAD_POOL_JOB_SIZE];
+			dgThreadJob m_stealablePool[DG_THREAD_POOL_JOB_SIZE];
 		};
 
 		dgThreadHive(dgMemoryAllocator* const allocator);
@@ -104,8 +119,12 @@ typedef void (*dgWorkerThreadTaskCallback) (void* const context0, void* const co
 		void SetThreadsCount (dgInt32 count);
 
 		virtual void QueueJob (dgWorkerThreadTaskCallback callback, void* const context0, void* const context1, const char* const functionName);
+		virtual void QueueStealableJob (dgWorkerThreadTaskCallback callback, void* const context0, void* const context1, const char* const functionName);
+		virtual void QueueNestedJob (dgWorkerThreadTaskCallback callback, void* const context0, void* const context1, dgInt32 threadID, const char* const functionName);
 		virtual void SynchronizationBarrier ();
 
+		dgInt32 GetStolenJobsCount() const;
+
 		private:
 		void DestroyThreads();
 
@@ -113,6 +132,8 @@ typedef void (*dgWorkerThreadTaskCallback) (void* const context0, void* const co
 		dgWorkerThread* m_workerThreads;
 		dgMemoryAllocator* m_allocator;
 		dgInt32 m_jobsCount;
+		dgInt32 m_pendingJobs;
+		dgInt32 m_stolenJobs;
 		dgInt32 m_workerThreadsCount;
 		mutable dgInt32 m_globalCriticalSection;
 		dgThread::dgSemaphore m_beginSectionSemaphores[DG_MAX_THREADS_HIVE_COUNT];
@@ -128,6 +149,11 @@ typedef void (*dgWorkerThreadTaskCallback) (void* const context0, void* const co
 		return DG_MAX_THREADS_HIVE_COUNT;
 	}
 
+	DG_INLINE dgInt32 dgThreadHive::GetStolenJobsCount() const
+	{
+		return m_stolenJobs;
+	}
+
 
 	DG_INLINE void dgThreadHive::GlobalLock() const
 	{
@@ -191,7 +217,11 @@ typedef void (*dgWorkerThreadTaskCallback) (void* const context0, void* const co
 			virtual void Execute(dgInt32 threadId);
 
 			dgInt32 PushJob(const dgThreadJob& job);
+			bool PushStealableJob(const dgThreadJob& job);
+			bool PopStealableJob(dgThreadJob& job);
+			bool StealJob(dgThreadJob& job);
 			void RunNextJobInQueue(dgInt32 threadId);
+			void RunStealableJobs();
 			void ConcurrentWork(dgInt32 threadId);
 
 	//		bool IsBusy() const;
@@ -203,7 +233,11 @@ typedef void (*dgWorkerThreadTaskCallback) (void* const context0, void* const co
 			dgInt32 m_concurrentWork;
 			dgInt32 m_pendingWork;
 			dgInt32 m_jobsCount;
+			dgInt32 m_stealableHead;
+			dgInt32 m_stealableTail;
+			dgInt32 m_stealableLock;
 			dgThreadJob m_jobPool[DG_THREAD_POOL_JOB_SIZE];
+			dgThreadJob m_stealablePool[DG_THREAD_POOL_JOB_SIZE];
 		};
 
 		public:
@@ -229,8 +263,12 @@ typedef void (*dgWorkerThreadTaskCallback) (void* const context0, void* const co
 		void SetThreadsCount(dgInt32 count);
 
 		virtual void QueueJob(dgWorkerThreadTaskCallback callback, void* const context0, void* const context1, const char* const functionName);
+		virtual void QueueStealableJob(dgWorkerThreadTaskCallback callback, void* const context0, void* const context1, const char* const functionName);
+		virtual void QueueNestedJob(dgWorkerThreadTaskCallback callback, void* const context0, void* const context1, dgInt32 threadID, const char* const functionName);
 		virtual void SynchronizationBarrier();
 
+		dgInt32 GetStolenJobsCount() const;
+
 		private:
 		void DestroyThreads();
 
@@ -239,6 +277,8 @@ typedef void (*dgWorkerThreadTaskCallback) (void* const context0, void* const co
 		dgMemoryAllocator* m_allocator;
 		dgInt32 m_syncLock;
 		dgInt32 m_jobsCount;
+		dgInt32 m_pendingJobs;
+		dgInt32 m_stolenJobs;
 		dgInt32 m_workerThreadsCount;
 		mutable dgInt32 m_globalCriticalSection;
 		dgThread::dgSemaphore m_endSectionSemaphores[DG_MAX_THREADS_HIVE_COUNT];
@@ -255,6 +295,11 @@ typedef void (*dgWorkerThreadTaskCallback) (void* const context0, void* const co
 		return DG_MAX_THREADS_HIVE_COUNT;
 	}
 
+	DG_INLINE dgInt32 dgThreadHive::GetStolenJobsCount() const
+	{
+		return m_stolenJobs;
+	}
+
 	DG_INLINE void dgThreadHive::GlobalLock() const
 	{
 		GetIndirectLock(&m_globalCriticalSection);
@@ -25,6 +25,10 @@
 #include "dgVector.h"
 #include "dgMemory.h"
 #include "dgStack.h"
+#include "dgThreadHive.h"
+
+#define DG_VERTEX_SORT_SPLIT_SIZE		(1024 * 256)
+#define DG_VERTEX_SORT_PARALLEL_DEPTH	5
 
 dgUnsigned64 dgGetTimeInMicrosenconds()
 {
@@ -260,84 +264,183 @@ static dgInt32 SortVertices (dgFloat64* const vertexList,  dgInt32 stride, dgInt
 }
 
 
-static dgInt32 QuickSortVertices (dgFloat64* const vertList, dgInt32 stride, dgInt32 compareCount, dgInt32 vertexCount, dgFloat64 tolerance)
+static dgInt32 SplitVertices (dgFloat64* const vertList, dgInt32 stride, dgInt32 vertexCount)
 {
-	dgInt32 count = 0;
-	if (vertexCount > (1024 * 256)) {
-		dgFloat64 x = dgFloat32 (0.0f);
-		dgFloat64 y = dgFloat32 (0.0f);
-		dgFloat64 z = dgFloat32 (0.0f);
-		dgFloat64 xd = dgFloat32 (0.0f);
-		dgFloat64 yd = dgFloat32 (0.0f);
-		dgFloat64 zd = dgFloat32 (0.0f);
-
-		for (dgInt32 i = 0; i < vertexCount; i ++) {
-			dgFloat64 x0 = vertList[i * stride + 2];
-			dgFloat64 y0 = vertList[i * stride + 3];
-			dgFloat64 z0 = vertList[i * stride + 4];
-			x += x0;
-			y += y0;
-			z += z0;
-			xd += x0 * x0;
-			yd += y0 * y0;
-			zd += z0 * z0;
-		}
+	dgFloat64 x = dgFloat32 (0.0f);
+	dgFloat64 y = dgFloat32 (0.0f);
+	dgFloat64 z = dgFloat32 (0.0f);
+	dgFloat64 xd = dgFloat32 (0.0f);
+	dgFloat64 yd = dgFloat32 (0.0f);
+	dgFloat64 zd = dgFloat32 (0.0f);
 
-		xd = vertexCount * xd - x * x;
-		yd = vertexCount * yd - y * y;
-		zd = vertexCount * zd - z * z;
+	for (dgInt32 i = 0; i < vertexCount; i ++) {
+		dgFloat64 x0 = vertList[i * stride + 2];
+		dgFloat64 y0 = vertList[i * stride + 3];
+		dgFloat64 z0 = vertList[i * stride + 4];
+		x += x0;
+		y += y0;
+		z += z0;
+		xd += x0 * x0;
+		yd += y0 * y0;
+		zd += z0 * z0;
+	}
 
-		dgInt32 axis = 2;
-		dgFloat64 axisVal = x / vertexCount;
-		if ((yd > xd) && (yd > zd)) {
-			axis = 3;
-			axisVal = y / vertexCount;
-		}
-		if ((zd > xd) && (zd > yd)) {
-			axis = 4;
-			axisVal = z / vertexCount;
-		}
+	xd = vertexCount * xd - x * x;
+	yd = vertexCount * yd - y * y;
+	zd = vertexCount * zd - z * z;
 
-		dgInt32 i0 = 0;
-		dgInt32 i1 = vertexCount - 1;
-		do {    
-			for ( ;vertList[i0 * stride + axis] < axisVal; i0 ++); 
-			for ( ;vertList[i1 * stride + axis] > axisVal; i1 --);
-			if (i0 <= i1) {
-				for (dgInt32 i = 0; i < stride; i ++) {
-					dgSwap (vertList[i0 * stride + i], vertList[i1 * stride + i]);
-				}
-				i0 ++; 
-				i1 --;
+	dgInt32 axis = 2;
+	dgFloat64 axisVal = x / vertexCount;
+	if ((yd > xd) && (yd > zd)) {
+		axis = 3;
+		axisVal = y / vertexCount;
+	}
+	if ((zd > xd) && (zd > yd)) {
+		axis = 4;
+		axisVal = z / vertexCount;
+	}
+
+	dgInt32 i0 = 0;
+	dgInt32 i1 = vertexCount - 1;
+	do {    
+		for ( ;vertList[i0 * stride + axis] < axisVal; i0 ++); 
+		for ( ;vertList[i1 * stride + axis] > axisVal; i1 --);
+		if (i0 <= i1) {
+			for (dgInt32 i = 0; i < stride; i ++) {
+				dgSwap (vertList[i0 * stride + i], vertList[i1 * stride + i]);
 			}
-		} while (i0 <= i1);
-		dgAssert (i0 < vertexCount);
+			i0 ++; 
+			i1 --;
+		}
+	} while (i0 <= i1);
+	dgAssert (i0 < vertexCount);
+	return i0;
+}
+
+static dgInt32 MergeVertices (dgFloat64* const vertList, dgInt32 stride, dgInt32 vertexCount, dgInt32 i0, dgInt32 count0, dgInt32 count1)
+{
+	for (dgInt32 i = 0; i < count1; i ++) {
+		memcpy (&vertList[(count0 + i) * stride + 2], &vertList[(i0 + i) * stride + 2], (stride - 2) * sizeof (dgFloat64));
+	}
+
+	//		dgFloat64* const indexPtr = (dgInt64*)vertList;
+	for (dgInt32 i = i0; i < vertexCount; i ++) {
+		//			indexPtr[i * stride] += count0;
+		vertList[i * stride] += dgFloat64 (count0);
+	}
+	return count0 + count1;
+}
 
+static dgInt32 QuickSortVertices (dgFloat64* const vertList, dgInt32 stride, dgInt32 compareCount, dgInt32 vertexCount, dgFloat64 tolerance)
+{
+	dgInt32 count = 0;
+	if (vertexCount > DG_VERTEX_SORT_SPLIT_SIZE) {
+		dgInt32 i0 = SplitVertices (vertList, stride, vertexCount);
 		dgInt32 count0 = QuickSortVertices (&vertList[ 0 * stride], stride, compareCount, i0, tolerance);
 		dgInt32 count1 = QuickSortVertices (&vertList[i0 * stride], stride, compareCount, vertexCount - i0, tolerance);
+		count = MergeVertices (vertList, stride, vertexCount, i0, count0, count1);
+	} else {
+		count = SortVertices (vertList, stride, compareCount, vertexCount, tolerance);
+	}
 
-		count = count0 + count1;
+	return count;
+}
 
-		for (dgInt32 i = 0; i < count1; i ++) {
-			memcpy (&vertList[(count0 + i) * stride + 2], &vertList[(i0 + i) * stride + 2], (stride - 2) * sizeof (dgFloat64));
-		}
+// the top levels of the same split tree are partitioned here, the branches are sorted by the 
+// worker threads and then merged back in the same order, so the result is identical to QuickSortVertices
+class dgSortVerticesDescriptor
+{
+	public:
+	class dgSortNode
+	{
+		public:
+		dgFloat64* m_vertList;
+		dgInt32 m_vertexCount;
+		dgInt32 m_split;
+		dgInt32 m_left;
+		dgInt32 m_right;
+		dgInt32 m_count;
+	};
+
+	dgSortVerticesDescriptor (dgInt32 stride, dgInt32 compareCount, dgFloat64 tolerance)
+		:m_stride(stride)
+		,m_compareCount(compareCount)
+		,m_nodesCount(0)
+		,m_leafsCount(0)
+		,m_atomicIndex(0)
+		,m_tolerance(tolerance)
+	{
+	}
 
+	dgInt32 BuildSplitTree (dgFloat64* const vertList, dgInt32 vertexCount, dgInt32 depth)
+	{
+		const dgInt32 nodeIndex = m_nodesCount;
+		dgSortNode& node = m_nodes[nodeIndex];
+		m_nodesCount ++;
+
+		node.m_vertList = vertList;
+		node.m_vertexCount = vertexCount;
+		node.m_split = 0;
+		node.m_left = -1;
+		node.m_right = -1;
+		node.m_count = 0;
+		if ((vertexCount > DG_VERTEX_SORT_SPLIT_SIZE) && (depth < DG_VERTEX_SORT_PARALLEL_DEPTH)) {
+			const dgInt32 i0 = SplitVertices (vertList, m_stride, vertexCount);
+			node.m_split = i0;
+			node.m_left = BuildSplitTree (vertList, i0, depth + 1);
+			node.m_right = BuildSplitTree (&vertList[i0 * m_stride], vertexCount - i0, depth + 1);
+		} else {
+			m_leafs[m_leafsCount] = nodeIndex;
+			m_leafsCount ++;
+		}
+		return nodeIndex;
+	}
 
-		//		dgFloat64* const indexPtr = (dgInt64*)vertList;
-		for (dgInt32 i = i0; i < vertexCount; i ++) {
-			//			indexPtr[i * stride] += count0;
-			vertList[i * stride] += dgFloat64 (count0);
+	dgInt32 MergeSplitTree (dgInt32 nodeIndex)
+	{
+		dgSortNode& node = m_nodes[nodeIndex];
+		if (node.m_split) {
+			const dgInt32 count0 = MergeSplitTree (node.m_left);
+			const dgInt32 count1 = MergeSplitTree (node.m_right);
+			node.m_count = MergeVertices (node.m_vertList, m_stride, node.m_vertexCount, node.m_split, count0, count1);
 		}
+		return node.m_count;
+	}
 
-	} else {
-		count = SortVertices (vertList, stride, compareCount, vertexCount, tolerance);
+	static void SortKernel (void* const context, void* const, dgInt32 threadID)
+	{
+		dgSortVerticesDescriptor* const descriptor = (dgSortVerticesDescriptor*) context;
+		const dgInt32 leafsCount = descriptor->m_leafsCount;
+		for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, 1); i < leafsCount; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, 1)) {
+			dgSortNode& node = descriptor->m_nodes[descriptor->m_leafs[i]];
+			node.m_count = QuickSortVertices (node.m_vertList, descriptor->m_stride, descriptor->m_compareCount, node.m_vertexCount, descriptor->m_tolerance);
+		}
 	}
 
-	return count;
+	dgInt32 m_stride;
+	dgInt32 m_compareCount;
+	dgInt32 m_nodesCount;
+	dgInt32 m_leafsCount;
+	dgInt32 m_atomicIndex;
+	dgFloat64 m_tolerance;
+	dgInt32 m_leafs[1 << DG_VERTEX_SORT_PARALLEL_DEPTH];
+	dgSortNode m_nodes[2 << DG_VERTEX_SORT_PARALLEL_DEPTH];
+};
+
+static dgInt32 QuickSortVertices (dgThreadHive* const threadPool, dgFloat64* const vertList, dgInt32 stride, dgInt32 compareCount, dgInt32 vertexCount, dgFloat64 tolerance)
+{
+	dgSortVerticesDescriptor descriptor (stride, compareCount, tolerance);
+	const dgInt32 root = descriptor.BuildSplitTree (vertList, vertexCount, 0);
+	const dgInt32 threadsCount = threadPool->GetThreadCount();
+	for (dgInt32 i = 0; i < threadsCount; i ++) {
+		threadPool->QueueJob (dgSortVerticesDescriptor::SortKernel, &descriptor, NULL, "dgVertexListToIndexList");
+	}
+	threadPool->SynchronizationBarrier();
+	return descriptor.MergeSplitTree (root);
 }
 
 
-dgInt32 dgVertexListToIndexList (dgFloat64* const vertList, dgInt32 strideInBytes, dgInt32 compareCount, dgInt32 vertexCount, dgInt32* const indexListOut, dgFloat64 tolerance)
+dgInt32 dgVertexListToIndexList (dgFloat64* const vertList, dgInt32 strideInBytes, dgInt32 compareCount, dgInt32 vertexCount, dgInt32* const indexListOut, dgFloat64 tolerance, dgThreadHive* const threadPool)
 {
 	dgSetPrecisionDouble precision;
 
@@ -366,7 +469,12 @@ dgInt32 dgVertexListToIndexList (dgFloat64* const vertList, dgInt32 strideInByte
 		m += stride2;
 	}
 	
-	dgInt32 count = QuickSortVertices (tmpVertexList, stride2, compareCount, vertexCount, tolerance);
+	dgInt32 count = 0;
+	if (threadPool && (threadPool->GetThreadCount() > 1) && (vertexCount > DG_VERTEX_SORT_SPLIT_SIZE)) {
+		count = QuickSortVertices (threadPool, tmpVertexList, stride2, compareCount, vertexCount, tolerance);
+	} else {
+		count = QuickSortVertices (tmpVertexList, stride2, compareCount, vertexCount, tolerance);
+	}
 
 	k = 0;
 	m = 0;
@@ -389,7 +497,7 @@ dgInt32 dgVertexListToIndexList (dgFloat64* const vertList, dgInt32 strideInByte
 	return count;
 }
 
-dgInt32 dgVertexListToIndexList (dgFloat32* const vertList, dgInt32 strideInBytes, dgInt32 floatSizeInBytes, dgInt32 unsignedSizeInBytes, dgInt32 vertexCount, dgInt32* const indexList, dgFloat32 tolerance)
+dgInt32 dgVertexListToIndexList (dgFloat32* const vertList, dgInt32 strideInBytes, dgInt32 floatSizeInBytes, dgInt32 unsignedSizeInBytes, dgInt32 vertexCount, dgInt32* const indexList, dgFloat32 tolerance, dgThreadHive* const threadPool)
 {
 	dgInt32 stride = dgInt32 (strideInBytes / sizeof (dgFloat32));
 
@@ -408,7 +516,7 @@ dgInt32 dgVertexListToIndexList (dgFloat32* const vertList, dgInt32 strideInByte
 		}
 	}
 
-	dgInt32 count = dgVertexListToIndexList (data, dgInt32 (stride * sizeof (dgFloat64)), floatCount, vertexCount, indexList, dgFloat64 (tolerance));
+	dgInt32 count = dgVertexListToIndexList (data, dgInt32 (stride * sizeof (dgFloat64)), floatCount, vertexCount, indexList, dgFloat64 (tolerance), threadPool);
 	for (dgInt32 i = 0; i < count; i ++) {
 		dgFloat64* const src = &data[i * stride];
 		dgFloat32* const dst = &vertList[i * stride];
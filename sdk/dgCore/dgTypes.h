@@ -209,6 +209,7 @@
 
 #define DG_VECTOR_SIMD_SIZE		16
 #define DG_VECTOR_AVX2_SIZE		32
+#define DG_VECTOR_AVX512_SIZE	64
 
 #if (defined (_WIN_32_VER) || defined (_WIN_64_VER))
 	#define	DG_GCC_VECTOR_ALIGMENT	
@@ -226,6 +227,14 @@
 	#define	DG_MSC_AVX_ALIGMENT			
 #endif
 
+#if (defined (_WIN_32_VER) || defined (_WIN_64_VER))
+	#define	DG_GCC_AVX512_ALIGMENT	
+	#define	DG_MSC_AVX512_ALIGMENT		__declspec(align(DG_VECTOR_AVX512_SIZE))
+#else
+	#define	DG_GCC_AVX512_ALIGMENT		__attribute__ ((aligned (DG_VECTOR_AVX512_SIZE)))
+	#define	DG_MSC_AVX512_ALIGMENT			
+#endif
+
 
 
 #if ((defined (_WIN_32_VER) || defined (_WIN_64_VER)) && (_MSC_VER  >= 1600))
@@ -283,6 +292,7 @@ class dgTriplex
 #define dgRadToDegree  	dgFloat32 (180.0f / dgPi)
 
 class dgBigVector;
+class dgThreadHive;
 #ifndef _NEWTON_USE_DOUBLE
 class dgVector;
 #endif 
@@ -449,8 +459,9 @@ union dgDoubleInt
 
 
 void dgGetMinMax (dgBigVector &Min, dgBigVector &Max, const dgFloat64* const vArray, dgInt32 vCount, dgInt32 strideInBytes);
-dgInt32 dgVertexListToIndexList (dgFloat64* const vertexList, dgInt32 strideInBytes, dgInt32 compareCount,     dgInt32 vertexCount,         dgInt32* const indexListOut, dgFloat64 tolerance = dgEpsilon);
-dgInt32 dgVertexListToIndexList (dgFloat32* const vertexList, dgInt32 strideInBytes, dgInt32 floatSizeInBytes, dgInt32 unsignedSizeInBytes, dgInt32 vertexCount, dgInt32* const indexListOut, dgFloat32 tolerance = dgEpsilon);
+// when a thread pool is passed, large vertex lists are sorted by the worker threads, the result is the same.
+dgInt32 dgVertexListToIndexList (dgFloat64* const vertexList, dgInt32 strideInBytes, dgInt32 compareCount,     dgInt32 vertexCount,         dgInt32* const indexListOut, dgFloat64 tolerance = dgEpsilon, dgThreadHive* const threadPool = NULL);
+dgInt32 dgVertexListToIndexList (dgFloat32* const vertexList, dgInt32 strideInBytes, dgInt32 floatSizeInBytes, dgInt32 unsignedSizeInBytes, dgInt32 vertexCount, dgInt32* const indexListOut, dgFloat32 tolerance = dgEpsilon, dgThreadHive* const threadPool = NULL);
 
 #define PointerToInt(x) ((size_t)x)
 #define IntToPointer(x) ((void*)(size_t(x)))
@@ -528,6 +539,32 @@ DG_INLINE dgInt32 dgAtomicExchangeAndAdd (dgInt32* const addend, dgInt32 amount)
 	#endif
 }
 
+DG_INLINE bool dgAtomicCompareAndSwap (dgInt32* const ptr, dgInt32 oldValue, dgInt32 newValue)
+{
+	#if (defined (_WIN_32_VER) || defined (_WIN_64_VER))
+		return _InterlockedCompareExchange((long*)ptr, long(newValue), long(oldValue)) == long(oldValue);
+	#elif (defined (_MINGW_32_VER) || defined (_MINGW_64_VER))
+		return InterlockedCompareExchange((long*)ptr, long(newValue), long(oldValue)) == long(oldValue);
+	#elif (defined (_POSIX_VER) || defined (_POSIX_VER_64) ||defined (_MACOSX_VER)|| defined ANDROID)
+		return __sync_bool_compare_and_swap((int32_t*)ptr, oldValue, newValue);
+	#else
+		#error "dgAtomicCompareAndSwap implementation required"
+	#endif
+}
+
+DG_INLINE bool dgAtomicCompareAndSwap (void** const ptr, void* const oldValue, void* const newValue)
+{
+	#if (defined (_WIN_32_VER) || defined (_WIN_64_VER))
+		return _InterlockedCompareExchangePointer(ptr, newValue, oldValue) == oldValue;
+	#elif (defined (_MINGW_32_VER) || defined (_MINGW_64_VER))
+		return InterlockedCompareExchangePointer(ptr, newValue, oldValue) == oldValue;
+	#elif (defined (_POSIX_VER) || defined (_POSIX_VER_64) ||defined (_MACOSX_VER)|| defined ANDROID)
+		return __sync_bool_compare_and_swap(ptr, oldValue, newValue);
+	#else
+		#error "dgAtomicCompareAndSwap implementation required"
+	#endif
+}
+
 DG_INLINE dgInt32 dgInterlockedExchange(dgInt32* const ptr, dgInt32 value)
 {
 	#if (defined (_WIN_32_VER) || defined (_WIN_64_VER))
@@ -561,6 +598,33 @@ DG_INLINE void* dgInterlockedExchange(void** const ptr, void* value)
 }
 
 
+// publish a pointer after the data it points to is written, readers pair it with dgAtomicLoadAcquire
+DG_INLINE void dgAtomicStoreRelease(void** const ptr, void* const value)
+{
+	#if (defined (_WIN_32_VER) || defined (_WIN_64_VER))
+		_ReadWriteBarrier();
+		*((void* volatile*)ptr) = value;
+	#elif (defined (_MINGW_32_VER) || defined (_MINGW_64_VER) || defined (_POSIX_VER) || defined (_POSIX_VER_64) ||defined (_MACOSX_VER) || defined ANDROID)
+		__atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+	#else
+		#error "dgAtomicStoreRelease implementation required"
+	#endif
+}
+
+DG_INLINE void* dgAtomicLoadAcquire(void* const* const ptr)
+{
+	#if (defined (_WIN_32_VER) || defined (_WIN_64_VER))
+		void* const value = *((void* const volatile*)ptr);
+		_ReadWriteBarrier();
+		return value;
+	#elif (defined (_MINGW_32_VER) || defined (_MINGW_64_VER) || defined (_POSIX_VER) || defined (_POSIX_VER_64) ||defined (_MACOSX_VER) || defined ANDROID)
+		return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+	#else
+		#error "dgAtomicLoadAcquire implementation required"
+	#endif
+}
+
+
 DG_INLINE dgInt32 dgInterlockedTest(dgInt32* const ptr, dgInt32 value)
 {
 	#if (defined (_WIN_32_VER) || defined (_WIN_64_VER))
@@ -314,6 +314,77 @@ void NewtonDeserializeFromFile (const NewtonWorld* const newtonWorld, const char
 	}
 }
 
+/*!
+  Get the size of the buffer needed to save the current state of the world.
+
+  @param *newtonWorld Pointer to the Newton world.
+
+  @return size in bytes of the state snapshot.
+
+  The size depends on the number of contacts, which changes every step, 
+  applications should allocate the buffer with some margin.
+
+  See also: ::NewtonWorldSaveState, ::NewtonWorldRestoreState
+*/
+int NewtonWorldGetStateSizeInBytes (const NewtonWorld* const newtonWorld)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return world->GetStateSizeInBytes();
+}
+
+/*!
+  Save the mutable simulation state of the world into a memory buffer.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param *buffer memory buffer that receives the snapshot.
+  @param bufferSizeInBytes size of the buffer.
+
+  @return the number of bytes written, zero if the buffer is too small.
+
+  The snapshot contains the body matrices, velocities and sleep states, the contact joints 
+  with their contact points and warm start impulses, and the warm start forces of the bilateral joints.
+  Shapes, materials and all other settings are not saved, the snapshot can only be restored 
+  into the same world while it has the same bodies and joints. The internal state of user joints 
+  and the particles of deformable bodies are not part of the snapshot.
+
+  This function is intended for rollback, save the state every frame and restore it 
+  to resimulate a number of frames.
+
+  See also: ::NewtonWorldGetStateSizeInBytes, ::NewtonWorldRestoreState
+*/
+int NewtonWorldSaveState (const NewtonWorld* const newtonWorld, void* const buffer, int bufferSizeInBytes)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return world->SaveState(buffer, bufferSizeInBytes);
+}
+
+/*!
+  Restore the world to a state saved with ::NewtonWorldSaveState.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param *buffer memory buffer with the snapshot.
+  @param bufferSizeInBytes size of the buffer.
+
+  @return 1 if the state was restored, 0 if the snapshot does not match the bodies or the joints of the world.
+  A snapshot that fails validation leaves the world unchanged.
+
+  Bodies are moved in place and contacts are restored in the order they had when the 
+  snapshot was taken, contacts created after the snapshot are destroyed.
+  In pipelined update mode, the pending transform callbacks are dispatched before the state is restored.
+  Resimulating from the same snapshot is repeatable, but the broadphase tree is not part of the snapshot, 
+  so after the tree is rebuilt a resimulation can drift from the frames that were simulated originally.
+
+  See also: ::NewtonWorldGetStateSizeInBytes, ::NewtonWorldSaveState
+*/
+int NewtonWorldRestoreState (const NewtonWorld* const newtonWorld, const void* const buffer, int bufferSizeInBytes)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return world->RestoreState(buffer, bufferSizeInBytes) ? 1 : 0;
+}
+
 NewtonBody* NewtonFindSerializedBody(const NewtonWorld* const newtonWorld, int bodySerializedID)
 {
 	TRACE_FUNCTION(__FUNCTION__);
@@ -535,10 +606,14 @@ int NewtonGetMaxThreadsCount(const NewtonWorld* const newtonWorld)
   (disabled by default).
 
   @param *newtonWorld Pointer to the Newton world.
-  @param mode 1: enabled  0: disabled (default)
+  @param mode NEWTON_PARALLEL_SOLVER_JACOBI: enabled  NEWTON_PARALLEL_SOLVER_GRAPH_COLORING: enabled with the graph colored solver  0: disabled (default)
 
   @return Nothing
 
+  The graph colored solver splits the joints of the large islands in sets that do not share
+  bodies and solves one set at the time with the same Gauss-Seidel iteration of the sequential
+  solver, so it usually reaches the same stability with fewer solver iterations.
+
   Multi threaded mode is not always faster. Among the reasons are
 
   1 - Significant software cost to set up threads, as well as instruction overhead.
@@ -655,7 +730,101 @@ void NewtonWaitForUpdateToFinish (const NewtonWorld* const newtonWorld)
 {
 	TRACE_FUNCTION(__FUNCTION__);
 	Newton* const world = (Newton *)newtonWorld;
-	world->Sync ();
+	world->WaitForUpdateToFinish ();
+}
+
+/*!
+  Enable or disable the pipelined update mode.
+
+  @param *newtonWorld is the pointer to the Newton world
+  @param state 1 to enable the pipelined update, 0 to go back to the default update.
+
+  @return Nothing
+
+  In pipelined mode ::NewtonUpdateAsync does not wait for the body transform callbacks.
+  The matrices of the bodies that moved are copied at the end of the step, and the
+  transform callbacks and the post update callback of that step are dispatched by
+  whichever comes first:
+
+  - the next call to ::NewtonUpdate or ::NewtonUpdateAsync. The callbacks then run on the
+    world worker threads, concurrently with the force and torque callbacks of that update.
+  - a call to ::NewtonWaitForUpdateToFinish. The callbacks then run on the calling thread,
+    with thread index zero, before the function returns.
+
+  This hides the cost of the transform callbacks behind the next step.
+
+  ::NewtonUpdate is not affected. A synchronous update has nothing to overlap the callbacks
+  with, so it calls them on the worker threads before it returns, the same as without the mode.
+
+  The transform callbacks receive the copied matrix, not the body current matrix.
+  The post update callback is still called after the last transform callback. When that
+  happens during the next update it is called from a worker thread, so it must not destroy
+  bodies or joints.
+
+  Disabling the mode dispatches any pending transform callbacks immediately.
+
+  See also: ::NewtonGetPipelinedUpdate, ::NewtonUpdateAsync
+*/
+void NewtonSetPipelinedUpdate (const NewtonWorld* const newtonWorld, int state)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	world->SetPipelinedUpdate (state ? true : false);
+}
+
+/*!
+  Return 1 if the world is using the pipelined update mode.
+
+  @param *newtonWorld is the pointer to the Newton world
+
+  See also: ::NewtonSetPipelinedUpdate
+*/
+int NewtonGetPipelinedUpdate (const NewtonWorld* const newtonWorld)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return world->GetPipelinedUpdate () ? 1 : 0;
+}
+
+/*!
+  Enable or disable the deterministic update mode.
+
+  @param *newtonWorld is the pointer to the Newton world
+  @param state 1 to enable the deterministic mode, 0 to go back to the default update.
+
+  @return Nothing
+
+  By default the result of a step is reproducible for a given number of threads, but
+  it can change in the last bits when the same scene is simulated with a different
+  thread count. In deterministic mode the result of ::NewtonUpdate is bit identical
+  for any number of worker threads, which is needed for lockstep networking and replays
+  recorded on different machines.
+
+  The mode costs some performance: contacts that wake bodies are resolved in a serial
+  pass, the joints are sorted on one thread, and large islands are not solved with the
+  parallel solver enabled by ::NewtonSetParallelSolverOnLargeIsland.
+
+  See also: ::NewtonGetDeterministicMode, ::NewtonSetThreadsCount
+*/
+void NewtonSetDeterministicMode (const NewtonWorld* const newtonWorld, int state)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	world->SetDeterministicMode (state ? true : false);
+}
+
+/*!
+  Return 1 if the world is using the deterministic update mode.
+
+  @param *newtonWorld is the pointer to the Newton world
+
+  See also: ::NewtonSetDeterministicMode
+*/
+int NewtonGetDeterministicMode (const NewtonWorld* const newtonWorld)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return world->GetDeterministicMode () ? 1 : 0;
 }
 
 dFloat NewtonGetLastUpdateTime (const NewtonWorld* const newtonWorld)
@@ -665,6 +834,59 @@ dFloat NewtonGetLastUpdateTime (const NewtonWorld* const newtonWorld)
 	return world->GetUpdateTime();
 }
 
+/*!
+  Get the timings and counters of the last world update.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param *stats pointer to the structure that receives the statistics.
+
+  @return Nothing.
+
+  Timings are in seconds. Timings and work counters, like pairs tested, rows and solver 
+  iterations, are accumulated over all the substeps of the update. Population counts, like 
+  bodies, contacts and islands, are the values at the end of the last substep.
+
+  The statistics are always collected, this function can be called at any time, 
+  even while an asynchronous update is running; it returns the last completed update.
+
+  See also: ::NewtonGetLastUpdateTime
+*/
+void NewtonWorldGetStats (const NewtonWorld* const newtonWorld, NewtonWorldStats* const stats)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+
+	dgWorldStats worldStats;
+	world->GetStats(worldStats);
+
+	stats->m_updateTime = worldStats.m_updateTime;
+	stats->m_skeletonsTime = worldStats.m_skeletonsTime;
+	stats->m_broadPhaseTime = worldStats.m_broadPhaseTime;
+	stats->m_forceAndTorqueTime = worldStats.m_forceAndTorqueTime;
+	stats->m_collidingPairsTime = worldStats.m_collidingPairsTime;
+	stats->m_contactsTime = worldStats.m_contactsTime;
+	stats->m_clustersTime = worldStats.m_clustersTime;
+	stats->m_solverTime = worldStats.m_solverTime;
+	stats->m_transformsTime = worldStats.m_transformsTime;
+
+	stats->m_substeps = worldStats.m_substeps;
+	stats->m_threads = worldStats.m_threads;
+	stats->m_bodies = worldStats.m_bodies;
+	stats->m_activeBodies = worldStats.m_activeBodies;
+	stats->m_pairsTested = worldStats.m_pairsTested;
+	stats->m_narrowPhasePairs = worldStats.m_narrowPhasePairs;
+	stats->m_newContacts = worldStats.m_newContacts;
+	stats->m_contacts = worldStats.m_contacts;
+	stats->m_activeContacts = worldStats.m_activeContacts;
+	stats->m_contactPoints = worldStats.m_contactPoints;
+	stats->m_islands = worldStats.m_islands;
+	stats->m_parallelIslands = worldStats.m_parallelIslands;
+	stats->m_joints = worldStats.m_joints;
+	stats->m_rows = worldStats.m_rows;
+	stats->m_solverIterations = worldStats.m_solverIterations;
+	stats->m_stolenJobs = worldStats.m_stolenJobs;
+}
+
 
 void NewtonSetNumberOfSubsteps (const NewtonWorld* const newtonWorld, int subSteps)
 {
@@ -1214,6 +1436,62 @@ int NewtonWorldCollide (const NewtonWorld* const newtonWorld, const dFloat* cons
 	return world->GetBroadPhase()->Collide((dgCollisionInstance*)shape, dgMatrix(matrix), (OnRayPrecastAction)prefilter, userData, (dgConvexCastReturnInfo*)info, maxContactsCount, threadIndex);
 }
 
+/*!
+  Cast an array of rays into the world.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param *queries array of ray queries, each with its origin, destination and user data.
+  @param count number of queries in the array.
+  @param filter user define function to be called for each body hit, the same as for ::NewtonWorldRayCast.
+  @param prefilter user define function to be called for each body before intersection.
+  @param threadIndex thread index from where this function is called, or -1 to distribute the batch over the world worker threads.
+
+  @return Nothing.
+
+  Each ray behaves exactly as a call to ::NewtonWorldRayCast with the query *m_userData* passed to the callbacks,
+  but the batch is sorted so that rays with close origins and similar directions are processed together, 
+  which keeps the broadphase nodes they visit in cache.
+
+  When *threadIndex* is -1 the rays are processed by all the world worker threads and the filter callback
+  can be called concurrently from different threads. This mode can only be used outside a *NewtonUpdate*.
+  From inside a Newton callback pass the thread index of the callback, and the batch runs on that thread.
+
+  See also: ::NewtonWorldRayCast, ::NewtonWorldConvexCastBatch
+*/
+void NewtonWorldRayCastBatch(const NewtonWorld* const newtonWorld, const NewtonWorldRayCastQuery* const queries, int count, NewtonWorldRayFilterCallback filter, NewtonWorldRayPrefilterCallback prefilter, int threadIndex)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	world->GetBroadPhase()->RayCastBatch((const dgRayCastQuery*)queries, count, (OnRayCastAction)filter, (OnRayPrecastAction)prefilter, threadIndex);
+}
+
+/*!
+  Cast an array of convex shapes into the world.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param *queries array of convex cast queries.
+  @param count number of queries in the array.
+  @param prefilter user define function to be called for each body before intersection.
+  @param threadIndex thread index from where this function is called, or -1 to distribute the batch over the world worker threads.
+
+  @return Nothing.
+
+  Each query behaves as a call to ::NewtonWorldConvexCast, the results are written to the *m_param* and 
+  *m_contactCount* members of the query and the contacts to the query *m_info* buffer.
+  A query that hits nothing reports an *m_param* larger than 1.0, a query with *m_maxContacts* set to zero
+  can hit and still report a zero *m_contactCount*, so *m_param* is the value to test for a hit.
+
+  The threading rules are the same as for ::NewtonWorldRayCastBatch.
+
+  See also: ::NewtonWorldConvexCast, ::NewtonWorldRayCastBatch
+*/
+void NewtonWorldConvexCastBatch(const NewtonWorld* const newtonWorld, NewtonWorldConvexCastQuery* const queries, int count, NewtonWorldRayPrefilterCallback prefilter, int threadIndex)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	world->GetBroadPhase()->ConvexCastBatch((dgConvexCastQuery*)queries, count, (OnRayPrecastAction)prefilter, threadIndex);
+}
+
 
 /*!
   Retrieve body by index from island.
@@ -3249,6 +3527,80 @@ void NewtonHeightFieldSetHorizontalDisplacement (const NewtonCollision* const he
 	}
 }
 
+/*!
+  Set, replace or evict one tile of a tiled height field collision.
+
+  @param *heightField is the pointer to a tiled height field collision.
+  @param tileX tile column index.
+  @param tileZ tile row index.
+  @param elevationMap array of (tileSize + 1) x (tileSize + 1) elevation samples, the last row and column duplicate the first samples of the neighbor tiles. NULL evicts the tile.
+  @param attributeMap array of tileSize x tileSize cell attributes, can be NULL.
+
+  @return Nothing.
+
+  The arrays are not copied, they can point into a memory mapped file and must stay valid until the tile is replaced or evicted.
+  Tiles can only be set while the world is not updating, and the elevations must be within the range passed at creation.
+
+  See also: ::NewtonCreateTiledHeightFieldCollision, ::NewtonHeightFieldSetTileLoadCallback
+*/
+void NewtonHeightFieldSetTile (const NewtonCollision* const heightField, int tileX, int tileZ, const void* const elevationMap, const char* const attributeMap)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgCollisionInstance* const collision = (dgCollisionInstance*)heightField;
+	if (collision->IsType(dgCollision::dgCollisionHeightField_RTTI)) {
+		dgCollisionHeightField* const shape = (dgCollisionHeightField*)collision->GetChildShape();
+		shape->SetTile (tileX, tileZ, elevationMap, (const dgInt8* const) attributeMap);
+	}
+}
+
+/*!
+  Query if a tile of a tiled height field has its elevation data installed.
+
+  @param *heightField is the pointer to a tiled height field collision.
+  @param tileX tile column.
+  @param tileZ tile row.
+
+  @return 1 if the tile is resident, 0 if the tile is not loaded, was evicted, is out of range, or the collision is not a height field.
+
+  The query is safe to call from any thread while the world is updating, a tile installed by a load callback
+  on another thread is reported resident only after its data is visible to the calling thread.
+  A tile whose load callback returned zero stays a hole and is not requested again until it is set with ::NewtonHeightFieldSetTile.
+
+  See also: ::NewtonHeightFieldSetTile, ::NewtonHeightFieldSetTileLoadCallback
+*/
+int NewtonHeightFieldIsTileResident (const NewtonCollision* const heightField, int tileX, int tileZ)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgCollisionInstance* const collision = (dgCollisionInstance*)heightField;
+	if (collision->IsType(dgCollision::dgCollisionHeightField_RTTI)) {
+		dgCollisionHeightField* const shape = (dgCollisionHeightField*)collision->GetChildShape();
+		return shape->IsTileResident (tileX, tileZ) ? 1 : 0;
+	}
+	return 0;
+}
+
+/*!
+  Set the function called the first time a collision query touches a tile that is not resident.
+
+  @param *heightField is the pointer to a tiled height field collision.
+  @param callback returns non zero after setting the tile elevation and attribute pointers, or zero to leave the tile as a hole.
+  @param userData user data passed to the callback.
+
+  @return Nothing.
+
+  The callback is called from the worker threads once per tile, an application that streams tiles asynchronously 
+  can return zero and install the tile later with ::NewtonHeightFieldSetTile. Evicting a tile rearms the callback.
+*/
+void NewtonHeightFieldSetTileLoadCallback (const NewtonCollision* const heightField, NewtonHeightFieldTileLoadCallback callback, void* const userData)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgCollisionInstance* const collision = (dgCollisionInstance*)heightField;
+	if (collision->IsType(dgCollision::dgCollisionHeightField_RTTI)) {
+		dgCollisionHeightField* const shape = (dgCollisionHeightField*)collision->GetChildShape();
+		shape->SetTileLoadCallback ((dgCollisionHeightFieldTileLoadCallback) callback, userData);
+	}
+}
+
 /*!
   Prepare a *TreeCollision* to begin to accept the polygons that comprise the collision mesh.
 
@@ -3318,6 +3670,36 @@ void NewtonTreeCollisionEndBuild(const NewtonCollision* const treeCollision, int
 	collision->EndBuild(optimize);
 }
 
+/*!
+  Finalize the construction of the polygonal mesh using the world worker threads.
+
+  @param *newtonWorld is the pointer to the world that lends its worker threads.
+  @param *treeCollision is the pointer to the collision tree.
+  @param optimize flag that indicates to Newton whether it should optimize this mesh. Set to 1 to optimize the mesh, otherwise 0.
+
+  @return Nothing.
+
+  Same as ::NewtonTreeCollisionEndBuild, but the vertex welding, the face optimization and the tree construction are split across the world worker threads.
+  The function waits for any asynchronous update to finish before it uses the threads.
+  It must not be called from inside a world callback, or from another thread while ::NewtonUpdate or ::NewtonUpdateAsync are running on the same world.
+  If the world is updating, or it has only one thread, the mesh is built serially on the calling thread.
+  The resulting mesh is identical to the one built by ::NewtonTreeCollisionEndBuild.
+
+  See also: ::NewtonTreeCollisionEndBuild, ::NewtonWaitForUpdateToFinish, ::NewtonSetThreadsCount
+*/
+void NewtonTreeCollisionEndBuildParallel(const NewtonWorld* const newtonWorld, const NewtonCollision* const treeCollision, int optimize)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	dgCollisionBVH* const collision = (dgCollisionBVH*) ((dgCollisionInstance*)treeCollision)->GetChildShape();
+	dgAssert (collision->IsType (dgCollision::dgCollisionBVH_RTTI));
+
+	world->Sync ();
+	dgAssert (!world->IsInUpdate());
+	dgThreadHive* const threadPool = (!world->IsInUpdate() && (world->GetThreadCount() > 1)) ? world : NULL;
+	collision->EndBuild(optimize, threadPool);
+}
+
 
 /*!
   Get the user defined collision attributes stored with each face of the collision mesh.
@@ -3366,6 +3748,11 @@ void NewtonTreeCollisionSetFaceAttribute(const NewtonCollision* const treeCollis
 	dgCollisionBVH* const collision = (dgCollisionBVH*) ((dgCollisionInstance*)treeCollision)->GetChildShape();
 	dgAssert (collision->IsType (dgCollision::dgCollisionBVH_RTTI));
 
+	if (collision->IsMapped()) {
+		// the faces live in a read only image
+		dgAssert (0);
+		return;
+	}
 	collision->SetTagId (faceIndexArray, indexCount, dgUnsigned32 (attribute));
 }
 
@@ -3465,6 +3852,41 @@ int NewtonTreeCollisionGetVertexListTriangleListInAABB(const NewtonCollision* co
 	return (NewtonCollision*) collision;
 }
 
+/*!
+  Create a tiled height field collision geometry, for terrains too large to be resident.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param tileCountX number of tiles in the x direction.
+  @param tileCountZ number of tiles in the z direction.
+  @param tileSize number of cells per tile side, a power of two not smaller than 8.
+  @param gridsDiagonals cell diagonal construction mode, same as ::NewtonCreateHeightFieldCollision.
+  @param elevationdatType 0 for 32 bit float elevations, 1 for 16 bit unsigned elevations.
+  @param minElevation lowest elevation sample of all tiles.
+  @param maxElevation highest elevation sample of all tiles.
+  @param verticalScale scale of the elevation.
+  @param horizontalScale_x cell size in the x direction.
+  @param horizontalScale_z cell size in the z direction.
+  @param shapeID user shape id.
+
+  @return Pointer to the collision.
+
+  The collision is created with no resident tiles, cells in tiles that are not resident do not collide.
+  The elevation range defines the bounding box of the collision, so tiles can be streamed in and out 
+  without recreating the collision or reinserting the body in the broadphase.
+
+  See also: ::NewtonHeightFieldSetTile, ::NewtonHeightFieldSetTileLoadCallback
+*/
+NewtonCollision* NewtonCreateTiledHeightFieldCollision (const NewtonWorld* const newtonWorld, int tileCountX, int tileCountZ, int tileSize, int gridsDiagonals, int elevationdatType,
+														dFloat minElevation, dFloat maxElevation, dFloat verticalScale, dFloat horizontalScale_x, dFloat horizontalScale_z, int shapeID)
+{
+	Newton* const world = (Newton *)newtonWorld;
+
+	TRACE_FUNCTION(__FUNCTION__);
+	dgCollisionInstance* const collision = world->CreateTiledHeightField(tileCountX, tileCountZ, tileSize, gridsDiagonals, elevationdatType, dgFloat32 (minElevation), dgFloat32 (maxElevation), verticalScale, horizontalScale_x, horizontalScale_z);
+	collision->SetUserDataID(dgUnsigned32 (shapeID));
+	return (NewtonCollision*) collision;
+}
+
 
 
 /*!
@@ -4148,6 +4570,51 @@ NewtonCollision* NewtonCreateCollisionFromSerialization(const NewtonWorld* const
 	return  (NewtonCollision*) world->CreateCollisionFromSerialization ((dgDeserialize) deserializeFunction, serializeHandle);
 }
 
+/*!
+  Write the memory image of a static mesh collision.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param *collision is the pointer to a tree collision or a non tiled height field collision.
+  @param serializeFunction pointer to the event function that will receive the image bytes.
+  @param *serializeHandle user data that will be passed to the _NewtonSerialize_ callback.
+
+  @return the size in bytes of the image, zero if the shape does not have an image.
+
+  The image is written in the exact layout the collision uses at run time, so an image saved to a file can be memory mapped
+  and passed to *NewtonCreateCollisionFromImage* without any parsing or building.
+  Images are only valid on machines with the same endianness and the same floating point precision of the library that wrote them.
+
+  See also: ::NewtonCreateCollisionFromImage, ::NewtonCollisionSerialize
+*/
+int NewtonCollisionSerializeImage(const NewtonWorld* const newtonWorld, const NewtonCollision* const collision, NewtonSerializeCallback serializeFunction, void* const serializeHandle)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return world->SerializeCollisionImage((dgCollisionInstance*) collision, (dgSerialize) serializeFunction, serializeHandle);
+}
+
+/*!
+  Create a static mesh collision that uses a memory image in place.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param *image pointer to an image written by *NewtonCollisionSerializeImage*, must be aligned to 16 bytes.
+  @param sizeInBytes size of the memory block pointed by image.
+
+  @return the collision, or NULL if the image is not valid.
+
+  The collision does not copy the image, the application must keep the memory valid and unchanged until the collision is destroyed.
+  The image is never written, so a read only memory mapped file can be shared by many collisions, worlds and processes.
+  Face attributes of collisions created from an image can not be changed.
+
+  See also: ::NewtonCollisionSerializeImage, ::NewtonCreateCollisionFromSerialization
+*/
+NewtonCollision* NewtonCreateCollisionFromImage(const NewtonWorld* const newtonWorld, const void* const image, int sizeInBytes)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return (NewtonCollision*) world->CreateCollisionFromImage (image, sizeInBytes);
+}
+
 
 /*!
   Get creation parameters for this collision objects.
@@ -8529,6 +8996,15 @@ NewtonCollision* NewtonCreateMassSpringDamperSystem (const NewtonWorld* const ne
 	return (NewtonCollision*)world->CreateMassSpringDamperSystem (shapeID, pointCount, points, strideInBytes, pointMass, linksCount, links, linksSpring, linksDamper);
 }
 
+NewtonCollision* NewtonCreateIncompressibleParticles (const NewtonWorld* const newtonWorld, int shapeID,
+													  const dFloat* const points, int pointCount, int strideInBytes, 
+													  dFloat particleRadius, dFloat restDensity, dFloat viscosity)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return (NewtonCollision*)world->CreateIncompressibleParticles (shapeID, pointCount, points, strideInBytes, particleRadius, restDensity, viscosity);
+}
+
 int NewtonDeformableMeshGetParticleCount(const NewtonCollision* const deformableMesh)
 {
 	TRACE_FUNCTION(__FUNCTION__);
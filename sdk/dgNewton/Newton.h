@@ -73,6 +73,10 @@ extern "C" {
 	#define NEWTON_BROADPHASE_DEFAULT						0
 	#define NEWTON_BROADPHASE_PERSINTENT					1
 
+	#define NEWTON_PARALLEL_SOLVER_DISABLED					0
+	#define NEWTON_PARALLEL_SOLVER_JACOBI					1
+	#define NEWTON_PARALLEL_SOLVER_GRAPH_COLORING			2
+
 	#define NEWTON_DYNAMIC_BODY								0
 	#define NEWTON_KINEMATIC_BODY							1
 	#define NEWTON_DYNAMIC_ASYMETRIC_BODY					2
@@ -288,6 +292,54 @@ extern "C" {
 		const NewtonBody* m_hitBody;			// body hit at contact point
 		dFloat m_penetration;                   // contact penetration at collision point
 	} NewtonWorldConvexCastReturnInfo;
+
+	typedef struct NewtonWorldRayCastQuery
+	{
+		dFloat m_p0[4];							// ray origin in global space
+		dFloat m_p1[4];							// ray destination in global space
+		void* m_userData;						// user data passed to the filter and prefilter callbacks of this ray
+	} NewtonWorldRayCastQuery;
+
+	typedef struct NewtonWorldConvexCastQuery
+	{
+		dFloat m_matrix[16];					// shape matrix at the start of the cast
+		dFloat m_target[4];						// destination of the shape origin in global space
+		const NewtonCollision* m_shape;			// convex shape to be cast
+		void* m_userData;						// user data passed to the prefilter callback of this cast
+		NewtonWorldConvexCastReturnInfo* m_info;	// contact buffer, can be NULL if m_maxContacts is zero
+		int m_maxContacts;						// capacity of m_info
+		int m_contactCount;						// on return, number of contacts at the time of impact
+		dFloat m_param;							// on return, time of impact along the cast, larger than 1.0 if nothing was hit
+	} NewtonWorldConvexCastQuery;
+
+	typedef struct NewtonWorldStats
+	{
+		dFloat m_updateTime;					// whole update, in seconds
+		dFloat m_skeletonsTime;					// skeleton containers update
+		dFloat m_broadPhaseTime;				// force callbacks, pair finding and contact generation
+		dFloat m_forceAndTorqueTime;			// force and torque callbacks
+		dFloat m_collidingPairsTime;			// sleep states, broadphase tree update and pair finding
+		dFloat m_contactsTime;					// narrow phase contact generation
+		dFloat m_clustersTime;					// simulation islands build
+		dFloat m_solverTime;					// constraint solver and integration
+		dFloat m_transformsTime;				// transform callbacks
+		int m_substeps;							// substeps executed by the update
+		int m_threads;							// worker threads
+		int m_bodies;							// bodies in the world
+		int m_activeBodies;						// bodies in simulated islands
+		int m_pairsTested;						// broadphase pairs tested for overlap
+		int m_narrowPhasePairs;					// pairs sent to the narrow phase
+		int m_newContacts;						// contact joints created
+		int m_contacts;							// contact joints alive
+		int m_activeContacts;					// contact joints with contact points
+		int m_contactPoints;					// contact points in active contact joints
+		int m_islands;							// simulation islands
+		int m_parallelIslands;					// islands solved together by the parallel solver
+		int m_joints;							// joints in simulation islands, including contacts
+		int m_rows;								// jacobian rows
+		int m_solverIterations;					// solver passes executed by the slowest island, over all its integration steps
+		int m_stolenJobs;						// jobs run by a worker other than the one they were queued to
+	} NewtonWorldStats;
 	
 	typedef struct NewtonUserMeshCollisionRayHitDesc
 	{
@@ -398,6 +450,7 @@ extern "C" {
 
 	typedef dFloat (*NewtonCollisionTreeRayCastCallback) (const NewtonBody* const body, const NewtonCollision* const treeCollision, dFloat intersection, dFloat* const normal, int faceId, void* const usedData);
 	typedef dFloat (*NewtonHeightFieldRayCastCallback) (const NewtonBody* const body, const NewtonCollision* const heightFieldCollision, dFloat intersection, int row, int col, dFloat* const normal, int faceId, void* const usedData);
+	typedef int (*NewtonHeightFieldTileLoadCallback) (const NewtonCollision* const heightFieldCollision, int tileX, int tileZ, const void** const elevationMap, const char** const attributeMap, void* const userData);
 
 	typedef void (*NewtonCollisionCopyConstructionCallback) (const NewtonWorld* const newtonWorld, NewtonCollision* const collision, const NewtonCollision* const sourceCollision);
 	typedef void (*NewtonCollisionDestructorCallback) (const NewtonWorld* const newtonWorld, const NewtonCollision* const collision);
@@ -492,14 +545,23 @@ extern "C" {
 	NEWTON_API void NewtonUpdate (const NewtonWorld* const newtonWorld, dFloat timestep);
 	NEWTON_API void NewtonUpdateAsync (const NewtonWorld* const newtonWorld, dFloat timestep);
 	NEWTON_API void NewtonWaitForUpdateToFinish (const NewtonWorld* const newtonWorld);
+	NEWTON_API int NewtonGetPipelinedUpdate (const NewtonWorld* const newtonWorld);
+	NEWTON_API void NewtonSetPipelinedUpdate (const NewtonWorld* const newtonWorld, int state);
+	NEWTON_API int NewtonGetDeterministicMode (const NewtonWorld* const newtonWorld);
+	NEWTON_API void NewtonSetDeterministicMode (const NewtonWorld* const newtonWorld, int state);
 
 	NEWTON_API int NewtonGetNumberOfSubsteps (const NewtonWorld* const newtonWorld);
 	NEWTON_API void NewtonSetNumberOfSubsteps (const NewtonWorld* const newtonWorld, int subSteps);
 	NEWTON_API dFloat NewtonGetLastUpdateTime (const NewtonWorld* const newtonWorld);
+	NEWTON_API void NewtonWorldGetStats (const NewtonWorld* const newtonWorld, NewtonWorldStats* const stats);
 
 	NEWTON_API void NewtonSerializeToFile (const NewtonWorld* const newtonWorld, const char* const filename, NewtonOnBodySerializationCallback bodyCallback, void* const bodyUserData);
 	NEWTON_API void NewtonDeserializeFromFile (const NewtonWorld* const newtonWorld, const char* const filename, NewtonOnBodyDeserializationCallback bodyCallback, void* const bodyUserData);
 
+	NEWTON_API int NewtonWorldGetStateSizeInBytes (const NewtonWorld* const newtonWorld);
+	NEWTON_API int NewtonWorldSaveState (const NewtonWorld* const newtonWorld, void* const buffer, int bufferSizeInBytes);
+	NEWTON_API int NewtonWorldRestoreState (const NewtonWorld* const newtonWorld, const void* const buffer, int bufferSizeInBytes);
+
 	NEWTON_API void NewtonSerializeScene(const NewtonWorld* const newtonWorld, NewtonOnBodySerializationCallback bodyCallback, void* const bodyUserData,
 									   	 NewtonSerializeCallback serializeCallback, void* const serializeHandle);
 	NEWTON_API void NewtonDeserializeScene(const NewtonWorld* const newtonWorld, NewtonOnBodyDeserializationCallback bodyCallback, void* const bodyUserData,
@@ -553,6 +615,8 @@ extern "C" {
 	NEWTON_API void NewtonWorldRayCast (const NewtonWorld* const newtonWorld, const dFloat* const p0, const dFloat* const p1, NewtonWorldRayFilterCallback filter, void* const userData, NewtonWorldRayPrefilterCallback prefilter, int threadIndex);
 	NEWTON_API int NewtonWorldConvexCast (const NewtonWorld* const newtonWorld, const dFloat* const matrix, const dFloat* const target, const NewtonCollision* const shape, dFloat* const param, void* const userData, NewtonWorldRayPrefilterCallback prefilter, NewtonWorldConvexCastReturnInfo* const info, int maxContactsCount, int threadIndex);
 	NEWTON_API int NewtonWorldCollide (const NewtonWorld* const newtonWorld, const dFloat* const matrix, const NewtonCollision* const shape, void* const userData, NewtonWorldRayPrefilterCallback prefilter, NewtonWorldConvexCastReturnInfo* const info, int maxContactsCount, int threadIndex);
+	NEWTON_API void NewtonWorldRayCastBatch (const NewtonWorld* const newtonWorld, const NewtonWorldRayCastQuery* const queries, int count, NewtonWorldRayFilterCallback filter, NewtonWorldRayPrefilterCallback prefilter, int threadIndex);
+	NEWTON_API void NewtonWorldConvexCastBatch (const NewtonWorld* const newtonWorld, NewtonWorldConvexCastQuery* const queries, int count, NewtonWorldRayPrefilterCallback prefilter, int threadIndex);
 	
 	// world utility functions
 	NEWTON_API int NewtonWorldGetBodyCount(const NewtonWorld* const newtonWorld);
@@ -764,6 +828,8 @@ extern "C" {
 	// ***********************************************************************************************************
 	NEWTON_API NewtonCollision* NewtonCreateCollisionFromSerialization (const NewtonWorld* const newtonWorld, NewtonDeserializeCallback deserializeFunction, void* const serializeHandle);
 	NEWTON_API void NewtonCollisionSerialize (const NewtonWorld* const newtonWorld, const NewtonCollision* const collision, NewtonSerializeCallback serializeFunction, void* const serializeHandle);
+	NEWTON_API int NewtonCollisionSerializeImage (const NewtonWorld* const newtonWorld, const NewtonCollision* const collision, NewtonSerializeCallback serializeFunction, void* const serializeHandle);
+	NEWTON_API NewtonCollision* NewtonCreateCollisionFromImage (const NewtonWorld* const newtonWorld, const void* const image, int sizeInBytes);
 	NEWTON_API void NewtonCollisionGetInfo (const NewtonCollision* const collision, NewtonCollisionInfoRecord* const collisionInfo);
 
 	// **********************************************************************************************
@@ -775,6 +841,11 @@ extern "C" {
 	NEWTON_API void NewtonHeightFieldSetUserRayCastCallback (const NewtonCollision* const heightfieldCollision, NewtonHeightFieldRayCastCallback rayHitCallback);
 	NEWTON_API void NewtonHeightFieldSetHorizontalDisplacement (const NewtonCollision* const heightfieldCollision, const unsigned short* const horizontalMap, dFloat scale);
 
+	NEWTON_API NewtonCollision* NewtonCreateTiledHeightFieldCollision (const NewtonWorld* const newtonWorld, int tileCountX, int tileCountZ, int tileSize, int gridsDiagonals, int elevationdatType, dFloat minElevation, dFloat maxElevation, dFloat verticalScale, dFloat horizontalScale_x, dFloat horizontalScale_z, int shapeID);
+	NEWTON_API void NewtonHeightFieldSetTile (const NewtonCollision* const heightfieldCollision, int tileX, int tileZ, const void* const elevationMap, const char* const attributeMap);
+	NEWTON_API int NewtonHeightFieldIsTileResident (const NewtonCollision* const heightfieldCollision, int tileX, int tileZ);
+	NEWTON_API void NewtonHeightFieldSetTileLoadCallback (const NewtonCollision* const heightfieldCollision, NewtonHeightFieldTileLoadCallback callback, void* const userData);
+
 	NEWTON_API NewtonCollision* NewtonCreateTreeCollision (const NewtonWorld* const newtonWorld, int shapeID);
 	NEWTON_API NewtonCollision* NewtonCreateTreeCollisionFromMesh (const NewtonWorld* const newtonWorld, const NewtonMesh* const mesh, int shapeID);
 	NEWTON_API void NewtonTreeCollisionSetUserRayCastCallback (const NewtonCollision* const treeCollision, NewtonCollisionTreeRayCastCallback rayHitCallback);
@@ -782,6 +853,7 @@ extern "C" {
 	NEWTON_API void NewtonTreeCollisionBeginBuild (const NewtonCollision* const treeCollision);
 	NEWTON_API void NewtonTreeCollisionAddFace (const NewtonCollision* const treeCollision, int vertexCount, const dFloat* const vertexPtr, int strideInBytes, int faceAttribute);
 	NEWTON_API void NewtonTreeCollisionEndBuild (const NewtonCollision* const treeCollision, int optimize);
+	NEWTON_API void NewtonTreeCollisionEndBuildParallel (const NewtonWorld* const newtonWorld, const NewtonCollision* const treeCollision, int optimize);
 
 	NEWTON_API int NewtonTreeCollisionGetFaceAttribute (const NewtonCollision* const treeCollision, const int* const faceIndexArray, int indexCount); 
 	NEWTON_API void NewtonTreeCollisionSetFaceAttribute (const NewtonCollision* const treeCollision, const int* const faceIndexArray, int indexCount, int attribute);
@@ -1075,6 +1147,10 @@ extern "C" {
 																	const dFloat* const points, int pointCount, int strideInBytes, const dFloat* const pointMass, 
 																	const int* const links, int linksCount, const dFloat* const linksSpring, const dFloat* const linksDamper);
 
+	NEWTON_API NewtonCollision* NewtonCreateIncompressibleParticles (const NewtonWorld* const newtonWorld, int shapeID,
+																	 const dFloat* const points, int pointCount, int strideInBytes, 
+																	 dFloat particleRadius, dFloat restDensity, dFloat viscosity);
+
 	NEWTON_API NewtonCollision* NewtonCreateDeformableSolid(const NewtonWorld* const newtonWorld, const NewtonMesh* const mesh, int shapeID);
 
 	NEWTON_API int NewtonDeformableMeshGetParticleCount (const NewtonCollision* const deformableMesh); 
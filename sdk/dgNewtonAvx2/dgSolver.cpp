@@ -1140,6 +1140,7 @@ void dgSolver::CalculateForces()
 	const dgInt32 threadCounts = m_world->GetThreadCount();
 
 	InitSkeletons();
+	dgInt32 executedPasses = 0;
 	for (dgInt32 step = 0; step < 4; step++) {
 		CalculateJointsAcceleration();
 		dgFloat32 accNorm = DG_SOLVER_MAX_ERROR * dgFloat32(2.0f);
@@ -1149,10 +1150,12 @@ void dgSolver::CalculateForces()
 			for (dgInt32 i = 0; i < threadCounts; i++) {
 				accNorm = dgMax(accNorm, m_accelNorm[i]);
 			}
+			executedPasses ++;
 		}
 		UpdateSkeletons();
 		IntegrateBodiesVelocity();
 	}
+	m_world->ReportSolverPasses(executedPasses);
 
 	UpdateForceFeedback();
 
@@ -0,0 +1,258 @@
+/* Copyright (c) <2003-2016> <Julio Jerez, Newton Game Dynamics>
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "dgNewtonPluginStdafx.h"
+#include "dgWorldBase.h"
+
+
+// This is an example of an exported function.
+dgWorldPlugin* GetPlugin(dgWorld* const world, dgMemoryAllocator* const allocator)
+{
+#ifdef _WIN32
+	union cpuInfo
+	{
+		int m_data[4];
+		struct
+		{
+			int m_eax;
+			int m_ebx;
+			int m_ecx;
+			int m_edx;
+		};
+	} info;
+
+	__cpuid(info.m_data, 0);
+	if (info.m_eax < 7) {
+		return NULL;
+	}
+
+	// check for instruction set support (avx512f is bit 16 in reg ebx)
+	__cpuid(info.m_data, 7);
+	if (!(info.m_ebx & (1 << 16))) {
+		return NULL;
+	}
+
+	static dgWorldBase module(world, allocator);
+	module.m_score = 5;
+#ifdef _DEBUG
+	sprintf(module.m_hardwareDeviceName, "Newton avx512_d");
+#else
+	sprintf(module.m_hardwareDeviceName, "Newton avx512");
+#endif
+	return &module;
+#elif __linux__
+	if(__builtin_cpu_supports("avx512f")) {
+		static dgWorldBase module(world, allocator);
+		module.m_score = 5;
+#ifdef _DEBUG
+		sprintf(module.m_hardwareDeviceName, "Newton avx512_d");
+#else
+		sprintf(module.m_hardwareDeviceName, "Newton avx512");
+#endif
+		return &module;
+	} else {
+		return NULL;
+	}
+#elif defined (_MACOSX_VER)
+	return NULL;
+#endif
+}
+
+dgWorldBase::dgWorldBase(dgWorld* const world, dgMemoryAllocator* const allocator)
+	:dgWorldPlugin(world, allocator)
+	,dgSolver(world, allocator)
+{
+}
+
+dgWorldBase::~dgWorldBase()
+{
+}
+
+const char* dgWorldBase::GetId() const
+{
+	return m_hardwareDeviceName;
+}
+
+dgInt32 dgWorldBase::GetScore() const
+{
+	return m_score;
+}
+
+void dgWorldBase::CalculateJointForces(const dgBodyCluster& cluster, dgBodyInfo* const bodyArray, dgJointInfo* const jointArray, dgFloat32 timestep)
+{
+	dgSolver::CalculateJointForces(cluster, bodyArray, jointArray, timestep);
+}
+dgInt32 dgWorldBase::GetKernels() const
+{
+	return m_overlapKernel | m_primitiveContactKernel | m_integrateBodiesKernel;
+}
+
+void dgWorldBase::IntegrateBodies(dgBody** const bodyArray, dgInt32 count, dgFloat32 timestep) const
+{
+	dgSolver::IntegrateBodies(bodyArray, count, timestep);
+}
+
+dgUnsigned32 dgWorldBase::CalculateOverlaps(const dgVector* const minBox, const dgVector* const maxBox, const dgVector& boxP0, const dgVector& boxP1, dgInt32 count) const
+{
+	dgAssert(count <= DG_PLUGIN_OVERLAP_BATCH_SIZE);
+
+	// a box overlaps when the x, y and z lanes pass both tests, the w lane is ignored
+	dgUnsigned32 overlapMask = 0;
+#ifdef _NEWTON_USE_DOUBLE
+	const __m512d p0(_mm512_broadcast_f64x4(_mm256_loadu_pd(&boxP0.m_x)));
+	const __m512d p1(_mm512_broadcast_f64x4(_mm256_loadu_pd(&boxP1.m_x)));
+	for (dgInt32 i = 0; i < count; i += 2) {
+		const __mmask8 boxMask = ((count - i) > 1) ? 0xff : 0x0f;
+		const __m512d boxMin(_mm512_maskz_loadu_pd(boxMask, &minBox[i].m_x));
+		const __m512d boxMax(_mm512_maskz_loadu_pd(boxMask, &maxBox[i].m_x));
+		dgUnsigned32 mask = _mm512_mask_cmp_pd_mask(boxMask, boxMin, p1, _CMP_LT_OQ) & _mm512_mask_cmp_pd_mask(boxMask, boxMax, p0, _CMP_GT_OQ);
+		mask = mask & (mask >> 1) & (mask >> 2);
+		overlapMask |= ((mask & 0x01) | ((mask >> 3) & 0x02)) << i;
+	}
+#else
+	const __m512 p0(_mm512_broadcast_f32x4(_mm_loadu_ps(&boxP0.m_x)));
+	const __m512 p1(_mm512_broadcast_f32x4(_mm_loadu_ps(&boxP1.m_x)));
+	for (dgInt32 i = 0; i < count; i += 4) {
+		const dgInt32 boxes = dgMin(count - i, 4);
+		const __mmask16 boxMask = __mmask16((1 << (boxes * 4)) - 1);
+		const __m512 boxMin(_mm512_maskz_loadu_ps(boxMask, &minBox[i].m_x));
+		const __m512 boxMax(_mm512_maskz_loadu_ps(boxMask, &maxBox[i].m_x));
+		dgUnsigned32 mask = _mm512_mask_cmp_ps_mask(boxMask, boxMin, p1, _CMP_LT_OQ) & _mm512_mask_cmp_ps_mask(boxMask, boxMax, p0, _CMP_GT_OQ);
+		mask = mask & (mask >> 1) & (mask >> 2);
+		overlapMask |= ((mask & 0x01) | ((mask >> 3) & 0x02) | ((mask >> 6) & 0x04) | ((mask >> 9) & 0x08)) << i;
+	}
+#endif
+	return overlapMask;
+}
+
+bool dgWorldBase::CalculatePrimitiveContact(const dgPluginPrimitivePair& pair, dgPluginPrimitiveContact& contact) const
+{
+	if (pair.m_type0 == m_boxCollision) {
+		if (pair.m_type1 == m_sphereCollision) {
+			return CalculateBoxSphereContact(pair.m_matrix0, pair.m_size0, pair.m_matrix1.m_posit, pair.m_size1.m_x, contact);
+		}
+		// box to box and box to capsule need a contact patch, leave them to the contact solver
+		return false;
+	}
+
+	if (pair.m_type1 == m_boxCollision) {
+		if ((pair.m_type0 == m_sphereCollision) && CalculateBoxSphereContact(pair.m_matrix1, pair.m_size1, pair.m_matrix0.m_posit, pair.m_size0.m_x, contact)) {
+			dgSwap(contact.m_point0, contact.m_point1);
+			contact.m_normal = contact.m_normal * dgVector::m_negOne;
+			return true;
+		}
+		return false;
+	}
+
+	// spheres and capsules are segments with a radius, a sphere segment has zero length
+	const dgVector axis0(pair.m_matrix0.m_front.Scale((pair.m_type0 == m_capsuleCollision) ? pair.m_size0.m_y : dgFloat32(0.0f)));
+	const dgVector axis1(pair.m_matrix1.m_front.Scale((pair.m_type1 == m_capsuleCollision) ? pair.m_size1.m_y : dgFloat32(0.0f)));
+	const dgVector origin0(pair.m_matrix0.m_posit & dgVector::m_triplexMask);
+	const dgVector origin1(pair.m_matrix1.m_posit & dgVector::m_triplexMask);
+	return CalculateSegmentContact(origin0 - axis0, origin0 + axis0, pair.m_size0.m_x, origin1 - axis1, origin1 + axis1, pair.m_size1.m_x, contact);
+}
+
+bool dgWorldBase::CalculateSegmentContact(const dgVector& p0, const dgVector& p1, dgFloat32 radius0, const dgVector& q0, const dgVector& q1, dgFloat32 radius1, dgPluginPrimitiveContact& contact) const
+{
+	const dgFloat32 tol = dgFloat32(1.0e-12f);
+	const dgVector p10(p1 - p0);
+	const dgVector q10(q1 - q0);
+	const dgVector r(p0 - q0);
+	const dgFloat32 a = p10.DotProduct(p10).GetScalar();
+	const dgFloat32 e = q10.DotProduct(q10).GetScalar();
+	const dgFloat32 f = q10.DotProduct(r).GetScalar();
+
+	dgFloat32 s = dgFloat32(0.0f);
+	dgFloat32 t = dgFloat32(0.0f);
+	if (a <= tol) {
+		if (e > tol) {
+			t = dgClamp(f / e, dgFloat32(0.0f), dgFloat32(1.0f));
+		}
+	} else {
+		const dgFloat32 c = p10.DotProduct(r).GetScalar();
+		if (e <= tol) {
+			s = dgClamp(-c / a, dgFloat32(0.0f), dgFloat32(1.0f));
+		} else {
+			const dgFloat32 b = p10.DotProduct(q10).GetScalar();
+			if ((b * b) > (dgFloat32(0.998f * 0.998f) * a * e)) {
+				// parallel capsules need two contacts, leave them to the contact solver
+				return false;
+			}
+			s = dgClamp((b * f - c * e) / (a * e - b * b), dgFloat32(0.0f), dgFloat32(1.0f));
+			t = (b * s + f) / e;
+			if (t < dgFloat32(0.0f)) {
+				t = dgFloat32(0.0f);
+				s = dgClamp(-c / a, dgFloat32(0.0f), dgFloat32(1.0f));
+			} else if (t > dgFloat32(1.0f)) {
+				t = dgFloat32(1.0f);
+				s = dgClamp((b - c) / a, dgFloat32(0.0f), dgFloat32(1.0f));
+			}
+		}
+	}
+
+	const dgVector c0(p0 + p10.Scale(s));
+	const dgVector c1(q0 + q10.Scale(t));
+	const dgVector dir(c1 - c0);
+	const dgFloat32 dist2 = dir.DotProduct(dir).GetScalar();
+	if (dist2 < tol) {
+		return false;
+	}
+
+	contact.m_normal = dir.Scale(dgRsqrt(dist2));
+	contact.m_point0 = c0 + contact.m_normal.Scale(radius0);
+	contact.m_point1 = c1 - contact.m_normal.Scale(radius1);
+	return true;
+}
+
+bool dgWorldBase::CalculateBoxSphereContact(const dgMatrix& boxMatrix, const dgVector& boxSize, const dgVector& center, dgFloat32 radius, dgPluginPrimitiveContact& contact) const
+{
+	const dgVector localCenter(boxMatrix.UntransformVector(center) & dgVector::m_triplexMask);
+	const dgVector size(boxSize & dgVector::m_triplexMask);
+	const dgVector clipped(localCenter.GetMax(size * dgVector::m_negOne).GetMin(size));
+	const dgVector diff(localCenter - clipped);
+	const dgFloat32 dist2 = diff.DotProduct(diff).GetScalar();
+
+	dgVector normal;
+	dgVector point(clipped);
+	if (dist2 > dgFloat32(1.0e-12f)) {
+		normal = diff.Scale(dgRsqrt(dist2));
+	} else {
+		// the center is inside the box, push it out through the closest face
+		dgInt32 index = 0;
+		dgFloat32 minDist = dgFloat32(1.0e10f);
+		for (dgInt32 i = 0; i < 3; i++) {
+			const dgFloat32 dist = size[i] - dgAbs(localCenter[i]);
+			if (dist < minDist) {
+				index = i;
+				minDist = dist;
+			}
+		}
+		const dgFloat32 sign = (localCenter[index] >= dgFloat32(0.0f)) ? dgFloat32(1.0f) : dgFloat32(-1.0f);
+		normal = dgVector::m_zero;
+		normal[index] = sign;
+		point[index] = sign * size[index];
+	}
+
+	contact.m_normal = boxMatrix.RotateVector(normal);
+	contact.m_point0 = boxMatrix.TransformVector(point) & dgVector::m_triplexMask;
+	contact.m_point1 = (center & dgVector::m_triplexMask) - contact.m_normal.Scale(radius);
+	return true;
+}
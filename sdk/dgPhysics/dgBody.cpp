@@ -65,6 +65,7 @@ dgBody::dgBody()
 	,m_destructor(NULL)
 	,m_matrixUpdate(NULL)
 	,m_index(0)
+	,m_bodyArrayIndex(-1)
 	,m_uniqueID(0)
 	,m_bodyGroupId(0)
 	,m_rtti(m_baseBodyRTTI)
@@ -112,6 +113,7 @@ dgBody::dgBody (dgWorld* const world, const dgTree<const dgCollision*, dgInt32>*
 	,m_destructor(NULL)
 	,m_matrixUpdate(NULL)
 	,m_index(0)
+	,m_bodyArrayIndex(-1)
 	,m_uniqueID(0)
 	,m_bodyGroupId(0)
 	,m_rtti(m_baseBodyRTTI)
@@ -222,6 +224,8 @@ void dgBody::SetMatrix(const dgMatrix& matrix)
 
 	if (!m_inCallback) {
 		UpdateCollisionMatrix (dgFloat32 (0.0f), 0);
+	} else if (m_masterNode) {
+		m_world->UpdateBodyState(this);
 	}
 }
 
@@ -255,6 +259,11 @@ void dgBody::UpdateCollisionMatrix (dgFloat32 timestep, dgInt32 threadIndex)
 		dgMovingAABB (m_minAABB, m_maxAABB, predictiveVeloc, predictiveOmega, timestep, m_collision->GetBoxMaxRadius(), m_collision->GetBoxMinRadius());
 	}
 
+	if (m_masterNode) {
+		dgAssert (m_world);
+		m_world->UpdateBodyState(this);
+	}
+
 	if (m_broadPhaseNode) {
 		dgAssert (m_world);
 		if (!m_equilibrium) {
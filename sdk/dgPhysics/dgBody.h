@@ -304,6 +304,7 @@ class dgBody
 
 	dgSetInfo m_disjointInfo;
 	dgInt32 m_index;
+	dgInt32 m_bodyArrayIndex;
 	dgInt32 m_uniqueID;
 	dgInt32 m_bodyGroupId;
 	dgInt32 m_rtti;
@@ -132,7 +132,17 @@ void dgBodyMasterListRow::SortList()
 dgBodyMasterList::dgBodyMasterList (dgMemoryAllocator* const allocator)
 	:dgList<dgBodyMasterListRow>(allocator)
 	,m_disableBodies(allocator)
+	,m_bodyArray(allocator)
+	,m_bodyMatrix(allocator)
+	,m_bodyVeloc(allocator)
+	,m_bodyOmega(allocator)
+	,m_bodyMinAABB(allocator)
+	,m_bodyMaxAABB(allocator)
+	,m_bodyInvMass(allocator)
+	,m_bodyStateFlags(allocator)
+	,m_bodyArrayCount(0)
 	,m_constraintCount (0)
+	,m_bodyArrayIsDirty(true)
 {
 }
 
@@ -150,6 +160,7 @@ void dgBodyMasterList::AddBody (dgBody* const body)
 	if ((body->m_invMass.m_w == dgFloat32 (0.0f)) && (GetFirst() != node)) {
 		InsertAfter (GetFirst(), node);
 	}
+	m_bodyArrayIsDirty = true;
 }
 
 void dgBodyMasterList::RemoveBody (dgBody* const body)
@@ -162,6 +173,57 @@ void dgBodyMasterList::RemoveBody (dgBody* const body)
 
 	Remove (node);
 	body->m_masterNode = NULL;
+	body->m_bodyArrayIndex = -1;
+	m_bodyArrayIsDirty = true;
+}
+
+dgInt32 dgBodyMasterList::UpdateBodyArray()
+{
+	// dense mirror of the master list order, so that per step kernels can 
+	// iterate bodies in contiguous chunks instead of chasing list nodes.
+	// bodies added while a kernel is running are picked up on the next update
+	if (m_bodyArrayIsDirty) {
+		const dgInt32 count = GetCount();
+		m_bodyArray.ResizeIfNecessary(count);
+		m_bodyMatrix.ResizeIfNecessary(count);
+		m_bodyVeloc.ResizeIfNecessary(count);
+		m_bodyOmega.ResizeIfNecessary(count);
+		m_bodyMinAABB.ResizeIfNecessary(count);
+		m_bodyMaxAABB.ResizeIfNecessary(count);
+		m_bodyInvMass.ResizeIfNecessary(count);
+		m_bodyStateFlags.ResizeIfNecessary(count);
+		dgInt32 index = 0;
+		for (dgListNode* node = GetFirst(); node; node = node->GetNext()) {
+			dgBody* const body = node->GetInfo().GetBody();
+			m_bodyArray[index] = body;
+			body->m_bodyArrayIndex = index;
+			StoreBodyState(index, body);
+			index ++;
+		}
+		m_bodyArrayCount = index;
+		m_bodyArrayIsDirty = false;
+	}
+	return m_bodyArrayCount;
+}
+
+void dgBodyMasterList::StoreBodyState(dgInt32 index, const dgBody* const body)
+{
+	m_bodyMatrix[index] = body->m_matrix;
+	m_bodyVeloc[index] = body->m_veloc;
+	m_bodyOmega[index] = body->m_omega;
+	m_bodyMinAABB[index] = body->m_minAABB;
+	m_bodyMaxAABB[index] = body->m_maxAABB;
+	m_bodyInvMass[index] = body->m_invMass.m_w;
+	m_bodyStateFlags[index] = dgUnsigned8 ((body->m_equilibrium ? DG_BODY_STATE_EQUILIBRIUM : 0) | (body->m_sleeping ? DG_BODY_STATE_SLEEPING : 0) | (body->m_transformIsDirty ? DG_BODY_STATE_TRANSFORM_DIRTY : 0));
+}
+
+void dgBodyMasterList::UpdateBodyState(const dgBody* const body)
+{
+	// each body owns its row, so kernels can refresh rows from many threads at once
+	const dgInt32 index = body->m_bodyArrayIndex;
+	if (HasBodyState(index, body)) {
+		StoreBodyState(index, body);
+	}
 }
 
 dgBodyMasterListRow::dgListNode* dgBodyMasterList::FindConstraintLink (const dgBody* const body0, const dgBody* const body1) const
@@ -336,4 +398,5 @@ void dgBodyMasterList::SortMasterList()
 			InsertAfter (prev, entry);
 		}
 	}
+	m_bodyArrayIsDirty = true;
 }
@@ -22,6 +22,14 @@
 #ifndef __DGBODYMASTER_LIST__
 #define __DGBODYMASTER_LIST__
 
+// bodies per work item when per step kernels iterate the dense body array
+#define DG_BODY_ARRAY_CHUNK_SIZE	64
+
+// bits of the packed body state flags
+#define DG_BODY_STATE_EQUILIBRIUM		1
+#define DG_BODY_STATE_SLEEPING			2
+#define DG_BODY_STATE_TRANSFORM_DIRTY	4
+
 class dgBody;
 class dgContact;
 class dgConstraint;
@@ -77,9 +85,48 @@ class dgBodyMasterList: public dgList<dgBodyMasterListRow>
 	dgUnsigned32 MakeSortMask(const dgBody* const body) const;
 	void SortMasterList();
 
+	dgInt32 UpdateBodyArray();
+	dgInt32 GetBodyArrayCount() const;
+	dgBody* const* GetBodyArray() const;
+
+	bool HasBodyState(dgInt32 index, const dgBody* const body) const;
+	void UpdateBodyState(const dgBody* const body);
+
+	private:
+	void StoreBodyState(dgInt32 index, const dgBody* const body);
+
 	public:
 	dgTree<int, dgBody*> m_disableBodies;
+	dgArray<dgBody*> m_bodyArray;
+
+	// packed copy of the hot body state, indexed like m_bodyArray. dgBody stays the owner of the state, 
+	// the rows are refreshed when the array is rebuilt, after the force callbacks, and by the integration.
+	dgArray<dgMatrix> m_bodyMatrix;
+	dgArray<dgVector> m_bodyVeloc;
+	dgArray<dgVector> m_bodyOmega;
+	dgArray<dgVector> m_bodyMinAABB;
+	dgArray<dgVector> m_bodyMaxAABB;
+	dgArray<dgFloat32> m_bodyInvMass;
+	dgArray<dgUnsigned8> m_bodyStateFlags;
+	dgInt32 m_bodyArrayCount;
 	dgUnsigned32 m_constraintCount;
+	bool m_bodyArrayIsDirty;
 };
 
+DG_INLINE dgInt32 dgBodyMasterList::GetBodyArrayCount() const
+{
+	return m_bodyArrayCount;
+}
+
+DG_INLINE dgBody* const* dgBodyMasterList::GetBodyArray() const
+{
+	return &m_bodyArray[0];
+}
+
+DG_INLINE bool dgBodyMasterList::HasBodyState(dgInt32 index, const dgBody* const body) const
+{
+	// a body added or removed since the last rebuild has no valid row until the array is rebuilt
+	return !m_bodyArrayIsDirty && (index >= 0) && (index < m_bodyArrayCount) && (m_bodyArray[index] == body);
+}
+
 #endif
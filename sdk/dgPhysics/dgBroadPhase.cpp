@@ -40,6 +40,10 @@
 #define DG_CONTACT_ANGULAR_ERROR		(dgFloat32 (0.25f * dgDegreeToRad))
 #define DG_NARROW_PHASE_DIST			dgFloat32 (0.2f)
 #define DG_CONTACT_DELAY_FRAMES			4
+#define DG_BROADPHASE_SAH_BINS			16
+#define DG_BROADPHASE_SAH_MIN_BOXES		16
+#define DG_BROADPHASE_PARALLEL_BUILD	1024
+#define DG_BROADPHASE_QUERY_BATCH_CHUNK	16
 
 //#define DG_USE_OLD_SCANNER
 
@@ -144,6 +148,387 @@ class dgBroadPhase::dgSpliteInfo
 };
 
 
+class dgBroadPhase::dgBinnedSpliteInfo
+{
+	public:
+	dgBinnedSpliteInfo (dgBroadPhaseNode** const boxArray, dgInt32 boxCount)
+		:m_axis(0)
+	{
+		dgVector minP ( dgFloat32 (1.0e15f)); 
+		dgVector maxP (-dgFloat32 (1.0e15f)); 
+		dgVector minCenter ( dgFloat32 (1.0e15f)); 
+		dgVector maxCenter (-dgFloat32 (1.0e15f)); 
+		for (dgInt32 i = 0; i < boxCount; i ++) {
+			const dgBroadPhaseNode* const node = boxArray[i];
+			dgAssert (node->IsLeafNode());
+			dgVector p (dgVector::m_half * (node->m_minBox + node->m_maxBox));
+			minP = minP.GetMin (node->m_minBox); 
+			maxP = maxP.GetMax (node->m_maxBox); 
+			minCenter = minCenter.GetMin (p); 
+			maxCenter = maxCenter.GetMax (p); 
+		}
+		m_p0 = minP;
+		m_p1 = maxP;
+
+		// bin the box centers on all three axis at once
+		dgVector binMinBox[3][DG_BROADPHASE_SAH_BINS];
+		dgVector binMaxBox[3][DG_BROADPHASE_SAH_BINS];
+		dgInt32 binCount[3][DG_BROADPHASE_SAH_BINS];
+		for (dgInt32 j = 0; j < 3; j ++) {
+			for (dgInt32 i = 0; i < DG_BROADPHASE_SAH_BINS; i ++) {
+				binMinBox[j][i] = dgVector ( dgFloat32 (1.0e15f));
+				binMaxBox[j][i] = dgVector (-dgFloat32 (1.0e15f));
+				binCount[j][i] = 0;
+			}
+		}
+
+		const dgVector maxBin (dgFloat32 (DG_BROADPHASE_SAH_BINS - 1));
+		const dgVector extend ((maxCenter - minCenter) & dgVector::m_triplexMask);
+		const dgVector binScale (dgVector (dgFloat32 (DG_BROADPHASE_SAH_BINS) * dgFloat32 (0.999f)) * extend.GetMax(dgVector (dgFloat32 (1.0e-6f))).Reciproc());
+		for (dgInt32 i = 0; i < boxCount; i ++) {
+			const dgBroadPhaseNode* const node = boxArray[i];
+			dgVector p (dgVector::m_half * (node->m_minBox + node->m_maxBox));
+			dgVector bin (((p - minCenter) * binScale).GetMin(maxBin).GetMax(dgVector::m_zero).GetInt());
+			const dgInt32 index[] = {dgInt32 (bin.m_ix), dgInt32 (bin.m_iy), dgInt32 (bin.m_iz)};
+			for (dgInt32 j = 0; j < 3; j ++) {
+				const dgInt32 k = index[j];
+				binMinBox[j][k] = binMinBox[j][k].GetMin(node->m_minBox);
+				binMaxBox[j][k] = binMaxBox[j][k].GetMax(node->m_maxBox);
+				binCount[j][k] ++;
+			}
+		}
+
+		// sweep the bins and select the plane with the lowest surface area heuristic cost
+		dgInt32 bestAxis = -1;
+		dgInt32 bestBin = -1;
+		dgFloat32 bestCost = dgFloat32 (1.0e30f);
+		for (dgInt32 j = 0; j < 3; j ++) {
+			if (extend[j] < dgFloat32 (1.0e-6f)) {
+				continue;
+			}
+			dgFloat32 rightArea[DG_BROADPHASE_SAH_BINS];
+			dgInt32 rightCount[DG_BROADPHASE_SAH_BINS];
+			dgVector p0 ( dgFloat32 (1.0e15f));
+			dgVector p1 (-dgFloat32 (1.0e15f));
+			dgInt32 count = 0;
+			for (dgInt32 i = DG_BROADPHASE_SAH_BINS - 1; i > 0; i --) {
+				p0 = p0.GetMin(binMinBox[j][i]);
+				p1 = p1.GetMax(binMaxBox[j][i]);
+				count += binCount[j][i];
+				rightArea[i] = SurfaceArea (p0, p1, count);
+				rightCount[i] = count;
+			}
+
+			p0 = dgVector ( dgFloat32 (1.0e15f));
+			p1 = dgVector (-dgFloat32 (1.0e15f));
+			count = 0;
+			for (dgInt32 i = 0; i < DG_BROADPHASE_SAH_BINS - 1; i ++) {
+				p0 = p0.GetMin(binMinBox[j][i]);
+				p1 = p1.GetMax(binMaxBox[j][i]);
+				count += binCount[j][i];
+				if (count && rightCount[i + 1]) {
+					dgFloat32 cost = SurfaceArea (p0, p1, count) * dgFloat32 (count) + rightArea[i + 1] * dgFloat32 (rightCount[i + 1]);
+					if (cost < bestCost) {
+						bestCost = cost;
+						bestAxis = j;
+						bestBin = i;
+					}
+				}
+			}
+		}
+
+		if (bestAxis >= 0) {
+			const dgFloat32 origin = minCenter[bestAxis];
+			const dgFloat32 scale = binScale[bestAxis];
+			dgInt32 i0 = 0;
+			dgInt32 i1 = boxCount - 1;
+			while (i0 <= i1) {
+				const dgBroadPhaseNode* const node = boxArray[i0];
+				dgFloat32 center = dgFloat32 (0.5f) * (node->m_minBox[bestAxis] + node->m_maxBox[bestAxis]);
+				dgInt32 bin = dgClamp (dgInt32 ((center - origin) * scale), 0, DG_BROADPHASE_SAH_BINS - 1);
+				if (bin <= bestBin) {
+					i0 ++;
+				} else {
+					dgSwap (boxArray[i0], boxArray[i1]);
+					i1 --;
+				}
+			}
+			// the bin sweep guarantees both sides are not empty, but guard against rounding
+			m_axis = ((i0 > 0) && (i0 < boxCount)) ? i0 : 0;
+		}
+	}
+
+	static dgFloat32 SurfaceArea (const dgVector& p0, const dgVector& p1, dgInt32 count)
+	{
+		if (!count) {
+			return dgFloat32 (0.0f);
+		}
+		dgVector side0 (p1 - p0);
+		return side0.DotProduct(side0.ShiftTripleRight()).GetScalar();
+	}
+
+	dgInt32 m_axis;
+	dgVector m_p0;
+	dgVector m_p1;
+};
+
+class dgBroadPhase::dgTreeBuildDescriptor
+{
+	public:
+	class dgBuildJob
+	{
+		public:
+		dgBroadPhaseNode** m_slot;
+		dgBroadPhaseTreeNode* m_parent;
+		dgBroadPhaseTreeNode** m_nodeArray;
+		dgInt32 m_firstBox;
+		dgInt32 m_lastBox;
+	};
+
+	dgTreeBuildDescriptor(dgBroadPhase* const broadPhase, dgBroadPhaseNode** const leafArray, dgBuildJob* const jobs, dgInt32 jobsCapacity, dgInt32 minBoxesPerJob)
+		:m_broadPhase(broadPhase)
+		,m_leafArray(leafArray)
+		,m_jobs(jobs)
+		,m_jobsCapacity(jobsCapacity)
+		,m_atomicJobsCount(0)
+		,m_minBoxesPerJob(minBoxesPerJob)
+	{
+	}
+
+	dgBroadPhase* m_broadPhase;
+	dgBroadPhaseNode** m_leafArray;
+	dgBuildJob* m_jobs;
+	dgInt32 m_jobsCapacity;
+	dgInt32 m_atomicJobsCount;
+	dgInt32 m_minBoxesPerJob;
+};
+
+class dgBroadPhase::dgQueryBatchDescriptor
+{
+	public:
+	class dgSortKey
+	{
+		public:
+		dgUnsigned32 m_key;
+		dgInt32 m_index;
+	};
+
+	dgQueryBatchDescriptor(const dgBroadPhase* const broadPhase, dgSortKey* const sortKeys, dgInt32 count)
+		:m_broadPhase(broadPhase)
+		,m_rayQueries(NULL)
+		,m_castQueries(NULL)
+		,m_sortKeys(sortKeys)
+		,m_filter(NULL)
+		,m_prefilter(NULL)
+		,m_count(count)
+		,m_atomicIndex(0)
+	{
+	}
+
+	static dgInt32 CompareKeys(const dgSortKey* const keyA, const dgSortKey* const keyB, void* const context)
+	{
+		if (keyA->m_key < keyB->m_key) {
+			return -1;
+		} else if (keyA->m_key > keyB->m_key) {
+			return 1;
+		}
+		return 0;
+	}
+
+	static dgUnsigned32 SpreadBits(dgUnsigned32 x)
+	{
+		x &= 0x1ff;
+		x = (x | (x << 16)) & 0x030000ff;
+		x = (x | (x << 8)) & 0x0300f00f;
+		x = (x | (x << 4)) & 0x030c30c3;
+		x = (x | (x << 2)) & 0x09249249;
+		return x;
+	}
+
+	const dgBroadPhase* m_broadPhase;
+	const dgRayCastQuery* m_rayQueries;
+	dgConvexCastQuery* m_castQueries;
+	dgSortKey* m_sortKeys;
+	OnRayCastAction m_filter;
+	OnRayPrecastAction m_prefilter;
+	dgInt32 m_count;
+	dgInt32 m_atomicIndex;
+};
+
+dgBroadPhase::dgContactCache::dgContactCache (dgMemoryAllocator* const allocator)
+	:m_allocator(allocator)
+{
+	Init();
+}
+
+dgBroadPhase::dgContactCache::~dgContactCache ()
+{
+	FreeTables();
+}
+
+void dgBroadPhase::dgContactCache::Init()
+{
+	for (dgInt32 i = 0; i < DG_CONTACT_CACHE_SHARDS; i ++) {
+		dgShard& shard = m_shards[i];
+		shard.m_table = CreateTable(DG_CONTACT_CACHE_SHARD_SIZE);
+		shard.m_retired = NULL;
+		shard.m_lock = 0;
+	}
+}
+
+void dgBroadPhase::dgContactCache::FreeTables()
+{
+	ReleaseRetiredTables();
+	for (dgInt32 i = 0; i < DG_CONTACT_CACHE_SHARDS; i ++) {
+		dgFree (m_shards[i].m_table);
+		m_shards[i].m_table = NULL;
+	}
+}
+
+void dgBroadPhase::dgContactCache::Flush()
+{
+	FreeTables();
+	Init();
+}
+
+void dgBroadPhase::dgContactCache::ReleaseRetiredTables()
+{
+	// tables replaced by a grow may still be read by a concurrent lookup, 
+	// so they can only be released once no more pairs are been generated. 
+	for (dgInt32 i = 0; i < DG_CONTACT_CACHE_SHARDS; i ++) {
+		dgShard& shard = m_shards[i];
+		for (dgTable* table = shard.m_retired; table; ) {
+			dgTable* const next = table->m_retired;
+			dgFree (table);
+			table = next;
+		}
+		shard.m_retired = NULL;
+	}
+}
+
+dgBroadPhase::dgContactCache::dgTable* dgBroadPhase::dgContactCache::CreateTable(dgInt32 count) const
+{
+	dgAssert (!(count & (count - 1)));
+	const dgInt32 size = dgInt32 (sizeof (dgTable) + sizeof (dgEntry) * count + 16);
+	dgTable* const table = (dgTable*) dgMalloc(size_t (size), m_allocator);
+	table->m_entries = (dgEntry*) ((reinterpret_cast<uintptr_t>(table + 1) + 15) & -0x10);
+	table->m_retired = NULL;
+	table->m_mask = count - 1;
+	table->m_count = 0;
+	memset (table->m_entries, 0, sizeof (dgEntry) * count);
+	return table;
+}
+
+dgBroadPhase::dgContactCache::dgEntry* dgBroadPhase::dgContactCache::FindEntry(dgTable* const table, dgUnsigned64 key, dgUnsigned32 hash) const
+{
+	dgEntry* const entries = table->m_entries;
+	const dgUnsigned32 mask = dgUnsigned32 (table->m_mask);
+	for (dgUnsigned32 i = hash & mask; entries[i].m_tag; i = (i + 1) & mask) {
+		if (entries[i].m_tag == key) {
+			return &entries[i];
+		}
+	}
+	return NULL;
+}
+
+void dgBroadPhase::dgContactCache::InsertEntry(dgShard& shard, dgUnsigned64 key, dgUnsigned32 hash, dgContact* const joint)
+{
+	// the caller owns the shard lock
+	dgTable* table = shard.m_table;
+	if ((table->m_count + 1) * 2 > (table->m_mask + 1)) {
+		// keep the load factor under one half, only this shard is rehashed. 
+		// concurrent lookups may still be reading the old table, so it is retired instead of deleted.
+		dgTable* const newTable = CreateTable((table->m_mask + 1) * 2);
+		const dgUnsigned32 newMask = dgUnsigned32 (newTable->m_mask);
+		dgEntry* const newEntries = newTable->m_entries;
+		const dgEntry* const entries = table->m_entries;
+		for (dgInt32 i = 0; i <= table->m_mask; i ++) {
+			if (entries[i].m_tag) {
+				dgUnsigned32 j = GetHash(entries[i].m_tag) & newMask;
+				while (newEntries[j].m_tag) {
+					j = (j + 1) & newMask;
+				}
+				newEntries[j] = entries[i];
+			}
+		}
+		newTable->m_count = table->m_count;
+		table->m_retired = shard.m_retired;
+		shard.m_retired = table;
+		dgInterlockedExchange((void**)&shard.m_table, newTable);
+		table = newTable;
+	}
+
+	dgEntry* const entries = table->m_entries;
+	const dgUnsigned32 mask = dgUnsigned32 (table->m_mask);
+	dgUnsigned32 i = hash & mask;
+	while (entries[i].m_tag) {
+		i = (i + 1) & mask;
+	}
+	// the joint must be visible before the tag that makes the entry reachable
+	entries[i].m_contact = joint;
+	dgAtomicExchangeAndAdd(&table->m_count, 1);
+	entries[i].m_tag = key;
+}
+
+bool dgBroadPhase::dgContactCache::ReserveContactJoint(const dgBody* const body0, const dgBody* const body1)
+{
+	// claims the pair slot so that only one thread creates the joint, the joint is set later with AddContactJoint 
+	CacheEntryTag tag(body0->m_uniqueID, body1->m_uniqueID);
+	const dgUnsigned32 hash = GetHash(tag.m_tag);
+	dgShard& shard = m_shards[hash >> (32 - DG_CONTACT_CACHE_SHARDS_BITS)];
+
+	dgScopeSpinPause lock(&shard.m_lock);
+	if (FindEntry(shard.m_table, tag.m_tag, hash)) {
+		return false;
+	}
+	InsertEntry(shard, tag.m_tag, hash, NULL);
+	return true;
+}
+
+void dgBroadPhase::dgContactCache::AddContactJoint(dgContact* const joint)
+{
+	CacheEntryTag tag(joint->GetBody0()->m_uniqueID, joint->GetBody1()->m_uniqueID);
+	const dgUnsigned32 hash = GetHash(tag.m_tag);
+	dgShard& shard = m_shards[hash >> (32 - DG_CONTACT_CACHE_SHARDS_BITS)];
+
+	dgScopeSpinPause lock(&shard.m_lock);
+	dgEntry* const entry = FindEntry(shard.m_table, tag.m_tag, hash);
+	if (entry) {
+		dgAssert (!entry->m_contact || (entry->m_contact == joint));
+		entry->m_contact = joint;
+	} else {
+		InsertEntry(shard, tag.m_tag, hash, joint);
+	}
+}
+
+void dgBroadPhase::dgContactCache::RemoveContactJoint(dgContact* const joint)
+{
+	// only called from serial code, no lookup can be running on this shard
+	CacheEntryTag tag(joint->GetBody0()->m_uniqueID, joint->GetBody1()->m_uniqueID);
+	const dgUnsigned32 hash = GetHash(tag.m_tag);
+	dgShard& shard = m_shards[hash >> (32 - DG_CONTACT_CACHE_SHARDS_BITS)];
+
+	dgTable* const table = shard.m_table;
+	dgEntry* const entries = table->m_entries;
+	const dgUnsigned32 mask = dgUnsigned32 (table->m_mask);
+	dgEntry* const entry = FindEntry(table, tag.m_tag, hash);
+	if (entry) {
+		// backward shift deletion, move back the entries of the probe chain that can no longer be reached 
+		dgUnsigned32 i = dgUnsigned32 (entry - entries);
+		for (dgUnsigned32 j = (i + 1) & mask; entries[j].m_tag; j = (j + 1) & mask) {
+			const dgUnsigned32 k = GetHash(entries[j].m_tag) & mask;
+			const bool reachable = (i <= j) ? ((i < k) && (k <= j)) : ((i < k) || (k <= j));
+			if (!reachable) {
+				entries[i] = entries[j];
+				i = j;
+			}
+		}
+		entries[i].m_tag = 0;
+		entries[i].m_contact = NULL;
+		table->m_count --;
+	}
+}
+
 dgBroadPhase::dgBroadPhase(dgWorld* const world)
 	:m_world(world)
 	,m_rootNode(NULL)
@@ -155,6 +540,14 @@ dgBroadPhase::dgBroadPhase(dgWorld* const world)
 	,m_pendingSoftBodyCollisions(world->GetAllocator(), 64)
 	,m_pendingSoftBodyPairsCount(0)
 	,m_criticalSectionLock(0)
+	,m_queryNodes(world->GetAllocator())
+	,m_queryBodies(world->GetAllocator())
+	,m_queryNodesCount(0)
+	,m_queryBodiesCount(0)
+	,m_queryTreeLock(0)
+	,m_queryTreeReaders(0)
+	,m_queryTreeIsValid(0)
+	,m_queryTreeIsUsed(0)
 {
 }
 
@@ -225,6 +618,7 @@ dgBroadPhaseTreeNode* dgBroadPhase::InsertNode(dgBroadPhaseNode* const root, dgB
 		}
 	}
 
+	InvalidateQueryTree();
 	dgBroadPhaseTreeNode* const parent = new (m_world->GetAllocator()) dgBroadPhaseTreeNode(sibling, node);
 	return parent;
 }
@@ -244,7 +638,8 @@ void dgBroadPhase::ForceAndToqueKernel(void* const context, void* const node, dg
 	dgBroadphaseSyncDescriptor* const descriptor = (dgBroadphaseSyncDescriptor*)context;
 	dgWorld* const world = descriptor->m_world;
 	dgBroadPhase* const broadPhase = world->GetBroadPhase();
-	broadPhase->ApplyForceAndtorque(descriptor, (dgBodyMasterList::dgListNode*) node, threadID);
+	broadPhase->ApplyForceAndtorque(descriptor, threadID);
+	world->DispatchPendingTransforms(threadID);
 }
 
 void dgBroadPhase::SleepingStateKernel(void* const context, void* const node, dgInt32 threadID)
@@ -253,13 +648,11 @@ void dgBroadPhase::SleepingStateKernel(void* const context, void* const node, dg
 	dgBroadphaseSyncDescriptor* const descriptor = (dgBroadphaseSyncDescriptor*)context;
 	dgWorld* const world = descriptor->m_world;
 	dgBroadPhase* const broadPhase = world->GetBroadPhase();
-	broadPhase->SleepingState(descriptor, (dgBodyMasterList::dgListNode*) node, threadID);
+	broadPhase->SleepingState(descriptor, threadID);
 }
 
-bool dgBroadPhase::DoNeedUpdate(dgBodyMasterList::dgListNode* const node) const
+bool dgBroadPhase::DoNeedUpdate(dgBody* const body) const
 {
-	dgBody* const body = node->GetInfo().GetBody();
-
 	bool state = body->GetInvMass().m_w != dgFloat32 (0.0f);
 	state = state || !body->m_equilibrium || (body->GetExtForceAndTorqueCallback() != NULL);
 	return state;
@@ -277,98 +670,105 @@ void dgBroadPhase::UpdateAggregateEntropy (dgBroadphaseSyncDescriptor* const des
 	}
 }
 
-void dgBroadPhase::ApplyForceAndtorque(dgBroadphaseSyncDescriptor* const descriptor, dgBodyMasterList::dgListNode* node, dgInt32 threadID)
+void dgBroadPhase::ApplyForceAndtorque(dgBroadphaseSyncDescriptor* const descriptor, dgInt32 threadID)
 {
 	dgFloat32 timestep = descriptor->m_timestep;
 
-	const dgInt32 threadCount = m_world->GetThreadCount();
-	while (node) {
-		dgBody* const body = node->GetInfo().GetBody();
-		body->InitJointSet();
-		if (DoNeedUpdate(node)) {
-			if (body->IsRTTIType(dgBody::m_dynamicBodyRTTI)) {
-				dgDynamicBody* const dynamicBody = (dgDynamicBody*)body;
-				dynamicBody->ApplyExtenalForces(timestep, threadID);
+	// skip the sentinel body at index zero
+	dgBodyMasterList* const masterList = m_world;
+	dgBody* const* const bodyArray = masterList->GetBodyArray() + 1;
+	const dgInt32 bodyCount = masterList->GetBodyArrayCount() - 1;
+	dgInt32* const atomicIndex = &descriptor->m_atomicBodyIndex;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(atomicIndex, DG_BODY_ARRAY_CHUNK_SIZE); i < bodyCount; i = dgAtomicExchangeAndAdd(atomicIndex, DG_BODY_ARRAY_CHUNK_SIZE)) {
+		const dgInt32 count = dgMin (bodyCount - i, DG_BODY_ARRAY_CHUNK_SIZE);
+		for (dgInt32 j = 0; j < count; j ++) {
+			dgBody* const body = bodyArray[i + j];
+			body->InitJointSet();
+			if (DoNeedUpdate(body)) {
+				if (body->IsRTTIType(dgBody::m_dynamicBodyRTTI)) {
+					dgDynamicBody* const dynamicBody = (dgDynamicBody*)body;
+					dynamicBody->ApplyExtenalForces(timestep, threadID);
+				}
 			}
-		}
-
-		for (dgInt32 i = 0; i < threadCount; i++) {
-			node = node ? node->GetNext() : NULL;
+			// the force callback is the last place the application edits bodies before the step
+			masterList->UpdateBodyState(body);
 		}
 	}
 }
 
-void dgBroadPhase::SleepingState(dgBroadphaseSyncDescriptor* const descriptor, dgBodyMasterList::dgListNode* node, dgInt32 threadID)
+void dgBroadPhase::SleepingState(dgBroadphaseSyncDescriptor* const descriptor, dgInt32 threadID)
 {
 	DG_TRACKTIME();
 	dgFloat32 timestep = descriptor->m_timestep;
 
-	const dgInt32 threadCount = m_world->GetThreadCount();
 	dgBodyInfo* const pendingBodies = &m_world->m_bodiesMemory[0];
 
 	dgInt32* const atomicBodiesCount = &descriptor->m_atomicDynamicsCount;
 	dgInt32* const atomicPendingBodiesCount = &descriptor->m_atomicPendingBodiesCount;
 
-	while (node) {
-		if (DoNeedUpdate(node)) {
-			dgBody* const body = node->GetInfo().GetBody();
-
-			if (body->IsRTTIType(dgBody::m_dynamicBodyRTTI)) {
-				dgDynamicBody* const dynamicBody = (dgDynamicBody*)body;
-
-				if (!dynamicBody->m_equilibrium && (dynamicBody->GetInvMass().m_w == dgFloat32(0.0f))) {
-					descriptor->m_fullScan = true;
-				}
-				if (dynamicBody->GetInvMass().m_w) {
-					dgAtomicExchangeAndAdd(atomicBodiesCount, 1);
-				}
-
-				if (dynamicBody->GetInvMass().m_w == dgFloat32(0.0f) || body->m_collision->IsType(dgCollision::dgCollisionMesh_RTTI)) {
-					dynamicBody->m_sleeping = true;
-					dynamicBody->m_autoSleep = true;
-					dynamicBody->m_equilibrium = true;
-				}
+	dgBodyMasterList* const masterList = m_world;
+	dgBody* const* const bodyArray = masterList->GetBodyArray() + 1;
+	const dgInt32 bodyCount = masterList->GetBodyArrayCount() - 1;
+	dgInt32* const atomicIndex = &descriptor->m_atomicBodyIndex;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(atomicIndex, DG_BODY_ARRAY_CHUNK_SIZE); i < bodyCount; i = dgAtomicExchangeAndAdd(atomicIndex, DG_BODY_ARRAY_CHUNK_SIZE)) {
+		const dgInt32 count = dgMin (bodyCount - i, DG_BODY_ARRAY_CHUNK_SIZE);
+		for (dgInt32 j = 0; j < count; j ++) {
+			dgBody* const body = bodyArray[i + j];
+			if (DoNeedUpdate(body)) {
+				if (body->IsRTTIType(dgBody::m_dynamicBodyRTTI)) {
+					dgDynamicBody* const dynamicBody = (dgDynamicBody*)body;
+
+					if (!dynamicBody->m_equilibrium && (dynamicBody->GetInvMass().m_w == dgFloat32(0.0f))) {
+						descriptor->m_fullScan = true;
+					}
+					if (dynamicBody->GetInvMass().m_w) {
+						dgAtomicExchangeAndAdd(atomicBodiesCount, 1);
+					}
 
-				if (dynamicBody->IsInEquilibrium()) {
-					dynamicBody->m_equilibrium = true;
-					dynamicBody->m_sleeping = dynamicBody->m_autoSleep;
-				} else {
-					dynamicBody->m_sleeping = false;
-					dynamicBody->m_equilibrium = false;
-					if (dynamicBody->GetBroadPhase()) {
-						dynamicBody->UpdateCollisionMatrix(timestep, threadID);
-						dgInt32 pendingBodyIndex = dgAtomicExchangeAndAdd(atomicPendingBodiesCount, 1);
-						pendingBodies[pendingBodyIndex].m_body = dynamicBody;
+					if (dynamicBody->GetInvMass().m_w == dgFloat32(0.0f) || body->m_collision->IsType(dgCollision::dgCollisionMesh_RTTI)) {
+						dynamicBody->m_sleeping = true;
+						dynamicBody->m_autoSleep = true;
+						dynamicBody->m_equilibrium = true;
 					}
-				}
 
-				dynamicBody->m_savedExternalForce = dynamicBody->m_externalForce;
-				dynamicBody->m_savedExternalTorque = dynamicBody->m_externalTorque;
-			} else {
-				dgAssert(body->IsRTTIType(dgBody::m_kinematicBodyRTTI));
+					if (dynamicBody->IsInEquilibrium()) {
+						dynamicBody->m_equilibrium = true;
+						dynamicBody->m_sleeping = dynamicBody->m_autoSleep;
+					} else {
+						dynamicBody->m_sleeping = false;
+						dynamicBody->m_equilibrium = false;
+						if (dynamicBody->GetBroadPhase()) {
+							dynamicBody->UpdateCollisionMatrix(timestep, threadID);
+							dgInt32 pendingBodyIndex = dgAtomicExchangeAndAdd(atomicPendingBodiesCount, 1);
+							pendingBodies[pendingBodyIndex].m_body = dynamicBody;
+						}
+					}
 
-				// kinematic bodies are always sleeping (skip collision with kinematic bodies)
-				bool isResting = (body->m_omega.DotProduct(body->m_omega).GetScalar() < dgFloat32 (1.0e-6f)) && (body->m_veloc.DotProduct(body->m_veloc).GetScalar() < dgFloat32(1.0e-4f));
-				if (body->IsCollidable()) {
-					body->m_sleeping = false;
-					body->m_autoSleep = false;
+					dynamicBody->m_savedExternalForce = dynamicBody->m_externalForce;
+					dynamicBody->m_savedExternalTorque = dynamicBody->m_externalTorque;
 				} else {
-					body->m_autoSleep = true;
-					body->m_sleeping = isResting;
-					descriptor->m_fullScan = !isResting;
-				}
-				body->m_equilibrium = isResting;
+					dgAssert(body->IsRTTIType(dgBody::m_kinematicBodyRTTI));
+
+					// kinematic bodies are always sleeping (skip collision with kinematic bodies)
+					bool isResting = (body->m_omega.DotProduct(body->m_omega).GetScalar() < dgFloat32 (1.0e-6f)) && (body->m_veloc.DotProduct(body->m_veloc).GetScalar() < dgFloat32(1.0e-4f));
+					if (body->IsCollidable()) {
+						body->m_sleeping = false;
+						body->m_autoSleep = false;
+					} else {
+						body->m_autoSleep = true;
+						body->m_sleeping = isResting;
+						descriptor->m_fullScan = !isResting;
+					}
+					body->m_equilibrium = isResting;
 
-				// update collision matrix by calling the transform callback for all kinematic bodies
-				if (body->GetBroadPhase()) {
-					body->UpdateCollisionMatrix(timestep, threadID);
+					// update collision matrix by calling the transform callback for all kinematic bodies
+					if (body->GetBroadPhase()) {
+						body->UpdateCollisionMatrix(timestep, threadID);
+					}
 				}
+				masterList->UpdateBodyState(body);
 			}
 		}
-
-		for (dgInt32 i = 0; i < threadCount; i++) {
-			node = node ? node->GetNext() : NULL;
-		}
 	}
 }
 
@@ -675,29 +1075,565 @@ void dgBroadPhase::RayCast(const dgBroadPhaseNode** stackPool, dgFloat32* const
 						stackPool[j] = stackPool[j - 1];
 						distance[j] = distance[j - 1];
 					}
-					stackPool[j] = left;
-					distance[j] = dist1;
-					stack++;
-					dgAssert(stack < DG_BROADPHASE_MAX_STACK_DEPTH);
+					stackPool[j] = left;
+					distance[j] = dist1;
+					stack++;
+					dgAssert(stack < DG_BROADPHASE_MAX_STACK_DEPTH);
+				}
+
+				const dgBroadPhaseNode* const right = me->GetRight();
+				dgAssert(right);
+				dist1 = ray.BoxIntersect(right->m_minBox, right->m_maxBox);
+				if (dist1 < maxParam) {
+					dgInt32 j = stack;
+					for (; j && (dist1 > distance[j - 1]); j--) {
+						stackPool[j] = stackPool[j - 1];
+						distance[j] = distance[j - 1];
+					}
+					stackPool[j] = right;
+					distance[j] = dist1;
+					stack++;
+					dgAssert(stack < DG_BROADPHASE_MAX_STACK_DEPTH);
+				}
+			}
+		}
+	}
+}
+
+bool dgBroadPhase::UpdateQueryTree() const
+{
+	// the flat arrays are only rebuilt while no query is walking them, 
+	// a query that finds the tree stale and can not rebuild it traverses the node tree instead.
+	dgBroadPhase* const me = (dgBroadPhase*)this;
+	if (dgInterlockedExchange(&me->m_queryTreeLock, 1)) {
+		return false;
+	}
+	if (!m_queryTreeIsValid && !dgAtomicExchangeAndAdd(&me->m_queryTreeReaders, 0)) {
+		me->BuildQueryTree();
+		dgInterlockedExchange(&me->m_queryTreeIsValid, 1);
+	}
+	const bool isValid = m_queryTreeIsValid ? true : false;
+	dgInterlockedExchange(&me->m_queryTreeLock, 0);
+	return isValid;
+}
+
+bool dgBroadPhase::AcquireQueryTree() const
+{
+	// readers register before looking at the tree, so a rebuild never starts under them, 
+	// and a reader that sees a rebuild in progress backs off.
+	dgBroadPhase* const me = (dgBroadPhase*)this;
+	me->m_queryTreeIsUsed = 1;
+	for (dgInt32 pass = 0; pass < 2; pass ++) {
+		dgAtomicExchangeAndAdd(&me->m_queryTreeReaders, 1);
+		if (m_queryTreeIsValid && !dgAtomicExchangeAndAdd(&me->m_queryTreeLock, 0)) {
+			return true;
+		}
+		dgAtomicExchangeAndAdd(&me->m_queryTreeReaders, -1);
+
+		// the node tree is in flux during a world update, queries issued from callbacks do not rebuild
+		if (pass || m_world->m_inUpdate || !UpdateQueryTree()) {
+			break;
+		}
+	}
+	return false;
+}
+
+void dgBroadPhase::ReleaseQueryTree() const
+{
+	dgAssert(m_queryTreeReaders > 0);
+	dgAtomicExchangeAndAdd(&((dgBroadPhase*)this)->m_queryTreeReaders, -1);
+}
+
+void dgBroadPhase::BuildQueryTree()
+{
+	DG_TRACKTIME();
+	const dgBodyMasterList* const masterList = m_world;
+	const dgInt32 maxCount = masterList->GetCount() + 2;
+	m_queryNodes.ResizeIfNecessary(maxCount);
+	m_queryBodies.ResizeIfNecessary(maxCount);
+
+	m_queryNodesCount = 0;
+	m_queryBodiesCount = 0;
+	if (m_rootNode) {
+		BuildQueryNode(m_rootNode);
+	}
+	dgAssert(m_queryNodesCount <= maxCount);
+	dgAssert(m_queryBodiesCount <= maxCount);
+}
+
+dgInt32 dgBroadPhase::BuildQueryNode(const dgBroadPhaseNode* const node)
+{
+	// collapse the binary tree into a four wide tree by opening the children 
+	// with the largest surface area, aggregates are flattened transparently.
+	const dgBroadPhaseNode* children[4];
+	dgInt32 count = 0;
+	if (node->IsLeafNode()) {
+		children[0] = node;
+		count = 1;
+	} else {
+		children[0] = node->GetLeft();
+		children[1] = node->GetRight();
+		count = 2;
+	}
+
+	bool expand = true;
+	while (expand) {
+		expand = false;
+		for (dgInt32 i = count - 1; i >= 0; i--) {
+			const dgBroadPhaseNode* child = children[i];
+			while (child && child->IsAggregate()) {
+				child = ((dgBroadPhaseAggregate*)child)->m_root;
+			}
+			if (child) {
+				children[i] = child;
+			} else {
+				count--;
+				children[i] = children[count];
+			}
+		}
+
+		if (count < 4) {
+			dgInt32 index = -1;
+			dgFloat32 maxArea = dgFloat32(-1.0f);
+			for (dgInt32 i = 0; i < count; i++) {
+				if (!children[i]->IsLeafNode() && (children[i]->m_surfaceArea > maxArea)) {
+					index = i;
+					maxArea = children[i]->m_surfaceArea;
+				}
+			}
+			if (index >= 0) {
+				const dgBroadPhaseNode* const child = children[index];
+				children[index] = child->GetLeft();
+				children[count] = child->GetRight();
+				count++;
+				expand = true;
+			}
+		}
+	}
+
+	const dgInt32 nodeIndex = m_queryNodesCount;
+	m_queryNodesCount++;
+
+	dgInt32 childIndex[4];
+	for (dgInt32 i = 0; i < count; i++) {
+		const dgBroadPhaseNode* const child = children[i];
+		if (child->IsLeafNode()) {
+			dgAssert(child->GetBody());
+			m_queryBodies[m_queryBodiesCount] = child->GetBody();
+			m_queryBodiesCount++;
+			childIndex[i] = -m_queryBodiesCount;
+		} else {
+			childIndex[i] = BuildQueryNode(child);
+		}
+	}
+
+	dgQueryNode* const queryNode = &m_queryNodes[nodeIndex];
+	queryNode->m_minX = dgVector::m_zero;
+	queryNode->m_minY = dgVector::m_zero;
+	queryNode->m_minZ = dgVector::m_zero;
+	queryNode->m_maxX = dgVector::m_zero;
+	queryNode->m_maxY = dgVector::m_zero;
+	queryNode->m_maxZ = dgVector::m_zero;
+	queryNode->m_count = count;
+	for (dgInt32 i = 0; i < 4; i++) {
+		queryNode->m_child[i] = 0;
+	}
+	for (dgInt32 i = 0; i < count; i++) {
+		const dgBroadPhaseNode* const child = children[i];
+		queryNode->m_minX[i] = child->m_minBox.m_x;
+		queryNode->m_minY[i] = child->m_minBox.m_y;
+		queryNode->m_minZ[i] = child->m_minBox.m_z;
+		queryNode->m_maxX[i] = child->m_maxBox.m_x;
+		queryNode->m_maxY[i] = child->m_maxBox.m_y;
+		queryNode->m_maxZ[i] = child->m_maxBox.m_z;
+		queryNode->m_child[i] = childIndex[i];
+	}
+	return nodeIndex;
+}
+
+void dgBroadPhase::QueryTreeForEachBodyInAABB(const dgVector& minBox, const dgVector& maxBox, OnBodiesInAABB callback, void* const userData) const
+{
+	if (m_queryNodesCount) {
+		const dgQueryNode* const nodes = &m_queryNodes[0];
+		dgBody* const* const bodies = &m_queryBodies[0];
+
+		dgInt32 stackPool[DG_BROADPHASE_QUERY_STACK_DEPTH];
+		stackPool[0] = 0;
+		dgInt32 stack = 1;
+		while (stack) {
+			stack--;
+			const dgQueryNode* const node = &nodes[stackPool[stack]];
+			for (dgInt32 mask = node->OverlapMask(minBox, maxBox), i = 0; mask; mask >>= 1, i++) {
+				if (mask & 1) {
+					const dgInt32 child = node->m_child[i];
+					if (child >= 0) {
+						stackPool[stack] = child;
+						stack++;
+						dgAssert(stack < DG_BROADPHASE_QUERY_STACK_DEPTH);
+					} else {
+						dgBody* const body = bodies[-child - 1];
+						if (dgOverlapTest(body->m_minAABB, body->m_maxAABB, minBox, maxBox)) {
+							if (!callback(body, userData)) {
+								return;
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+void dgBroadPhase::QueryTreeRayCast(const dgVector& l0, const dgVector& l1, OnRayCastAction filter, OnRayPrecastAction prefilter, void* const userData) const
+{
+	if (m_queryNodesCount) {
+		const dgQueryNode* const nodes = &m_queryNodes[0];
+		dgBody* const* const bodies = &m_queryBodies[0];
+
+		dgLineBox line;
+		line.m_l0 = l0;
+		line.m_l1 = l1;
+		dgVector test(line.m_l0 <= line.m_l1);
+		line.m_boxL0 = line.m_l1.Select(line.m_l0, test);
+		line.m_boxL1 = line.m_l0.Select(line.m_l1, test);
+
+		dgFastRayTest ray(l0, l1);
+		dgFloat32 maxParam = dgFloat32(1.2f);
+
+		dgFloat32 distance[DG_BROADPHASE_QUERY_STACK_DEPTH];
+		dgInt32 stackPool[DG_BROADPHASE_QUERY_STACK_DEPTH];
+		stackPool[0] = 0;
+		distance[0] = dgFloat32(0.0f);
+		dgInt32 stack = 1;
+		while (stack) {
+			stack--;
+			if (distance[stack] > maxParam) {
+				break;
+			}
+			const dgInt32 entry = stackPool[stack];
+			if (entry < 0) {
+				dgBody* const body = bodies[-entry - 1];
+				dgFloat32 param = body->RayCast(line, filter, prefilter, userData, maxParam);
+				if (param < maxParam) {
+					maxParam = param;
+					if (maxParam < dgFloat32(1.0e-8f)) {
+						break;
+					}
+				}
+			} else {
+				const dgQueryNode* const node = &nodes[entry];
+				const dgVector dist(node->RayDistance(ray, dgVector::m_zero, dgVector::m_zero));
+				for (dgInt32 i = 0; i < node->m_count; i++) {
+					const dgFloat32 dist1 = dist[i];
+					if (dist1 < maxParam) {
+						dgInt32 j = stack;
+						for (; j && (dist1 > distance[j - 1]); j--) {
+							stackPool[j] = stackPool[j - 1];
+							distance[j] = distance[j - 1];
+						}
+						stackPool[j] = node->m_child[i];
+						distance[j] = dist1;
+						stack++;
+						dgAssert(stack < DG_BROADPHASE_QUERY_STACK_DEPTH);
+					}
+				}
+			}
+		}
+	}
+}
+
+dgInt32 dgBroadPhase::QueryTreeConvexCast(dgCollisionInstance* const shape, const dgMatrix& matrix, const dgVector& target, dgFloat32* const param, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const
+{
+	dgVector boxP0;
+	dgVector boxP1;
+	dgTriplex points[DG_CONVEX_CAST_POOLSIZE];
+	dgTriplex normals[DG_CONVEX_CAST_POOLSIZE];
+	dgFloat32 penetration[DG_CONVEX_CAST_POOLSIZE];
+	dgInt64 attributeA[DG_CONVEX_CAST_POOLSIZE];
+	dgInt64 attributeB[DG_CONVEX_CAST_POOLSIZE];
+	dgInt32 totalCount = 0;
+
+	*param = dgFloat32(1.0f);
+	if (m_queryNodesCount) {
+		const dgQueryNode* const nodes = &m_queryNodes[0];
+		dgBody* const* const bodies = &m_queryBodies[0];
+
+		dgAssert(matrix.TestOrthogonal());
+		shape->CalcAABB(matrix, boxP0, boxP1);
+
+		dgVector velocA((target - matrix.m_posit) & dgVector::m_triplexMask);
+		dgVector velocB(dgFloat32(0.0f));
+		dgFastRayTest ray(dgVector(dgFloat32(0.0f)), velocA);
+
+		maxContacts = dgMin(maxContacts, DG_CONVEX_CAST_POOLSIZE);
+		dgAssert(!maxContacts || (maxContacts && info));
+		dgFloat32 maxParam = *param;
+		dgFloat32 timeToImpact = *param;
+
+		dgFloat32 distance[DG_BROADPHASE_QUERY_STACK_DEPTH];
+		dgInt32 stackPool[DG_BROADPHASE_QUERY_STACK_DEPTH];
+		stackPool[0] = 0;
+		distance[0] = dgFloat32(0.0f);
+		dgInt32 stack = 1;
+		while (stack) {
+			stack--;
+			if (distance[stack] > maxParam) {
+				break;
+			}
+			const dgInt32 entry = stackPool[stack];
+			if (entry < 0) {
+				dgBody* const body = bodies[-entry - 1];
+				if (!PREFILTER_RAYCAST(prefilter, body, body->m_collision, userData)) {
+					dgInt32 count = m_world->CollideContinue(shape, matrix, velocA, velocB, body->m_collision, body->m_matrix, velocB, velocB, timeToImpact, points, normals, penetration, attributeA, attributeB, maxContacts, threadIndex);
+
+					if (timeToImpact < maxParam) {
+						if ((timeToImpact - maxParam) < dgFloat32(-1.0e-3f)) {
+							totalCount = 0;
+						}
+						maxParam = timeToImpact;
+						if (count >= (maxContacts - totalCount)) {
+							count = maxContacts - totalCount;
+						}
+
+						for (dgInt32 i = 0; i < count; i++) {
+							info[totalCount].m_point[0] = points[i].m_x;
+							info[totalCount].m_point[1] = points[i].m_y;
+							info[totalCount].m_point[2] = points[i].m_z;
+							info[totalCount].m_point[3] = dgFloat32(0.0f);
+							info[totalCount].m_normal[0] = normals[i].m_x;
+							info[totalCount].m_normal[1] = normals[i].m_y;
+							info[totalCount].m_normal[2] = normals[i].m_z;
+							info[totalCount].m_normal[3] = dgFloat32(0.0f);
+							info[totalCount].m_penetration = penetration[i];
+							info[totalCount].m_contaID = attributeB[i];
+							info[totalCount].m_hitBody = body;
+							totalCount++;
+						}
+					}
+					if (maxParam < 1.0e-8f) {
+						break;
+					}
+				}
+			} else {
+				const dgQueryNode* const node = &nodes[entry];
+				const dgVector dist(node->RayDistance(ray, boxP0, boxP1));
+				for (dgInt32 i = 0; i < node->m_count; i++) {
+					const dgFloat32 dist1 = dist[i];
+					if (dist1 < maxParam) {
+						dgInt32 j = stack;
+						for (; j && (dist1 > distance[j - 1]); j--) {
+							stackPool[j] = stackPool[j - 1];
+							distance[j] = distance[j - 1];
+						}
+						stackPool[j] = node->m_child[i];
+						distance[j] = dist1;
+						stack++;
+						dgAssert(stack < DG_BROADPHASE_QUERY_STACK_DEPTH);
+					}
 				}
+			}
+		}
+		*param = maxParam;
+	}
+	return totalCount;
+}
 
-				const dgBroadPhaseNode* const right = me->GetRight();
-				dgAssert(right);
-				dist1 = ray.BoxIntersect(right->m_minBox, right->m_maxBox);
-				if (dist1 < maxParam) {
-					dgInt32 j = stack;
-					for (; j && (dist1 > distance[j - 1]); j--) {
-						stackPool[j] = stackPool[j - 1];
-						distance[j] = distance[j - 1];
+dgInt32 dgBroadPhase::QueryTreeCollide(dgCollisionInstance* const shape, const dgMatrix& matrix, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const
+{
+	dgTriplex points[DG_CONVEX_CAST_POOLSIZE];
+	dgTriplex normals[DG_CONVEX_CAST_POOLSIZE];
+	dgFloat32 penetration[DG_CONVEX_CAST_POOLSIZE];
+	dgInt64 attributeA[DG_CONVEX_CAST_POOLSIZE];
+	dgInt64 attributeB[DG_CONVEX_CAST_POOLSIZE];
+
+	dgInt32 totalCount = 0;
+	if (m_queryNodesCount) {
+		const dgQueryNode* const nodes = &m_queryNodes[0];
+		dgBody* const* const bodies = &m_queryBodies[0];
+
+		dgVector boxP0;
+		dgVector boxP1;
+		dgAssert(matrix.TestOrthogonal());
+		shape->CalcAABB(shape->GetLocalMatrix() * matrix, boxP0, boxP1);
+
+		dgInt32 stackPool[DG_BROADPHASE_QUERY_STACK_DEPTH];
+		stackPool[0] = 0;
+		dgInt32 stack = 1;
+		while (stack) {
+			stack--;
+			const dgQueryNode* const node = &nodes[stackPool[stack]];
+			for (dgInt32 mask = node->OverlapMask(boxP0, boxP1), i = 0; mask; mask >>= 1, i++) {
+				if (mask & 1) {
+					const dgInt32 child = node->m_child[i];
+					if (child >= 0) {
+						stackPool[stack] = child;
+						stack++;
+						dgAssert(stack < DG_BROADPHASE_QUERY_STACK_DEPTH);
+					} else {
+						dgBody* const body = bodies[-child - 1];
+						if (!PREFILTER_RAYCAST(prefilter, body, body->m_collision, userData)) {
+							dgInt32 count = m_world->Collide(shape, matrix, body->m_collision, body->m_matrix, points, normals, penetration, attributeA, attributeB, DG_CONVEX_CAST_POOLSIZE, threadIndex);
+							if (count) {
+								bool teminate = false;
+								if (count >= (maxContacts - totalCount)) {
+									count = maxContacts - totalCount;
+									teminate = true;
+								}
+
+								for (dgInt32 j = 0; j < count; j++) {
+									info[totalCount].m_point[0] = points[j].m_x;
+									info[totalCount].m_point[1] = points[j].m_y;
+									info[totalCount].m_point[2] = points[j].m_z;
+									info[totalCount].m_point[3] = dgFloat32(0.0f);
+									info[totalCount].m_normal[0] = normals[j].m_x;
+									info[totalCount].m_normal[1] = normals[j].m_y;
+									info[totalCount].m_normal[2] = normals[j].m_z;
+									info[totalCount].m_normal[3] = dgFloat32(0.0f);
+									info[totalCount].m_penetration = penetration[j];
+									info[totalCount].m_contaID = attributeB[j];
+									info[totalCount].m_hitBody = body;
+									totalCount++;
+								}
+
+								if (teminate) {
+									return totalCount;
+								}
+							}
+						}
 					}
-					stackPool[j] = right;
-					distance[j] = dist1;
-					stack++;
-					dgAssert(stack < DG_BROADPHASE_MAX_STACK_DEPTH);
 				}
 			}
 		}
 	}
+	return totalCount;
+}
+
+void dgBroadPhase::SortQueryBatch(dgQueryBatchDescriptor* const descriptor, const dgVector* const origin, const dgVector* const direction) const
+{
+	// sort the queries along a morton curve of their origins, grouped by direction octant, 
+	// so that consecutive queries visit mostly the same tree nodes.
+	const dgInt32 count = descriptor->m_count;
+	dgVector minBox(origin[0]);
+	dgVector maxBox(origin[0]);
+	for (dgInt32 i = 1; i < count; i++) {
+		minBox = minBox.GetMin(origin[i]);
+		maxBox = maxBox.GetMax(origin[i]);
+	}
+
+	dgVector size((maxBox - minBox) & dgVector::m_triplexMask);
+	size = size.GetMax(dgVector(dgFloat32(1.0e-3f)));
+	const dgVector scale(dgVector(dgFloat32(511.0f)) * size.Reciproc());
+
+	dgQueryBatchDescriptor::dgSortKey* const keys = descriptor->m_sortKeys;
+	for (dgInt32 i = 0; i < count; i++) {
+		const dgVector p((origin[i] - minBox) * scale);
+		const dgUnsigned32 x = dgUnsigned32(dgClamp(dgInt32(p.m_x), 0, 511));
+		const dgUnsigned32 y = dgUnsigned32(dgClamp(dgInt32(p.m_y), 0, 511));
+		const dgUnsigned32 z = dgUnsigned32(dgClamp(dgInt32(p.m_z), 0, 511));
+		const dgUnsigned32 octant = direction[i].GetSignMask() & 0x07;
+		keys[i].m_key = (octant << 27) | dgQueryBatchDescriptor::SpreadBits(x) | (dgQueryBatchDescriptor::SpreadBits(y) << 1) | (dgQueryBatchDescriptor::SpreadBits(z) << 2);
+		keys[i].m_index = i;
+	}
+	dgSort(keys, count, dgQueryBatchDescriptor::CompareKeys);
+}
+
+void dgBroadPhase::RunQueryBatch(dgQueryBatchDescriptor* const descriptor, dgWorkerThreadTaskCallback kernel, dgInt32 threadIndex) const
+{
+	const dgInt32 threadsCount = m_world->GetThreadCount();
+	if ((threadIndex < 0) && (threadsCount > 1) && (descriptor->m_count > DG_BROADPHASE_QUERY_BATCH_CHUNK)) {
+		// fanning out to the worker threads is only legal outside a world update
+		dgAssert(!m_world->m_inUpdate);
+		m_world->Sync();
+		UpdateQueryTree();
+		m_world->BeginSection();
+		for (dgInt32 i = 0; i < threadsCount; i++) {
+			m_world->QueueStealableJob(kernel, descriptor, NULL, "dgBroadPhase::QueryBatch");
+		}
+		m_world->SynchronizationBarrier();
+		m_world->EndSection();
+	} else {
+		kernel(descriptor, NULL, dgMax(threadIndex, 0));
+	}
+}
+
+void dgBroadPhase::RayCastBatchKernel(void* const context, void* const, dgInt32 threadID)
+{
+	DG_TRACKTIME();
+	dgQueryBatchDescriptor* const descriptor = (dgQueryBatchDescriptor*)context;
+	const dgBroadPhase* const broadPhase = descriptor->m_broadPhase;
+	const dgQueryBatchDescriptor::dgSortKey* const keys = descriptor->m_sortKeys;
+	const dgInt32 count = descriptor->m_count;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_BROADPHASE_QUERY_BATCH_CHUNK); i < count; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_BROADPHASE_QUERY_BATCH_CHUNK)) {
+		const dgInt32 end = dgMin(i + DG_BROADPHASE_QUERY_BATCH_CHUNK, count);
+		for (dgInt32 j = i; j < end; j++) {
+			const dgRayCastQuery& query = descriptor->m_rayQueries[keys[j].m_index];
+			const dgVector p0(query.m_p0[0], query.m_p0[1], query.m_p0[2], dgFloat32(0.0f));
+			const dgVector p1(query.m_p1[0], query.m_p1[1], query.m_p1[2], dgFloat32(0.0f));
+			broadPhase->RayCast(p0, p1, descriptor->m_filter, descriptor->m_prefilter, query.m_userData);
+		}
+	}
+}
+
+void dgBroadPhase::ConvexCastBatchKernel(void* const context, void* const, dgInt32 threadID)
+{
+	DG_TRACKTIME();
+	dgQueryBatchDescriptor* const descriptor = (dgQueryBatchDescriptor*)context;
+	const dgBroadPhase* const broadPhase = descriptor->m_broadPhase;
+	const dgQueryBatchDescriptor::dgSortKey* const keys = descriptor->m_sortKeys;
+	const dgInt32 count = descriptor->m_count;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_BROADPHASE_QUERY_BATCH_CHUNK); i < count; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_BROADPHASE_QUERY_BATCH_CHUNK)) {
+		const dgInt32 end = dgMin(i + DG_BROADPHASE_QUERY_BATCH_CHUNK, count);
+		for (dgInt32 j = i; j < end; j++) {
+			dgConvexCastQuery& query = descriptor->m_castQueries[keys[j].m_index];
+			const dgMatrix matrix(query.m_matrix);
+			const dgVector target(query.m_target[0], query.m_target[1], query.m_target[2], dgFloat32(0.0f));
+			// the cast leaves the parameter at 1.0 when nothing is hit, report the miss past the end of the cast
+			dgFloat32 param;
+			query.m_contactCount = broadPhase->ConvexCast(query.m_shape, matrix, target, &param, descriptor->m_prefilter, query.m_userData, query.m_info, query.m_maxContacts, threadID);
+			query.m_param = (param < dgFloat32(1.0f)) ? param : dgFloat32(1.2f);
+		}
+	}
+}
+
+void dgBroadPhase::RayCastBatch(const dgRayCastQuery* const queries, dgInt32 count, OnRayCastAction filter, OnRayPrecastAction prefilter, dgInt32 threadIndex) const
+{
+	if (filter && (count > 0)) {
+		dgStack<dgVector> origin(count);
+		dgStack<dgVector> direction(count);
+		for (dgInt32 i = 0; i < count; i++) {
+			origin[i] = dgVector(queries[i].m_p0[0], queries[i].m_p0[1], queries[i].m_p0[2], dgFloat32(0.0f));
+			direction[i] = dgVector(queries[i].m_p1[0], queries[i].m_p1[1], queries[i].m_p1[2], dgFloat32(0.0f)) - origin[i];
+		}
+
+		dgStack<dgQueryBatchDescriptor::dgSortKey> sortKeys(count);
+		dgQueryBatchDescriptor descriptor(this, &sortKeys[0], count);
+		descriptor.m_rayQueries = queries;
+		descriptor.m_filter = filter;
+		descriptor.m_prefilter = prefilter;
+
+		SortQueryBatch(&descriptor, &origin[0], &direction[0]);
+		RunQueryBatch(&descriptor, RayCastBatchKernel, threadIndex);
+	}
+}
+
+void dgBroadPhase::ConvexCastBatch(dgConvexCastQuery* const queries, dgInt32 count, OnRayPrecastAction prefilter, dgInt32 threadIndex) const
+{
+	if (count > 0) {
+		dgStack<dgVector> origin(count);
+		dgStack<dgVector> direction(count);
+		for (dgInt32 i = 0; i < count; i++) {
+			origin[i] = dgVector(queries[i].m_matrix[12], queries[i].m_matrix[13], queries[i].m_matrix[14], dgFloat32(0.0f));
+			direction[i] = dgVector(queries[i].m_target[0], queries[i].m_target[1], queries[i].m_target[2], dgFloat32(0.0f)) - origin[i];
+		}
+
+		dgStack<dgQueryBatchDescriptor::dgSortKey> sortKeys(count);
+		dgQueryBatchDescriptor descriptor(this, &sortKeys[0], count);
+		descriptor.m_castQueries = queries;
+		descriptor.m_prefilter = prefilter;
+
+		SortQueryBatch(&descriptor, &origin[0], &direction[0]);
+		RunQueryBatch(&descriptor, ConvexCastBatchKernel, threadIndex);
+	}
 }
 
 void dgBroadPhase::CollisionChange (dgBody* const body, dgCollisionInstance* const collision)
@@ -733,36 +1669,71 @@ void dgBroadPhase::UpdateBody(dgBody* const body, dgInt32 threadIndex)
 			aggregate->m_isInEquilibrium = body1->m_equilibrium;
 		}
 		
-		if (!dgBoxInclusionTest(body1->m_minAABB, body1->m_maxAABB, node->m_minBox, node->m_maxBox)) {
+		// read the box from the packed body state when the body has a row
+		const dgBodyMasterList* const masterList = m_world;
+		const dgInt32 index = body1->m_bodyArrayIndex;
+		const bool packed = masterList->HasBodyState(index, body1);
+		const dgVector& minBox = packed ? masterList->m_bodyMinAABB[index] : body1->m_minAABB;
+		const dgVector& maxBox = packed ? masterList->m_bodyMaxAABB[index] : body1->m_maxAABB;
+		if (!dgBoxInclusionTest(minBox, maxBox, node->m_minBox, node->m_maxBox)) {
 			dgAssert(!node->IsAggregate());
-			node->SetAABB(body1->m_minAABB, body1->m_maxAABB);
-
-			if (!m_rootNode->IsLeafNode()) {
-				const dgBroadPhaseNode* const root = (m_rootNode->GetLeft() && m_rootNode->GetRight()) ? NULL : m_rootNode;
-				for (dgBroadPhaseNode* parent = node->m_parent; parent != root; parent = parent->m_parent) {
-					dgScopeSpinPause lock(&parent->m_criticalSectionLock);
-					if (!parent->IsAggregate()) {
-						dgVector minBox;
-						dgVector maxBox;
-						dgFloat32 area = CalculateSurfaceArea(parent->GetLeft(), parent->GetRight(), minBox, maxBox);
-						if (dgBoxInclusionTest(minBox, maxBox, parent->m_minBox, parent->m_maxBox)) {
-							break;
-						}
-						parent->m_minBox = minBox;
-						parent->m_maxBox = maxBox;
-						parent->m_surfaceArea = area;
-					} else {
-						dgBroadPhaseAggregate* const aggregate = (dgBroadPhaseAggregate*)parent;
-						aggregate->m_minBox = aggregate->m_root->m_minBox;
-						aggregate->m_maxBox = aggregate->m_root->m_maxBox;
-						aggregate->m_surfaceArea = aggregate->m_root->m_surfaceArea;
+			InvalidateQueryTree();
+			node->SetAABB(minBox, maxBox);
+			UpdateParentAABB(node);
+		}
+	}
+}
+
+void dgBroadPhase::UpdateParentAABB(dgBroadPhaseNode* const node)
+{
+	if (!m_rootNode->IsLeafNode()) {
+		// leaf boxes can shrink, so when several threads refit the same parent the result of the inclusion test 
+		// depends on the order they get there. in deterministic mode parents are always refit to the exact union 
+		// of their children, and the walk stops only when that does not change the parent box.
+		const bool deterministicMode = m_world->m_deterministicMode;
+		const dgBroadPhaseNode* const root = (m_rootNode->GetLeft() && m_rootNode->GetRight()) ? NULL : m_rootNode;
+		for (dgBroadPhaseNode* parent = node->m_parent; parent != root; parent = parent->m_parent) {
+			dgScopeSpinPause lock(&parent->m_criticalSectionLock);
+			if (!parent->IsAggregate()) {
+				dgVector minBox;
+				dgVector maxBox;
+				dgFloat32 area = CalculateSurfaceArea(parent->GetLeft(), parent->GetRight(), minBox, maxBox);
+				if (deterministicMode) {
+					dgVector test (dgVector::m_negOne & (minBox == parent->m_minBox) & (maxBox == parent->m_maxBox));
+					if ((test.GetSignMask() & 0x07) == 0x07) {
+						break;
 					}
+				} else if (dgBoxInclusionTest(minBox, maxBox, parent->m_minBox, parent->m_maxBox)) {
+					break;
 				}
+				parent->m_minBox = minBox;
+				parent->m_maxBox = maxBox;
+				parent->m_surfaceArea = area;
+			} else {
+				dgBroadPhaseAggregate* const aggregate = (dgBroadPhaseAggregate*)parent;
+				aggregate->m_minBox = aggregate->m_root->m_minBox;
+				aggregate->m_maxBox = aggregate->m_root->m_maxBox;
+				aggregate->m_surfaceArea = aggregate->m_root->m_surfaceArea;
 			}
 		}
 	}
 }
 
+void dgBroadPhase::RestoreBodyAABB (dgBody* const body, const dgVector& minBox, const dgVector& maxBox)
+{
+	// the leaf box is part of the simulation state, contacts are kept alive while the leaf boxes overlap
+	dgBroadPhaseBodyNode* const node = body->GetBroadPhase();
+	if (m_rootNode && node) {
+		dgAssert(dgBoxInclusionTest(body->m_minAABB, body->m_maxAABB, minBox, maxBox));
+		InvalidateQueryTree();
+		node->m_minBox = minBox;
+		node->m_maxBox = maxBox;
+		const dgVector side0(maxBox - minBox);
+		node->m_surfaceArea = side0.DotProduct(side0.ShiftTripleRight()).m_x;
+		UpdateParentAABB(node);
+	}
+}
+
 
 dgBroadPhaseNode* dgBroadPhase::BuildTopDown(dgBroadPhaseNode** const leafArray, dgInt32 firstBox, dgInt32 lastBox, dgFitnessList::dgListNode** const nextNode)
 {
@@ -790,6 +1761,106 @@ dgBroadPhaseNode* dgBroadPhase::BuildTopDown(dgBroadPhaseNode** const leafArray,
 }
 
 
+dgBroadPhaseNode* dgBroadPhase::BuildTopDownSAH(dgBroadPhaseNode** const leafArray, dgInt32 firstBox, dgInt32 lastBox, dgBroadPhaseTreeNode** const nodeArray, dgTreeBuildDescriptor* const descriptor, dgInt32 threadID)
+{
+	dgAssert(firstBox >= 0);
+	dgAssert(lastBox >= firstBox);
+
+	if (lastBox == firstBox) {
+		return leafArray[firstBox];
+	}
+
+	// a sub tree of n leafs uses n - 1 nodes, the parent takes the first one, 
+	// the left branch the next leftCount - 1 and the right branch the rest.
+	const dgInt32 boxCount = lastBox - firstBox + 1;
+	dgBroadPhaseTreeNode* const parent = nodeArray[0];
+	parent->m_parent = NULL;
+
+	dgInt32 leftCount = 0;
+	if (boxCount >= DG_BROADPHASE_SAH_MIN_BOXES) {
+		dgBinnedSpliteInfo info(&leafArray[firstBox], boxCount);
+		parent->SetAABB(info.m_p0, info.m_p1);
+		leftCount = info.m_axis;
+	}
+	if (!leftCount) {
+		dgSpliteInfo info(&leafArray[firstBox], boxCount);
+		parent->SetAABB(info.m_p0, info.m_p1);
+		leftCount = info.m_axis;
+	}
+
+	dgBroadPhaseNode** const slots[] = {&parent->m_left, &parent->m_right};
+	const dgInt32 first[] = {firstBox, firstBox + leftCount};
+	const dgInt32 last[] = {firstBox + leftCount - 1, lastBox};
+	dgBroadPhaseTreeNode** const nodes[] = {&nodeArray[1], &nodeArray[leftCount]};
+	for (dgInt32 i = 0; i < 2; i ++) {
+		const dgInt32 count = last[i] - first[i] + 1;
+		if (descriptor && (count > descriptor->m_minBoxesPerJob)) {
+			// big branches are spawned as nested jobs, idle workers steal them
+			const dgInt32 index = dgAtomicExchangeAndAdd(&descriptor->m_atomicJobsCount, 1);
+			dgAssert (index < descriptor->m_jobsCapacity);
+			dgTreeBuildDescriptor::dgBuildJob& job = descriptor->m_jobs[index];
+			job.m_slot = slots[i];
+			job.m_parent = parent;
+			job.m_nodeArray = nodes[i];
+			job.m_firstBox = first[i];
+			job.m_lastBox = last[i];
+			m_world->QueueNestedJob(BuildTopDownKernel, descriptor, &job, threadID, "dgBroadPhase::BuildTopDown");
+		} else {
+			dgBroadPhaseNode* const child = BuildTopDownSAH(leafArray, first[i], last[i], nodes[i], NULL, threadID);
+			child->m_parent = parent;
+			*slots[i] = child;
+		}
+	}
+	return parent;
+}
+
+void dgBroadPhase::BuildTopDownKernel(void* const context, void* const buildJob, dgInt32 threadID)
+{
+	DG_TRACKTIME();
+	dgTreeBuildDescriptor* const descriptor = (dgTreeBuildDescriptor*)context;
+	const dgTreeBuildDescriptor::dgBuildJob* const job = (dgTreeBuildDescriptor::dgBuildJob*)buildJob;
+	dgBroadPhase* const me = descriptor->m_broadPhase;
+	dgBroadPhaseNode* const child = me->BuildTopDownSAH(descriptor->m_leafArray, job->m_firstBox, job->m_lastBox, job->m_nodeArray, descriptor, threadID);
+	child->m_parent = job->m_parent;
+	*job->m_slot = child;
+}
+
+dgBroadPhaseNode* dgBroadPhase::BuildTopDownParallel(dgBroadPhaseNode** const leafArray, dgInt32 firstBox, dgInt32 lastBox, dgFitnessList::dgListNode** const nextNode)
+{
+	if (lastBox == firstBox) {
+		return leafArray[firstBox];
+	}
+
+	const dgInt32 boxCount = lastBox - firstBox + 1;
+	dgArenaMemoryAllocator* const stepAllocator = m_world->GetStepAllocator(0);
+	dgBroadPhaseTreeNode** const nodeArray = stepAllocator->AllocArray<dgBroadPhaseTreeNode*>(boxCount - 1);
+	for (dgInt32 i = 0; i < boxCount - 1; i ++) {
+		nodeArray[i] = (*nextNode)->GetInfo();
+		*nextNode = (*nextNode)->GetNext();
+	}
+
+	dgBroadPhaseNode* root = NULL;
+	const dgInt32 threadsCount = m_world->GetThreadCount();
+	if ((threadsCount > 1) && (boxCount >= DG_BROADPHASE_PARALLEL_BUILD)) {
+		// the root is one stealable job, each split spawns its big branches as nested jobs, 
+		// so the build fans out over the workers after the first few levels
+		const dgInt32 minBoxesPerJob = dgMax (boxCount / (threadsCount * 8), DG_BROADPHASE_SAH_MIN_BOXES);
+		dgTreeBuildDescriptor::dgBuildJob* const jobs = stepAllocator->AllocArray<dgTreeBuildDescriptor::dgBuildJob>(boxCount);
+		dgTreeBuildDescriptor descriptor(this, leafArray, jobs, boxCount, minBoxesPerJob);
+		dgTreeBuildDescriptor::dgBuildJob& rootJob = jobs[dgAtomicExchangeAndAdd(&descriptor.m_atomicJobsCount, 1)];
+		rootJob.m_slot = &root;
+		rootJob.m_parent = NULL;
+		rootJob.m_nodeArray = nodeArray;
+		rootJob.m_firstBox = firstBox;
+		rootJob.m_lastBox = lastBox;
+		m_world->QueueStealableJob(BuildTopDownKernel, &descriptor, &rootJob, "dgBroadPhase::BuildTopDown");
+		m_world->SynchronizationBarrier();
+	} else {
+		root = BuildTopDownSAH(leafArray, firstBox, lastBox, nodeArray, NULL, 0);
+	}
+	return root;
+}
+
 dgBroadPhaseNode* dgBroadPhase::BuildTopDownBig(dgBroadPhaseNode** const leafArray, dgInt32 firstBox, dgInt32 lastBox, dgFitnessList::dgListNode** const nextNode)
 {
 	if (lastBox == firstBox) {
@@ -811,7 +1882,7 @@ dgBroadPhaseNode* dgBroadPhase::BuildTopDownBig(dgBroadPhaseNode** const leafArr
 	}
 
 	if (midPoint == -1) {
-		return BuildTopDown(leafArray, firstBox, lastBox, nextNode);
+		return BuildTopDownParallel(leafArray, firstBox, lastBox, nextNode);
 	} else {
 		dgBroadPhaseTreeNode* const parent = (*nextNode)->GetInfo();
 
@@ -851,14 +1922,14 @@ void dgBroadPhase::ImproveFitness(dgFitnessList& fitness, dgFloat64& oldEntropy,
 {
 	if (*root) {
 		DG_TRACKTIME();
+		InvalidateQueryTree();
 		dgBroadPhaseNode* const parent = (*root)->m_parent;
 		(*root)->m_parent = NULL;
 		dgFloat64 entropy = CalculateEntropy(fitness, root);
 
 		if ((entropy > oldEntropy * dgFloat32(1.5f)) || (entropy < oldEntropy * dgFloat32(0.75f))) {
 			if (fitness.GetFirst()) {
-				m_world->m_solverJacobiansMemory.ResizeIfNecessary ((fitness.GetCount() * 2 + 16) * sizeof (dgBroadPhaseNode*));
-				dgBroadPhaseNode** const leafArray = (dgBroadPhaseNode**)&m_world->m_solverJacobiansMemory[0];
+				dgBroadPhaseNode** const leafArray = m_world->GetStepAllocator(0)->AllocArray<dgBroadPhaseNode*>(fitness.GetCount() * 2 + 16);
 
 				dgInt32 leafNodesCount = 0;
 				for (dgFitnessList::dgListNode* nodePtr = fitness.GetFirst(); nodePtr; nodePtr = nodePtr->GetNext()) {
@@ -893,6 +1964,11 @@ void dgBroadPhase::ImproveFitness(dgFitnessList& fitness, dgFloat64& oldEntropy,
 				//entropy = CalculateEntropy(fitness, root);
 				entropy = fitness.TotalCost();
 				fitness.m_prevCost = entropy;
+
+				// outside an update nothing resets the step arena, recycle the leaf array here
+				if (!m_world->m_inUpdate) {
+					m_world->GetStepAllocator(0)->Reset();
+				}
 			}
 			oldEntropy = entropy;
 		}
@@ -1128,6 +2204,7 @@ void dgBroadPhase::AddPair (dgContact* const contact, dgFloat32 timestep, dgInt3
 
 			pair.m_contact = contact;
 			pair.m_timestep = timestep;
+			world->m_threadCounters[threadIndex].m_narrowPhasePairs ++;
             CalculatePairContacts (&pair, threadIndex);
 		}
 	}
@@ -1200,6 +2277,7 @@ void dgBroadPhase::AddPair (dgBody* const body0, dgBody* const body1, const dgFl
 {
 	dgAssert(body0);
 	dgAssert(body1);
+	m_world->m_threadCounters[threadID].m_pairsTested ++;
 	const bool test = TestOverlaping (body0, body1, timestep);
 	if (test) {
 		dgContact* contact = m_contactCache.FindContactJoint(body0, body1);
@@ -1236,16 +2314,23 @@ void dgBroadPhase::AddPair (dgBody* const body0, dgBody* const body1, const dgFl
 						const dgInt32 isSofBody1 = body1->m_collision->IsType(dgCollision::dgCollisionLumpedMass_RTTI);
 
 						if (isSofBody0 || isSofBody1) {
-							m_pendingSoftBodyCollisions[m_pendingSoftBodyPairsCount].m_body0 = body0;
-							m_pendingSoftBodyCollisions[m_pendingSoftBodyPairsCount].m_body1 = body1;
-							m_pendingSoftBodyPairsCount++;
+							// pairs that do not fit are counted, the array grows and the pair pass runs again
+							const dgInt32 index = dgAtomicExchangeAndAdd(&m_pendingSoftBodyPairsCount, 1);
+							if (index < m_pendingSoftBodyCollisions.GetElementsCapacity()) {
+								m_pendingSoftBodyCollisions[index].m_body0 = body0;
+								m_pendingSoftBodyCollisions[index].m_body1 = body1;
+							}
 						} else {
 							dgContactList& contactList = *m_world;
 							dgAtomicExchangeAndAdd(&contactList.m_contactCountReset, 1);
 							if (contactList.m_contactCount < contactList.GetElementsCapacity()) {
-								contact = new (m_world->m_allocator) dgContact(m_world, material, body0, body1);
-								dgAssert(contact);
-								contactList.Push(contact);
+								// only the thread that claims the pair creates the contact
+								if (m_contactCache.ReserveContactJoint(body0, body1)) {
+									contact = new (m_world->m_allocator) dgContact(m_world, material, body0, body1);
+									dgAssert(contact);
+									m_contactCache.AddContactJoint(contact);
+									contactList.Push(contact);
+								}
 							}
 						}
 					}
@@ -1303,8 +2388,42 @@ dgAssert (0);
 }
 
 
+DG_INLINE void dgBroadPhase::SubmitLeafPair(dgBroadPhaseNode* const leafNode, dgBroadPhaseNode* const node, bool test0, dgFloat32 timestep, dgInt32 threadID)
+{
+	dgAssert(!node->GetRight());
+	dgAssert(!node->GetLeft());
+	dgBody* const body0 = leafNode->GetBody();
+	dgBody* const body1 = node->GetBody();
+	if (body0) {
+		if (body1) {
+			if (test0 || (body1->GetInvMass().m_w != dgFloat32(0.0f))) {
+				AddPair(body0, body1, timestep, threadID);
+			}
+		} else {
+			dgAssert (node->IsAggregate());
+			dgBroadPhaseAggregate* const aggregate = (dgBroadPhaseAggregate*) node;
+			aggregate->SummitPairs(body0, timestep, threadID);
+		}
+	} else {
+		dgAssert (leafNode->IsAggregate());
+		dgBroadPhaseAggregate* const aggregate = (dgBroadPhaseAggregate*) leafNode;
+		if (body1) {
+			aggregate->SummitPairs(body1, timestep, threadID);
+		} else {
+			dgAssert (node->IsAggregate());
+			aggregate->SummitPairs((dgBroadPhaseAggregate*) node, timestep, threadID);
+		}
+	}
+}
+
 void dgBroadPhase::SubmitPairs(dgBroadPhaseNode* const leafNode, dgBroadPhaseNode* const node, dgFloat32 timestep, dgInt32 threadCount, dgInt32 threadID)
 {
+	dgWorldPlugin* const plugin = m_world->GetKernelPlugin(dgWorldPlugin::m_overlapKernel);
+	if (plugin) {
+		SubmitPairs(plugin, leafNode, node, timestep, threadID);
+		return;
+	}
+
 	dgBroadPhaseNode* pool[DG_BROADPHASE_MAX_STACK_DEPTH];
 	pool[0] = node;
 	dgInt32 stack = 1;
@@ -1322,29 +2441,7 @@ void dgBroadPhase::SubmitPairs(dgBroadPhaseNode* const leafNode, dgBroadPhaseNod
 		dgBroadPhaseNode* const rootNode = pool[stack];
 		if (dgOverlapTest(rootNode->m_minBox, rootNode->m_maxBox, boxP0, boxP1)) {
 			if (rootNode->IsLeafNode()) {
-				dgAssert(!rootNode->GetRight());
-				dgAssert(!rootNode->GetLeft());
-				dgBody* const body1 = rootNode->GetBody();
-				if (body0) {
-					if (body1) {
-						if (test0 || (body1->GetInvMass().m_w != dgFloat32(0.0f))) {
-							AddPair(body0, body1, timestep, threadID);
-						}
-					} else {
-						dgAssert (rootNode->IsAggregate());
-						dgBroadPhaseAggregate* const aggregate = (dgBroadPhaseAggregate*) rootNode;
-						aggregate->SummitPairs(body0, timestep, threadID);
-					}
-				} else {
-					dgAssert (leafNode->IsAggregate());
-					dgBroadPhaseAggregate* const aggregate = (dgBroadPhaseAggregate*) leafNode;
-					if (body1) {
-						aggregate->SummitPairs(body1, timestep, threadID);
-					} else {
-						dgAssert (rootNode->IsAggregate());
-						aggregate->SummitPairs((dgBroadPhaseAggregate*) rootNode, timestep, threadID);
-					}
-				}
+				SubmitLeafPair(leafNode, rootNode, test0, timestep, threadID);
 			} else {
 				dgBroadPhaseTreeNode* const tmpNode = (dgBroadPhaseTreeNode*) rootNode;
 				dgAssert (tmpNode->m_left);
@@ -1362,6 +2459,83 @@ void dgBroadPhase::SubmitPairs(dgBroadPhaseNode* const leafNode, dgBroadPhaseNod
 	}
 }
 
+// same traversal but the boxes on top of the stack are tested in batches by the plugin overlap kernel.
+// the order pairs are found does not matter since new contacts are sorted before they are attached.
+// a batch of n nodes can grow the stack by n, so batches only use the lower half of the pool, 
+// above that the walk goes one node at a time and needs no more room than the scalar walk.
+void dgBroadPhase::SubmitPairs(dgWorldPlugin* const plugin, dgBroadPhaseNode* const leafNode, dgBroadPhaseNode* const node, dgFloat32 timestep, dgInt32 threadID)
+{
+	dgVector minBox[DG_PLUGIN_OVERLAP_BATCH_SIZE];
+	dgVector maxBox[DG_PLUGIN_OVERLAP_BATCH_SIZE];
+	dgBroadPhaseNode* batch[DG_PLUGIN_OVERLAP_BATCH_SIZE];
+	dgBroadPhaseNode* pool[DG_BROADPHASE_QUERY_STACK_DEPTH];
+	pool[0] = node;
+	dgInt32 stack = 1;
+
+	dgAssert (leafNode->IsLeafNode());
+	dgBody* const body0 = leafNode->GetBody();
+
+	const dgVector boxP0 (body0 ? body0->m_minAABB : leafNode->m_minBox);
+	const dgVector boxP1 (body0 ? body0->m_maxAABB : leafNode->m_maxBox);
+
+	const bool test0 = body0 ? (body0->GetInvMass().m_w != dgFloat32(0.0f)) : true;
+
+	while (stack) {
+		const dgInt32 count = dgMin (stack, DG_PLUGIN_OVERLAP_BATCH_SIZE, DG_BROADPHASE_QUERY_STACK_DEPTH - DG_BROADPHASE_MAX_STACK_DEPTH - stack);
+		if (count <= 0) {
+			stack--;
+			dgBroadPhaseNode* const rootNode = pool[stack];
+			if (dgOverlapTest(rootNode->m_minBox, rootNode->m_maxBox, boxP0, boxP1)) {
+				if (rootNode->IsLeafNode()) {
+					SubmitLeafPair(leafNode, rootNode, test0, timestep, threadID);
+				} else {
+					dgBroadPhaseTreeNode* const tmpNode = (dgBroadPhaseTreeNode*) rootNode;
+					dgAssert (tmpNode->m_left);
+					dgAssert (tmpNode->m_right);
+
+					pool[stack] = tmpNode->m_left;
+					stack++;
+					dgAssert(stack < dgInt32(sizeof (pool) / sizeof (pool[0])));
+
+					pool[stack] = tmpNode->m_right;
+					stack++;
+					dgAssert(stack < dgInt32(sizeof (pool) / sizeof (pool[0])));
+				}
+			}
+			continue;
+		}
+
+		for (dgInt32 i = 0; i < count; i ++) {
+			stack--;
+			batch[i] = pool[stack];
+			minBox[i] = pool[stack]->m_minBox;
+			maxBox[i] = pool[stack]->m_maxBox;
+		}
+
+		const dgUnsigned32 overlapMask = plugin->CalculateOverlaps(minBox, maxBox, boxP0, boxP1, count);
+		for (dgInt32 i = 0; i < count; i ++) {
+			if (overlapMask & (1 << i)) {
+				dgBroadPhaseNode* const rootNode = batch[i];
+				if (rootNode->IsLeafNode()) {
+					SubmitLeafPair(leafNode, rootNode, test0, timestep, threadID);
+				} else {
+					dgBroadPhaseTreeNode* const tmpNode = (dgBroadPhaseTreeNode*) rootNode;
+					dgAssert (tmpNode->m_left);
+					dgAssert (tmpNode->m_right);
+
+					pool[stack] = tmpNode->m_left;
+					stack++;
+					dgAssert(stack < dgInt32(sizeof (pool) / sizeof (pool[0])));
+
+					pool[stack] = tmpNode->m_right;
+					stack++;
+					dgAssert(stack < dgInt32(sizeof (pool) / sizeof (pool[0])));
+				}
+			}
+		}
+	}
+}
+
 
 void dgBroadPhase::ImproveNodeFitness(dgBroadPhaseTreeNode* const node, dgBroadPhaseNode** const root)
 {
@@ -1371,6 +2545,7 @@ void dgBroadPhase::ImproveNodeFitness(dgBroadPhaseTreeNode* const node, dgBroadP
 	dgBroadPhaseNode* const parent = node->m_parent;
 	if (parent && parent->m_parent) {
 		dgAssert (!parent->IsLeafNode());
+		InvalidateQueryTree();
 		if (parent->GetLeft() == node) {
 			RotateRight(node, root);
 		} else {
@@ -1498,10 +2673,8 @@ void dgBroadPhase::UpdateRigidBodyContactKernel(void* const context, void* const
 
 void dgBroadPhase::UpdateSoftBodyContacts(dgBroadphaseSyncDescriptor* const descriptor, dgFloat32 timeStep, dgInt32 threadID)
 {
-	dgAssert(0);
-/*
 	const dgInt32 count = m_pendingSoftBodyPairsCount;
-	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_pairsAtomicCounter, 1); i < count; i = dgAtomicExchangeAndAdd(&descriptor->m_pairsAtomicCounter, 1)) {
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, 1); i < count; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, 1)) {
 		dgPendingCollisionSoftBodies& pair = m_pendingSoftBodyCollisions[i];
 		if (pair.m_body0->m_collision->IsType(dgCollision::dgCollisionLumpedMass_RTTI)) {
 			dgCollisionLumpedMassParticles* const lumpedMassShape = (dgCollisionLumpedMassParticles*)pair.m_body0->m_collision->GetChildShape();
@@ -1515,7 +2688,6 @@ void dgBroadPhase::UpdateSoftBodyContacts(dgBroadphaseSyncDescriptor* const desc
 			lumpedMassShape->RegisterCollision(pair.m_body0);
 		}
 	}
-*/
 }
 
 void dgBroadPhase::UpdateRigidBodyContacts(dgBroadphaseSyncDescriptor* const descriptor, dgFloat32 timeStep, dgInt32 threadID)
@@ -1529,11 +2701,16 @@ void dgBroadPhase::UpdateRigidBodyContacts(dgBroadphaseSyncDescriptor* const des
 
 	const dgInt32 contactCount = contactList.m_contactCount;
 	dgContact** const contactArray = &contactList[0];
+	const bool deterministicMode = m_world->m_deterministicMode;
 
 	dgVector deltaTime(timestep);
 	for (dgInt32 i = threadID; i < contactCount; i += threadCount) {
 		dgContact* const contact = contactArray[i];
 		dgAssert (contact);
+		if (contact->m_contactUpdated) {
+			dgAssert (deterministicMode);
+			continue;
+		}
 
 		dgBody* const body0 = contact->GetBody0();
 		dgBody* const body1 = contact->GetBody1();
@@ -1583,7 +2760,11 @@ void dgBroadPhase::UpdateRigidBodyContacts(dgBroadphaseSyncDescriptor* const des
 				}
 			}
 
-			if (isActive ^ contact->m_isActive) {
+			if (deterministicMode) {
+				// other threads may be reading the equilibrium state of these bodies, they are woken after the barrier
+				contact->m_contactUpdated = 1;
+				contact->m_activityChanged = isActive ^ contact->m_isActive;
+			} else if (isActive ^ contact->m_isActive) {
 				if (body0->GetInvMass().m_w) {
 					body0->m_equilibrium = false;
 				}
@@ -1592,11 +2773,64 @@ void dgBroadPhase::UpdateRigidBodyContacts(dgBroadphaseSyncDescriptor* const des
 				}
 			}
 
-		} else {
+		} else if (!deterministicMode) {
 			contact->m_broadphaseLru = m_lru;
 		}
 
-		//contact->m_killContact = contact->m_killContact | (body0->m_equilibrium & body1->m_equilibrium & !(contact->m_maxDOF && contact->m_isActive));
+		if (!deterministicMode) {
+			//contact->m_killContact = contact->m_killContact | (body0->m_equilibrium & body1->m_equilibrium & !(contact->m_maxDOF && contact->m_isActive));
+			contact->m_killContact = contact->m_killContact | (body0->m_equilibrium & body1->m_equilibrium & !contact->m_isActive);
+		}
+	}
+}
+
+void dgBroadPhase::UpdateDeterministicContacts(dgBroadphaseSyncDescriptor* const descriptor)
+{
+	DG_TRACKTIME();
+	// wake the bodies of the contacts that changed activity, and update the contacts of the woken bodies, 
+	// until no more bodies wake up. the result is the same for any order the contacts were updated in.
+	dgContactList& contactList = *m_world;
+	const dgInt32 contactCount = contactList.m_contactCount;
+	dgContact** const contactArray = &contactList[0];
+	const dgInt32 threadsCount = m_world->GetThreadCount();
+
+	bool wakeBodies = true;
+	while (wakeBodies) {
+		wakeBodies = false;
+		for (dgInt32 i = 0; i < contactCount; i ++) {
+			dgContact* const contact = contactArray[i];
+			if (contact->m_activityChanged) {
+				contact->m_activityChanged = 0;
+				dgBody* const body0 = contact->GetBody0();
+				dgBody* const body1 = contact->GetBody1();
+				if (body0->m_equilibrium && body0->GetInvMass().m_w) {
+					body0->m_equilibrium = false;
+					wakeBodies = true;
+				}
+				if (body1->m_equilibrium && body1->GetInvMass().m_w) {
+					body1->m_equilibrium = false;
+					wakeBodies = true;
+				}
+			}
+		}
+
+		if (wakeBodies) {
+			for (dgInt32 i = 0; i < threadsCount; i++) {
+				m_world->QueueJob(UpdateRigidBodyContactKernel, descriptor, NULL, "dgBroadPhase::UpdateRigidBodyContact");
+			}
+			m_world->SynchronizationBarrier();
+		}
+	}
+
+	for (dgInt32 i = 0; i < contactCount; i ++) {
+		dgContact* const contact = contactArray[i];
+		const dgBody* const body0 = contact->GetBody0();
+		const dgBody* const body1 = contact->GetBody1();
+		if (contact->m_contactUpdated) {
+			contact->m_contactUpdated = 0;
+		} else {
+			contact->m_broadphaseLru = m_lru;
+		}
 		contact->m_killContact = contact->m_killContact | (body0->m_equilibrium & body1->m_equilibrium & !contact->m_isActive);
 	}
 }
@@ -1644,6 +2878,39 @@ bool dgBroadPhase::SanityCheck() const
 	return true;
 }
 
+dgInt32 dgBroadPhase::ComparePendingSoftBodyPairs(const dgPendingCollisionSoftBodies* const pairA, const dgPendingCollisionSoftBodies* const pairB, void* const context)
+{
+	const dgInt32 idA0 = pairA->m_body0->GetUniqueID();
+	const dgInt32 idA1 = pairA->m_body1->GetUniqueID();
+	const dgInt32 idB0 = pairB->m_body0->GetUniqueID();
+	const dgInt32 idB1 = pairB->m_body1->GetUniqueID();
+	const dgUnsigned64 keyA = (dgUnsigned64 (dgMin (idA0, idA1)) << 32) + dgUnsigned32 (dgMax (idA0, idA1));
+	const dgUnsigned64 keyB = (dgUnsigned64 (dgMin (idB0, idB1)) << 32) + dgUnsigned32 (dgMax (idB0, idB1));
+	if (keyA < keyB) {
+		return -1;
+	} else if (keyA > keyB) {
+		return 1;
+	}
+	return 0;
+}
+
+dgInt32 dgBroadPhase::CompareNewContacts(dgContact* const* const contactA, dgContact* const* const contactB, void* const context)
+{
+	// order new contacts by their body pair, so that the order does not depend on how the tree was traversed
+	const dgInt32 idA0 = (*contactA)->GetBody0()->GetUniqueID();
+	const dgInt32 idA1 = (*contactA)->GetBody1()->GetUniqueID();
+	const dgInt32 idB0 = (*contactB)->GetBody0()->GetUniqueID();
+	const dgInt32 idB1 = (*contactB)->GetBody1()->GetUniqueID();
+	const dgUnsigned64 keyA = (dgUnsigned64 (dgMin (idA0, idA1)) << 32) + dgUnsigned32 (dgMax (idA0, idA1));
+	const dgUnsigned64 keyB = (dgUnsigned64 (dgMin (idB0, idB1)) << 32) + dgUnsigned32 (dgMax (idB0, idB1));
+	if (keyA < keyB) {
+		return -1;
+	} else if (keyA > keyB) {
+		return 1;
+	}
+	return 0;
+}
+
 void dgBroadPhase::AttachNewContact(dgInt32 startCount)
 {
 	DG_TRACKTIME();
@@ -1652,26 +2919,43 @@ void dgBroadPhase::AttachNewContact(dgInt32 startCount)
 		contactList.Resize(contactList.GetElementsCapacity() * 2);
 	}
 
+	// new contacts are already in the cache, the pair generation never creates duplicates
 	dgContact** const contactArray = &contactList[0];
+	dgSort(&contactArray[startCount], contactList.m_contactCount - startCount, CompareNewContacts);
 	for (dgInt32 i = contactList.m_contactCount - 1; i >= startCount; i--) {
-		dgContact* const contact = contactArray[i];
-		if (m_contactCache.AddContactJoint(contact)) {
-			m_world->AttachContact(contact);
-		} else {
-			contactList.m_contactCount--;
-			contactArray[i] = contactList[contactList.m_contactCount];
-			delete contact;
-		}
+		m_world->AttachContact(contactArray[i]);
 	}
+	m_contactCache.ReleaseRetiredTables();
 	dgAssert(SanityCheck());
 }
 
+dgContact* dgBroadPhase::RestoreContact(dgBody* const body0, dgBody* const body1)
+{
+	// recreates a contact joint taken out of a world state snapshot, only called from serial code
+	dgUnsigned32 group0_ID = dgUnsigned32 (body0->m_bodyGroupId);
+	dgUnsigned32 group1_ID = dgUnsigned32 (body1->m_bodyGroupId);
+	if (group1_ID < group0_ID) {
+		dgSwap (group0_ID, group1_ID);
+	}
+
+	dgUnsigned32 key = (group1_ID << 16) + group0_ID;
+	const dgBodyMaterialList* const materialList = m_world;  
+	dgAssert (materialList->Find (key));
+	const dgContactMaterial* const material = &materialList->Find (key)->GetInfo();
+
+	dgContact* const contact = new (m_world->m_allocator) dgContact(m_world, material, body0, body1);
+	m_contactCache.AddContactJoint(contact);
+	m_world->AttachContact(contact);
+	return contact;
+}
+
 void dgBroadPhase::DeleteDeadContact()
 {
 	DG_TRACKTIME();
 	dgInt32 activeCount = 0;
 	dgContactList& contactList = *m_world;
 	dgContact** const contactArray = &contactList[0];
+	dgInt32 contactPoints = 0;
 	dgArray<dgJointInfo>& constraintArray = m_world->m_jointsMemory;
 	for (dgInt32 i = contactList.m_contactCount - 1; i >= 0; i--) {
 		dgContact* const contact = contactArray[i];
@@ -1683,11 +2967,17 @@ void dgBroadPhase::DeleteDeadContact()
 			delete contact;
 		} else if (contact->m_isActive && contact->m_maxDOF) {
 			constraintArray[activeCount].m_joint = contact;
+			contactPoints += contact->GetCount();
 			activeCount++;
 		}
 	}
 	dgAssert(SanityCheck());
 	contactList.m_activeContactCount = activeCount;
+
+	dgWorldStats& stats = m_world->m_stepStats;
+	stats.m_contacts = contactList.m_contactCount;
+	stats.m_activeContacts = activeCount;
+	stats.m_contactPoints = contactPoints;
 	//dgTrace (("%d %d\n", contactList.m_activeContactCount, contactList.m_contactCount));
 }
 
@@ -1699,17 +2989,20 @@ void dgBroadPhase::UpdateContacts(dgFloat32 timestep)
 
 	const dgInt32 threadsCount = m_world->GetThreadCount();
 
-	const dgBodyMasterList* const masterList = m_world;
+	dgBodyMasterList* const masterList = m_world;
 
 	m_world->m_bodiesMemory.ResizeIfNecessary(masterList->GetCount());
 	dgBroadphaseSyncDescriptor syncPoints(timestep, m_world);
+	dgWorldStats& stats = m_world->m_stepStats;
 
-	dgBodyMasterList::dgListNode* node = masterList->GetFirst()->GetNext();
+	const dgUnsigned64 forceTime = dgGetTimeInMicrosenconds();
+	masterList->UpdateBodyArray();
 	for (dgInt32 i = 0; i < threadsCount; i++) {
-		m_world->QueueJob(ForceAndToqueKernel, &syncPoints, node, "dgBroadPhase::ForceAndToque");
-		node = node ? node->GetNext() : NULL;
+		m_world->QueueJob(ForceAndToqueKernel, &syncPoints, NULL, "dgBroadPhase::ForceAndToque");
 	}
 	m_world->SynchronizationBarrier();
+	// any transform callbacks left pending by a pipelined update were dispatched along with the forces
+	m_world->m_pendingTransformsCount = 0;
 
 	// update pre-listeners after the force and torque are applied
 	if (m_world->m_listeners.GetCount()) {
@@ -1721,11 +3014,14 @@ void dgBroadPhase::UpdateContacts(dgFloat32 timestep)
 		}
 	}
 
+	const dgUnsigned64 pairsTime = dgGetTimeInMicrosenconds();
+	stats.m_forceAndTorqueTime += (pairsTime - forceTime) * dgFloat32 (1.0e-6f);
+
 	// check for sleeping bodies states
-	node = masterList->GetFirst()->GetNext();
+	masterList->UpdateBodyArray();
+	syncPoints.m_atomicBodyIndex = 0;
 	for (dgInt32 i = 0; i < threadsCount; i++) {
-		m_world->QueueJob(SleepingStateKernel, &syncPoints, node, "dgBroadPhase::SleepingState");
-		node = node ? node->GetNext() : NULL;
+		m_world->QueueJob(SleepingStateKernel, &syncPoints, NULL, "dgBroadPhase::SleepingState");
 	}
 	m_world->SynchronizationBarrier();
 
@@ -1751,18 +3047,43 @@ void dgBroadPhase::UpdateContacts(dgFloat32 timestep)
 	}
 	m_world->SynchronizationBarrier();
 
+	if (m_pendingSoftBodyPairsCount > m_pendingSoftBodyCollisions.GetElementsCapacity()) {
+		// some soft body pairs did not fit, grow the array and find the pairs again.
+		// rigid pairs found by the first pass are already in the contact cache and are skipped.
+		m_pendingSoftBodyCollisions.Resize(m_pendingSoftBodyPairsCount * 2);
+		m_pendingSoftBodyPairsCount = 0;
+		syncPoints.m_atomicIndex = 0;
+		broadPhaseNode = m_updateList.GetFirst();
+		for (dgInt32 i = 0; i < threadsCount; i++) {
+			m_world->QueueJob(CollidingPairsKernel, &syncPoints, broadPhaseNode, "dgBroadPhase::CollidingPairs");
+			broadPhaseNode = broadPhaseNode ? broadPhaseNode->GetNext() : NULL;
+		}
+		m_world->SynchronizationBarrier();
+		dgAssert(m_pendingSoftBodyPairsCount <= m_pendingSoftBodyCollisions.GetElementsCapacity());
+	}
+
 	AttachNewContact(syncPoints.m_contactStart);
+	stats.m_newContacts += contactList.m_contactCount - syncPoints.m_contactStart;
+
+	const dgUnsigned64 contactsTime = dgGetTimeInMicrosenconds();
+	stats.m_collidingPairsTime += (contactsTime - pairsTime) * dgFloat32 (1.0e-6f);
 	for (dgInt32 i = 0; i < threadsCount; i++) {
 		m_world->QueueJob(UpdateRigidBodyContactKernel, &syncPoints, NULL, "dgBroadPhase::UpdateRigidBodyContact");
 	}
 	m_world->SynchronizationBarrier();
+	if (m_world->m_deterministicMode) {
+		UpdateDeterministicContacts(&syncPoints);
+	}
 
 	if (m_pendingSoftBodyPairsCount) {
-		dgAssert (0);
-		//for (dgInt32 i = 0; i < threadsCount; i++) {
-		//	m_world->QueueJob(UpdateSoftBodyContactKernel, &syncPoints, contactListNode, "dgBroadPhase::UpdateSoftBodyContact");
-		//}
-		//m_world->SynchronizationBarrier();
+		if (m_world->m_deterministicMode) {
+			dgSort(&m_pendingSoftBodyCollisions[0], m_pendingSoftBodyPairsCount, ComparePendingSoftBodyPairs);
+		}
+		syncPoints.m_atomicIndex = 0;
+		for (dgInt32 i = 0; i < threadsCount; i++) {
+			m_world->QueueJob(UpdateSoftBodyContactKernel, &syncPoints, m_world, "dgBroadPhase::UpdateSoftBodyContact");
+		}
+		m_world->SynchronizationBarrier();
 	}
 
 	//	m_recursiveChunks = false;
@@ -1783,4 +3104,5 @@ void dgBroadPhase::UpdateContacts(dgFloat32 timestep)
 	}
 
 	DeleteDeadContact();
+	stats.m_contactsTime += (dgGetTimeInMicrosenconds() - contactsTime) * dgFloat32 (1.0e-6f);
 }
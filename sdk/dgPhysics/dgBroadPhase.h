@@ -31,12 +31,14 @@ class dgWorld;
 class dgContact;
 class dgCollision;
 class dgDynamicBody;
+class dgWorldPlugin;
 class dgCollisionInstance;
 class dgBroadPhaseAggregate;
 
 
 #define DG_CACHE_DIST_TOL				dgFloat32 (1.0e-3f)
 #define DG_BROADPHASE_MAX_STACK_DEPTH	256
+#define DG_BROADPHASE_QUERY_STACK_DEPTH	(DG_BROADPHASE_MAX_STACK_DEPTH * 2)
 
 class dgConvexCastReturnInfo
 {
@@ -50,6 +52,27 @@ class dgConvexCastReturnInfo
 	dgFloat32 m_penetration;                // contact penetration at collision point
 };
 
+class dgRayCastQuery
+{
+	public:
+	dgFloat32 m_p0[4];						// ray origin in global space
+	dgFloat32 m_p1[4];						// ray destination in global space
+	void* m_userData;						// user data passed to the filter and prefilter callbacks
+};
+
+class dgConvexCastQuery
+{
+	public:
+	dgFloat32 m_matrix[16];					// shape matrix at the start of the cast
+	dgFloat32 m_target[4];					// destination of the shape origin in global space
+	dgCollisionInstance* m_shape;			// convex shape to be cast
+	void* m_userData;						// user data passed to the prefilter callback
+	dgConvexCastReturnInfo* m_info;			// contact buffer, can be NULL if m_maxContacts is zero
+	dgInt32 m_maxContacts;					// capacity of m_info
+	dgInt32 m_contactCount;					// number of contacts at the time of impact
+	dgFloat32 m_param;						// time of impact along the cast, larger than 1.0 if nothing was hit
+};
+
 
 DG_MSC_VECTOR_ALIGMENT
 class dgBroadPhaseNode
@@ -224,7 +247,9 @@ class dgBroadPhaseTreeNode: public dgBroadPhaseNode
 	dgList<dgBroadPhaseTreeNode*>::dgListNode* m_fitnessNode;
 } DG_GCC_VECTOR_ALIGMENT;
 
-#define DG_CONTACT_CACHE_LINE_SIZE 4
+#define DG_CONTACT_CACHE_SHARDS_BITS	6
+#define DG_CONTACT_CACHE_SHARDS		(1 << DG_CONTACT_CACHE_SHARDS_BITS)
+#define DG_CONTACT_CACHE_SHARD_SIZE	64
 
 class dgBroadPhase
 {
@@ -256,148 +281,148 @@ class dgBroadPhase
 		};
 	};
 
-	class dgContactCacheLine
+	// concurrent map from body pairs to contact joints. 
+	// the map is split into shards, each one is an open addressing hash table that grows on its own, 
+	// so a burst of new pairs only rehashes the shards it lands on, never the whole cache.
+	// lookups are lock free, insertions only lock the shard that owns the pair, 
+	// removals and releasing the tables replaced by a grow are only done from serial code.
+	class dgContactCache
 	{
 		public:
-		DG_INLINE dgContactCacheLine()
+		class dgEntry
 		{
-		}
-
-		dgInt32 m_count;
-		dgUnsigned32 m_key;
-		dgContact* m_contact[DG_CONTACT_CACHE_LINE_SIZE];
-		dgInt32 m_hashKey[DG_CONTACT_CACHE_LINE_SIZE];
-		CacheEntryTag m_tags[DG_CONTACT_CACHE_LINE_SIZE];
-	};
+			public:
+			dgUnsigned64 m_tag;
+			dgContact* m_contact;
+		};
 
-	class dgContactCache: public dgArray<dgContactCacheLine>
-	{
-		public:
-		dgContactCache (dgMemoryAllocator* const allocator)
-			:dgArray<dgContactCacheLine>(allocator)
-			,m_count(1<<10)
+		class dgTable
 		{
-			Init();
-		}
+			public:
+			dgEntry* m_entries;
+			dgTable* m_retired;
+			dgInt32 m_mask;
+			dgInt32 m_count;
+		};
 
-		void Flush()
+		class dgShard
 		{
-			Clear();
-			Init();
-		}
+			public:
+			dgTable* volatile m_table;
+			dgTable* m_retired;
+			dgInt32 m_lock;
+			dgInt8 m_pad[64 - 2 * sizeof (dgTable*) - sizeof (dgInt32)];
+		};
 
-		void Init()
-		{
-			m_count = 1 << 10;
-			ResizeIfNecessary(m_count);
-			dgContactCacheLine* const cache = &(*this)[0];
-			memset(cache, 0, m_count * sizeof(dgContactCacheLine));
-		}
+		dgContactCache (dgMemoryAllocator* const allocator);
+		~dgContactCache ();
+
+		void Flush();
+		void ReleaseRetiredTables();
+		bool ReserveContactJoint(const dgBody* const body0, const dgBody* const body1);
+		void AddContactJoint(dgContact* const joint);
+		void RemoveContactJoint(dgContact* const joint);
 
 		DG_INLINE dgContact* FindContactJoint(const dgBody* const body0, const dgBody* const body1) const
 		{
 			CacheEntryTag tag(body0->m_uniqueID, body1->m_uniqueID);
-			dgUnsigned32 hash = tag.GetHash();
-
-			dgInt32 entry = hash & (m_count - 1);
-
-			const dgContactCacheLine& cacheLine = (*this)[entry];
-			for (dgInt32 i = 0; i < cacheLine.m_count; i++) {
-				if (cacheLine.m_tags[i].m_tag == tag.m_tag) {
-					return cacheLine.m_contact[i];
+			const dgUnsigned32 hash = GetHash(tag.m_tag);
+			const dgTable* const table = m_shards[hash >> (32 - DG_CONTACT_CACHE_SHARDS_BITS)].m_table;
+
+			const dgEntry* const entries = table->m_entries;
+			const dgUnsigned32 mask = dgUnsigned32 (table->m_mask);
+			for (dgUnsigned32 i = hash & mask; entries[i].m_tag; i = (i + 1) & mask) {
+				if (entries[i].m_tag == tag.m_tag) {
+					return entries[i].m_contact;
 				}
 			}
 			return NULL;
 		}
 
-		DG_INLINE bool AddContactJoint(dgContact* const joint)
+		private:
+		DG_INLINE static dgUnsigned32 GetHash(dgUnsigned64 key)
 		{
-			// note this function is not thread safe
-			CacheEntryTag tag(joint->GetBody0()->m_uniqueID, joint->GetBody1()->m_uniqueID);
+			CacheEntryTag tag;
+			tag.m_tag = key;
 			dgUnsigned32 hash = tag.GetHash();
+			hash ^= hash >> 15;
+			hash *= 0x2c1b3c6du;
+			hash ^= hash >> 12;
+			return hash;
+		}
 
-			dgInt32 entry = hash & (m_count - 1);
-			dgContactCacheLine* cacheLine = &(*this)[entry];
-
-			for (dgInt32 i = cacheLine->m_count - 1; i >= 0; i--) {
-				if (cacheLine->m_tags[i].m_tag == tag.m_tag) {
-					return false;
-				}
-			}
-
-			while (cacheLine->m_count == 4) {
-				Rehash();
-				entry = hash & (m_count - 1);
-				cacheLine = &(*this)[entry];
-			}
-			if (cacheLine->m_count == 0) {
-				cacheLine->m_key = hash;
-			}
+		void Init();
+		void FreeTables();
+		dgTable* CreateTable(dgInt32 count) const;
+		dgEntry* FindEntry(dgTable* const table, dgUnsigned64 key, dgUnsigned32 hash) const;
+		void InsertEntry(dgShard& shard, dgUnsigned64 key, dgUnsigned32 hash, dgContact* const joint);
 
-			const dgInt32 index = cacheLine->m_count;
-			cacheLine->m_count++;
-			cacheLine->m_tags[index] = tag;
-			cacheLine->m_hashKey[index] = hash;
-			cacheLine->m_contact[index] = joint;
-			return true;
-		}
+		dgShard m_shards[DG_CONTACT_CACHE_SHARDS];
+		dgMemoryAllocator* m_allocator;
+	};
 
-		DG_INLINE void RemoveContactJoint(dgContact* const joint)
+	// four wide node of the flatten query tree, child boxes are stored in SoA form so that 
+	// all four can be tested at once, child indices are positive for inner nodes and 
+	// negative, -(index + 1), for leaf bodies.
+	DG_MSC_VECTOR_ALIGMENT
+	class dgQueryNode
+	{
+		public:
+		DG_INLINE dgInt32 OverlapMask(const dgVector& minBox, const dgVector& maxBox) const
 		{
-			CacheEntryTag tag(joint->GetBody0()->m_uniqueID, joint->GetBody1()->m_uniqueID);
-			dgUnsigned32 hash = tag.GetHash();
-
-			dgInt32 entry = hash & (m_count - 1);
-			dgContactCacheLine* const cacheLine = &(*this)[entry];
-			for (dgInt32 i = cacheLine->m_count - 1; i >= 0 ; i--) {
-				if (cacheLine->m_tags[i].m_tag == tag.m_tag) {
-					cacheLine->m_count--;
-					const dgInt32 index = cacheLine->m_count;
-					cacheLine->m_tags[i] = cacheLine->m_tags[index];
-					cacheLine->m_hashKey[i] = cacheLine->m_hashKey[index];
-					cacheLine->m_contact[i] = cacheLine->m_contact[index];
-					break;
-				}
-			}
+			dgVector test((m_minX < maxBox.BroadcastX()) & (m_maxX > minBox.BroadcastX()));
+			test = test & (m_minY < maxBox.BroadcastY()) & (m_maxY > minBox.BroadcastY());
+			test = test & (m_minZ < maxBox.BroadcastZ()) & (m_maxZ > minBox.BroadcastZ());
+			return test.GetSignMask() & ((1 << m_count) - 1);
 		}
 
-		private:
-		void Rehash()
+		DG_INLINE dgVector RayDistance(const dgFastRayTest& ray, const dgVector& shapeMinBox, const dgVector& shapeMaxBox) const
 		{
-			const dgInt32 newCount = m_count * 2;
-			ResizeIfNecessary(newCount);
-			dgContactCacheLine* const cache0 = &(*this)[0];
-			dgContactCacheLine* const cache1 = &cache0[m_count];
-	
-			const dgInt32 mask = newCount - 1;
-			for (dgInt32 i = 0; i < m_count; i++) {
-				dgContactCacheLine* const src = &cache0[i];
-				dgContactCacheLine* const dst = &cache1[i];
-				dst->m_count = 0;
-				for (dgInt32 j = src->m_count - 1; j >= 0; j--) {
-					dgInt32 entry = src->m_hashKey[j] & mask;
-					if (entry >= m_count) {
-						const dgInt32 dstIndex = dst->m_count;
-						dst->m_count++;
-						dst->m_tags[dstIndex] = src->m_tags[j];
-						dst->m_hashKey[dstIndex] = src->m_hashKey[j];
-						dst->m_contact[dstIndex] = src->m_contact[j];
-
-						src->m_count--;
-						const dgInt32 srcIndex = src->m_count;
-						src->m_tags[j] = src->m_tags[srcIndex];
-						src->m_hashKey[j] = src->m_hashKey[srcIndex];
-						src->m_contact[j] = src->m_contact[srcIndex];
-					}
-				}
-			}
-			m_count = newCount;
+			const dgVector p0x(ray.m_p0.BroadcastX());
+			const dgVector p0y(ray.m_p0.BroadcastY());
+			const dgVector p0z(ray.m_p0.BroadcastZ());
+			const dgVector minX(m_minX - shapeMaxBox.BroadcastX());
+			const dgVector minY(m_minY - shapeMaxBox.BroadcastY());
+			const dgVector minZ(m_minZ - shapeMaxBox.BroadcastZ());
+			const dgVector maxX(m_maxX - shapeMinBox.BroadcastX());
+			const dgVector maxY(m_maxY - shapeMinBox.BroadcastY());
+			const dgVector maxZ(m_maxZ - shapeMinBox.BroadcastZ());
+
+			dgVector parallel(((p0x <= minX) | (p0x >= maxX)) & ray.m_isParallel.BroadcastX());
+			parallel = parallel | (((p0y <= minY) | (p0y >= maxY)) & ray.m_isParallel.BroadcastY());
+			parallel = parallel | (((p0z <= minZ) | (p0z >= maxZ)) & ray.m_isParallel.BroadcastZ());
+
+			const dgVector invX(ray.m_dpInv.BroadcastX());
+			const dgVector invY(ray.m_dpInv.BroadcastY());
+			const dgVector invZ(ray.m_dpInv.BroadcastZ());
+			const dgVector tx0(invX * (minX - p0x));
+			const dgVector tx1(invX * (maxX - p0x));
+			const dgVector ty0(invY * (minY - p0y));
+			const dgVector ty1(invY * (maxY - p0y));
+			const dgVector tz0(invZ * (minZ - p0z));
+			const dgVector tz1(invZ * (maxZ - p0z));
+
+			dgVector t0(ray.m_minT.GetMax(tx0.GetMin(tx1)).GetMax(ty0.GetMin(ty1)).GetMax(tz0.GetMin(tz1)));
+			dgVector t1(ray.m_maxT.GetMin(tx0.GetMax(tx1)).GetMin(ty0.GetMax(ty1)).GetMin(tz0.GetMax(tz1)));
+			dgVector mask((t0 < t1).AndNot(parallel));
+			return dgVector(dgFloat32(1.2f)).Select(t0, mask);
 		}
 
+		dgVector m_minX;
+		dgVector m_minY;
+		dgVector m_minZ;
+		dgVector m_maxX;
+		dgVector m_maxY;
+		dgVector m_maxZ;
+		dgInt32 m_child[4];
 		dgInt32 m_count;
-	};
+		dgInt32 m_pad[3];
+	} DG_GCC_VECTOR_ALIGMENT;
 
 	class dgSpliteInfo;
+	class dgQueryBatchDescriptor;
+	class dgBinnedSpliteInfo;
+	class dgTreeBuildDescriptor;
 	class dgBroadphaseSyncDescriptor
 	{
 		public:
@@ -405,6 +430,7 @@ class dgBroadPhase
 			:m_world(world)
 			,m_timestep(timestep)
 			,m_atomicIndex(0)
+			,m_atomicBodyIndex(0)
 			,m_contactStart(0)
 			,m_atomicDynamicsCount(0)
 			,m_atomicPendingBodiesCount(0)
@@ -415,6 +441,7 @@ class dgBroadPhase
 		dgWorld* m_world;
 		dgFloat32 m_timestep;
 		dgInt32 m_atomicIndex;
+		dgInt32 m_atomicBodyIndex;
 		dgInt32 m_contactStart;
 		dgInt32 m_atomicDynamicsCount;
 		dgInt32 m_atomicPendingBodiesCount;
@@ -501,21 +528,27 @@ class dgBroadPhase
 	virtual void FindCollidingPairs (dgBroadphaseSyncDescriptor* const descriptor, dgList<dgBroadPhaseNode*>::dgListNode* const node, dgInt32 threadID) = 0;
 
 	void UpdateBody(dgBody* const body, dgInt32 threadIndex);
+	void UpdateParentAABB(dgBroadPhaseNode* const node);
 	void AddInternallyGeneratedBody(dgBody* const body)
 	{
 		m_generatedBodies.Append(body);
 	}
 
+	void RayCastBatch (const dgRayCastQuery* const queries, dgInt32 count, OnRayCastAction filter, OnRayPrecastAction prefilter, dgInt32 threadIndex) const;
+	void ConvexCastBatch (dgConvexCastQuery* const queries, dgInt32 count, OnRayPrecastAction prefilter, dgInt32 threadIndex) const;
+
 	void UpdateContacts(dgFloat32 timestep);
 	void CollisionChange (dgBody* const body, dgCollisionInstance* const collisionSrc);
 
 	void MoveNodes (dgBroadPhase* const dest);
+	dgContact* RestoreContact (dgBody* const body0, dgBody* const body1);
+	void RestoreBodyAABB (dgBody* const body, const dgVector& minBox, const dgVector& maxBox);
 
 	protected:
 	virtual void LinkAggregate (dgBroadPhaseAggregate* const aggregate) = 0; 
 	virtual void UnlinkAggregate (dgBroadPhaseAggregate* const aggregate) = 0; 
 
-	bool DoNeedUpdate(dgBodyMasterList::dgListNode* const node) const;
+	bool DoNeedUpdate(dgBody* const body) const;
 	dgFloat64 CalculateEntropy (dgFitnessList& fitness, dgBroadPhaseNode** const root);
 	dgBroadPhaseTreeNode* InsertNode (dgBroadPhaseNode* const root, dgBroadPhaseNode* const node);
 
@@ -530,6 +563,48 @@ class dgBroadPhase
 
 	bool TestOverlaping(const dgBody* const body0, const dgBody* const body1, dgFloat32 timestep) const;
 
+	class dgQueryTreeReader
+	{
+		public:
+		DG_INLINE dgQueryTreeReader(const dgBroadPhase* const broadPhase)
+			:m_broadPhase(broadPhase)
+			,m_isValid(broadPhase->AcquireQueryTree())
+		{
+		}
+
+		DG_INLINE ~dgQueryTreeReader()
+		{
+			if (m_isValid) {
+				m_broadPhase->ReleaseQueryTree();
+			}
+		}
+
+		DG_INLINE bool IsValid() const
+		{
+			return m_isValid;
+		}
+
+		const dgBroadPhase* m_broadPhase;
+		bool m_isValid;
+	};
+
+	DG_INLINE void InvalidateQueryTree()
+	{
+		m_queryTreeIsValid = 0;
+	}
+
+	bool UpdateQueryTree() const;
+	bool AcquireQueryTree() const;
+	void ReleaseQueryTree() const;
+	void BuildQueryTree();
+	dgInt32 BuildQueryNode(const dgBroadPhaseNode* const node);
+	void QueryTreeForEachBodyInAABB(const dgVector& minBox, const dgVector& maxBox, OnBodiesInAABB callback, void* const userData) const;
+	void QueryTreeRayCast(const dgVector& l0, const dgVector& l1, OnRayCastAction filter, OnRayPrecastAction prefilter, void* const userData) const;
+	dgInt32 QueryTreeConvexCast(dgCollisionInstance* const shape, const dgMatrix& matrix, const dgVector& target, dgFloat32* const param, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const;
+	void SortQueryBatch(dgQueryBatchDescriptor* const descriptor, const dgVector* const origin, const dgVector* const direction) const;
+	void RunQueryBatch(dgQueryBatchDescriptor* const descriptor, dgWorkerThreadTaskCallback kernel, dgInt32 threadIndex) const;
+	dgInt32 QueryTreeCollide(dgCollisionInstance* const shape, const dgMatrix& matrix, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const;
+
 	void ForEachBodyInAABB (const dgBroadPhaseNode** stackPool, dgInt32 stack, const dgVector& minBox, const dgVector& maxBox, OnBodiesInAABB callback, void* const userData) const;
 	void RayCast (const dgBroadPhaseNode** stackPool, dgFloat32* const distance, dgInt32 stack, const dgVector& l0, const dgVector& l1, dgFastRayTest& ray, OnRayCastAction filter, OnRayPrecastAction prefilter, void* const userData) const;
 
@@ -539,24 +614,30 @@ class dgBroadPhase
 	dgInt32 Collide(const dgBroadPhaseNode** stackPool, dgInt32* const overlap, dgInt32 stack, const dgVector& p0, const dgVector& p1, 
 		            dgCollisionInstance* const shape, const dgMatrix& matrix, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const;
 
-	void SleepingState (dgBroadphaseSyncDescriptor* const descriptor, dgBodyMasterList::dgListNode* node, dgInt32 threadID);
-	void ApplyForceAndtorque (dgBroadphaseSyncDescriptor* const descriptor, dgBodyMasterList::dgListNode* node, dgInt32 threadID);
+	void SleepingState (dgBroadphaseSyncDescriptor* const descriptor, dgInt32 threadID);
+	void ApplyForceAndtorque (dgBroadphaseSyncDescriptor* const descriptor, dgInt32 threadID);
 	
 	void UpdateAggregateEntropy (dgBroadphaseSyncDescriptor* const descriptor, dgList<dgBroadPhaseAggregate*>::dgListNode* node, dgInt32 threadID);
 
 	dgBroadPhaseNode* BuildTopDown(dgBroadPhaseNode** const leafArray, dgInt32 firstBox, dgInt32 lastBox, dgFitnessList::dgListNode** const nextNode);
 	dgBroadPhaseNode* BuildTopDownBig(dgBroadPhaseNode** const leafArray, dgInt32 firstBox, dgInt32 lastBox, dgFitnessList::dgListNode** const nextNode);
+	dgBroadPhaseNode* BuildTopDownParallel(dgBroadPhaseNode** const leafArray, dgInt32 firstBox, dgInt32 lastBox, dgFitnessList::dgListNode** const nextNode);
+	dgBroadPhaseNode* BuildTopDownSAH(dgBroadPhaseNode** const leafArray, dgInt32 firstBox, dgInt32 lastBox, dgBroadPhaseTreeNode** const nodeArray, dgTreeBuildDescriptor* const descriptor, dgInt32 threadID);
 
 	void KinematicBodyActivation (dgContact* const contatJoint) const;
 	
 	void FindGeneratedBodiesCollidingPairs (dgBroadphaseSyncDescriptor* const descriptor, dgInt32 threadID);
 	void UpdateSoftBodyContacts(dgBroadphaseSyncDescriptor* const descriptor, dgFloat32 timeStep, dgInt32 threadID);
 	void UpdateRigidBodyContacts (dgBroadphaseSyncDescriptor* const descriptor, dgFloat32 timeStep, dgInt32 threadID);
+	void UpdateDeterministicContacts (dgBroadphaseSyncDescriptor* const descriptor);
 	void SubmitPairs (dgBroadPhaseNode* const body, dgBroadPhaseNode* const node, dgFloat32 timestep, dgInt32 threaCount, dgInt32 threadID);
+	void SubmitPairs (dgWorldPlugin* const plugin, dgBroadPhaseNode* const body, dgBroadPhaseNode* const node, dgFloat32 timestep, dgInt32 threadID);
+	DG_INLINE void SubmitLeafPair (dgBroadPhaseNode* const leafNode, dgBroadPhaseNode* const node, bool test0, dgFloat32 timestep, dgInt32 threadID);
 
 	bool SanityCheck() const;
 	void DeleteDeadContact();
 	void AttachNewContact(dgInt32 startCount);
+	static dgInt32 CompareNewContacts(dgContact* const* const contactA, dgContact* const* const contactB, void* const context);
 
 	DG_INLINE bool ValidateContactCache(dgContact* const contact, const dgVector& timestep) const;
 		
@@ -564,6 +645,9 @@ class dgBroadPhase
 	static void ForceAndToqueKernel(void* const descriptor, void* const worldContext, dgInt32 threadID);
 	static void CollidingPairsKernel(void* const descriptor, void* const worldContext, dgInt32 threadID);
 	static void UpdateAggregateEntropyKernel(void* const descriptor, void* const worldContext, dgInt32 threadID);
+	static void BuildTopDownKernel(void* const descriptor, void* const buildJob, dgInt32 threadID);
+	static void RayCastBatchKernel(void* const descriptor, void* const worldContext, dgInt32 threadID);
+	static void ConvexCastBatchKernel(void* const descriptor, void* const worldContext, dgInt32 threadID);
 	static void AddGeneratedBodiesContactsKernel(void* const descriptor, void* const worldContext, dgInt32 threadID);
 	static void UpdateRigidBodyContactKernel(void* const descriptor, void* const worldContext, dgInt32 threadID);
 	static void UpdateSoftBodyContactKernel(void* const descriptor, void* const worldContext, dgInt32 threadID);
@@ -576,6 +660,8 @@ class dgBroadPhase
 		dgBody* m_body1;
 	};
 
+	static dgInt32 ComparePendingSoftBodyPairs(const dgPendingCollisionSoftBodies* const pairA, const dgPendingCollisionSoftBodies* const pairB, void* const context);
+
 	dgWorld* m_world;
 	dgBroadPhaseNode* m_rootNode;
 	dgList<dgBody*> m_generatedBodies;
@@ -587,6 +673,15 @@ class dgBroadPhase
 	dgInt32 m_pendingSoftBodyPairsCount;
 	dgInt32 m_criticalSectionLock;
 
+	dgArray<dgQueryNode> m_queryNodes;
+	dgArray<dgBody*> m_queryBodies;
+	dgInt32 m_queryNodesCount;
+	dgInt32 m_queryBodiesCount;
+	dgInt32 m_queryTreeLock;
+	dgInt32 m_queryTreeReaders;
+	dgInt32 m_queryTreeIsValid;
+	dgInt32 m_queryTreeIsUsed;
+
 	static dgVector m_velocTol;
 	static dgVector m_linearContactError2;
 	static dgVector m_angularContactError2;
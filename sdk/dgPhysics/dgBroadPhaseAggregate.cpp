@@ -82,6 +82,7 @@ void dgBroadPhaseAggregate::AddBody(dgBody* const body)
 {
 	dgAssert(body->GetBroadPhase());
 	m_broadPhase->Remove(body);
+	m_broadPhase->InvalidateQueryTree();
 
 	dgBroadPhaseBodyNode* const newNode = new (m_broadPhase->GetWorld()->GetAllocator()) dgBroadPhaseBodyNode(body);
 	if (!m_root) {
@@ -66,6 +66,12 @@ void dgBroadPhaseMixed::InvalidateCache()
 
 void dgBroadPhaseMixed::ForEachBodyInAABB(const dgVector& minBox, const dgVector& maxBox, OnBodiesInAABB callback, void* const userData) const
 {
+	dgQueryTreeReader queryTree(this);
+	if (queryTree.IsValid()) {
+		QueryTreeForEachBodyInAABB(minBox, maxBox, callback, userData);
+		return;
+	}
+
 	if (m_rootNode) {
 		const dgBroadPhaseNode* stackPool[DG_BROADPHASE_MAX_STACK_DEPTH];
 		stackPool[0] = m_rootNode;
@@ -76,6 +82,15 @@ void dgBroadPhaseMixed::ForEachBodyInAABB(const dgVector& minBox, const dgVector
 
 void dgBroadPhaseMixed::RayCast(const dgVector& l0, const dgVector& l1, OnRayCastAction filter, OnRayPrecastAction prefilter, void* const userData) const
 {
+	dgQueryTreeReader queryTree(this);
+	if (filter && queryTree.IsValid()) {
+		dgVector segment(l1 - l0);
+		if (segment.DotProduct(segment).GetScalar() > dgFloat32(1.0e-8f)) {
+			QueryTreeRayCast(l0, l1, filter, prefilter, userData);
+		}
+		return;
+	}
+
 	if (filter && m_rootNode) {
 		dgVector segment(l1 - l0);
 		dgAssert (segment.m_w == dgFloat32 (0.0f));
@@ -98,7 +113,10 @@ void dgBroadPhaseMixed::RayCast(const dgVector& l0, const dgVector& l1, OnRayCas
 dgInt32 dgBroadPhaseMixed::ConvexCast(dgCollisionInstance* const shape, const dgMatrix& matrix, const dgVector& target, dgFloat32* const param, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const
 {
 	dgInt32 totalCount = 0;
-	if (m_rootNode) {
+	dgQueryTreeReader queryTree(this);
+	if (m_rootNode && queryTree.IsValid()) {
+		totalCount = QueryTreeConvexCast(shape, matrix, target, param, prefilter, userData, info, maxContacts, threadIndex);
+	} else if (m_rootNode) {
 		dgVector boxP0;
 		dgVector boxP1;
 		dgAssert(matrix.TestOrthogonal());
@@ -126,7 +144,10 @@ dgInt32 dgBroadPhaseMixed::ConvexCast(dgCollisionInstance* const shape, const dg
 dgInt32 dgBroadPhaseMixed::Collide(dgCollisionInstance* const shape, const dgMatrix& matrix, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const
 {
 	dgInt32 totalCount = 0;
-	if (m_rootNode) {
+	dgQueryTreeReader queryTree(this);
+	if (m_rootNode && queryTree.IsValid()) {
+		totalCount = QueryTreeCollide(shape, matrix, prefilter, userData, info, maxContacts, threadIndex);
+	} else if (m_rootNode) {
 		dgVector boxP0;
 		dgVector boxP1;
 		dgAssert(matrix.TestOrthogonal());
@@ -146,6 +167,7 @@ dgInt32 dgBroadPhaseMixed::Collide(dgCollisionInstance* const shape, const dgMat
 
 void dgBroadPhaseMixed::AddNode(dgBroadPhaseNode* const newNode)
 {
+	InvalidateQueryTree();
 	if (!m_rootNode) {
 		m_rootNode = newNode;
 	} else {
@@ -183,6 +205,7 @@ void dgBroadPhaseMixed::LinkAggregate(dgBroadPhaseAggregate* const aggregate)
 
 void dgBroadPhaseMixed::RemoveNode(dgBroadPhaseNode* const node)
 {
+	InvalidateQueryTree();
 	if (node->m_parent) {
 		if (!node->m_parent->IsAggregate()) {
 			dgBroadPhaseTreeNode* const parent = (dgBroadPhaseTreeNode*)node->m_parent;
@@ -271,6 +294,7 @@ void dgBroadPhaseMixed::RemoveNode(dgBroadPhaseNode* const node)
 
 void dgBroadPhaseMixed::UnlinkAggregate(dgBroadPhaseAggregate* const aggregate)
 {
+	InvalidateQueryTree();
 	dgAssert (m_rootNode);
 	if (m_rootNode == aggregate) {
 		m_rootNode = NULL;
@@ -95,6 +95,7 @@ void dgBroadPhaseSegregated::CheckStaticDynamic(dgBody* const body, dgFloat32 ma
 
 void dgBroadPhaseSegregated::AddStaticBody(dgBody* const body)
 {
+	InvalidateQueryTree();
 	dgBroadPhaseSegregatedRootNode* const root = (dgBroadPhaseSegregatedRootNode*)m_rootNode;
 	dgAssert(m_rootNode->IsSegregatedRoot());
 
@@ -111,6 +112,7 @@ void dgBroadPhaseSegregated::AddStaticBody(dgBody* const body)
 
 void dgBroadPhaseSegregated::AddDynamicBody(dgBody* const body)
 {
+	InvalidateQueryTree();
 	dgBroadPhaseSegregatedRootNode* const root = (dgBroadPhaseSegregatedRootNode*)m_rootNode;
 	dgAssert(m_rootNode->IsSegregatedRoot());
 
@@ -147,6 +149,7 @@ dgBroadPhaseAggregate* dgBroadPhaseSegregated::CreateAggregate()
 
 void dgBroadPhaseSegregated::LinkAggregate(dgBroadPhaseAggregate* const aggregate)
 {
+	InvalidateQueryTree();
 	dgAssert(m_rootNode->IsSegregatedRoot());
 	dgBroadPhaseSegregatedRootNode* const root = (dgBroadPhaseSegregatedRootNode*)m_rootNode;
 
@@ -171,6 +174,7 @@ void dgBroadPhaseSegregated::DestroyAggregate(dgBroadPhaseAggregate* const aggre
 
 void dgBroadPhaseSegregated::RemoveNode(dgBroadPhaseNode* const node)
 {
+	InvalidateQueryTree();
 	dgAssert (node->m_parent);
 
 	if (node->m_parent->IsSegregatedRoot()) {
@@ -310,6 +314,7 @@ void dgBroadPhaseSegregated::RemoveNode(dgBroadPhaseNode* const node)
 
 void dgBroadPhaseSegregated::UnlinkAggregate (dgBroadPhaseAggregate* const aggregate)
 {
+	InvalidateQueryTree();
 	dgBroadPhaseSegregatedRootNode* const root = (dgBroadPhaseSegregatedRootNode*)m_rootNode;
 	dgAssert (root && root->m_left);
 	if (aggregate->m_parent == root) {
@@ -389,6 +394,12 @@ void dgBroadPhaseSegregated::UpdateFitness()
 
 void dgBroadPhaseSegregated::ForEachBodyInAABB(const dgVector& minBox, const dgVector& maxBox, OnBodiesInAABB callback, void* const userData) const
 {
+	dgQueryTreeReader queryTree(this);
+	if (queryTree.IsValid()) {
+		QueryTreeForEachBodyInAABB(minBox, maxBox, callback, userData);
+		return;
+	}
+
 	dgBroadPhaseSegregatedRootNode* const root = (dgBroadPhaseSegregatedRootNode*)m_rootNode;
 	const dgBroadPhaseNode* stackPool[DG_BROADPHASE_MAX_STACK_DEPTH];
 
@@ -407,6 +418,15 @@ void dgBroadPhaseSegregated::ForEachBodyInAABB(const dgVector& minBox, const dgV
 
 void dgBroadPhaseSegregated::RayCast(const dgVector& l0, const dgVector& l1, OnRayCastAction filter, OnRayPrecastAction prefilter, void* const userData) const
 {
+	dgQueryTreeReader queryTree(this);
+	if (filter && queryTree.IsValid()) {
+		dgVector segment(l1 - l0);
+		if (segment.DotProduct(segment).GetScalar() > dgFloat32(1.0e-8f)) {
+			QueryTreeRayCast(l0, l1, filter, prefilter, userData);
+		}
+		return;
+	}
+
 	dgBroadPhaseSegregatedRootNode* const root = (dgBroadPhaseSegregatedRootNode*)m_rootNode;
 	if (filter && (root->m_left || root->m_right)) {
 		dgVector segment(l1 - l0);
@@ -445,7 +465,10 @@ void dgBroadPhaseSegregated::RayCast(const dgVector& l0, const dgVector& l1, OnR
 dgInt32 dgBroadPhaseSegregated::ConvexCast(dgCollisionInstance* const shape, const dgMatrix& matrix, const dgVector& target, dgFloat32* const param, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const
 {
 	dgInt32 totalCount = 0;
-	if (m_rootNode) {
+	dgQueryTreeReader queryTree(this);
+	if (m_rootNode && queryTree.IsValid()) {
+		totalCount = QueryTreeConvexCast(shape, matrix, target, param, prefilter, userData, info, maxContacts, threadIndex);
+	} else if (m_rootNode) {
 		dgVector boxP0;
 		dgVector boxP1;
 		dgAssert(matrix.TestOrthogonal());
@@ -491,7 +514,10 @@ dgInt32 dgBroadPhaseSegregated::ConvexCast(dgCollisionInstance* const shape, con
 dgInt32 dgBroadPhaseSegregated::Collide(dgCollisionInstance* const shape, const dgMatrix& matrix, OnRayPrecastAction prefilter, void* const userData, dgConvexCastReturnInfo* const info, dgInt32 maxContacts, dgInt32 threadIndex) const
 {
 	dgInt32 totalCount = 0;
-	if (m_rootNode) {
+	dgQueryTreeReader queryTree(this);
+	if (m_rootNode && queryTree.IsValid()) {
+		totalCount = QueryTreeCollide(shape, matrix, prefilter, userData, info, maxContacts, threadIndex);
+	} else if (m_rootNode) {
 		dgVector boxP0;
 		dgVector boxP1;
 		dgAssert(matrix.TestOrthogonal());
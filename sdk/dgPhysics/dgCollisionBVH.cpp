@@ -40,7 +40,7 @@ dgCollisionBVH::dgCollisionBVH (dgWorld* const world, dgDeserialize deserializat
 	,m_trianglesCount(0)
 {
 	dgAssert (m_rtti | dgCollisionBVH_RTTI);
-	m_builder = NULL;;
+	m_builder = NULL;
 	m_userRayCastCallback = NULL;
 
 	dgAABBPolygonSoup::Deserialize (deserialization, userData, revisionNumber);
@@ -53,6 +53,31 @@ dgCollisionBVH::dgCollisionBVH (dgWorld* const world, dgDeserialize deserializat
 	deserialization(userData, &m_trianglesCount, sizeof (dgInt32));
 }
 
+dgCollisionBVH::dgCollisionBVH (dgWorld* const world, const dgImageHeader* const header)
+	:dgCollisionMesh (world, header)
+	,dgAABBPolygonSoup()
+	,m_trianglesCount(0)
+{
+	dgAssert (header->m_collisionId == m_boundingBoxHierachy);
+	m_rtti |= dgCollisionBVH_RTTI;
+	m_builder = NULL;
+	m_userRayCastCallback = NULL;
+
+	// the image is image header, bvh header, soup image. a bad soup image leaves the mesh empty and unmapped
+	const dgInt32 soupOffset = dgInt32 (sizeof (dgImageHeader) + sizeof (dgBVHImage));
+	if (header->m_sizeInBytes >= soupOffset) {
+		const dgBVHImage* const image = (const dgBVHImage*) (header + 1);
+		if (MapImage ((const dgImage*) ((const char*)header + soupOffset), header->m_sizeInBytes - soupOffset)) {
+			m_trianglesCount = image->m_trianglesCount;
+		}
+	}
+
+	dgVector p0; 
+	dgVector p1; 
+	GetAABB (p0, p1);
+	SetCollisionBBox(p0, p1);
+}
+
 dgCollisionBVH::~dgCollisionBVH(void)
 {
 }
@@ -64,6 +89,22 @@ void dgCollisionBVH::Serialize(dgSerialize callback, void* const userData) const
 	callback(userData, &m_trianglesCount, sizeof (dgInt32));
 }
 
+dgInt32 dgCollisionBVH::GetImageSize () const
+{
+	return dgInt32 (sizeof (dgImageHeader) + sizeof (dgBVHImage)) + dgAABBPolygonSoup::GetImageSize();
+}
+
+void dgCollisionBVH::SerializeImage (dgSerialize callback, void* const userData) const
+{
+	dgBVHImage image;
+	memset (&image, 0, sizeof (image));
+	image.m_trianglesCount = m_trianglesCount;
+
+	SerializeImageHeader (callback, userData);
+	callback (userData, &image, sizeof (image));
+	dgAABBPolygonSoup::SerializeImage (callback, userData);
+}
+
 void dgCollisionBVH::BeginBuild()
 {
 	m_builder = new (m_allocator) dgPolygonSoupDatabaseBuilder(m_allocator);
@@ -89,16 +130,17 @@ void dgCollisionBVH::SetCollisionRayCastCallback (dgCollisionBVHUserRayCastCallb
 }
 
 
-void dgCollisionBVH::EndBuild(dgInt32 optimize)
+void dgCollisionBVH::EndBuild(dgInt32 optimize, dgThreadHive* const threadPool)
 {
 	dgVector p0;
 	dgVector p1;
 
 	bool state = optimize ? true : false;
 
-	m_builder->End(state);
-	Create (*m_builder, state);
-	CalculateAdjacendy();
+	// the build is serial unless the caller lends it an idle thread pool
+	m_builder->End(state, threadPool);
+	Create (*m_builder, state, threadPool);
+	CalculateAdjacendy(threadPool);
 	
 	GetAABB (p0, p1);
 	SetCollisionBBox (p0, p1);
@@ -51,12 +51,13 @@ class dgCollisionBVH: public dgCollisionMesh, public dgAABBPolygonSoup
 	} DG_GCC_VECTOR_ALIGMENT;
 
 	dgCollisionBVH(dgWorld* const world);
+	dgCollisionBVH (dgWorld* const world, const dgImageHeader* const header);
 	dgCollisionBVH (dgWorld* const world, dgDeserialize deserialization, void* const userData, dgInt32 revisionNumber);
 	virtual ~dgCollisionBVH(void);
 
 	void BeginBuild();
 	void AddFace (dgInt32 vertexCount, const dgFloat32* const vertexPtr, dgInt32 strideInBytes, dgInt32 faceAttribute);
-	void EndBuild(dgInt32 optimize);
+	void EndBuild(dgInt32 optimize, dgThreadHive* const threadPool = NULL);
 
 	void SetCollisionRayCastCallback (dgCollisionBVHUserRayCastCallback rayCastCallback);
 	dgCollisionBVHUserRayCastCallback GetDebugRayCastCallback() const { return m_userRayCastCallback;} 
@@ -72,7 +73,16 @@ class dgCollisionBVH: public dgCollisionMesh, public dgAABBPolygonSoup
 	static dgIntersectStatus GetTriangleCount (void* const context, const dgFloat32* const polygon, dgInt32 strideInBytes, const dgInt32* const indexArray, dgInt32 indexCount, dgFloat32 hitDistance);
 	static dgIntersectStatus CollectVertexListIndexList (void* const context, const dgFloat32* const polygon, dgInt32 strideInBytes, const dgInt32* const indexArray, dgInt32 indexCount, dgFloat32 hitDistance);
 
+	class dgBVHImage
+	{
+		public:
+		dgInt32 m_trianglesCount;
+		dgInt32 m_reserved[3];
+	};
+
 	void Serialize(dgSerialize callback, void* const userData) const;
+	virtual dgInt32 GetImageSize () const;
+	virtual void SerializeImage (dgSerialize callback, void* const userData) const;
 	virtual dgVector SupportVertex (const dgVector& dir) const;
 
 	virtual dgFloat32 RayCast (const dgVector& localP0, const dgVector& localP1, dgFloat32 maxT, dgContactPoint& contactOut, const dgBody* const body, void* const userData, OnRayPrecastAction preFilter) const;
@@ -37,6 +37,12 @@ DG_MSC_VECTOR_ALIGMENT
 class dgCollisionConvexHull::dgConvexBox
 {
 	public:
+	// projection of the box corner furthest along dir, positiveMask selects the max corner for positive components of dir
+	DG_INLINE dgFloat32 SupportDist (const dgVector& dir, const dgVector& positiveMask) const
+	{
+		return m_box[0].Select(m_box[1], positiveMask).DotProduct(dir).GetScalar();
+	}
+
 	dgVector m_box[2];
 	dgInt32 m_vertexStart;
 	dgInt32 m_vertexCount;
@@ -44,6 +50,22 @@ class dgCollisionConvexHull::dgConvexBox
 	dgInt32 m_rightBox;
 } DG_GCC_VECTOR_ALIGMENT;
 
+// the vertices of a leaf of the support tree stored in SoA form, so that the projections 
+// of all of them are calculated at once. unused lanes repeat the first vertex of the leaf.
+DG_MSC_VECTOR_ALIGMENT
+class dgCollisionConvexHull::dgSupportBlock
+{
+	public:
+	DG_INLINE dgVector Projection (const dgVector& dirX, const dgVector& dirY, const dgVector& dirZ) const
+	{
+		return (m_x * dirX).MulAdd(m_y, dirY).MulAdd(m_z, dirZ);
+	}
+
+	dgVector m_x;
+	dgVector m_y;
+	dgVector m_z;
+} DG_GCC_VECTOR_ALIGMENT;
+
 dgCollisionConvexHull::dgCollisionConvexHull(dgMemoryAllocator* const allocator, dgUnsigned32 signature)
 	:dgCollisionConvex(allocator, signature, m_convexHullCollision)
 	,m_faceCount (0)
@@ -51,6 +73,7 @@ dgCollisionConvexHull::dgCollisionConvexHull(dgMemoryAllocator* const allocator,
 	,m_faceArray (NULL)
 	,m_vertexToEdgeMapping(NULL)
 	,m_supportTree (NULL)
+	,m_supportBlocks (NULL)
 {
 	m_edgeCount = 0;
 	m_vertexCount = 0;
@@ -66,6 +89,7 @@ dgCollisionConvexHull::dgCollisionConvexHull(dgMemoryAllocator* const allocator,
 	,m_faceArray (NULL)
 	,m_vertexToEdgeMapping(NULL)
 	,m_supportTree (NULL)
+	,m_supportBlocks (NULL)
 {
 	m_edgeCount = 0;
 	m_vertexCount = 0;
@@ -83,6 +107,7 @@ dgCollisionConvexHull::dgCollisionConvexHull(dgWorld* const world, dgDeserialize
 	,m_faceArray (NULL)
 	,m_vertexToEdgeMapping(NULL)
 	,m_supportTree (NULL)
+	,m_supportBlocks (NULL)
 {
 	m_rtti |= dgCollisionConvexHull_RTTI;
 	deserialization (userData, &m_vertexCount, sizeof (dgInt32));
@@ -123,6 +148,7 @@ dgCollisionConvexHull::dgCollisionConvexHull(dgWorld* const world, dgDeserialize
 		m_vertexToEdgeMapping[i] = m_simplex + faceOffset; 
 	}
 
+	BuildSupportBlocks ();
 	SetVolumeAndCG ();
 }
 
@@ -138,6 +164,9 @@ dgCollisionConvexHull::~dgCollisionConvexHull()
 	if (m_supportTree) {
 		m_allocator->Free(m_supportTree);
 	}
+	if (m_supportBlocks) {
+		m_allocator->Free(m_supportBlocks);
+	}
 }
 
 void dgCollisionConvexHull::BuildHull (dgInt32 count, dgInt32 strideInBytes, dgFloat32 tolerance, const dgFloat32* const vertexArray)
@@ -700,10 +729,43 @@ bool dgCollisionConvexHull::Create (dgInt32 count, dgInt32 strideInBytes, const
 		m_vertexToEdgeMapping[edge->m_vertex] = edge;
 	}
 
+	BuildSupportBlocks ();
 	SetVolumeAndCG ();
 	return true;
 }
 
+void dgCollisionConvexHull::BuildSupportBlocks ()
+{
+	// one block per box of the support tree, only the leaves are filled, 
+	// hulls without a tree have at most DG_CONVEX_VERTEX_CHUNK_SIZE vertices in a single block
+	dgAssert (DG_CONVEX_VERTEX_CHUNK_SIZE <= 4);
+	const dgInt32 blockCount = m_supportTreeCount ? m_supportTreeCount : 1;
+	m_supportBlocks = (dgSupportBlock*) m_allocator->Malloc(dgInt32 (blockCount * sizeof(dgSupportBlock)));
+	memset (m_supportBlocks, 0, blockCount * sizeof(dgSupportBlock));
+	for (dgInt32 i = 0; i < blockCount; i ++) {
+		dgInt32 start = 0;
+		dgInt32 count = m_vertexCount;
+		if (m_supportTreeCount) {
+			const dgConvexBox& box = m_supportTree[i];
+			if (box.m_leftBox > 0) {
+				continue;
+			}
+			start = box.m_vertexStart;
+			count = box.m_vertexCount;
+		}
+		dgAssert (count >= 1);
+		dgAssert (count <= 4);
+
+		dgSupportBlock& block = m_supportBlocks[i];
+		for (dgInt32 j = 0; j < 4; j ++) {
+			const dgVector& p = m_vertex[start + ((j < count) ? j : 0)];
+			block.m_x[j] = p.m_x;
+			block.m_y[j] = p.m_y;
+			block.m_z[j] = p.m_z;
+		}
+	}
+}
+
 dgInt32 dgCollisionConvexHull::CalculateSignature (dgInt32 vertexCount, const dgFloat32* const vertexArray, dgInt32 strideInBytes)
 {
 	dgStack<dgUnsigned32> buffer(1 + 3 * vertexCount);  
@@ -764,23 +826,21 @@ dgVector dgCollisionConvexHull::SupportVertex (const dgVector& dir, dgInt32* con
 {
 	dgAssert (dir.m_w == dgFloat32 (0.0f));
 	dgInt32 index = -1;
-	dgVector maxProj (dgFloat32 (-1.0e20f)); 
+	dgFloat32 maxProj = dgFloat32 (-1.0e20f);
+	const dgVector dirX (dir.BroadcastX());
+	const dgVector dirY (dir.BroadcastY());
+	const dgVector dirZ (dir.BroadcastZ());
 	if (m_vertexCount > DG_CONVEX_VERTEX_CHUNK_SIZE) {
 		dgFloat32 distPool[32];
 		const dgConvexBox* stackPool[32];
 
-		dgInt32 ix = (dir[0] > dgFloat64 (0.0f)) ? 1 : 0;
-		dgInt32 iy = (dir[1] > dgFloat64 (0.0f)) ? 1 : 0;
-		dgInt32 iz = (dir[2] > dgFloat64 (0.0f)) ? 1 : 0;
+		const dgVector positiveMask (dir > dgVector::m_zero);
 
 		const dgConvexBox& leftBox = m_supportTree[m_supportTree[0].m_leftBox];
 		const dgConvexBox& rightBox = m_supportTree[m_supportTree[0].m_rightBox];
-		
-		dgVector leftP (leftBox.m_box[ix][0], leftBox.m_box[iy][1], leftBox.m_box[iz][2], dgFloat32 (0.0f));
-		dgVector rightP (rightBox.m_box[ix][0], rightBox.m_box[iy][1], rightBox.m_box[iz][2], dgFloat32 (0.0f));
 
-		dgFloat32 leftDist = leftP.DotProduct(dir).m_x;
-		dgFloat32 rightDist = rightP.DotProduct(dir).m_x;
+		dgFloat32 leftDist = leftBox.SupportDist(dir, positiveMask);
+		dgFloat32 rightDist = rightBox.SupportDist(dir, positiveMask);
 		if (rightDist >= leftDist) {
 			distPool[0] = leftDist;
 			stackPool[0] = &leftBox; 
@@ -800,7 +860,7 @@ dgVector dgCollisionConvexHull::SupportVertex (const dgVector& dir, dgInt32* con
 		while (stack) {
 			stack--;
 			dgFloat32 dist = distPool[stack];
-			if (dist > maxProj.m_x) {
+			if (dist > maxProj) {
 				const dgConvexBox& box = *stackPool[stack];
 
 				if (box.m_leftBox > 0) {
@@ -808,11 +868,8 @@ dgVector dgCollisionConvexHull::SupportVertex (const dgVector& dir, dgInt32* con
 					const dgConvexBox& leftBox1 = m_supportTree[box.m_leftBox];
 					const dgConvexBox& rightBox1 = m_supportTree[box.m_rightBox];
 
-					dgVector leftBoxP (leftBox1.m_box[ix][0], leftBox1.m_box[iy][1], leftBox1.m_box[iz][2], dgFloat32 (0.0f));
-					dgVector rightBoxP (rightBox1.m_box[ix][0], rightBox1.m_box[iy][1], rightBox1.m_box[iz][2], dgFloat32 (0.0f));
-
-					dgFloat32 leftBoxDist = leftBoxP.DotProduct(dir).m_x;
-					dgFloat32 rightBoxDist = rightBoxP.DotProduct(dir).m_x;
+					dgFloat32 leftBoxDist = leftBox1.SupportDist(dir, positiveMask);
+					dgFloat32 rightBoxDist = rightBox1.SupportDist(dir, positiveMask);
 					if (rightBoxDist >= leftBoxDist) {
 						distPool[stack] = leftBoxDist;
 						stackPool[stack] = &leftBox1; 
@@ -836,32 +893,23 @@ dgVector dgCollisionConvexHull::SupportVertex (const dgVector& dir, dgInt32* con
 						dgAssert (stack < sizeof (distPool)/sizeof (distPool[0]));
 					}
 				} else {
-					for (dgInt32 i = 0; i < box.m_vertexCount; i ++) {
-						const dgVector& p = m_vertex[box.m_vertexStart + i];
-						dgAssert (p.m_x >= box.m_box[0].m_x);
-						dgAssert (p.m_x <= box.m_box[1].m_x);
-						dgAssert (p.m_y >= box.m_box[0].m_y);
-						dgAssert (p.m_y <= box.m_box[1].m_y);
-						dgAssert (p.m_z >= box.m_box[0].m_z);
-						dgAssert (p.m_z <= box.m_box[1].m_z);
-						dgVector projectionDist (p.DotProduct(dir));
-						dgVector mask (projectionDist > maxProj);
-						dgInt32 intMask = *((dgInt32*) &mask.m_x);
-						index = ((box.m_vertexStart + i) & intMask) | (index & ~intMask);
-						maxProj = maxProj.GetMax(projectionDist);
+					const dgSupportBlock& block = m_supportBlocks[&box - m_supportTree];
+					const dgVector projection (block.Projection(dirX, dirY, dirZ));
+					const dgFloat32 blockMaxProj = projection.GetMax();
+					if (blockMaxProj > maxProj) {
+						// first lane with the largest projection
+						const dgInt32 mask = (projection == dgVector (blockMaxProj)).GetSignMask();
+						index = box.m_vertexStart + dgExp2 (mask & -mask);
+						maxProj = blockMaxProj;
 					}
 				}
 			}
 		}
 	} else {
-		for (dgInt32 i = 0; i < m_vertexCount; i ++) {
-			const dgVector& p = m_vertex[i];
-			dgVector dist (p.DotProduct(dir));
-			dgVector mask (dist > maxProj);
-			dgInt32 intMask = *((dgInt32*) &mask.m_x);
-			index = (i & intMask) | (index & ~intMask);
-			maxProj = maxProj.GetMax(dist);
-		}
+		const dgVector projection (m_supportBlocks[0].Projection(dirX, dirY, dirZ));
+		maxProj = projection.GetMax();
+		const dgInt32 mask = (projection == dgVector (maxProj)).GetSignMask();
+		index = dgExp2 (mask & -mask);
 	}
 
 	if (vertexIndex) {
@@ -29,6 +29,7 @@ class dgCollisionConvexHull: public dgCollisionConvex
 {
 	public:
 	class dgConvexBox;
+	class dgSupportBlock;
 
 	dgCollisionConvexHull(dgMemoryAllocator* const allocator, dgUnsigned32 signature);
 	dgCollisionConvexHull(dgMemoryAllocator* const allocator, dgUnsigned32 signature, dgInt32 count, dgInt32 strideInBytes, dgFloat32 tolerance, const dgFloat32* const vertexArray);
@@ -46,6 +47,7 @@ class dgCollisionConvexHull: public dgCollisionConvex
 	bool RemoveCoplanarEdge (dgPolyhedra& convex, const dgBigVector* const hullVertexArray) const;	
 	dgBigVector FaceNormal (const dgEdge *face, const dgBigVector* const pool) const;
 	bool CheckConvex (dgPolyhedra& polyhedra, const dgBigVector* hullVertexArray) const;
+	void BuildSupportBlocks ();
 
 	virtual dgVector SupportVertex (const dgVector& dir, dgInt32* const vertexIndex) const;
 
@@ -64,6 +66,7 @@ class dgCollisionConvexHull: public dgCollisionConvex
 	dgConvexSimplexEdge** m_faceArray;
 	const dgConvexSimplexEdge** m_vertexToEdgeMapping;
 	dgConvexBox* m_supportTree;
+	dgSupportBlock* m_supportBlocks;
 
 	friend class dgWorld;
 	friend class dgCollisionConvex;
@@ -26,6 +26,14 @@
 
 
 #define DG_HIGHTFIELD_DATA_ID 0x45AF5E07
+#define DG_HIGHTFIELD_TILED_FLAG 0x100
+#define DG_HIGHTFIELD_TILE_BLOCK_SHIFT 3
+
+// tile request states, a tile is resident only when its elevation pointer is published
+#define DG_HIGHTFIELD_TILE_IDLE			0
+#define DG_HIGHTFIELD_TILE_LOADING		1
+#define DG_HIGHTFIELD_TILE_REQUESTED	2
+#define DG_HIGHTFIELD_IMAGE_ALIGN(x) (((x) + 15) & -16)
 
 dgVector dgCollisionHeightField::m_yMask (0xffffffff, 0, 0xffffffff, 0);
 dgVector dgCollisionHeightField::m_padding (dgFloat32 (0.25f), dgFloat32 (0.25f), dgFloat32 (0.25f), dgFloat32 (0.0f));
@@ -72,6 +80,17 @@ dgCollisionHeightField::dgCollisionHeightField(
 	,m_horizontalDisplacementScale_z(dgFloat32(1.0f))
 	,m_userRayCastCallback(NULL)
 	,m_elevationDataType(elevationDataType)
+	,m_mapped(false)
+	,m_tiles(NULL)
+	,m_tileCount_x(0)
+	,m_tileCount_z(0)
+	,m_tileSize(0)
+	,m_tileShift(0)
+	,m_tileMask(0)
+	,m_tileLevels(0)
+	,m_tileLock(0)
+	,m_tileLoadCallback(NULL)
+	,m_tileLoadUserData(NULL)
 {
 	m_rtti |= dgCollisionHeightField_RTTI;
 
@@ -95,159 +114,88 @@ dgCollisionHeightField::dgCollisionHeightField(
 	m_atributeMap = (dgInt8 *)dgMallocStack(attibutePaddedMapSize * sizeof (dgInt8));
 	m_diagonals = (dgInt8 *)dgMallocStack(attibutePaddedMapSize * sizeof (dgInt8));
 
-	switch (m_diagonalMode)
-	{
-		case m_normalDiagonals:
-		{
-			memset (m_diagonals, 0, m_width * m_height * sizeof (dgInt8));
-			break;
-		}
-		case m_invertedDiagonals:
-		{
-			memset (m_diagonals, 1, m_width * m_height * sizeof (dgInt8));
-			break;
-		}
-
-		case m_alternateOddRowsDiagonals:
-		{
-			for (dgInt32 j = 0; j < m_height; j += 2) {
-				dgInt32 index = j * m_width;
-				for (dgInt32 i = 0; i < m_width; i ++) {
-					m_diagonals[index + i] = 0;
-				}
-			}
-
-			for (dgInt32 j = 1; j < m_height; j += 2) {
-				dgInt32 index = j * m_width;
-				for (dgInt32 i = 0; i < m_width; i ++) {
-					m_diagonals[index + i] = 1;
-				}
-			}
-			break;
-		}
-
-		case m_alternateEvenRowsDiagonals:
-		{
-			for (dgInt32 j = 0; j < m_height; j += 2) {
-				dgInt32 index = j * m_width;
-				for (dgInt32 i = 0; i < m_width; i ++) {
-					m_diagonals[index + i] = 1;
-				}
-			}
-
-			for (dgInt32 j = 1; j < m_height; j += 2) {
-				dgInt32 index = j * m_width;
-				for (dgInt32 i = 0; i < m_width; i ++) {
-					m_diagonals[index + i] = 0;
-				}
-			}
-			break;
-		}
-
-
-		case m_alternateOddColumsDiagonals:
-		{
-			for (dgInt32 j = 0; j < m_height; j ++) {
-				dgInt32 index = j * m_width;
-				for (dgInt32 i = 0; i < m_width; i += 2) {
-					m_diagonals[index + i] = 0;
-				}
-
-				for (dgInt32 i = 1; i < m_width; i += 2) {
-					m_diagonals[index + i] = 1;
-				}
-			}
-			break;
-		}
-
-		case m_alternateEvenColumsDiagonals:
-		{
-			for (dgInt32 j = 0; j < m_height; j ++) {
-				dgInt32 index = j * m_width;
-				for (dgInt32 i = 0; i < m_width; i += 2) {
-					m_diagonals[index + i] = 1;
-				}
-
-				for (dgInt32 i = 1; i < m_width; i += 2) {
-					m_diagonals[index + i] = 0;
-				}
-			}
-			break;
-		}
-
-		case m_starDiagonals:
-		{
-			for (dgInt32 j = 0; j < m_height; j += 2) {
-				dgInt32 index = j * m_width;
-				for (dgInt32 i = 0; i < m_width; i += 2) {
-					m_diagonals[index + i] = 0;
-				}
-				for (dgInt32 i = 1; i < m_width; i += 2) {
-					m_diagonals[index + i] = 1;
-				}
-			}
+	CalculateDiagonals(m_width, m_height);
+	memcpy (m_atributeMap, atributeMap, m_width * m_height * sizeof (dgInt8));
 
-			for (dgInt32 j = 1; j < m_height; j += 2) {
-				dgInt32 index = j * m_width;
-				for (dgInt32 i = 0; i < m_width; i += 2) {
-					m_diagonals[index + i] = 1;
-				}
-				for (dgInt32 i = 1; i < m_width; i += 2) {
-					m_diagonals[index + i] = 0;
-				}
-			}
-			break;
-		}
+	InitInstanceData(world);
 
-		case m_starInvertexDiagonals:
-		{
-			for (dgInt32 j = 0; j < m_height; j += 2) {
-				dgInt32 index = j * m_width;
-				for (dgInt32 i = 0; i < m_width; i += 2) {
-					m_diagonals[index + i] = 1;
-				}
-				for (dgInt32 i = 1; i < m_width; i += 2) {
-					m_diagonals[index + i] = 0;
-				}
-			}
+	CalculateAABB();
+	SetCollisionBBox(m_minBox, m_maxBox);
+}
 
-			for (dgInt32 j = 1; j < m_height; j += 2) {
-				dgInt32 index = j * m_width;
-				for (dgInt32 i = 0; i < m_width; i += 2) {
-					m_diagonals[index + i] = 0;
-				}
-				for (dgInt32 i = 1; i < m_width; i += 2) {
-					m_diagonals[index + i] = 1;
-				}
-			}
+dgCollisionHeightField::dgCollisionHeightField(
+	dgWorld* const world, dgInt32 tileCount_x, dgInt32 tileCount_z, dgInt32 tileSize, dgInt32 contructionMode, 
+	dgElevationType elevationDataType, dgFloat32 minElevation, dgFloat32 maxElevation, dgFloat32 verticalScale, 
+	dgFloat32 horizontalScale_x, dgFloat32 horizontalScale_z)
+	:dgCollisionMesh (world, m_heightField)
+	,m_diagonalMode (dgCollisionHeightFieldGridConstruction  (dgClamp (contructionMode, dgInt32 (m_normalDiagonals), dgInt32 (m_starInvertexDiagonals))))
+	,m_atributeMap(NULL)
+	,m_elevationMap(NULL)
+	,m_horizontalDisplacement(NULL)
+	,m_verticalScale(verticalScale)
+	,m_horizontalScale_x(horizontalScale_x)
+	,m_horizontalScaleInv_x (dgFloat32 (1.0f) / m_horizontalScale_x)
+	,m_horizontalDisplacementScale_x(dgFloat32 (1.0f))
+	,m_horizontalScale_z(horizontalScale_z)
+	,m_horizontalScaleInv_z(dgFloat32(1.0f) / m_horizontalScale_z)
+	,m_horizontalDisplacementScale_z(dgFloat32(1.0f))
+	,m_userRayCastCallback(NULL)
+	,m_elevationDataType(elevationDataType)
+	,m_mapped(false)
+	,m_tileLock(0)
+	,m_tileLoadCallback(NULL)
+	,m_tileLoadUserData(NULL)
+{
+	m_rtti |= dgCollisionHeightField_RTTI;
 
-			break;
-		}
+	InitTiles(tileCount_x, tileCount_z, tileSize);
+	InitInstanceData(world);
 
-		default:
-			dgAssert (0);
-		
-	}
-	memcpy (m_atributeMap, atributeMap, m_width * m_height * sizeof (dgInt8));
+	// tiles are not resident at creation time, so the vertical extend is the one declared by the application
+	m_minBox = dgVector (dgFloat32 (0.0f),                               minElevation * m_verticalScale, dgFloat32 (0.0f),                                dgFloat32 (0.0f)); 
+	m_maxBox = dgVector (dgFloat32 (m_width - 1) * m_horizontalScale_x, maxElevation * m_verticalScale, dgFloat32 (m_height - 1) * m_horizontalScale_z, dgFloat32 (0.0f)); 
+	SetCollisionBBox(m_minBox, m_maxBox);
+}
 
-	dgTree<void*, unsigned>::dgTreeNode* nodeData = world->m_perInstanceData.Find(DG_HIGHTFIELD_DATA_ID);
-	if (!nodeData) {
-		m_instanceData = (dgPerIntanceData*) new dgPerIntanceData();
-		m_instanceData->m_refCount = 0;
-		m_instanceData->m_world = world;
-		for (dgInt32 i = 0 ; i < DG_MAX_THREADS_HIVE_COUNT; i ++) {
-			m_instanceData->m_vertex[i] = NULL;
-			m_instanceData->m_vertexCount[i] = 0;
-			m_instanceData->m_vertex[i].SetAllocator(world->GetAllocator());
-			AllocateVertex(world, i);
-		}
-		nodeData = world->m_perInstanceData.Insert (m_instanceData, DG_HIGHTFIELD_DATA_ID);
-	}
-	m_instanceData = (dgPerIntanceData*) nodeData->GetInfo();
+dgCollisionHeightField::dgCollisionHeightField (dgWorld* const world, const dgImageHeader* const header)
+	:dgCollisionMesh (world, header)
+	,m_width(0)
+	,m_height(0)
+	,m_diagonalMode(m_normalDiagonals)
+	,m_atributeMap(NULL)
+	,m_diagonals(NULL)
+	,m_elevationMap(NULL)
+	,m_horizontalDisplacement(NULL)
+	,m_verticalScale(dgFloat32 (1.0f))
+	,m_horizontalScale_x(dgFloat32 (1.0f))
+	,m_horizontalScaleInv_x(dgFloat32 (1.0f))
+	,m_horizontalDisplacementScale_x(dgFloat32 (1.0f))
+	,m_horizontalScale_z(dgFloat32 (1.0f))
+	,m_horizontalScaleInv_z(dgFloat32 (1.0f))
+	,m_horizontalDisplacementScale_z(dgFloat32 (1.0f))
+	,m_userRayCastCallback(NULL)
+	,m_elevationDataType(m_float32Bit)
+	,m_mapped(false)
+	,m_tiles(NULL)
+	,m_tileCount_x(0)
+	,m_tileCount_z(0)
+	,m_tileSize(0)
+	,m_tileShift(0)
+	,m_tileMask(0)
+	,m_tileLevels(0)
+	,m_tileLock(0)
+	,m_tileLoadCallback(NULL)
+	,m_tileLoadUserData(NULL)
+{
+	dgAssert (header->m_collisionId == m_heightField);
+	m_rtti |= dgCollisionHeightField_RTTI;
 
-	m_instanceData->m_refCount ++;
+	// a bad image leaves the height field empty and unmapped
+	m_minBox = dgVector::m_zero;
+	m_maxBox = dgVector::m_zero;
+	MapImage (header);
 
-	CalculateAABB();
+	InitInstanceData(world);
 	SetCollisionBBox(m_minBox, m_maxBox);
 }
 
@@ -260,6 +208,11 @@ dgCollisionHeightField::dgCollisionHeightField (dgWorld* const world, dgDeserial
 
 	m_userRayCastCallback = NULL;
 	m_horizontalDisplacement = NULL;
+	m_mapped = false;
+	m_tiles = NULL;
+	m_tileLock = 0;
+	m_tileLoadCallback = NULL;
+	m_tileLoadUserData = NULL;
 	deserialization (userData, &m_width, sizeof (dgInt32));
 	deserialization (userData, &m_height, sizeof (dgInt32));
 	deserialization (userData, &m_diagonalMode, sizeof (dgInt32));
@@ -272,7 +225,25 @@ dgCollisionHeightField::dgCollisionHeightField (dgWorld* const world, dgDeserial
 	deserialization (userData, &m_minBox.m_x, sizeof (dgVector)); 
 	deserialization (userData, &m_maxBox.m_x, sizeof (dgVector)); 
 
-	m_elevationDataType = dgElevationType (elevationDataType);
+	m_elevationDataType = dgElevationType (elevationDataType & ~DG_HIGHTFIELD_TILED_FLAG);
+	m_horizontalScaleInv_x = dgFloat32 (1.0f) / m_horizontalScale_x;
+	m_horizontalScaleInv_z = dgFloat32 (1.0f) / m_horizontalScale_z;
+
+	if (elevationDataType & DG_HIGHTFIELD_TILED_FLAG) {
+		// only the tile layout is saved, the application streams the tiles back in
+		dgInt32 tileCount_x;
+		dgInt32 tileCount_z;
+		dgInt32 tileSize;
+		deserialization (userData, &tileCount_x, sizeof (dgInt32));
+		deserialization (userData, &tileCount_z, sizeof (dgInt32));
+		deserialization (userData, &tileSize, sizeof (dgInt32));
+		m_atributeMap = NULL;
+		m_elevationMap = NULL;
+		InitTiles(tileCount_x, tileCount_z, tileSize);
+		InitInstanceData(world);
+		SetCollisionBBox(m_minBox, m_maxBox);
+		return;
+	}
 
 	dgInt32 attibutePaddedMapSize = (m_width * m_height + 4) & -4; 
 	m_atributeMap = (dgInt8 *)dgMallocStack(attibutePaddedMapSize * sizeof (dgInt8));
@@ -304,25 +275,7 @@ dgCollisionHeightField::dgCollisionHeightField (dgWorld* const world, dgDeserial
 		deserialization (userData, m_horizontalDisplacement, m_width * m_height * sizeof (dgUnsigned16));
 	}
 
-	m_horizontalScaleInv_x = dgFloat32 (1.0f) / m_horizontalScale_x;
-	m_horizontalScaleInv_z = dgFloat32 (1.0f) / m_horizontalScale_z;
-
-	dgTree<void*, unsigned>::dgTreeNode* nodeData = world->m_perInstanceData.Find(DG_HIGHTFIELD_DATA_ID);
-	if (!nodeData) {
-		m_instanceData = (dgPerIntanceData*) new dgPerIntanceData();
-		m_instanceData->m_refCount = 0;
-		m_instanceData->m_world = world;
-		for (dgInt32 i = 0; i < DG_MAX_THREADS_HIVE_COUNT; i++) {
-			m_instanceData->m_vertex[i] = NULL;
-			m_instanceData->m_vertexCount[i] = 0;
-			m_instanceData->m_vertex[i].SetAllocator(world->GetAllocator());
-			AllocateVertex(world, i);
-		}
-		nodeData = world->m_perInstanceData.Insert(m_instanceData, DG_HIGHTFIELD_DATA_ID);
-	}
-	m_instanceData = (dgPerIntanceData*)nodeData->GetInfo();
-
-	m_instanceData->m_refCount ++;
+	InitInstanceData(world);
 	SetCollisionBBox(m_minBox, m_maxBox);
 }
 
@@ -334,8 +287,21 @@ dgCollisionHeightField::~dgCollisionHeightField(void)
 		delete m_instanceData;
 		world->m_perInstanceData.Remove(DG_HIGHTFIELD_DATA_ID);
 	}
-	dgFreeStack(m_elevationMap);
-	dgFreeStack(m_atributeMap);
+
+	if (m_mapped || !m_diagonals) {
+		// the maps belong to the image, or the image was rejected
+		return;
+	}
+
+	if (m_tiles) {
+		for (dgInt32 i = 0; i < m_tileCount_x * m_tileCount_z; i ++) {
+			EvictTile(&m_tiles[i]);
+		}
+		dgFreeStack(m_tiles);
+	} else {
+		dgFreeStack(m_elevationMap);
+		dgFreeStack(m_atributeMap);
+	}
 	dgFreeStack(m_diagonals);
 
 	if (m_horizontalDisplacement) {
@@ -343,11 +309,125 @@ dgCollisionHeightField::~dgCollisionHeightField(void)
 	}
 }
 
+dgInt32 dgCollisionHeightField::GetImageSize () const
+{
+	if (m_tiles) {
+		// tiled height fields stream their data, they have no image
+		return 0;
+	}
+	const dgInt32 cellsCount = m_width * m_height;
+	const dgInt32 attibutePaddedMapSize = (cellsCount + 4) & -4; 
+	const dgInt32 elevationSize = cellsCount * ((m_elevationDataType == m_float32Bit) ? sizeof (dgFloat32) : sizeof (dgUnsigned16));
+
+	dgInt32 size = DG_HIGHTFIELD_IMAGE_ALIGN (dgInt32 (sizeof (dgImageHeader) + sizeof (dgHeightFieldImage)));
+	size += DG_HIGHTFIELD_IMAGE_ALIGN (elevationSize);
+	size += DG_HIGHTFIELD_IMAGE_ALIGN (attibutePaddedMapSize) * 2;
+	if (m_horizontalDisplacement) {
+		size += DG_HIGHTFIELD_IMAGE_ALIGN (dgInt32 (cellsCount * sizeof (dgUnsigned16)));
+	}
+	return size;
+}
+
+void dgCollisionHeightField::SerializeImage (dgSerialize callback, void* const userData) const
+{
+	dgAssert (!m_tiles);
+	const dgInt32 cellsCount = m_width * m_height;
+	const dgInt32 attibutePaddedMapSize = (cellsCount + 4) & -4; 
+	const dgInt32 elevationSize = cellsCount * ((m_elevationDataType == m_float32Bit) ? sizeof (dgFloat32) : sizeof (dgUnsigned16));
+	const dgInt32 displacementSize = m_horizontalDisplacement ? dgInt32 (cellsCount * sizeof (dgUnsigned16)) : 0;
+
+	dgHeightFieldImage image;
+	memset (&image, 0, sizeof (image));
+	memcpy (image.m_minBox, &m_minBox.m_x, sizeof (image.m_minBox));
+	memcpy (image.m_maxBox, &m_maxBox.m_x, sizeof (image.m_maxBox));
+	image.m_width = m_width;
+	image.m_height = m_height;
+	image.m_diagonalMode = m_diagonalMode;
+	image.m_elevationDataType = m_elevationDataType;
+	image.m_verticalScale = m_verticalScale;
+	image.m_horizontalScale_x = m_horizontalScale_x;
+	image.m_horizontalDisplacementScale_x = m_horizontalDisplacementScale_x;
+	image.m_horizontalScale_z = m_horizontalScale_z;
+	image.m_horizontalDisplacementScale_z = m_horizontalDisplacementScale_z;
+
+	// the offsets are relative to the image header
+	const dgInt32 headerSize = dgInt32 (sizeof (dgImageHeader) + sizeof (dgHeightFieldImage));
+	image.m_elevationOffset = DG_HIGHTFIELD_IMAGE_ALIGN (headerSize);
+	image.m_atributeOffset = image.m_elevationOffset + DG_HIGHTFIELD_IMAGE_ALIGN (elevationSize);
+	image.m_diagonalsOffset = image.m_atributeOffset + DG_HIGHTFIELD_IMAGE_ALIGN (attibutePaddedMapSize);
+	image.m_displacementOffset = displacementSize ? image.m_diagonalsOffset + DG_HIGHTFIELD_IMAGE_ALIGN (attibutePaddedMapSize) : 0;
+
+	const dgInt32 zeros[4] = {0, 0, 0, 0};
+	SerializeImageHeader (callback, userData);
+	callback (userData, &image, sizeof (image));
+	callback (userData, zeros, image.m_elevationOffset - headerSize);
+	callback (userData, m_elevationMap, elevationSize);
+	callback (userData, zeros, DG_HIGHTFIELD_IMAGE_ALIGN (elevationSize) - elevationSize);
+	callback (userData, m_atributeMap, attibutePaddedMapSize);
+	callback (userData, zeros, DG_HIGHTFIELD_IMAGE_ALIGN (attibutePaddedMapSize) - attibutePaddedMapSize);
+	callback (userData, m_diagonals, attibutePaddedMapSize);
+	callback (userData, zeros, DG_HIGHTFIELD_IMAGE_ALIGN (attibutePaddedMapSize) - attibutePaddedMapSize);
+	if (displacementSize) {
+		callback (userData, m_horizontalDisplacement, displacementSize);
+		callback (userData, zeros, DG_HIGHTFIELD_IMAGE_ALIGN (displacementSize) - displacementSize);
+	}
+}
+
+bool dgCollisionHeightField::MapImage (const dgImageHeader* const header)
+{
+	if (header->m_sizeInBytes < dgInt32 (sizeof (dgImageHeader) + sizeof (dgHeightFieldImage))) {
+		return false;
+	}
+	const dgHeightFieldImage* const image = (const dgHeightFieldImage*) (header + 1);
+	if ((image->m_width < 2) || (image->m_height < 2) || (image->m_width > (1<<15)) || (image->m_height > (1<<15))) {
+		return false;
+	}
+	if ((image->m_elevationDataType != m_float32Bit) && (image->m_elevationDataType != m_unsigned16Bit)) {
+		return false;
+	}
+
+	const dgInt32 cellsCount = image->m_width * image->m_height;
+	const dgInt32 attibutePaddedMapSize = (cellsCount + 4) & -4; 
+	const dgInt32 elevationSize = cellsCount * ((image->m_elevationDataType == m_float32Bit) ? sizeof (dgFloat32) : sizeof (dgUnsigned16));
+	const dgInt32 displacementSize = image->m_displacementOffset ? dgInt32 (cellsCount * sizeof (dgUnsigned16)) : 0;
+	const dgInt32 minOffset = dgInt32 (sizeof (dgImageHeader) + sizeof (dgHeightFieldImage));
+	const dgInt32 offsets[] = {image->m_elevationOffset, image->m_atributeOffset, image->m_diagonalsOffset, image->m_displacementOffset};
+	const dgInt32 sizes[] = {elevationSize, attibutePaddedMapSize, attibutePaddedMapSize, displacementSize};
+	for (dgInt32 i = 0; i < 4; i ++) {
+		if (sizes[i] && ((offsets[i] < minOffset) || (offsets[i] & 15) || ((offsets[i] + sizes[i]) > header->m_sizeInBytes))) {
+			return false;
+		}
+	}
+
+	const char* const base = (const char*) header;
+	m_mapped = true;
+	m_width = image->m_width;
+	m_height = image->m_height;
+	m_diagonalMode = image->m_diagonalMode;
+	m_elevationDataType = dgElevationType (image->m_elevationDataType);
+	m_verticalScale = image->m_verticalScale;
+	m_horizontalScale_x = image->m_horizontalScale_x;
+	m_horizontalScaleInv_x = dgFloat32 (1.0f) / m_horizontalScale_x;
+	m_horizontalDisplacementScale_x = image->m_horizontalDisplacementScale_x;
+	m_horizontalScale_z = image->m_horizontalScale_z;
+	m_horizontalScaleInv_z = dgFloat32 (1.0f) / m_horizontalScale_z;
+	m_horizontalDisplacementScale_z = image->m_horizontalDisplacementScale_z;
+	m_minBox = dgVector (image->m_minBox[0], image->m_minBox[1], image->m_minBox[2], dgFloat32 (0.0f));
+	m_maxBox = dgVector (image->m_maxBox[0], image->m_maxBox[1], image->m_maxBox[2], dgFloat32 (0.0f));
+
+	// the image is never written, the const is only dropped to share the maps with the allocated path
+	m_elevationMap = (void*) (base + image->m_elevationOffset);
+	m_atributeMap = (dgInt8*) (base + image->m_atributeOffset);
+	m_diagonals = (dgInt8*) (base + image->m_diagonalsOffset);
+	m_horizontalDisplacement = displacementSize ? (dgUnsigned16*) (base + image->m_displacementOffset) : NULL;
+	return true;
+}
+
 void dgCollisionHeightField::Serialize(dgSerialize callback, void* const userData) const
 {
 	SerializeLow(callback, userData);
 
-	dgInt32 elevationDataType = m_elevationDataType;
+	dgInt32 elevationDataType = m_elevationDataType | (m_tiles ? DG_HIGHTFIELD_TILED_FLAG : 0);
 
 	callback (userData, &m_width, sizeof (dgInt32));
 	callback (userData, &m_height, sizeof (dgInt32));
@@ -361,6 +441,13 @@ void dgCollisionHeightField::Serialize(dgSerialize callback, void* const userDat
 	callback (userData, &m_minBox.m_x, sizeof (dgVector)); 
 	callback (userData, &m_maxBox.m_x, sizeof (dgVector)); 
 
+	if (m_tiles) {
+		callback (userData, &m_tileCount_x, sizeof (dgInt32));
+		callback (userData, &m_tileCount_z, sizeof (dgInt32));
+		callback (userData, &m_tileSize, sizeof (dgInt32));
+		return;
+	}
+
 	switch (m_elevationDataType) 
 	{
 		case m_float32Bit:
@@ -393,6 +480,18 @@ void dgCollisionHeightField::SetCollisionRayCastCallback (dgCollisionHeightField
 
 void dgCollisionHeightField::SetHorizontalDisplacement (const dgUnsigned16* const displacemnet, dgFloat32 scale)
 {
+	if (m_mapped) {
+		// the image is read only
+		dgAssert (0);
+		return;
+	}
+
+	if (m_tiles) {
+		// horizontal displacement is not supported by tiled height fields
+		dgAssert (!displacemnet);
+		return;
+	}
+
 	if (m_horizontalDisplacement) {
 		dgFreeStack(m_horizontalDisplacement);
 		m_horizontalDisplacement = NULL;
@@ -405,12 +504,515 @@ void dgCollisionHeightField::SetHorizontalDisplacement (const dgUnsigned16* cons
 	}
 }
 
+void dgCollisionHeightField::InitInstanceData(dgWorld* const world)
+{
+	dgTree<void*, unsigned>::dgTreeNode* nodeData = world->m_perInstanceData.Find(DG_HIGHTFIELD_DATA_ID);
+	if (!nodeData) {
+		m_instanceData = (dgPerIntanceData*) new dgPerIntanceData();
+		m_instanceData->m_refCount = 0;
+		m_instanceData->m_world = world;
+		for (dgInt32 i = 0 ; i < DG_MAX_THREADS_HIVE_COUNT; i ++) {
+			m_instanceData->m_vertex[i] = NULL;
+			m_instanceData->m_vertexCount[i] = 0;
+			m_instanceData->m_vertex[i].SetAllocator(world->GetAllocator());
+			AllocateVertex(world, i);
+		}
+		nodeData = world->m_perInstanceData.Insert (m_instanceData, DG_HIGHTFIELD_DATA_ID);
+	}
+	m_instanceData = (dgPerIntanceData*) nodeData->GetInfo();
+
+	m_instanceData->m_refCount ++;
+}
+
+void dgCollisionHeightField::CalculateDiagonals(dgInt32 width, dgInt32 height)
+{
+	switch (m_diagonalMode)
+	{
+		case m_normalDiagonals:
+		{
+			memset (m_diagonals, 0, width * height * sizeof (dgInt8));
+			break;
+		}
+		case m_invertedDiagonals:
+		{
+			memset (m_diagonals, 1, width * height * sizeof (dgInt8));
+			break;
+		}
+
+		case m_alternateOddRowsDiagonals:
+		{
+			for (dgInt32 j = 0; j < height; j += 2) {
+				dgInt32 index = j * width;
+				for (dgInt32 i = 0; i < width; i ++) {
+					m_diagonals[index + i] = 0;
+				}
+			}
+
+			for (dgInt32 j = 1; j < height; j += 2) {
+				dgInt32 index = j * width;
+				for (dgInt32 i = 0; i < width; i ++) {
+					m_diagonals[index + i] = 1;
+				}
+			}
+			break;
+		}
+
+		case m_alternateEvenRowsDiagonals:
+		{
+			for (dgInt32 j = 0; j < height; j += 2) {
+				dgInt32 index = j * width;
+				for (dgInt32 i = 0; i < width; i ++) {
+					m_diagonals[index + i] = 1;
+				}
+			}
+
+			for (dgInt32 j = 1; j < height; j += 2) {
+				dgInt32 index = j * width;
+				for (dgInt32 i = 0; i < width; i ++) {
+					m_diagonals[index + i] = 0;
+				}
+			}
+			break;
+		}
+
+
+		case m_alternateOddColumsDiagonals:
+		{
+			for (dgInt32 j = 0; j < height; j ++) {
+				dgInt32 index = j * width;
+				for (dgInt32 i = 0; i < width; i += 2) {
+					m_diagonals[index + i] = 0;
+				}
+
+				for (dgInt32 i = 1; i < width; i += 2) {
+					m_diagonals[index + i] = 1;
+				}
+			}
+			break;
+		}
+
+		case m_alternateEvenColumsDiagonals:
+		{
+			for (dgInt32 j = 0; j < height; j ++) {
+				dgInt32 index = j * width;
+				for (dgInt32 i = 0; i < width; i += 2) {
+					m_diagonals[index + i] = 1;
+				}
+
+				for (dgInt32 i = 1; i < width; i += 2) {
+					m_diagonals[index + i] = 0;
+				}
+			}
+			break;
+		}
+
+		case m_starDiagonals:
+		{
+			for (dgInt32 j = 0; j < height; j += 2) {
+				dgInt32 index = j * width;
+				for (dgInt32 i = 0; i < width; i += 2) {
+					m_diagonals[index + i] = 0;
+				}
+				for (dgInt32 i = 1; i < width; i += 2) {
+					m_diagonals[index + i] = 1;
+				}
+			}
+
+			for (dgInt32 j = 1; j < height; j += 2) {
+				dgInt32 index = j * width;
+				for (dgInt32 i = 0; i < width; i += 2) {
+					m_diagonals[index + i] = 1;
+				}
+				for (dgInt32 i = 1; i < width; i += 2) {
+					m_diagonals[index + i] = 0;
+				}
+			}
+			break;
+		}
+
+		case m_starInvertexDiagonals:
+		{
+			for (dgInt32 j = 0; j < height; j += 2) {
+				dgInt32 index = j * width;
+				for (dgInt32 i = 0; i < width; i += 2) {
+					m_diagonals[index + i] = 1;
+				}
+				for (dgInt32 i = 1; i < width; i += 2) {
+					m_diagonals[index + i] = 0;
+				}
+			}
+
+			for (dgInt32 j = 1; j < height; j += 2) {
+				dgInt32 index = j * width;
+				for (dgInt32 i = 0; i < width; i += 2) {
+					m_diagonals[index + i] = 0;
+				}
+				for (dgInt32 i = 1; i < width; i += 2) {
+					m_diagonals[index + i] = 1;
+				}
+			}
+
+			break;
+		}
+
+		default:
+			dgAssert (0);
+		
+	}
+}
+
 void dgCollisionHeightField::AllocateVertex(dgWorld* const world, dgInt32 threadIndex) const
 {
 	m_instanceData->m_vertex[threadIndex].Resize (m_instanceData->m_vertex[threadIndex].GetElementsCapacity() * 2);
 	m_instanceData->m_vertexCount[threadIndex] = m_instanceData->m_vertex[threadIndex].GetElementsCapacity();
 }
 
+void dgCollisionHeightField::InitTiles(dgInt32 tileCount_x, dgInt32 tileCount_z, dgInt32 tileSize)
+{
+	// each tile is a power of two square of cells with one extra row and column of samples, 
+	// so that cells on the tile edges can be built without the neighbor tiles
+	dgAssert (!(tileSize & (tileSize - 1)));
+	dgAssert (tileSize >= (1 << DG_HIGHTFIELD_TILE_BLOCK_SHIFT));
+	m_tileShift = DG_HIGHTFIELD_TILE_BLOCK_SHIFT;
+	while ((m_tileShift < 14) && ((1 << (m_tileShift + 1)) <= tileSize)) {
+		m_tileShift ++;
+	}
+	m_tileSize = 1 << m_tileShift;
+	m_tileMask = m_tileSize - 1;
+	m_tileLevels = m_tileShift - DG_HIGHTFIELD_TILE_BLOCK_SHIFT + 1;
+	m_tileCount_x = dgMax (tileCount_x, 1);
+	m_tileCount_z = dgMax (tileCount_z, 1);
+	m_width = m_tileCount_x * m_tileSize + 1;
+	m_height = m_tileCount_z * m_tileSize + 1;
+
+	m_tiles = (dgTile*)dgMallocStack(m_tileCount_x * m_tileCount_z * sizeof (dgTile));
+	memset (m_tiles, 0, m_tileCount_x * m_tileCount_z * sizeof (dgTile));
+
+	m_diagonals = (dgInt8 *)dgMallocStack(m_tileSize * m_tileSize * sizeof (dgInt8));
+	CalculateDiagonals(m_tileSize, m_tileSize);
+}
+
+void dgCollisionHeightField::InstallTile(dgTile* const tile, const void* const elevationMap, const dgInt8* const atributeMap) const
+{
+	// build a quad tree of min max elevations, the leaves are blocks of 8 x 8 cells 
+	const dgInt32 blockSize = 1 << DG_HIGHTFIELD_TILE_BLOCK_SHIFT;
+	const dgInt32 blocks = 1 << (m_tileLevels - 1);
+	dgInt32 boundsCount = 0;
+	for (dgInt32 i = 0; i < m_tileLevels; i ++) {
+		boundsCount += (blocks >> i) * (blocks >> i);
+	}
+	dgFloat32* const bounds = tile->m_bounds ? tile->m_bounds : (dgFloat32*)dgMallocStack(2 * boundsCount * sizeof (dgFloat32));
+
+	dgTile data;
+	data.m_elevation = elevationMap;
+	for (dgInt32 j = 0; j < blocks; j ++) {
+		for (dgInt32 i = 0; i < blocks; i ++) {
+			dgFloat32 minHeight = dgFloat32 (1.0e10f);
+			dgFloat32 maxHeight = dgFloat32 (-1.0e10f);
+			for (dgInt32 z = j * blockSize; z <= (j + 1) * blockSize; z ++) {
+				for (dgInt32 x = i * blockSize; x <= (i + 1) * blockSize; x ++) {
+					dgFloat32 high = GetTileElevation(&data, x, z);
+					minHeight = dgMin(high, minHeight);
+					maxHeight = dgMax(high, maxHeight);
+				}
+			}
+			bounds[(j * blocks + i) * 2 + 0] = minHeight;
+			bounds[(j * blocks + i) * 2 + 1] = maxHeight;
+		}
+	}
+
+	dgInt32 childBase = 0;
+	dgInt32 childSide = blocks;
+	dgInt32 base = blocks * blocks;
+	for (dgInt32 level = 1; level < m_tileLevels; level ++) {
+		const dgInt32 side = childSide >> 1;
+		for (dgInt32 j = 0; j < side; j ++) {
+			for (dgInt32 i = 0; i < side; i ++) {
+				const dgFloat32* const child0 = &bounds[(childBase + (2 * j + 0) * childSide + 2 * i) * 2];
+				const dgFloat32* const child1 = &bounds[(childBase + (2 * j + 1) * childSide + 2 * i) * 2];
+				bounds[(base + j * side + i) * 2 + 0] = dgMin (dgMin (child0[0], child0[2]), dgMin (child1[0], child1[2]));
+				bounds[(base + j * side + i) * 2 + 1] = dgMax (dgMax (child0[1], child0[3]), dgMax (child1[1], child1[3]));
+			}
+		}
+		childBase = base;
+		childSide = side;
+		base += side * side;
+	}
+	dgAssert (base == boundsCount);
+	dgAssert (bounds[(boundsCount - 1) * 2 + 0] * m_verticalScale >= m_minBox.m_y - dgFloat32 (1.0e-3f));
+	dgAssert (bounds[(boundsCount - 1) * 2 + 1] * m_verticalScale <= m_maxBox.m_y + dgFloat32 (1.0e-3f));
+
+	// the elevation pointer is published last with a release store, because it is what flags the tile as resident to other threads
+	tile->m_bounds = bounds;
+	tile->m_atributes = atributeMap;
+	dgAtomicStoreRelease((void**)&tile->m_elevation, (void*)elevationMap);
+}
+
+void dgCollisionHeightField::EvictTile(dgTile* const tile)
+{
+	dgAtomicStoreRelease((void**)&tile->m_elevation, NULL);
+	if (tile->m_bounds) {
+		dgFreeStack(tile->m_bounds);
+	}
+	tile->m_bounds = NULL;
+	tile->m_atributes = NULL;
+	tile->m_requested = DG_HIGHTFIELD_TILE_IDLE;
+}
+
+void dgCollisionHeightField::LoadTile(dgTile* const tile, dgInt32 tile_x, dgInt32 tile_z) const
+{
+	bool load = false;
+	{
+		// the lock only claims the tile, the callback can be slow and must not stall threads reading other tiles
+		dgScopeSpinLock lock(&m_tileLock);
+		if (!GetResidentElevation(tile) && (tile->m_requested == DG_HIGHTFIELD_TILE_IDLE)) {
+			tile->m_requested = DG_HIGHTFIELD_TILE_LOADING;
+			load = true;
+		}
+	}
+
+	if (load) {
+		// the callback is called only once per tile, an application streaming asynchronously 
+		// returns zero and installs the tile later with SetTile
+		const void* elevationMap = NULL;
+		const dgInt8* atributeMap = NULL;
+		if (m_tileLoadCallback (this, tile_x, tile_z, &elevationMap, &atributeMap, m_tileLoadUserData) && elevationMap) {
+			InstallTile(tile, elevationMap, atributeMap);
+		}
+		dgInterlockedExchange(&tile->m_requested, DG_HIGHTFIELD_TILE_REQUESTED);
+	} else {
+		// another thread is running the callback for this tile, wait for it without holding the lock
+		while (dgAtomicCompareAndSwap(&tile->m_requested, DG_HIGHTFIELD_TILE_LOADING, DG_HIGHTFIELD_TILE_LOADING)) {
+			dgThreadYield();
+		}
+	}
+}
+
+const dgCollisionHeightField::dgTile* dgCollisionHeightField::GetTile(dgInt32 tile_x, dgInt32 tile_z) const
+{
+	dgAssert ((tile_x >= 0) && (tile_x < m_tileCount_x));
+	dgAssert ((tile_z >= 0) && (tile_z < m_tileCount_z));
+	dgTile* const tile = &m_tiles[tile_z * m_tileCount_x + tile_x];
+	if (GetResidentElevation(tile)) {
+		return tile;
+	}
+	if ((tile->m_requested != DG_HIGHTFIELD_TILE_REQUESTED) && m_tileLoadCallback) {
+		LoadTile(tile, tile_x, tile_z);
+	}
+	return GetResidentElevation(tile) ? tile : NULL;
+}
+
+bool dgCollisionHeightField::IsTileResident (dgInt32 tile_x, dgInt32 tile_z) const
+{
+	if (m_tiles && (tile_x >= 0) && (tile_x < m_tileCount_x) && (tile_z >= 0) && (tile_z < m_tileCount_z)) {
+		return GetResidentElevation(&m_tiles[tile_z * m_tileCount_x + tile_x]) ? true : false;
+	}
+	return false;
+}
+
+void dgCollisionHeightField::SetTile (dgInt32 tile_x, dgInt32 tile_z, const void* const elevationMap, const dgInt8* const atributeMap)
+{
+	dgAssert (m_tiles);
+	if (m_tiles && (tile_x >= 0) && (tile_x < m_tileCount_x) && (tile_z >= 0) && (tile_z < m_tileCount_z)) {
+		dgTile* const tile = &m_tiles[tile_z * m_tileCount_x + tile_x];
+		if (elevationMap) {
+			InstallTile(tile, elevationMap, atributeMap);
+			tile->m_requested = DG_HIGHTFIELD_TILE_IDLE;
+		} else {
+			EvictTile(tile);
+		}
+	}
+}
+
+void dgCollisionHeightField::SetTileLoadCallback (dgCollisionHeightFieldTileLoadCallback callback, void* const userData)
+{
+	m_tileLoadCallback = callback;
+	m_tileLoadUserData = userData;
+}
+
+bool dgCollisionHeightField::GetTiledElevation(dgInt32 x, dgInt32 z, dgFloat32& elevation) const
+{
+	// samples on the tile edges are shared by the neighbor tiles, use the first one that is resident
+	const dgInt32 tile_x = dgMin (x >> m_tileShift, m_tileCount_x - 1);
+	const dgInt32 tile_z = dgMin (z >> m_tileShift, m_tileCount_z - 1);
+	for (dgInt32 j = tile_z; (j >= 0) && ((z - (j << m_tileShift)) <= m_tileSize); j --) {
+		for (dgInt32 i = tile_x; (i >= 0) && ((x - (i << m_tileShift)) <= m_tileSize); i --) {
+			const dgTile* const tile = GetTile(i, j);
+			if (tile) {
+				elevation = GetTileElevation(tile, x - (i << m_tileShift), z - (j << m_tileShift));
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+void dgCollisionHeightField::CalculateTileMinAndMaxElevation(const dgTile* const tile, dgInt32 level, dgInt32 block_x, dgInt32 block_z, dgInt32 x0, dgInt32 x1, dgInt32 z0, dgInt32 z1, dgFloat32& minHeight, dgFloat32& maxHeight) const
+{
+	dgInt32 base = 0;
+	for (dgInt32 i = 0; i < level; i ++) {
+		const dgInt32 side = 1 << (m_tileLevels - 1 - i);
+		base += side * side;
+	}
+	const dgFloat32* const bounds = &tile->m_bounds[(base + (block_z << (m_tileLevels - 1 - level)) + block_x) * 2];
+	if ((bounds[0] >= minHeight) && (bounds[1] <= maxHeight)) {
+		// this block can not expand the range
+		return;
+	}
+
+	const dgInt32 shift = DG_HIGHTFIELD_TILE_BLOCK_SHIFT + level;
+	const dgInt32 bx0 = block_x << shift;
+	const dgInt32 bz0 = block_z << shift;
+	const dgInt32 bx1 = bx0 + (1 << shift);
+	const dgInt32 bz1 = bz0 + (1 << shift);
+	if ((x0 <= bx0) && (x1 >= bx1) && (z0 <= bz0) && (z1 >= bz1)) {
+		minHeight = dgMin(bounds[0], minHeight);
+		maxHeight = dgMax(bounds[1], maxHeight);
+	} else if (level == 0) {
+		const dgInt32 xMax = dgMin (x1, bx1);
+		const dgInt32 zMax = dgMin (z1, bz1);
+		for (dgInt32 z = dgMax (z0, bz0); z <= zMax; z ++) {
+			for (dgInt32 x = dgMax (x0, bx0); x <= xMax; x ++) {
+				dgFloat32 high = GetTileElevation(tile, x, z);
+				minHeight = dgMin(high, minHeight);
+				maxHeight = dgMax(high, maxHeight);
+			}
+		}
+	} else {
+		const dgInt32 childSize = 1 << (shift - 1);
+		for (dgInt32 j = 0; j < 2; j ++) {
+			const dgInt32 cz0 = bz0 + j * childSize;
+			if ((cz0 <= z1) && ((cz0 + childSize) >= z0)) {
+				for (dgInt32 i = 0; i < 2; i ++) {
+					const dgInt32 cx0 = bx0 + i * childSize;
+					if ((cx0 <= x1) && ((cx0 + childSize) >= x0)) {
+						CalculateTileMinAndMaxElevation(tile, level - 1, block_x * 2 + i, block_z * 2 + j, x0, x1, z0, z1, minHeight, maxHeight);
+					}
+				}
+			}
+		}
+	}
+}
+
+void dgCollisionHeightField::CalculateTiledMinAndMaxElevation(dgInt32 x0, dgInt32 x1, dgInt32 z0, dgInt32 z1, dgFloat32& minHeight, dgFloat32& maxHeight) const
+{
+	// only the resident tiles contribute, cells in missing tiles are holes
+	const dgInt32 tile_x0 = dgMin (x0 >> m_tileShift, m_tileCount_x - 1);
+	const dgInt32 tile_z0 = dgMin (z0 >> m_tileShift, m_tileCount_z - 1);
+	const dgInt32 tile_x1 = dgMin (dgMax (x1 - 1, x0) >> m_tileShift, m_tileCount_x - 1);
+	const dgInt32 tile_z1 = dgMin (dgMax (z1 - 1, z0) >> m_tileShift, m_tileCount_z - 1);
+	for (dgInt32 j = tile_z0; j <= tile_z1; j ++) {
+		const dgInt32 origin_z = j << m_tileShift;
+		for (dgInt32 i = tile_x0; i <= tile_x1; i ++) {
+			const dgTile* const tile = GetTile(i, j);
+			if (tile) {
+				const dgInt32 origin_x = i << m_tileShift;
+				CalculateTileMinAndMaxElevation(tile, m_tileLevels - 1, 0, 0, 
+												dgMax (x0 - origin_x, 0), dgMin (x1 - origin_x, m_tileSize), 
+												dgMax (z0 - origin_z, 0), dgMin (z1 - origin_z, m_tileSize), minHeight, maxHeight);
+			}
+		}
+	}
+}
+
+bool dgCollisionHeightField::RayCastTileBlock(const dgVector& q0, const dgVector& q1, dgInt32 x, dgInt32 z) const
+{
+	// test the ray against the bounding box of the block of cells containing this cell
+	if ((x < 0) || (z < 0) || (x >= (m_width - 1)) || (z >= (m_height - 1))) {
+		return false;
+	}
+	const dgTile* const tile = GetCellTile(x, z);
+	if (!tile) {
+		return false;
+	}
+
+	const dgInt32 blocks = 1 << (m_tileLevels - 1);
+	const dgInt32 blockMask = (1 << DG_HIGHTFIELD_TILE_BLOCK_SHIFT) - 1;
+	const dgInt32 block_x = (x & m_tileMask) >> DG_HIGHTFIELD_TILE_BLOCK_SHIFT;
+	const dgInt32 block_z = (z & m_tileMask) >> DG_HIGHTFIELD_TILE_BLOCK_SHIFT;
+	const dgFloat32* const bounds = &tile->m_bounds[(block_z * blocks + block_x) * 2];
+	const dgFloat32 y0 = bounds[0] * m_verticalScale;
+	const dgFloat32 y1 = bounds[1] * m_verticalScale;
+	const dgInt32 x0 = x & ~blockMask;
+	const dgInt32 z0 = z & ~blockMask;
+	const dgInt32 x1 = x0 + blockMask + 1;
+	const dgInt32 z1 = z0 + blockMask + 1;
+
+	dgVector boxP0 (dgVector (x0 * m_horizontalScale_x, dgMin (y0, y1), z0 * m_horizontalScale_z, dgFloat32 (0.0f)) - m_padding);
+	dgVector boxP1 (dgVector (x1 * m_horizontalScale_x, dgMax (y0, y1), z1 * m_horizontalScale_z, dgFloat32 (0.0f)) + m_padding);
+	dgVector p0 (q0);
+	dgVector p1 (q1);
+	return dgRayBoxClip (p0, p1, boxP0, boxP1);
+}
+
+dgVector dgCollisionHeightField::TiledSupportVertex (const dgVector& dir) const
+{
+	dgFloat32 maxProject (dgFloat32 (-1.e-20f));
+	dgVector support (dgFloat32 (0.0f));
+	for (dgInt32 j = 0; j < m_tileCount_z; j ++) {
+		for (dgInt32 i = 0; i < m_tileCount_x; i ++) {
+			const dgTile* const tile = &m_tiles[j * m_tileCount_x + i];
+			if (GetResidentElevation(tile)) {
+				for (dgInt32 z = 0; z <= m_tileSize; z ++) {
+					dgFloat32 zVal = m_horizontalScale_z * ((j << m_tileShift) + z);
+					for (dgInt32 x = 0; x <= m_tileSize; x ++) {
+						dgVector p (m_horizontalScale_x * ((i << m_tileShift) + x), m_verticalScale * GetTileElevation(tile, x, z), zVal, dgFloat32 (0.0f));
+						dgFloat32 project = dir.DotProduct(p).m_x;
+						if (project > maxProject) {
+							maxProject = project;
+							support = p;
+						}
+					}
+				}
+			}
+		}
+	}
+	return support;
+}
+
+void dgCollisionHeightField::TiledDebugCollision (const dgMatrix& matrix, dgCollision::OnDebugCollisionMeshCallback callback, void* const userData) const
+{
+	for (dgInt32 j = 0; j < m_tileCount_z; j ++) {
+		for (dgInt32 i = 0; i < m_tileCount_x; i ++) {
+			const dgTile* const tile = &m_tiles[j * m_tileCount_x + i];
+			if (GetResidentElevation(tile)) {
+				for (dgInt32 z = 0; z < m_tileSize; z ++) {
+					const dgInt32 zIndex = (j << m_tileShift) + z;
+					for (dgInt32 x = 0; x < m_tileSize; x ++) {
+						const dgInt32 xIndex = (i << m_tileShift) + x;
+
+						dgVector points[4];
+						points[0 * 2 + 0] = matrix.TransformVector(dgVector ((xIndex + 0) * m_horizontalScale_x, m_verticalScale * GetTileElevation(tile, x + 0, z + 0), (zIndex + 0) * m_horizontalScale_z, dgFloat32 (0.0f)));
+						points[0 * 2 + 1] = matrix.TransformVector(dgVector ((xIndex + 1) * m_horizontalScale_x, m_verticalScale * GetTileElevation(tile, x + 1, z + 0), (zIndex + 0) * m_horizontalScale_z, dgFloat32 (0.0f)));
+						points[1 * 2 + 0] = matrix.TransformVector(dgVector ((xIndex + 0) * m_horizontalScale_x, m_verticalScale * GetTileElevation(tile, x + 0, z + 1), (zIndex + 1) * m_horizontalScale_z, dgFloat32 (0.0f)));
+						points[1 * 2 + 1] = matrix.TransformVector(dgVector ((xIndex + 1) * m_horizontalScale_x, m_verticalScale * GetTileElevation(tile, x + 1, z + 1), (zIndex + 1) * m_horizontalScale_z, dgFloat32 (0.0f)));
+
+						const dgInt32* const indirectIndex = &m_cellIndices[GetDiagonal(xIndex, zIndex)][0];
+						const dgInt32 atribute = GetCellAtribute(tile, xIndex, zIndex);
+
+						dgTriplex triangle[3];
+						const dgInt32 face0[] = {indirectIndex[1], indirectIndex[0], indirectIndex[2]};
+						const dgInt32 face1[] = {indirectIndex[1], indirectIndex[2], indirectIndex[3]};
+						for (dgInt32 k = 0; k < 3; k ++) {
+							triangle[k].m_x = points[face0[k]].m_x;
+							triangle[k].m_y = points[face0[k]].m_y;
+							triangle[k].m_z = points[face0[k]].m_z;
+						}
+						callback (userData, 3, &triangle[0].m_x, atribute);
+
+						for (dgInt32 k = 0; k < 3; k ++) {
+							triangle[k].m_x = points[face1[k]].m_x;
+							triangle[k].m_y = points[face1[k]].m_y;
+							triangle[k].m_z = points[face1[k]].m_z;
+						}
+						callback (userData, 3, &triangle[0].m_x, atribute);
+					}
+				}
+			}
+		}
+	}
+}
+
 
 
 DG_INLINE void dgCollisionHeightField::CalculateMinExtend2d(const dgVector& p0, const dgVector& p1, dgVector& boxP0, dgVector& boxP1) const
@@ -528,34 +1130,46 @@ dgFloat32 dgCollisionHeightField::RayCastCell (const dgFastRayTest& ray, dgInt32
 	
 	dgAssert (maxT <= 1.0);
 
-	dgInt32 base = zIndex0 * m_width + xIndex0;
-	
-	switch (m_elevationDataType) 
-	{
-		case m_float32Bit:
-		{
-			const dgFloat32* const elevation = (dgFloat32*)m_elevationMap;
-			points[0 * 2 + 0] = dgVector ((xIndex0 + 0) * m_horizontalScale_x, m_verticalScale * elevation[base],			      (zIndex0 + 0) * m_horizontalScale_z, dgFloat32 (0.0f));
-			points[0 * 2 + 1] = dgVector ((xIndex0 + 1) * m_horizontalScale_x, m_verticalScale * elevation[base + 1],           (zIndex0 + 0) * m_horizontalScale_z, dgFloat32 (0.0f));
-			points[1 * 2 + 1] = dgVector ((xIndex0 + 1) * m_horizontalScale_x, m_verticalScale * elevation[base + m_width + 1], (zIndex0 + 1) * m_horizontalScale_z, dgFloat32 (0.0f));
-			points[1 * 2 + 0] = dgVector ((xIndex0 + 0) * m_horizontalScale_x, m_verticalScale * elevation[base + m_width + 0], (zIndex0 + 1) * m_horizontalScale_z, dgFloat32 (0.0f));
-			break;
+	if (m_tiles) {
+		const dgTile* const tile = GetCellTile(xIndex0, zIndex0);
+		if (!tile) {
+			return dgFloat32 (1.2f);
 		}
-
-		case m_unsigned16Bit:
-		default:
+		const dgInt32 x = xIndex0 & m_tileMask;
+		const dgInt32 z = zIndex0 & m_tileMask;
+		points[0 * 2 + 0] = dgVector ((xIndex0 + 0) * m_horizontalScale_x, m_verticalScale * GetTileElevation(tile, x + 0, z + 0), (zIndex0 + 0) * m_horizontalScale_z, dgFloat32 (0.0f));
+		points[0 * 2 + 1] = dgVector ((xIndex0 + 1) * m_horizontalScale_x, m_verticalScale * GetTileElevation(tile, x + 1, z + 0), (zIndex0 + 0) * m_horizontalScale_z, dgFloat32 (0.0f));
+		points[1 * 2 + 1] = dgVector ((xIndex0 + 1) * m_horizontalScale_x, m_verticalScale * GetTileElevation(tile, x + 1, z + 1), (zIndex0 + 1) * m_horizontalScale_z, dgFloat32 (0.0f));
+		points[1 * 2 + 0] = dgVector ((xIndex0 + 0) * m_horizontalScale_x, m_verticalScale * GetTileElevation(tile, x + 0, z + 1), (zIndex0 + 1) * m_horizontalScale_z, dgFloat32 (0.0f));
+	} else {
+		dgInt32 base = zIndex0 * m_width + xIndex0;
+		switch (m_elevationDataType) 
 		{
-			const dgUnsigned16* const elevation = (dgUnsigned16*)m_elevationMap;
-			points[0 * 2 + 0] = dgVector ((xIndex0 + 0) * m_horizontalScale_x, m_verticalScale * dgFloat32 (elevation[base]),			   (zIndex0 + 0) * m_horizontalScale_z, dgFloat32 (0.0f));
-			points[0 * 2 + 1] = dgVector ((xIndex0 + 1) * m_horizontalScale_x, m_verticalScale * dgFloat32 (elevation[base + 1]),           (zIndex0 + 0) * m_horizontalScale_z, dgFloat32 (0.0f));
-			points[1 * 2 + 1] = dgVector ((xIndex0 + 1) * m_horizontalScale_x, m_verticalScale * dgFloat32 (elevation[base + m_width + 1]), (zIndex0 + 1) * m_horizontalScale_z, dgFloat32 (0.0f));
-			points[1 * 2 + 0] = dgVector ((xIndex0 + 0) * m_horizontalScale_x, m_verticalScale * dgFloat32 (elevation[base + m_width + 0]), (zIndex0 + 1) * m_horizontalScale_z, dgFloat32 (0.0f));
-			break;
+			case m_float32Bit:
+			{
+				const dgFloat32* const elevation = (dgFloat32*)m_elevationMap;
+				points[0 * 2 + 0] = dgVector ((xIndex0 + 0) * m_horizontalScale_x, m_verticalScale * elevation[base],			      (zIndex0 + 0) * m_horizontalScale_z, dgFloat32 (0.0f));
+				points[0 * 2 + 1] = dgVector ((xIndex0 + 1) * m_horizontalScale_x, m_verticalScale * elevation[base + 1],           (zIndex0 + 0) * m_horizontalScale_z, dgFloat32 (0.0f));
+				points[1 * 2 + 1] = dgVector ((xIndex0 + 1) * m_horizontalScale_x, m_verticalScale * elevation[base + m_width + 1], (zIndex0 + 1) * m_horizontalScale_z, dgFloat32 (0.0f));
+				points[1 * 2 + 0] = dgVector ((xIndex0 + 0) * m_horizontalScale_x, m_verticalScale * elevation[base + m_width + 0], (zIndex0 + 1) * m_horizontalScale_z, dgFloat32 (0.0f));
+				break;
+			}
+
+			case m_unsigned16Bit:
+			default:
+			{
+				const dgUnsigned16* const elevation = (dgUnsigned16*)m_elevationMap;
+				points[0 * 2 + 0] = dgVector ((xIndex0 + 0) * m_horizontalScale_x, m_verticalScale * dgFloat32 (elevation[base]),			   (zIndex0 + 0) * m_horizontalScale_z, dgFloat32 (0.0f));
+				points[0 * 2 + 1] = dgVector ((xIndex0 + 1) * m_horizontalScale_x, m_verticalScale * dgFloat32 (elevation[base + 1]),           (zIndex0 + 0) * m_horizontalScale_z, dgFloat32 (0.0f));
+				points[1 * 2 + 1] = dgVector ((xIndex0 + 1) * m_horizontalScale_x, m_verticalScale * dgFloat32 (elevation[base + m_width + 1]), (zIndex0 + 1) * m_horizontalScale_z, dgFloat32 (0.0f));
+				points[1 * 2 + 0] = dgVector ((xIndex0 + 0) * m_horizontalScale_x, m_verticalScale * dgFloat32 (elevation[base + m_width + 0]), (zIndex0 + 1) * m_horizontalScale_z, dgFloat32 (0.0f));
+				break;
+			}
 		}
 	}
 	
 	dgFloat32 t = dgFloat32 (1.2f);
-	if (!m_diagonals[base]) {
+	if (!GetDiagonal(xIndex0, zIndex0)) {
 		triangle[0] = 1;
 		triangle[1] = 2;
 		triangle[2] = 3;
@@ -682,15 +1296,26 @@ dgFloat32 dgCollisionHeightField::RayCast (const dgVector& q0, const dgVector& q
 		dgInt32 zIndex0 = iz0;
 		dgFastRayTest ray (q0, q1); 
 
+		dgInt32 block_x = -(1<<30);
+		dgInt32 block_z = -(1<<30);
+		bool blockHit = true;
+
 		// for each cell touched by the line
 		do {
-			dgFloat32 t = RayCastCell (ray, xIndex0, zIndex0, normalOut, maxT);
+			if (m_tiles && (((xIndex0 >> DG_HIGHTFIELD_TILE_BLOCK_SHIFT) != block_x) || ((zIndex0 >> DG_HIGHTFIELD_TILE_BLOCK_SHIFT) != block_z))) {
+				// skip the cells of blocks that the ray does not cross, and of tiles that are not resident
+				block_x = xIndex0 >> DG_HIGHTFIELD_TILE_BLOCK_SHIFT;
+				block_z = zIndex0 >> DG_HIGHTFIELD_TILE_BLOCK_SHIFT;
+				blockHit = RayCastTileBlock(q0, q1, xIndex0, zIndex0);
+			}
+
+			dgFloat32 t = blockHit ? RayCastCell (ray, xIndex0, zIndex0, normalOut, maxT) : dgFloat32 (1.2f);
 			if (t < maxT) {
 				// bail out at the first intersection and copy the data into the descriptor
 				dgAssert (normalOut.m_w == dgFloat32 (0.0f));
 				contactOut.m_normal = normalOut.Normalize();
-				contactOut.m_shapeId0 = m_atributeMap[zIndex0 * m_width + xIndex0];
-				contactOut.m_shapeId1 = m_atributeMap[zIndex0 * m_width + xIndex0];
+				contactOut.m_shapeId0 = m_tiles ? GetCellAtribute(GetCellTile(xIndex0, zIndex0), xIndex0, zIndex0) : m_atributeMap[zIndex0 * m_width + xIndex0];
+				contactOut.m_shapeId1 = contactOut.m_shapeId0;
 
 				if (m_userRayCastCallback) {
 					dgVector normal (body->GetCollision()->GetGlobalMatrix().RotateVector (contactOut.m_normal));
@@ -732,6 +1357,10 @@ struct dgCollisionHeightFieldShowPolyContext
 
 dgVector dgCollisionHeightField::SupportVertex (const dgVector& dir, dgInt32* const vertexIndex) const
 {
+	if (m_tiles) {
+		return TiledSupportVertex (dir);
+	}
+
 	dgFloat32 maxProject (dgFloat32 (-1.e-20f));
 	dgVector support (dgFloat32 (0.0f));
 	if (m_elevationDataType == m_float32Bit)  {
@@ -775,6 +1404,11 @@ dgVector dgCollisionHeightField::SupportVertexSpecial (const dgVector& dir, dgFl
 
 void dgCollisionHeightField::DebugCollision (const dgMatrix& matrix, dgCollision::OnDebugCollisionMeshCallback callback, void* const userData) const
 {
+	if (m_tiles) {
+		TiledDebugCollision (matrix, callback, userData);
+		return;
+	}
+
 	dgVector points[4];
 
 	dgInt32 base = 0;
@@ -937,18 +1571,22 @@ void dgCollisionHeightField::GetLocalAABB (const dgVector& q0, const dgVector& q
 	dgFloat32 minHeight = dgFloat32 (1.0e10f);
 	dgFloat32 maxHeight = dgFloat32 (-1.0e10f);
 	//dgInt32 base = z0 * m_width;
-	switch (m_elevationDataType) 
-	{
-		case m_float32Bit:
+	if (m_tiles) {
+		CalculateTiledMinAndMaxElevation(x0, x1, z0, z1, minHeight, maxHeight);
+	} else {
+		switch (m_elevationDataType) 
 		{
-			CalculateMinAndMaxElevation(x0, x1, z0, z1, (dgFloat32*)m_elevationMap, minHeight, maxHeight);
-			break;
-		}
+			case m_float32Bit:
+			{
+				CalculateMinAndMaxElevation(x0, x1, z0, z1, (dgFloat32*)m_elevationMap, minHeight, maxHeight);
+				break;
+			}
 
-		case m_unsigned16Bit:
-		{
-			CalculateMinAndMaxElevation(x0, x1, z0, z1, (dgUnsigned16*)m_elevationMap, minHeight, maxHeight);
-			break;
+			case m_unsigned16Bit:
+			{
+				CalculateMinAndMaxElevation(x0, x1, z0, z1, (dgUnsigned16*)m_elevationMap, minHeight, maxHeight);
+				break;
+			}
 		}
 	}
 
@@ -1007,18 +1645,22 @@ void dgCollisionHeightField::GetCollidingFaces (dgPolygonMeshDesc* const data) c
 	dgFloat32 minHeight = dgFloat32 (1.0e10f);
 	dgFloat32 maxHeight = dgFloat32 (-1.0e10f);
 //	dgInt32 base = z0 * m_width;
-	switch (m_elevationDataType) 
-	{
-		case m_float32Bit:
+	if (m_tiles) {
+		CalculateTiledMinAndMaxElevation(x0, x1, z0, z1, minHeight, maxHeight);
+	} else {
+		switch (m_elevationDataType) 
 		{
-			CalculateMinAndMaxElevation(x0, x1, z0, z1, (dgFloat32*)m_elevationMap, minHeight, maxHeight);
-			break;
-		}
+			case m_float32Bit:
+			{
+				CalculateMinAndMaxElevation(x0, x1, z0, z1, (dgFloat32*)m_elevationMap, minHeight, maxHeight);
+				break;
+			}
 
-		case m_unsigned16Bit:
-		{
-			CalculateMinAndMaxElevation(x0, x1, z0, z1, (dgUnsigned16*)m_elevationMap, minHeight, maxHeight);
-			break;
+			case m_unsigned16Bit:
+			{
+				CalculateMinAndMaxElevation(x0, x1, z0, z1, (dgUnsigned16*)m_elevationMap, minHeight, maxHeight);
+				break;
+			}
 		}
 	}
 
@@ -1036,8 +1678,26 @@ void dgCollisionHeightField::GetCollidingFaces (dgPolygonMeshDesc* const data) c
 		base = z0 * m_width;
 		dgVector* const vertex = &m_instanceData->m_vertex[data->m_threadNumber][0];
 
-		switch (m_elevationDataType) 
+		switch (m_tiles ? -1 : m_elevationDataType) 
 		{
+			case -1:
+			{
+				// samples in non resident tiles only belong to holes, they are placed at the bottom of the height field 
+				for (dgInt32 z = z0; z <= z1; z ++) {
+					dgFloat32 zVal = m_horizontalScale_z * z;
+					for (dgInt32 x = x0; x <= x1; x ++) {
+						dgFloat32 elevation = m_minBox.m_y;
+						if (GetTiledElevation(x, z, elevation)) {
+							elevation *= m_verticalScale;
+						}
+						vertex[vertexIndex] = dgVector(m_horizontalScale_x * x, elevation, zVal, dgFloat32 (0.0f));
+						vertexIndex ++;
+						dgAssert (vertexIndex <= m_instanceData->m_vertexCount[data->m_threadNumber]); 
+					}
+				}
+				break;
+			}
+
 			case m_float32Bit:
 			{
 				const dgFloat32* const elevation = (dgFloat32*)m_elevationMap;
@@ -1083,11 +1743,21 @@ void dgCollisionHeightField::GetCollidingFaces (dgPolygonMeshDesc* const data) c
 		dgInt32* const indices = data->m_globalFaceVertexIndex;
 		dgInt32* const faceIndexCount = data->m_meshData.m_globalFaceIndexCount;
 		dgInt32 faceSize = dgInt32 (dgMax (m_horizontalScale_x, m_horizontalScale_z) * dgFloat32 (2.0f)); 
+		dgInt8 holes[DG_MAX_COLLIDING_FACES / 2];
 
 		for (dgInt32 z = z0; (z < z1) && (faceCount < DG_MAX_COLLIDING_FACES); z ++) {
 			dgInt32 zStep = z * m_width;
 			for (dgInt32 x = x0; (x < x1) && (faceCount < DG_MAX_COLLIDING_FACES); x ++) {
-				const dgInt32* const indirectIndex = &m_cellIndices[dgInt32 (m_diagonals[zStep + x])][0];
+				const dgInt32* const indirectIndex = &m_cellIndices[GetDiagonal(x, z)][0];
+
+				dgInt32 atribute;
+				if (m_tiles) {
+					const dgTile* const tile = GetCellTile(x, z);
+					holes[faceCount >> 1] = tile ? 0 : 1;
+					atribute = tile ? GetCellAtribute(tile, x, z) : 0;
+				} else {
+					atribute = m_atributeMap[zStep + x];
+				}
 
 				dgInt32 vIndex[4];
 				vIndex[0] = vertexIndex;
@@ -1121,7 +1791,7 @@ void dgCollisionHeightField::GetCollidingFaces (dgPolygonMeshDesc* const data) c
 				indices[index + 0 + 0] = i2;
 				indices[index + 0 + 1] = i1;
 				indices[index + 0 + 2] = i0;
-				indices[index + 0 + 3] = m_atributeMap[zStep + x];
+				indices[index + 0 + 3] = atribute;
 				indices[index + 0 + 4] = normalIndex0;
 				indices[index + 0 + 5] = normalIndex0;
 				indices[index + 0 + 6] = normalIndex0;
@@ -1132,7 +1802,7 @@ void dgCollisionHeightField::GetCollidingFaces (dgPolygonMeshDesc* const data) c
 				indices[index + 9 + 0] = i1;
 				indices[index + 9 + 1] = i2;
 				indices[index + 9 + 2] = i3;
-				indices[index + 9 + 3] = m_atributeMap[zStep + x];
+				indices[index + 9 + 3] = atribute;
 				indices[index + 9 + 4] = normalIndex1;
 				indices[index + 9 + 5] = normalIndex1;
 				indices[index + 9 + 6] = normalIndex1;
@@ -1165,12 +1835,11 @@ void dgCollisionHeightField::GetCollidingFaces (dgPolygonMeshDesc* const data) c
 		const int maxIndex = index;
 		dgInt32 stepBase = (x1 - x0) * (2 * 9);
 		for (dgInt32 z = z0; z < z1; z ++) {
-			const dgInt32 diagBase = m_width * z;
 			const dgInt32 triangleIndexBase = (z - z0) * stepBase;
 			for (dgInt32 x = x0; x < (x1 - 1); x ++) {
 				dgInt32 index1 = (x - x0) * (2 * 9) + triangleIndexBase;
 				if (index1 < maxIndex) {
-					const dgInt32 code = (m_diagonals[diagBase + x] << 1) + m_diagonals[diagBase + x + 1];
+					const dgInt32 code = (GetDiagonal(x, z) << 1) + GetDiagonal(x + 1, z);
 					const dgInt32* const edgeMap = &m_horizontalEdgeMap[code][0];
 				
 					dgInt32* const triangles = &indices[index1];
@@ -1201,8 +1870,7 @@ void dgCollisionHeightField::GetCollidingFaces (dgPolygonMeshDesc* const data) c
 			for (dgInt32 z = z0; z < (z1 - 1); z ++) {	
 				dgInt32 index1 = (z - z0) * stepBase + triangleIndexBase;
 				if (index1 < maxIndex) {
-					const dgInt32 diagBase = m_width * z;
-					const dgInt32 code = (m_diagonals[diagBase + x] << 1) + m_diagonals[diagBase + m_width + x];
+					const dgInt32 code = (GetDiagonal(x, z) << 1) + GetDiagonal(x, z + 1);
 					const dgInt32* const edgeMap = &m_verticalEdgeMap[code][0];
 
 					dgInt32* const triangles = &indices[index1];
@@ -1228,6 +1896,20 @@ void dgCollisionHeightField::GetCollidingFaces (dgPolygonMeshDesc* const data) c
 			}
 		}
 
+		if (m_tiles) {
+			// remove the faces of the cells in non resident tiles
+			dgInt32 count = 0;
+			for (dgInt32 i = 0; i < faceCount; i ++) {
+				if (!holes[i >> 1]) {
+					if (count != i) {
+						memcpy (&indices[count * 9], &indices[i * 9], 9 * sizeof (dgInt32));
+					}
+					count ++;
+				}
+			}
+			faceCount = count;
+		}
+
 		dgInt32 stride = sizeof (dgVector) / sizeof (dgFloat32);
 		dgInt32 faceCount0 = 0; 
 		dgInt32 faceIndexCount0 = 0; 
@@ -27,6 +27,7 @@
 
 class dgCollisionHeightField;
 typedef dgFloat32 (*dgCollisionHeightFieldRayCastCallback) (const dgBody* const body, const dgCollisionHeightField* const heightFieldCollision, dgFloat32 interception, dgInt32 row, dgInt32 col, dgVector* const normal, int faceId, void* const usedData);
+typedef dgInt32 (*dgCollisionHeightFieldTileLoadCallback) (const dgCollisionHeightField* const heightFieldCollision, dgInt32 tile_x, dgInt32 tile_z, const void** const elevationMap, const dgInt8** const atributeMap, void* const userData);
 
 
 class dgCollisionHeightField: public dgCollisionMesh
@@ -53,16 +54,61 @@ class dgCollisionHeightField: public dgCollisionMesh
 							const void* const elevationMap, dgElevationType elevationDataType, dgFloat32 verticalScale, 
 							const dgInt8* const atributeMap, dgFloat32 horizontalScale_x, dgFloat32 horizontalScale_z);
 
+	dgCollisionHeightField (dgWorld* const world, dgInt32 tileCount_x, dgInt32 tileCount_z, dgInt32 tileSize, dgInt32 contructionMode, 
+							dgElevationType elevationDataType, dgFloat32 minElevation, dgFloat32 maxElevation, dgFloat32 verticalScale, 
+							dgFloat32 horizontalScale_x, dgFloat32 horizontalScale_z);
+
+	dgCollisionHeightField (dgWorld* const world, const dgImageHeader* const header);
 	dgCollisionHeightField (dgWorld* const world, dgDeserialize deserialization, void* const userData, dgInt32 revisionNumber);
 
 	virtual ~dgCollisionHeightField(void);
 
+	// height fields created from an image reference the image memory and can not be modified
+	bool IsMapped() const { return m_mapped; }
+
 	void SetCollisionRayCastCallback (dgCollisionHeightFieldRayCastCallback rayCastCallback);
 	dgCollisionHeightFieldRayCastCallback GetDebugRayCastCallback() const { return m_userRayCastCallback;} 
 
 	void SetHorizontalDisplacement (const dgUnsigned16* const displacemnet, dgFloat32 scale);
 
+	// tiled height fields reference the tile data, the memory must stay valid until the tile is replaced or evicted.
+	// tiles can only be set or evicted while the world is not updating.
+	bool IsTiled() const { return m_tiles ? true : false; }
+	bool IsTileResident (dgInt32 tile_x, dgInt32 tile_z) const;
+	void SetTile (dgInt32 tile_x, dgInt32 tile_z, const void* const elevationMap, const dgInt8* const atributeMap);
+	void SetTileLoadCallback (dgCollisionHeightFieldTileLoadCallback callback, void* const userData);
+
 	private:
+	class dgTile
+	{
+		public:
+		const void* m_elevation;
+		const dgInt8* m_atributes;
+		dgFloat32* m_bounds;
+		dgInt32 m_requested;
+	};
+
+	class dgHeightFieldImage
+	{
+		public:
+		dgFloat32 m_minBox[4];
+		dgFloat32 m_maxBox[4];
+		dgInt32 m_width;
+		dgInt32 m_height;
+		dgInt32 m_diagonalMode;
+		dgInt32 m_elevationDataType;
+		dgFloat32 m_verticalScale;
+		dgFloat32 m_horizontalScale_x;
+		dgFloat32 m_horizontalDisplacementScale_x;
+		dgFloat32 m_horizontalScale_z;
+		dgFloat32 m_horizontalDisplacementScale_z;
+		dgInt32 m_elevationOffset;
+		dgInt32 m_atributeOffset;
+		dgInt32 m_diagonalsOffset;
+		dgInt32 m_displacementOffset;
+		dgInt32 m_reserved[3];
+	};
+
 	class dgPerIntanceData
 	{
 		public:
@@ -72,6 +118,8 @@ class dgCollisionHeightField: public dgCollisionMesh
 		dgArray<dgVector> m_vertex[DG_MAX_THREADS_HIVE_COUNT];
 	};
 
+	void InitInstanceData(dgWorld* const world);
+	void CalculateDiagonals(dgInt32 width, dgInt32 height);
 	void CalculateAABB();
 	void CalculateMinAndMaxElevation(dgInt32 x0, dgInt32 x1, dgInt32 z0, dgInt32 z1, const dgUnsigned16* const elevation, dgFloat32& minHeight, dgFloat32& maxHeight) const;
 	void CalculateMinAndMaxElevation(dgInt32 x0, dgInt32 x1, dgInt32 z0, dgInt32 z1, const dgFloat32* const elevation, dgFloat32& minHeight, dgFloat32& maxHeight) const;
@@ -82,6 +130,9 @@ class dgCollisionHeightField: public dgCollisionMesh
 	dgFloat32 RayCastCell (const dgFastRayTest& ray, dgInt32 xIndex0, dgInt32 zIndex0, dgVector& normalOut, dgFloat32 maxT) const;
 
 	virtual void Serialize(dgSerialize callback, void* const userData) const;
+	virtual dgInt32 GetImageSize () const;
+	virtual void SerializeImage (dgSerialize callback, void* const userData) const;
+	bool MapImage (const dgImageHeader* const header);
 	virtual dgFloat32 RayCast (const dgVector& localP0, const dgVector& localP1, dgFloat32 maxT, dgContactPoint& contactOut, const dgBody* const body, void* const userData, OnRayPrecastAction preFilter) const;
 	virtual void GetCollidingFaces (dgPolygonMeshDesc* const data) const;
 
@@ -96,6 +147,46 @@ class dgCollisionHeightField: public dgCollisionMesh
 	
 	void AddDisplacement (dgVector* const vertex, dgInt32 x0, dgInt32 x1, dgInt32 z0, dgInt32 z1) const;
 
+	void InitTiles(dgInt32 tileCount_x, dgInt32 tileCount_z, dgInt32 tileSize);
+	void InstallTile(dgTile* const tile, const void* const elevationMap, const dgInt8* const atributeMap) const;
+	void EvictTile(dgTile* const tile);
+	void LoadTile(dgTile* const tile, dgInt32 tile_x, dgInt32 tile_z) const;
+	const dgTile* GetTile(dgInt32 tile_x, dgInt32 tile_z) const;
+	bool GetTiledElevation(dgInt32 x, dgInt32 z, dgFloat32& elevation) const;
+	void CalculateTiledMinAndMaxElevation(dgInt32 x0, dgInt32 x1, dgInt32 z0, dgInt32 z1, dgFloat32& minHeight, dgFloat32& maxHeight) const;
+	void CalculateTileMinAndMaxElevation(const dgTile* const tile, dgInt32 level, dgInt32 block_x, dgInt32 block_z, dgInt32 x0, dgInt32 x1, dgInt32 z0, dgInt32 z1, dgFloat32& minHeight, dgFloat32& maxHeight) const;
+	bool RayCastTileBlock(const dgVector& q0, const dgVector& q1, dgInt32 x, dgInt32 z) const;
+	dgVector TiledSupportVertex (const dgVector& dir) const;
+	void TiledDebugCollision (const dgMatrix& matrix, dgCollision::OnDebugCollisionMeshCallback callback, void* const userData) const;
+
+	DG_INLINE dgFloat32 GetTileElevation(const dgTile* const tile, dgInt32 x, dgInt32 z) const
+	{
+		const dgInt32 index = z * (m_tileSize + 1) + x;
+		return (m_elevationDataType == m_float32Bit) ? ((const dgFloat32*)tile->m_elevation)[index] : dgFloat32 (((const dgUnsigned16*)tile->m_elevation)[index]);
+	}
+
+	DG_INLINE const void* GetResidentElevation(const dgTile* const tile) const
+	{
+		// pairs with the release store in InstallTile, so a resident tile has its bounds and attributes visible
+		return dgAtomicLoadAcquire((void* const*)&tile->m_elevation);
+	}
+
+	DG_INLINE const dgTile* GetCellTile(dgInt32 x, dgInt32 z) const
+	{
+		return GetTile(x >> m_tileShift, z >> m_tileShift);
+	}
+
+	DG_INLINE dgInt32 GetCellAtribute(const dgTile* const tile, dgInt32 x, dgInt32 z) const
+	{
+		return tile->m_atributes ? tile->m_atributes[((z & m_tileMask) << m_tileShift) + (x & m_tileMask)] : 0;
+	}
+
+	DG_INLINE dgInt32 GetDiagonal(dgInt32 x, dgInt32 z) const
+	{
+		// the diagonal patterns repeat every two cells, so all tiles share the same diagonal map
+		return m_tiles ? m_diagonals[((z & m_tileMask) << m_tileShift) + (x & m_tileMask)] : m_diagonals[z * m_width + x];
+	}
+
 	DG_INLINE dgInt32 dgFastInt(dgFloat32 x) const
 	{
 		dgInt32 i = dgInt32(x);
@@ -124,7 +215,18 @@ class dgCollisionHeightField: public dgCollisionMesh
 	dgFloat32 m_horizontalDisplacementScale_z;
 	dgCollisionHeightFieldRayCastCallback m_userRayCastCallback;
 	dgElevationType m_elevationDataType;
-
+	bool m_mapped;
+
+	dgTile* m_tiles;
+	dgInt32 m_tileCount_x;
+	dgInt32 m_tileCount_z;
+	dgInt32 m_tileSize;
+	dgInt32 m_tileShift;
+	dgInt32 m_tileMask;
+	dgInt32 m_tileLevels;
+	mutable dgInt32 m_tileLock;
+	dgCollisionHeightFieldTileLoadCallback m_tileLoadCallback;
+	void* m_tileLoadUserData;
 	
 	static dgVector m_yMask;
 	static dgVector m_padding;
@@ -23,89 +23,876 @@
 #include "dgBody.h"
 #include "dgWorld.h"
 #include "dgContact.h"
-#include "dgMeshEffect.h"
 #include "dgDynamicBody.h"
 #include "dgCollisionIncompressibleParticles.h"
 
+// position based fluid (Macklin and Muller 2013): the particles are advected with the external forces, then 
+// the positions are projected so that the density around each particle matches the rest density.
+// neighbors are found with a spatial hash over a uniform grid of the size of the smoothing kernel, 
+// and each phase of the solver runs in parallel over chunks of particles in the world thread pool.
 
-dgCollisionIncompressibleParticles::dgCollisionIncompressibleParticles(dgWorld* const world, dgMeshEffect* const mesh)
+#define DG_FLUID_KERNEL_RADIUS_SCALE	dgFloat32 (4.0f)
+#define DG_FLUID_RELAXATION				dgFloat32 (0.1f)
+#define DG_FLUID_WALL_FRICTION			dgFloat32 (0.1f)
+#define DG_FLUID_MAX_NEIGHBORS			64
+#define DG_FLUID_SOLVER_ITERATIONS		4
+#define DG_FLUID_PARTICLES_CHUNK_SIZE	64
+
+
+dgCollisionIncompressibleParticles::dgCollisionIncompressibleParticles(dgWorld* const world, dgInt32 shapeID, dgInt32 pointCount, const dgFloat32* const points, dgInt32 strideInBytes, dgFloat32 particleRadius, dgFloat32 restDensity, dgFloat32 viscosity)
 	:dgCollisionLumpedMassParticles(world, m_deformableSolidMesh)
+	,m_normalDir(NULL)
+	,m_normalAccel(NULL)
+	,m_predicted(NULL)
+	,m_delta(NULL)
+	,m_lambda(NULL)
+	,m_friction(NULL)
+	,m_cellKey(world->GetAllocator())
+	,m_cellStart(world->GetAllocator())
+	,m_sortedParticles(world->GetAllocator())
+	,m_neighbors(world->GetAllocator())
+	,m_neighborsCount(world->GetAllocator())
+	,m_colliders(world->GetAllocator())
+	,m_reactions(world->GetAllocator())
+	,m_restDensity(restDensity)
+	,m_viscosity(viscosity)
+	,m_kernelRadius(particleRadius * DG_FLUID_KERNEL_RADIUS_SCALE)
+	,m_cellKeyMask(0)
+	,m_collidersCount(0)
+	,m_collidersLock(0)
+	,m_threadsCount(0)
 {
 	m_rtti |= dgCollisionIncompressibleParticles_RTTI;
+	dgAssert (pointCount > 0);
+	dgAssert (particleRadius > dgFloat32 (0.0f));
+	dgAssert (restDensity > dgFloat32 (0.0f));
 
-/*
-	dgInt32 count = mesh->GetVertexCount();
-	dgVector* const points = dgAlloca(dgVector, count);
-
-	for (dgInt32 i = 0; i < count; i++) {
-		dgBigVector p(mesh->GetVertex(i));
-		points[i] = p;
-	}
-
-	m_indexToVertexCount = count;
-	m_indexToVertexMap.Resize(count);
-	dgInt32* const indexToVertexMap = &m_indexToVertexMap[0];
-	m_particlesCount = dgVertexListToIndexList(&points[0].m_x, sizeof(dgVector), 3 * sizeof(dgFloat32), 0, count, indexToVertexMap, dgFloat32(1.0e-5f));
-	for (dgInt32 i = 0; i < m_particlesCount; i++) {
-		m_posit[i] = points[i];
-	}
-
-
-	dgInt32 edgeCount = 0;
-	dgSoftLink* const links = dgAlloca(dgSoftLink, mesh->GetCount() / 2);
-	for (void* edgePtr = mesh->GetFirstEdge(); edgePtr; edgePtr = mesh->GetNextEdge(edgePtr)) {
-		const dgEdge* const edge = mesh->GetPolyhedraEdgeFromNode(edgePtr);
-
-		dgInt32 v0 = indexToVertexMap[edge->m_incidentVertex];
-		dgInt32 v1 = indexToVertexMap[edge->m_twin->m_incidentVertex];
-		links[edgeCount].m_m0 = dgInt16(dgMin(v0, v1));
-		links[edgeCount].m_m1 = dgInt16(dgMax(v0, v1));
-		edgeCount++;
-		if ((edge->m_incidentFace > 0) && (edge->m_twin->m_incidentFace > 0)) {
-			v0 = indexToVertexMap[edge->m_prev->m_incidentVertex];
-			v1 = indexToVertexMap[edge->m_twin->m_prev->m_incidentVertex];
-			links[edgeCount].m_m0 = dgInt16(dgMin(v0, v1));
-			links[edgeCount].m_m1 = dgInt16(dgMax(v0, v1));
-			edgeCount++;
+	// calibrate the particle mass so that a particle inside a lattice 
+	// with a spacing of two radius has exactly the rest density
+	const dgFloat32 h2 = m_kernelRadius * m_kernelRadius;
+	const dgFloat32 spacing = particleRadius * dgFloat32 (2.0f);
+	const dgInt32 cells = dgInt32 (m_kernelRadius / spacing) + 1;
+	dgFloat32 kernelSum = dgFloat32 (0.0f);
+	for (dgInt32 z = -cells; z <= cells; z ++) {
+		for (dgInt32 y = -cells; y <= cells; y ++) {
+			for (dgInt32 x = -cells; x <= cells; x ++) {
+				const dgFloat32 r2 = spacing * spacing * dgFloat32 (x * x + y * y + z * z);
+				if (r2 < h2) {
+					const dgFloat32 w = h2 - r2;
+					kernelSum += w * w * w;
+				}
+			}
 		}
 	}
-	dgSort(links, edgeCount, CompareEdges);
+	const dgFloat32 poly6 = dgFloat32 (315.0f) / (dgFloat32 (64.0f) * dgPi * h2 * h2 * h2 * h2 * m_kernelRadius);
+	const dgFloat32 particleMass = restDensity / (poly6 * kernelSum);
 
-	dgInt32 uniqueEdgeCount = 0;
-	for (dgInt32 i = 1; i < edgeCount; i++) {
-		if (CompareEdges(&links[i], &links[uniqueEdgeCount], NULL) > 0) {
-			uniqueEdgeCount++;
-			links[uniqueEdgeCount] = links[i];
-		}
-	}
-	uniqueEdgeCount++;
-	m_linksCount = uniqueEdgeCount;
-	m_linkList.Resize(m_linksCount);
-	for (dgInt32 i = 0; i < m_linksCount; i++) {
-		m_linkList[i] = links[i];
+	m_particleRadius = particleRadius;
+	m_particlesCount = pointCount;
+	m_posit.Resize(m_particlesCount);
+	m_mass.Resize(m_particlesCount);
+	m_invMass.Resize(m_particlesCount);
+	const dgInt32 stride = strideInBytes / sizeof (dgFloat32);
+	m_totalMass = dgFloat32(0.0f);
+	for (dgInt32 i = 0; i < pointCount; i++) {
+		m_totalMass += particleMass;
+		m_mass[i] = particleMass;
+		m_invMass[i] = dgFloat32(1.0f) / particleMass;
+		m_posit[i] = dgVector(points[i * stride + 0], points[i * stride + 1], points[i * stride + 2], dgFloat32(0.0f));
 	}
+
+	AllocateSpatialHash();
 	FinalizeBuild();
-*/
 }
 
-
 dgCollisionIncompressibleParticles::dgCollisionIncompressibleParticles(const dgCollisionIncompressibleParticles& source)
 	:dgCollisionLumpedMassParticles(source)
+	,m_normalDir(NULL)
+	,m_normalAccel(NULL)
+	,m_predicted(NULL)
+	,m_delta(NULL)
+	,m_lambda(NULL)
+	,m_friction(NULL)
+	,m_cellKey(source.m_cellKey, source.m_particlesCount)
+	,m_cellStart(source.m_cellStart, source.m_cellKeyMask + 2)
+	,m_sortedParticles(source.m_sortedParticles, source.m_particlesCount)
+	,m_neighbors(source.m_neighbors, source.m_particlesCount * DG_FLUID_MAX_NEIGHBORS)
+	,m_neighborsCount(source.m_neighborsCount, source.m_particlesCount)
+	,m_colliders(source.m_colliders.GetAllocator())
+	,m_reactions(source.m_reactions.GetAllocator())
+	,m_restDensity(source.m_restDensity)
+	,m_viscosity(source.m_viscosity)
+	,m_kernelRadius(source.m_kernelRadius)
+	,m_cellKeyMask(source.m_cellKeyMask)
+	,m_collidersCount(0)
+	,m_collidersLock(0)
+	,m_threadsCount(0)
 {
 	m_rtti |= source.m_rtti;
 }
 
 dgCollisionIncompressibleParticles::dgCollisionIncompressibleParticles(dgWorld* const world, dgDeserialize deserialization, void* const userData, dgInt32 revisionNumber)
 	:dgCollisionLumpedMassParticles(world, deserialization, userData, revisionNumber)
+	,m_normalDir(NULL)
+	,m_normalAccel(NULL)
+	,m_predicted(NULL)
+	,m_delta(NULL)
+	,m_lambda(NULL)
+	,m_friction(NULL)
+	,m_cellKey(world->GetAllocator())
+	,m_cellStart(world->GetAllocator())
+	,m_sortedParticles(world->GetAllocator())
+	,m_neighbors(world->GetAllocator())
+	,m_neighborsCount(world->GetAllocator())
+	,m_colliders(world->GetAllocator())
+	,m_reactions(world->GetAllocator())
+	,m_restDensity(dgFloat32 (1000.0f))
+	,m_viscosity(dgFloat32 (0.0f))
+	,m_kernelRadius(m_particleRadius * DG_FLUID_KERNEL_RADIUS_SCALE)
+	,m_cellKeyMask(0)
+	,m_collidersCount(0)
+	,m_collidersLock(0)
+	,m_threadsCount(0)
 {
+	m_rtti |= dgCollisionIncompressibleParticles_RTTI;
+	deserialization(userData, &m_restDensity, sizeof (m_restDensity));
+	deserialization(userData, &m_viscosity, sizeof (m_viscosity));
+	dgAssert (m_particlesCount > 0);
+	dgAssert (m_restDensity > dgFloat32 (0.0f));
+
+	// the grid and neighbor tables are scratch state, rebuild them for the loaded particles
+	AllocateSpatialHash();
 }
 
 dgCollisionIncompressibleParticles::~dgCollisionIncompressibleParticles(void)
 {
 }
 
+void dgCollisionIncompressibleParticles::Serialize(dgSerialize callback, void* const userData) const
+{
+	// the lumped mass shapes share the deformable collision id, 
+	// the leading rtti tells the instance loader which one to build.
+	dgInt32 rtti = dgCollisionIncompressibleParticles_RTTI;
+	callback(userData, &rtti, sizeof (rtti));
+	SerializeLow(callback, userData);
+	callback(userData, &m_restDensity, sizeof (m_restDensity));
+	callback(userData, &m_viscosity, sizeof (m_viscosity));
+}
+
+void dgCollisionIncompressibleParticles::AllocateSpatialHash()
+{
+	dgInt32 tableSize = 1;
+	while (tableSize < m_particlesCount * 2) {
+		tableSize *= 2;
+	}
+	m_cellKeyMask = tableSize - 1;
+	m_cellStart.Resize(tableSize + 1);
+	m_cellKey.Resize(m_particlesCount);
+	m_sortedParticles.Resize(m_particlesCount);
+	m_neighborsCount.Resize(m_particlesCount);
+	m_neighbors.Resize(m_particlesCount * DG_FLUID_MAX_NEIGHBORS);
+}
+
+dgInt32 dgCollisionIncompressibleParticles::GetMemoryBufferSizeInBytes() const
+{
+	dgInt32 sizeInByte = 0;
+	sizeInByte += 4 * m_particlesCount * sizeof (dgVector);
+	sizeInByte += 2 * m_particlesCount * sizeof (dgFloat32);
+	return sizeInByte;
+}
+
+DG_INLINE dgInt32 dgCollisionIncompressibleParticles::GetCellKey (dgInt32 x, dgInt32 y, dgInt32 z) const
+{
+	const dgUnsigned32 key = (dgUnsigned32 (x) * 73856093u) ^ (dgUnsigned32 (y) * 19349663u) ^ (dgUnsigned32 (z) * 83492791u);
+	return dgInt32 (key & dgUnsigned32 (m_cellKeyMask));
+}
+
+void dgCollisionIncompressibleParticles::RegisterCollision(const dgBody* const otherBody)
+{
+	// particle systems do not collide with each other
+	if (!otherBody->GetCollision()->IsType(dgCollision::dgCollisionLumpedMass_RTTI)) {
+		dgScopeSpinLock lock(&m_collidersLock);
+		for (dgInt32 i = 0; i < m_collidersCount; i ++) {
+			if (m_colliders[i] == otherBody) {
+				return;
+			}
+		}
+		m_colliders[m_collidersCount] = (dgBody*) otherBody;
+		m_collidersCount ++;
+		m_body->SetSleepState(false);
+	}
+}
+
+void dgCollisionIncompressibleParticles::DispatchKernel (dgWorkerThreadTaskCallback kernel, dgFluidSyncDescriptor* const descriptor, const char* const name)
+{
+	dgWorld* const world = m_body->GetWorld();
+	descriptor->m_atomicIndex = 0;
+	for (dgInt32 i = 0; i < m_threadsCount; i ++) {
+		world->QueueJob(kernel, descriptor, world, name);
+	}
+	world->SynchronizationBarrier();
+}
+
+void dgCollisionIncompressibleParticles::IntegrateForces (dgFloat32 timestep)
+{
+	D_TRACKTIME();
+	dgAssert(m_body->m_invMass.m_w > dgFloat32(0.0f));
+	dgAssert(m_body->IsRTTIType(dgBody::m_dynamicBodyRTTI));
+
+	dgWorld* const world = m_body->GetWorld();
+	m_threadsCount = world->GetThreadCount();
+	world->m_solverJacobiansMemory.ResizeIfNecessary(GetMemoryBufferSizeInBytes() + 1024);
+
+	m_normalDir = (dgVector*)&world->m_solverJacobiansMemory[0];
+	m_normalAccel = &m_normalDir[m_particlesCount];
+	m_predicted = &m_normalAccel[m_particlesCount];
+	m_delta = &m_predicted[m_particlesCount];
+	m_lambda = (dgFloat32*)&m_delta[m_particlesCount];
+	m_friction = &m_lambda[m_particlesCount];
+
+	// the owner external force is applied as a uniform acceleration to all particles
+	dgVector* const extAccel = &m_externalAccel[0];
+	const dgVector unitAccel(m_body->m_externalForce * dgVector(m_body->m_invMass.m_w));
+	for (dgInt32 i = 0; i < m_particlesCount; i++) {
+		extAccel[i] = unitAccel;
+	}
+
+	m_body->m_alpha = dgVector::m_zero;
+	m_body->m_omega = dgVector::m_zero;
+	m_body->m_externalForce = dgVector::m_zero;
+	m_body->m_externalTorque = dgVector::m_zero;
+
+	HandleCollision(timestep, m_normalDir, m_normalAccel, m_friction);
+
+	dgFluidSyncDescriptor descriptor(this, timestep);
+	DispatchKernel(PredictPositionsKernel, &descriptor, "dgCollisionIncompressibleParticles::PredictPositions");
+	SortParticlesGrid();
+	DispatchKernel(FindNeighborsKernel, &descriptor, "dgCollisionIncompressibleParticles::FindNeighbors");
+
+	for (dgInt32 i = 0; i < DG_FLUID_SOLVER_ITERATIONS; i ++) {
+		DispatchKernel(CalculateLambdasKernel, &descriptor, "dgCollisionIncompressibleParticles::CalculateLambdas");
+		DispatchKernel(CalculateDeltaPositionsKernel, &descriptor, "dgCollisionIncompressibleParticles::CalculateDeltaPositions");
+		DispatchKernel(ApplyDeltaPositionsKernel, &descriptor, "dgCollisionIncompressibleParticles::ApplyDeltaPositions");
+	}
+
+	DispatchKernel(UpdateVelocitiesKernel, &descriptor, "dgCollisionIncompressibleParticles::UpdateVelocities");
+	if (m_viscosity > dgFloat32 (0.0f)) {
+		DispatchKernel(CalculateViscosityKernel, &descriptor, "dgCollisionIncompressibleParticles::CalculateViscosity");
+		DispatchKernel(ApplyViscosityKernel, &descriptor, "dgCollisionIncompressibleParticles::ApplyViscosity");
+	}
+
+	UpdateBodyState(timestep);
+	m_collidersCount = 0;
+}
+
+void dgCollisionIncompressibleParticles::HandleCollision (dgFloat32 timestep, dgVector* const normalDir, dgVector* const normalAccel, dgFloat32* const frictionCoefficient)
+{
+	dgAssert (normalDir == m_normalDir);
+	dgAssert (normalAccel == m_normalAccel);
+	dgAssert (frictionCoefficient == m_friction);
+
+	const dgInt32 reactionsCount = 2 * m_collidersCount * m_threadsCount;
+	m_reactions.ResizeIfNecessary(reactionsCount);
+	for (dgInt32 i = 0; i < reactionsCount; i ++) {
+		m_reactions[i] = dgVector::m_zero;
+	}
+
+	dgFluidSyncDescriptor descriptor(this, timestep);
+	DispatchKernel(CalculateCollisionsKernel, &descriptor, "dgCollisionIncompressibleParticles::CalculateCollisions");
+
+	// apply the particles impulses to the rigid bodies, the change of velocity takes effect next step
+	for (dgInt32 i = 0; i < m_collidersCount; i ++) {
+		dgBody* const body = m_colliders[i];
+		if (body->IsRTTIType(dgBody::m_dynamicBodyRTTI) && (body->GetInvMass().m_w > dgFloat32 (0.0f))) {
+			dgVector impulse(dgVector::m_zero);
+			dgVector angularImpulse(dgVector::m_zero);
+			for (dgInt32 j = 0; j < m_threadsCount; j ++) {
+				const dgInt32 index = (j * m_collidersCount + i) * 2;
+				impulse += m_reactions[index];
+				angularImpulse += m_reactions[index + 1];
+			}
+			if (impulse.DotProduct(impulse).GetScalar() > dgFloat32 (0.0f)) {
+				body->SetVelocity(body->GetVelocity() + impulse.Scale(body->GetInvMass().m_w));
+				body->SetOmega(body->GetOmega() + body->GetInvInertiaMatrix().RotateVector(angularImpulse));
+			}
+		}
+	}
+}
+
+void dgCollisionIncompressibleParticles::SortParticlesGrid ()
+{
+	D_TRACKTIME();
+	// counting sort of the particles by cell key, after the scatter 
+	// the particles of cell k are in the range [cellStart[k], cellStart[k + 1])
+	const dgInt32 tableSize = m_cellKeyMask + 1;
+	const dgInt32* const cellKey = &m_cellKey[0];
+	dgInt32* const cellStart = &m_cellStart[0];
+	dgInt32* const sortedParticles = &m_sortedParticles[0];
+
+	memset (cellStart, 0, (tableSize + 1) * sizeof (dgInt32));
+	for (dgInt32 i = 0; i < m_particlesCount; i ++) {
+		cellStart[cellKey[i]] ++;
+	}
+	for (dgInt32 i = 1; i <= tableSize; i ++) {
+		cellStart[i] += cellStart[i - 1];
+	}
+	for (dgInt32 i = m_particlesCount - 1; i >= 0; i --) {
+		const dgInt32 key = cellKey[i];
+		cellStart[key] --;
+		sortedParticles[cellStart[key]] = i;
+	}
+}
+
+void dgCollisionIncompressibleParticles::UpdateBodyState (dgFloat32 timestep)
+{
+	D_TRACKTIME();
+	dgVector* const posit = &m_posit[0];
+	const dgVector* const veloc = &m_veloc[0];
+	const dgVector* const accel = &m_accel[0];
+	const dgFloat32* const mass = &m_mass[0];
+
+	dgVector com(dgVector::m_zero);
+	dgVector maxAccel(dgVector::m_zero);
+	dgVector minP(dgFloat32 (1.0e10f));
+	dgVector maxP(dgFloat32 (-1.0e10f));
+	dgFloat32 maxAccel2 = dgFloat32 (0.0f);
+	dgFloat32 maxSpeed2 = dgFloat32 (0.0f);
+	for (dgInt32 i = 0; i < m_particlesCount; i ++) {
+		com += posit[i].Scale(mass[i]);
+		minP = minP.GetMin(posit[i]);
+		maxP = maxP.GetMax(posit[i]);
+		const dgFloat32 accel2 = accel[i].DotProduct(accel[i]).GetScalar();
+		if (accel2 > maxAccel2) {
+			maxAccel2 = accel2;
+			maxAccel = accel[i];
+		}
+		maxSpeed2 = dgMax (maxSpeed2, veloc[i].DotProduct(veloc[i]).GetScalar());
+	}
+
+	// keep the particles centered around the owner center of mass, the owner moves instead
+	const dgVector step((com.Scale(dgFloat32 (1.0f) / m_totalMass) - m_body->m_localCentreOfMass) & dgVector::m_triplexMask);
+	for (dgInt32 i = 0; i < m_particlesCount; i ++) {
+		posit[i] -= step;
+	}
+
+	// the owner reports the largest particle acceleration, so that it only comes to rest when all the particles do
+	m_body->m_veloc = step.Scale(dgFloat32 (1.0f) / timestep);
+	m_body->m_accel = maxAccel;
+	m_body->m_omega = dgVector::m_zero;
+	m_body->m_alpha = dgVector::m_zero;
+
+	// the box encloses how far the particles can travel next step, so that the broad phase reports the bodies they may hit
+	const dgVector padding(dgVector (m_particleRadius + dgSqrt (maxSpeed2) * timestep) & dgVector::m_triplexMask);
+	m_boxOrigin = (dgVector::m_half * (maxP + minP) - step) & dgVector::m_triplexMask;
+	m_boxSize = (dgVector::m_half * (maxP - minP) + padding) & dgVector::m_triplexMask;
+}
+
+void dgCollisionIncompressibleParticles::CalculateCollisionsKernel (void* const context, void* const worldContext, dgInt32 threadID)
+{
+	D_TRACKTIME();
+	dgFluidSyncDescriptor* const descriptor = (dgFluidSyncDescriptor*) context;
+	descriptor->m_fluid->CalculateCollisions(descriptor, threadID);
+}
+
+void dgCollisionIncompressibleParticles::PredictPositionsKernel (void* const context, void* const worldContext, dgInt32 threadID)
+{
+	D_TRACKTIME();
+	dgFluidSyncDescriptor* const descriptor = (dgFluidSyncDescriptor*) context;
+	descriptor->m_fluid->PredictPositions(descriptor, threadID);
+}
+
+void dgCollisionIncompressibleParticles::FindNeighborsKernel (void* const context, void* const worldContext, dgInt32 threadID)
+{
+	D_TRACKTIME();
+	dgFluidSyncDescriptor* const descriptor = (dgFluidSyncDescriptor*) context;
+	descriptor->m_fluid->FindNeighbors(descriptor, threadID);
+}
+
+void dgCollisionIncompressibleParticles::CalculateLambdasKernel (void* const context, void* const worldContext, dgInt32 threadID)
+{
+	D_TRACKTIME();
+	dgFluidSyncDescriptor* const descriptor = (dgFluidSyncDescriptor*) context;
+	descriptor->m_fluid->CalculateLambdas(descriptor, threadID);
+}
+
+void dgCollisionIncompressibleParticles::CalculateDeltaPositionsKernel (void* const context, void* const worldContext, dgInt32 threadID)
+{
+	D_TRACKTIME();
+	dgFluidSyncDescriptor* const descriptor = (dgFluidSyncDescriptor*) context;
+	descriptor->m_fluid->CalculateDeltaPositions(descriptor, threadID);
+}
+
+void dgCollisionIncompressibleParticles::ApplyDeltaPositionsKernel (void* const context, void* const worldContext, dgInt32 threadID)
+{
+	D_TRACKTIME();
+	dgFluidSyncDescriptor* const descriptor = (dgFluidSyncDescriptor*) context;
+	descriptor->m_fluid->ApplyDeltaPositions(descriptor, threadID);
+}
+
+void dgCollisionIncompressibleParticles::UpdateVelocitiesKernel (void* const context, void* const worldContext, dgInt32 threadID)
+{
+	D_TRACKTIME();
+	dgFluidSyncDescriptor* const descriptor = (dgFluidSyncDescriptor*) context;
+	descriptor->m_fluid->UpdateVelocities(descriptor, threadID);
+}
+
+void dgCollisionIncompressibleParticles::CalculateViscosityKernel (void* const context, void* const worldContext, dgInt32 threadID)
+{
+	D_TRACKTIME();
+	dgFluidSyncDescriptor* const descriptor = (dgFluidSyncDescriptor*) context;
+	descriptor->m_fluid->CalculateViscosity(descriptor, threadID);
+}
+
+void dgCollisionIncompressibleParticles::ApplyViscosityKernel (void* const context, void* const worldContext, dgInt32 threadID)
+{
+	D_TRACKTIME();
+	dgFluidSyncDescriptor* const descriptor = (dgFluidSyncDescriptor*) context;
+	descriptor->m_fluid->ApplyViscosity(descriptor, threadID);
+}
+
+void dgCollisionIncompressibleParticles::CalculateCollisions (dgFluidSyncDescriptor* const descriptor, dgInt32 threadID)
+{
+	const dgFloat32 timestep = descriptor->m_timestep;
+	const dgFloat32 invTimestep = dgFloat32 (1.0f) / timestep;
+	const dgFloat32 radius = m_particleRadius;
+	const dgVector timestepV(timestep);
+	const dgVector origin(m_body->GetCollision()->GetGlobalMatrix().m_posit & dgVector::m_triplexMask);
+
+	const dgVector* const posit = &m_posit[0];
+	const dgVector* const veloc = &m_veloc[0];
+	const dgVector* const extAccel = &m_externalAccel[0];
+	const dgFloat32* const mass = &m_mass[0];
+	dgVector* const normalDir = m_normalDir;
+	dgVector* const normalAccel = m_normalAccel;
+	dgFloat32* const frictionCoefficient = m_friction;
+	dgBody** const colliders = m_collidersCount ? &m_colliders[0] : NULL;
+	dgVector* const reactions = m_collidersCount ? &m_reactions[threadID * m_collidersCount * 2] : NULL;
+
+	const dgInt32 count = m_particlesCount;
+	dgInt32* const atomicIndex = &descriptor->m_atomicIndex;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(atomicIndex, DG_FLUID_PARTICLES_CHUNK_SIZE); i < count; i = dgAtomicExchangeAndAdd(atomicIndex, DG_FLUID_PARTICLES_CHUNK_SIZE)) {
+		const dgInt32 end = dgMin (i + DG_FLUID_PARTICLES_CHUNK_SIZE, count);
+		for (dgInt32 j = i; j < end; j ++) {
+			dgVector normal(dgVector::m_zero);
+			dgVector accel(dgVector::m_zero);
+			dgFloat32 frictionCoef = dgFloat32 (0.0f);
+
+			// cast the particle path this step against the bodies overlapping the fluid 
+			const dgVector projectedVeloc(veloc[j] + extAccel[j] * timestepV);
+			const dgFloat32 speed2 = projectedVeloc.DotProduct(projectedVeloc).GetScalar();
+			if (m_collidersCount && (speed2 > dgFloat32 (1.0e-8f))) {
+				const dgVector p0(origin + posit[j]);
+				const dgVector dir(projectedVeloc.Scale(dgRsqrt (speed2)));
+				const dgVector p1(p0 + projectedVeloc * timestepV + dir.Scale(radius));
+				const dgVector boxP0(p0.GetMin(p1));
+				const dgVector boxP1(p0.GetMax(p1));
+
+				dgInt32 hitBody = -1;
+				dgFloat32 param = dgFloat32 (1.0f);
+				dgVector hitNormal(dgVector::m_zero);
+				for (dgInt32 k = 0; k < m_collidersCount; k ++) {
+					const dgBody* const body = colliders[k];
+					dgVector minBox;
+					dgVector maxBox;
+					body->GetAABB(minBox, maxBox);
+					if (dgOverlapTest(boxP0, boxP1, minBox, maxBox)) {
+						dgContactPoint contact;
+						const dgCollisionInstance* const collision = body->GetCollision();
+						const dgMatrix& matrix = collision->GetGlobalMatrix();
+						const dgVector l0(matrix.UntransformVector(p0));
+						const dgVector l1(matrix.UntransformVector(p1));
+						const dgFloat32 t = collision->RayCast(l0, l1, param, contact, NULL, body, NULL);
+						if (t < param) {
+							const dgVector n(matrix.RotateVector(contact.m_normal) & dgVector::m_triplexMask);
+							if (n.DotProduct(dir).GetScalar() < dgFloat32 (0.0f)) {
+								param = t;
+								hitBody = k;
+								hitNormal = n;
+							}
+						}
+					}
+				}
+
+				if (hitBody >= 0) {
+					// speculative contact: the particle can approach the surface up to its radius this step
+					const dgVector hitPoint(p0 + (p1 - p0).Scale(param));
+					const dgFloat32 separation = dgMax (hitNormal.DotProduct(p0 - hitPoint).GetScalar() - radius, -radius);
+					const dgFloat32 normalSpeed = hitNormal.DotProduct(projectedVeloc).GetScalar();
+					const dgFloat32 minNormalSpeed = -separation * invTimestep;
+					if (normalSpeed < minNormalSpeed) {
+						const dgFloat32 normalDeltaSpeed = minNormalSpeed - normalSpeed;
+						const dgVector tangentVeloc(projectedVeloc - hitNormal.Scale(normalSpeed));
+						const dgFloat32 tangentSpeed2 = tangentVeloc.DotProduct(tangentVeloc).GetScalar();
+						dgVector deltaVeloc(hitNormal.Scale(normalDeltaSpeed));
+						if (tangentSpeed2 > dgFloat32 (1.0e-8f)) {
+							const dgFloat32 tangentSpeed = dgSqrt (tangentSpeed2);
+							const dgFloat32 frictionSpeed = dgMin (DG_FLUID_WALL_FRICTION * normalDeltaSpeed, tangentSpeed);
+							deltaVeloc -= tangentVeloc.Scale(frictionSpeed / tangentSpeed);
+						}
+						accel = deltaVeloc.Scale(invTimestep);
+						frictionCoef = DG_FLUID_WALL_FRICTION;
+
+						const dgBody* const body = colliders[hitBody];
+						if (body->GetInvMass().m_w > dgFloat32 (0.0f)) {
+							const dgVector impulse(deltaVeloc.Scale(-mass[j]));
+							const dgVector com(body->GetMatrix().TransformVector(body->GetCentreOfMass()) & dgVector::m_triplexMask);
+							reactions[hitBody * 2 + 0] += impulse;
+							reactions[hitBody * 2 + 1] += (hitPoint - com).CrossProduct(impulse);
+						}
+					}
+					// the separation is saved in w so that the position solver does not push the particle into the body
+					normal = hitNormal;
+					normal.m_w = separation;
+				}
+			}
+
+			normalDir[j] = normal;
+			normalAccel[j] = accel;
+			frictionCoefficient[j] = frictionCoef;
+		}
+	}
+}
+
+void dgCollisionIncompressibleParticles::PredictPositions (dgFluidSyncDescriptor* const descriptor, dgInt32 threadID)
+{
+	const dgVector timestep(descriptor->m_timestep);
+	const dgFloat32 invCellSize = dgFloat32 (1.0f) / m_kernelRadius;
+
+	const dgVector* const posit = &m_posit[0];
+	const dgVector* const veloc = &m_veloc[0];
+	const dgVector* const extAccel = &m_externalAccel[0];
+	const dgVector* const normalAccel = m_normalAccel;
+	dgVector* const predicted = m_predicted;
+	dgInt32* const cellKey = &m_cellKey[0];
+
+	const dgInt32 count = m_particlesCount;
+	dgInt32* const atomicIndex = &descriptor->m_atomicIndex;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(atomicIndex, DG_FLUID_PARTICLES_CHUNK_SIZE); i < count; i = dgAtomicExchangeAndAdd(atomicIndex, DG_FLUID_PARTICLES_CHUNK_SIZE)) {
+		const dgInt32 end = dgMin (i + DG_FLUID_PARTICLES_CHUNK_SIZE, count);
+		for (dgInt32 j = i; j < end; j ++) {
+			const dgVector projectedVeloc(veloc[j] + (extAccel[j] + normalAccel[j]) * timestep);
+			const dgVector p(posit[j] + projectedVeloc * timestep);
+			predicted[j] = p;
+			cellKey[j] = GetCellKey(dgInt32 (dgFloor (p.m_x * invCellSize)), dgInt32 (dgFloor (p.m_y * invCellSize)), dgInt32 (dgFloor (p.m_z * invCellSize)));
+		}
+	}
+}
+
+void dgCollisionIncompressibleParticles::FindNeighbors (dgFluidSyncDescriptor* const descriptor, dgInt32 threadID)
+{
+	const dgFloat32 h2 = m_kernelRadius * m_kernelRadius;
+	const dgFloat32 invCellSize = dgFloat32 (1.0f) / m_kernelRadius;
+
+	const dgVector* const predicted = m_predicted;
+	const dgInt32* const cellStart = &m_cellStart[0];
+	const dgInt32* const sortedParticles = &m_sortedParticles[0];
+	dgInt32* const neighborsArray = &m_neighbors[0];
+	dgInt32* const neighborsCount = &m_neighborsCount[0];
+
+	const dgInt32 count = m_particlesCount;
+	dgInt32* const atomicIndex = &descriptor->m_atomicIndex;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(atomicIndex, DG_FLUID_PARTICLES_CHUNK_SIZE); i < count; i = dgAtomicExchangeAndAdd(atomicIndex, DG_FLUID_PARTICLES_CHUNK_SIZE)) {
+		const dgInt32 end = dgMin (i + DG_FLUID_PARTICLES_CHUNK_SIZE, count);
+		for (dgInt32 j = i; j < end; j ++) {
+			const dgVector p(predicted[j]);
+			const dgInt32 x0 = dgInt32 (dgFloor (p.m_x * invCellSize));
+			const dgInt32 y0 = dgInt32 (dgFloor (p.m_y * invCellSize));
+			const dgInt32 z0 = dgInt32 (dgFloor (p.m_z * invCellSize));
 
-void dgCollisionIncompressibleParticles::CalculateAcceleration(dgFloat32 timestep)
+			dgInt32 neighbors = 0;
+			dgInt32 visitedCount = 0;
+			dgInt32 visited[27];
+			dgInt32* const neighborsList = &neighborsArray[j * DG_FLUID_MAX_NEIGHBORS];
+			for (dgInt32 z = z0 - 1; z <= z0 + 1; z ++) {
+				for (dgInt32 y = y0 - 1; y <= y0 + 1; y ++) {
+					for (dgInt32 x = x0 - 1; x <= x0 + 1; x ++) {
+						// different cells can hash to the same key, each key is only scanned once
+						const dgInt32 key = GetCellKey(x, y, z);
+						bool duplicate = false;
+						for (dgInt32 k = 0; k < visitedCount; k ++) {
+							duplicate = duplicate || (visited[k] == key);
+						}
+						if (!duplicate) {
+							visited[visitedCount] = key;
+							visitedCount ++;
+							const dgInt32 last = cellStart[key + 1];
+							for (dgInt32 k = cellStart[key]; (k < last) && (neighbors < DG_FLUID_MAX_NEIGHBORS); k ++) {
+								const dgInt32 index = sortedParticles[k];
+								const dgVector dist(p - predicted[index]);
+								if ((index != j) && (dist.DotProduct(dist).GetScalar() < h2)) {
+									neighborsList[neighbors] = index;
+									neighbors ++;
+								}
+							}
+						}
+					}
+				}
+			}
+
+			// pad the list to a multiple of four, the padding lanes are masked out by the solver
+			neighborsCount[j] = neighbors;
+			for (; neighbors & 3; neighbors ++) {
+				neighborsList[neighbors] = j;
+			}
+		}
+	}
+}
+
+void dgCollisionIncompressibleParticles::CalculateLambdas (dgFluidSyncDescriptor* const descriptor, dgInt32 threadID)
 {
-	dgAssert(0);
+	const dgFloat32 h = m_kernelRadius;
+	const dgFloat32 h2 = h * h;
+	const dgFloat32 poly6 = dgFloat32 (315.0f) / (dgFloat32 (64.0f) * dgPi * h2 * h2 * h2 * h2 * h);
+	const dgFloat32 spikyGrad = dgFloat32 (45.0f) / (dgPi * h2 * h2 * h2);
+	const dgFloat32 invRestDensity = dgFloat32 (1.0f) / m_restDensity;
+	const dgFloat32 gradScale = spikyGrad * invRestDensity;
+	const dgFloat32 relaxation = DG_FLUID_RELAXATION / h2;
+
+	const dgVector hV(h);
+	const dgVector h2V(h2);
+	const dgVector tiny(h2 * dgFloat32 (1.0e-6f));
+	const dgVector lanes(dgFloat32 (0.0f), dgFloat32 (1.0f), dgFloat32 (2.0f), dgFloat32 (3.0f));
+
+	const dgFloat32* const mass = &m_mass[0];
+	const dgVector* const predicted = m_predicted;
+	const dgInt32* const neighborsArray = &m_neighbors[0];
+	const dgInt32* const neighborsCount = &m_neighborsCount[0];
+	dgFloat32* const lambda = m_lambda;
+
+	const dgInt32 count = m_particlesCount;
+	dgInt32* const atomicIndex = &descriptor->m_atomicIndex;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(atomicIndex, DG_FLUID_PARTICLES_CHUNK_SIZE); i < count; i = dgAtomicExchangeAndAdd(atomicIndex, DG_FLUID_PARTICLES_CHUNK_SIZE)) {
+		const dgInt32 end = dgMin (i + DG_FLUID_PARTICLES_CHUNK_SIZE, count);
+		for (dgInt32 j = i; j < end; j ++) {
+			const dgVector p(predicted[j]);
+			const dgInt32 neighbors = neighborsCount[j];
+			const dgInt32* const neighborsList = &neighborsArray[j * DG_FLUID_MAX_NEIGHBORS];
+
+			// four neighbors at a time, one per lane
+			dgVector density(dgVector::m_zero);
+			dgVector gradX(dgVector::m_zero);
+			dgVector gradY(dgVector::m_zero);
+			dgVector gradZ(dgVector::m_zero);
+			dgVector grad2(dgVector::m_zero);
+			for (dgInt32 k = 0; k < neighbors; k += 4) {
+				const dgInt32 i0 = neighborsList[k + 0];
+				const dgInt32 i1 = neighborsList[k + 1];
+				const dgInt32 i2 = neighborsList[k + 2];
+				const dgInt32 i3 = neighborsList[k + 3];
+				dgVector dx;
+				dgVector dy;
+				dgVector dz;
+				dgVector dw;
+				dgVector::Transpose4x4(dx, dy, dz, dw, p - predicted[i0], p - predicted[i1], p - predicted[i2], p - predicted[i3]);
+				const dgVector massV(mass[i0], mass[i1], mass[i2], mass[i3]);
+
+				const dgVector r2(dx * dx + dy * dy + dz * dz);
+				const dgVector inside((r2 < h2V) & (lanes < dgVector (dgFloat32 (neighbors - k))));
+				const dgVector w(h2V - r2);
+				const dgVector r((r2 + tiny).Sqrt());
+				const dgVector hr(hV - r);
+				const dgVector coef((hr * hr * massV * r.Reciproc()) & inside);
+
+				density += (w * w * w * massV) & inside;
+				gradX += dx * coef;
+				gradY += dy * coef;
+				gradZ += dz * coef;
+				grad2 += coef * coef * r2;
+			}
+
+			const dgVector grad(gradX.AddHorizontal().GetScalar(), gradY.AddHorizontal().GetScalar(), gradZ.AddHorizontal().GetScalar(), dgFloat32 (0.0f));
+			const dgFloat32 rho = poly6 * (density.AddHorizontal().GetScalar() + mass[j] * h2 * h2 * h2);
+
+			// only compression is corrected, particles at the free surface are not pulled together
+			const dgFloat32 constraint = dgMax (rho * invRestDensity - dgFloat32 (1.0f), dgFloat32 (0.0f));
+			const dgFloat32 gradSum2 = gradScale * gradScale * (grad.DotProduct(grad).GetScalar() + grad2.AddHorizontal().GetScalar());
+			lambda[j] = -constraint / (gradSum2 + relaxation);
+		}
+	}
+}
+
+void dgCollisionIncompressibleParticles::CalculateDeltaPositions (dgFluidSyncDescriptor* const descriptor, dgInt32 threadID)
+{
+	const dgFloat32 h = m_kernelRadius;
+	const dgFloat32 h2 = h * h;
+	const dgFloat32 spikyGrad = dgFloat32 (45.0f) / (dgPi * h2 * h2 * h2);
+	const dgFloat32 gradScale = spikyGrad / m_restDensity;
+
+	const dgVector hV(h);
+	const dgVector h2V(h2);
+	const dgVector tiny(h2 * dgFloat32 (1.0e-6f));
+	const dgVector lanes(dgFloat32 (0.0f), dgFloat32 (1.0f), dgFloat32 (2.0f), dgFloat32 (3.0f));
+
+	const dgFloat32* const mass = &m_mass[0];
+	const dgVector* const posit = &m_posit[0];
+	const dgFloat32* const lambda = m_lambda;
+	const dgVector* const predicted = m_predicted;
+	const dgVector* const normalDir = m_normalDir;
+	const dgInt32* const neighborsArray = &m_neighbors[0];
+	const dgInt32* const neighborsCount = &m_neighborsCount[0];
+	dgVector* const delta = m_delta;
+
+	const dgInt32 count = m_particlesCount;
+	dgInt32* const atomicIndex = &descriptor->m_atomicIndex;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(atomicIndex, DG_FLUID_PARTICLES_CHUNK_SIZE); i < count; i = dgAtomicExchangeAndAdd(atomicIndex, DG_FLUID_PARTICLES_CHUNK_SIZE)) {
+		const dgInt32 end = dgMin (i + DG_FLUID_PARTICLES_CHUNK_SIZE, count);
+		for (dgInt32 j = i; j < end; j ++) {
+			const dgVector p(predicted[j]);
+			const dgVector lambda0(lambda[j]);
+			const dgInt32 neighbors = neighborsCount[j];
+			const dgInt32* const neighborsList = &neighborsArray[j * DG_FLUID_MAX_NEIGHBORS];
+
+			dgVector sumX(dgVector::m_zero);
+			dgVector sumY(dgVector::m_zero);
+			dgVector sumZ(dgVector::m_zero);
+			for (dgInt32 k = 0; k < neighbors; k += 4) {
+				const dgInt32 i0 = neighborsList[k + 0];
+				const dgInt32 i1 = neighborsList[k + 1];
+				const dgInt32 i2 = neighborsList[k + 2];
+				const dgInt32 i3 = neighborsList[k + 3];
+				dgVector dx;
+				dgVector dy;
+				dgVector dz;
+				dgVector dw;
+				dgVector::Transpose4x4(dx, dy, dz, dw, p - predicted[i0], p - predicted[i1], p - predicted[i2], p - predicted[i3]);
+				const dgVector massV(mass[i0], mass[i1], mass[i2], mass[i3]);
+				const dgVector lambda1(lambda[i0], lambda[i1], lambda[i2], lambda[i3]);
+
+				const dgVector r2(dx * dx + dy * dy + dz * dz);
+				const dgVector inside((r2 < h2V) & (lanes < dgVector (dgFloat32 (neighbors - k))));
+				const dgVector r((r2 + tiny).Sqrt());
+				const dgVector hr(hV - r);
+				const dgVector coef((hr * hr * massV * r.Reciproc() * (lambda0 + lambda1)) & inside);
+
+				sumX += dx * coef;
+				sumY += dy * coef;
+				sumZ += dz * coef;
+			}
+			dgVector step(dgVector (sumX.AddHorizontal().GetScalar(), sumY.AddHorizontal().GetScalar(), sumZ.AddHorizontal().GetScalar(), dgFloat32 (0.0f)).Scale(-gradScale));
+
+			// do not let the density correction push the particle into a body it is touching
+			const dgVector normal(normalDir[j] & dgVector::m_triplexMask);
+			if (normal.DotProduct(normal).GetScalar() > dgFloat32 (0.0f)) {
+				const dgFloat32 minDisplacement = -normalDir[j].m_w;
+				const dgFloat32 displacement = normal.DotProduct(p + step - posit[j]).GetScalar();
+				if (displacement < minDisplacement) {
+					step += normal.Scale(minDisplacement - displacement);
+				}
+			}
+			delta[j] = step;
+		}
+	}
+}
+
+void dgCollisionIncompressibleParticles::ApplyDeltaPositions (dgFluidSyncDescriptor* const descriptor, dgInt32 threadID)
+{
+	const dgVector* const delta = m_delta;
+	dgVector* const predicted = m_predicted;
+
+	const dgInt32 count = m_particlesCount;
+	dgInt32* const atomicIndex = &descriptor->m_atomicIndex;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(atomicIndex, DG_FLUID_PARTICLES_CHUNK_SIZE); i < count; i = dgAtomicExchangeAndAdd(atomicIndex, DG_FLUID_PARTICLES_CHUNK_SIZE)) {
+		const dgInt32 end = dgMin (i + DG_FLUID_PARTICLES_CHUNK_SIZE, count);
+		for (dgInt32 j = i; j < end; j ++) {
+			predicted[j] += delta[j];
+		}
+	}
+}
+
+void dgCollisionIncompressibleParticles::UpdateVelocities (dgFluidSyncDescriptor* const descriptor, dgInt32 threadID)
+{
+	const dgVector invTimestep(dgFloat32 (1.0f) / descriptor->m_timestep);
+	const dgVector* const predicted = m_predicted;
+	dgVector* const posit = &m_posit[0];
+	dgVector* const veloc = &m_veloc[0];
+	dgVector* const accel = &m_accel[0];
+
+	const dgInt32 count = m_particlesCount;
+	dgInt32* const atomicIndex = &descriptor->m_atomicIndex;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(atomicIndex, DG_FLUID_PARTICLES_CHUNK_SIZE); i < count; i = dgAtomicExchangeAndAdd(atomicIndex, DG_FLUID_PARTICLES_CHUNK_SIZE)) {
+		const dgInt32 end = dgMin (i + DG_FLUID_PARTICLES_CHUNK_SIZE, count);
+		for (dgInt32 j = i; j < end; j ++) {
+			const dgVector veloc1((predicted[j] - posit[j]) * invTimestep);
+			accel[j] = (veloc1 - veloc[j]) * invTimestep;
+			veloc[j] = veloc1;
+			posit[j] = predicted[j];
+		}
+	}
+}
+
+void dgCollisionIncompressibleParticles::CalculateViscosity (dgFluidSyncDescriptor* const descriptor, dgInt32 threadID)
+{
+	// XSPH viscosity, blend each particle velocity with the velocity of its neighbors
+	const dgFloat32 h = m_kernelRadius;
+	const dgFloat32 h2 = h * h;
+	const dgFloat32 poly6 = dgFloat32 (315.0f) / (dgFloat32 (64.0f) * dgPi * h2 * h2 * h2 * h2 * h);
+	const dgFloat32 scale = m_viscosity * poly6 / m_restDensity;
+
+	const dgVector h2V(h2);
+	const dgVector lanes(dgFloat32 (0.0f), dgFloat32 (1.0f), dgFloat32 (2.0f), dgFloat32 (3.0f));
+
+	const dgFloat32* const mass = &m_mass[0];
+	const dgVector* const posit = &m_posit[0];
+	const dgVector* const veloc = &m_veloc[0];
+	const dgInt32* const neighborsArray = &m_neighbors[0];
+	const dgInt32* const neighborsCount = &m_neighborsCount[0];
+	dgVector* const delta = m_delta;
+
+	const dgInt32 count = m_particlesCount;
+	dgInt32* const atomicIndex = &descriptor->m_atomicIndex;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(atomicIndex, DG_FLUID_PARTICLES_CHUNK_SIZE); i < count; i = dgAtomicExchangeAndAdd(atomicIndex, DG_FLUID_PARTICLES_CHUNK_SIZE)) {
+		const dgInt32 end = dgMin (i + DG_FLUID_PARTICLES_CHUNK_SIZE, count);
+		for (dgInt32 j = i; j < end; j ++) {
+			const dgVector p(posit[j]);
+			const dgVector v(veloc[j]);
+			const dgInt32 neighbors = neighborsCount[j];
+			const dgInt32* const neighborsList = &neighborsArray[j * DG_FLUID_MAX_NEIGHBORS];
+
+			dgVector sumX(dgVector::m_zero);
+			dgVector sumY(dgVector::m_zero);
+			dgVector sumZ(dgVector::m_zero);
+			for (dgInt32 k = 0; k < neighbors; k += 4) {
+				const dgInt32 i0 = neighborsList[k + 0];
+				const dgInt32 i1 = neighborsList[k + 1];
+				const dgInt32 i2 = neighborsList[k + 2];
+				const dgInt32 i3 = neighborsList[k + 3];
+				dgVector dx;
+				dgVector dy;
+				dgVector dz;
+				dgVector dw;
+				dgVector vx;
+				dgVector vy;
+				dgVector vz;
+				dgVector vw;
+				dgVector::Transpose4x4(dx, dy, dz, dw, p - posit[i0], p - posit[i1], p - posit[i2], p - posit[i3]);
+				dgVector::Transpose4x4(vx, vy, vz, vw, veloc[i0] - v, veloc[i1] - v, veloc[i2] - v, veloc[i3] - v);
+				const dgVector massV(mass[i0], mass[i1], mass[i2], mass[i3]);
+
+				const dgVector r2(dx * dx + dy * dy + dz * dz);
+				const dgVector inside((r2 < h2V) & (lanes < dgVector (dgFloat32 (neighbors - k))));
+				const dgVector w(h2V - r2);
+				const dgVector weight((w * w * w * massV) & inside);
+
+				sumX += vx * weight;
+				sumY += vy * weight;
+				sumZ += vz * weight;
+			}
+			delta[j] = dgVector (sumX.AddHorizontal().GetScalar(), sumY.AddHorizontal().GetScalar(), sumZ.AddHorizontal().GetScalar(), dgFloat32 (0.0f)).Scale(scale);
+		}
+	}
+}
+
+void dgCollisionIncompressibleParticles::ApplyViscosity (dgFluidSyncDescriptor* const descriptor, dgInt32 threadID)
+{
+	const dgVector* const delta = m_delta;
+	dgVector* const veloc = &m_veloc[0];
+
+	const dgInt32 count = m_particlesCount;
+	dgInt32* const atomicIndex = &descriptor->m_atomicIndex;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(atomicIndex, DG_FLUID_PARTICLES_CHUNK_SIZE); i < count; i = dgAtomicExchangeAndAdd(atomicIndex, DG_FLUID_PARTICLES_CHUNK_SIZE)) {
+		const dgInt32 end = dgMin (i + DG_FLUID_PARTICLES_CHUNK_SIZE, count);
+		for (dgInt32 j = i; j < end; j ++) {
+			veloc[j] += delta[j];
+		}
+	}
 }
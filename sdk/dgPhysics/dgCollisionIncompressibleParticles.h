@@ -32,16 +32,87 @@ class dgCollisionIncompressibleParticles: public dgCollisionLumpedMassParticles
 {
 	public:
 	dgCollisionIncompressibleParticles (const dgCollisionIncompressibleParticles& source);
-	dgCollisionIncompressibleParticles (dgWorld* const world, dgMeshEffect* const mesh);
+	dgCollisionIncompressibleParticles (dgWorld* const world, dgInt32 shapeID, dgInt32 pointCount, const dgFloat32* const points, dgInt32 strideInBytes, dgFloat32 particleRadius, dgFloat32 restDensity, dgFloat32 viscosity);
 	dgCollisionIncompressibleParticles (dgWorld* const world, dgDeserialize deserialization, void* const userData, dgInt32 revisionNumber);
 
 	virtual ~dgCollisionIncompressibleParticles(void);
-	virtual void CalculateAcceleration(dgFloat32 timestep);
-};
+	virtual void IntegrateForces (dgFloat32 timestep);
+
+	protected:
+	class dgFluidSyncDescriptor
+	{
+		public:
+		dgFluidSyncDescriptor(dgCollisionIncompressibleParticles* const fluid, dgFloat32 timestep)
+			:m_fluid(fluid)
+			,m_timestep(timestep)
+			,m_atomicIndex(0)
+		{
+		}
+
+		dgCollisionIncompressibleParticles* m_fluid;
+		dgFloat32 m_timestep;
+		dgInt32 m_atomicIndex;
+	};
+
+	virtual void Serialize(dgSerialize callback, void* const userData) const;
+	virtual void RegisterCollision(const dgBody* const otherBody);
+	virtual void HandleCollision (dgFloat32 timestep, dgVector* const normalDir, dgVector* const normalAccel, dgFloat32* const frictionCoefficient);
+	virtual dgInt32 GetMemoryBufferSizeInBytes() const;
+
+	void AllocateSpatialHash ();
+	void DispatchKernel (dgWorkerThreadTaskCallback kernel, dgFluidSyncDescriptor* const descriptor, const char* const name);
+	void SortParticlesGrid ();
+	void UpdateBodyState (dgFloat32 timestep);
 
+	void CalculateCollisions (dgFluidSyncDescriptor* const descriptor, dgInt32 threadID);
+	void PredictPositions (dgFluidSyncDescriptor* const descriptor, dgInt32 threadID);
+	void FindNeighbors (dgFluidSyncDescriptor* const descriptor, dgInt32 threadID);
+	void CalculateLambdas (dgFluidSyncDescriptor* const descriptor, dgInt32 threadID);
+	void CalculateDeltaPositions (dgFluidSyncDescriptor* const descriptor, dgInt32 threadID);
+	void ApplyDeltaPositions (dgFluidSyncDescriptor* const descriptor, dgInt32 threadID);
+	void UpdateVelocities (dgFluidSyncDescriptor* const descriptor, dgInt32 threadID);
+	void CalculateViscosity (dgFluidSyncDescriptor* const descriptor, dgInt32 threadID);
+	void ApplyViscosity (dgFluidSyncDescriptor* const descriptor, dgInt32 threadID);
 
+	static void CalculateCollisionsKernel (void* const context, void* const worldContext, dgInt32 threadID);
+	static void PredictPositionsKernel (void* const context, void* const worldContext, dgInt32 threadID);
+	static void FindNeighborsKernel (void* const context, void* const worldContext, dgInt32 threadID);
+	static void CalculateLambdasKernel (void* const context, void* const worldContext, dgInt32 threadID);
+	static void CalculateDeltaPositionsKernel (void* const context, void* const worldContext, dgInt32 threadID);
+	static void ApplyDeltaPositionsKernel (void* const context, void* const worldContext, dgInt32 threadID);
+	static void UpdateVelocitiesKernel (void* const context, void* const worldContext, dgInt32 threadID);
+	static void CalculateViscosityKernel (void* const context, void* const worldContext, dgInt32 threadID);
+	static void ApplyViscosityKernel (void* const context, void* const worldContext, dgInt32 threadID);
 
+	DG_INLINE dgInt32 GetCellKey (dgInt32 x, dgInt32 y, dgInt32 z) const;
 
+	// per step scratch buffers, carved from the world solver memory
+	dgVector* m_normalDir;
+	dgVector* m_normalAccel;
+	dgVector* m_predicted;
+	dgVector* m_delta;
+	dgFloat32* m_lambda;
+	dgFloat32* m_friction;
+
+	// uniform grid spatial hash over the predicted positions
+	dgArray<dgInt32> m_cellKey;
+	dgArray<dgInt32> m_cellStart;
+	dgArray<dgInt32> m_sortedParticles;
+	dgArray<dgInt32> m_neighbors;
+	dgArray<dgInt32> m_neighborsCount;
+
+	// rigid bodies overlapping the fluid this step, and the per thread impulses applied to them
+	dgArray<dgBody*> m_colliders;
+	dgArray<dgVector> m_reactions;
+
+	dgFloat32 m_restDensity;
+	dgFloat32 m_viscosity;
+	dgFloat32 m_kernelRadius;
+	dgInt32 m_cellKeyMask;
+	dgInt32 m_collidersCount;
+	dgInt32 m_collidersLock;
+	dgInt32 m_threadsCount;
+};
 
 #endif 
 
@@ -39,6 +39,7 @@
 #include "dgCollisionCompoundFractured.h"
 #include "dgCollisionDeformableSolidMesh.h"
 #include "dgCollisionMassSpringDamperSystem.h"
+#include "dgCollisionIncompressibleParticles.h"
 
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
@@ -283,6 +284,18 @@ dgCollisionInstance::dgCollisionInstance(const dgWorld* const constWorld, dgDese
 					break;
 				}
 
+				case m_deformableSolidMesh:
+				{
+					dgInt32 rtti;
+					serialize (userData, &rtti, sizeof (rtti));
+					if (rtti == dgCollision::dgCollisionIncompressibleParticles_RTTI) {
+						collision = new (allocator) dgCollisionIncompressibleParticles (world, serialize, userData, revisionNumber);
+					} else {
+						dgAssert (0);
+					}
+					break;
+				}
+
 //				case m_deformableMesh:
 //				{
 //					dgAssert (0);
@@ -80,7 +80,19 @@ dgCollisionLumpedMassParticles::dgCollisionLumpedMassParticles (dgWorld* const w
 	,m_particlesCount(0)
 {
 	m_rtti |= dgCollisionLumpedMass_RTTI;
-	dgAssert (0);
+	deserialization(userData, &m_particleRadius, sizeof (m_particleRadius));
+	deserialization(userData, &m_totalMass, sizeof (m_totalMass));
+	deserialization(userData, &m_particlesCount, sizeof (m_particlesCount));
+	dgAssert (m_particlesCount >= 0);
+	if (m_particlesCount > 0) {
+		m_posit.Resize(m_particlesCount);
+		m_mass.Resize(m_particlesCount);
+		m_invMass.Resize(m_particlesCount);
+		deserialization(userData, &m_posit[0], m_particlesCount * sizeof (dgVector));
+		deserialization(userData, &m_mass[0], m_particlesCount * sizeof (dgFloat32));
+		deserialization(userData, &m_invMass[0], m_particlesCount * sizeof (dgFloat32));
+		FinalizeBuild();
+	}
 }
 
 dgCollisionLumpedMassParticles::~dgCollisionLumpedMassParticles(void)
@@ -208,6 +220,19 @@ void dgCollisionLumpedMassParticles::Serialize(dgSerialize callback, void* const
 	dgAssert (0);
 }
 
+void dgCollisionLumpedMassParticles::SerializeLow(dgSerialize callback, void* const userData) const
+{
+	dgCollisionConvex::SerializeLow(callback, userData);
+	callback(userData, &m_particleRadius, sizeof (m_particleRadius));
+	callback(userData, &m_totalMass, sizeof (m_totalMass));
+	callback(userData, &m_particlesCount, sizeof (m_particlesCount));
+	if (m_particlesCount > 0) {
+		callback(userData, &m_posit[0], m_particlesCount * sizeof (dgVector));
+		callback(userData, &m_mass[0], m_particlesCount * sizeof (dgFloat32));
+		callback(userData, &m_invMass[0], m_particlesCount * sizeof (dgFloat32));
+	}
+}
+
 void dgCollisionLumpedMassParticles::RegisterCollision(const dgBody* const otherBody)
 {
 //	dgAssert (0);
@@ -52,6 +52,7 @@ class dgCollisionLumpedMassParticles: public dgCollisionConvex
 	virtual void RegisterCollision(const dgBody* const otherBody);
 	virtual void SetCollisionBBox(const dgVector& p0, const dgVector& p1);
 	virtual void Serialize(dgSerialize callback, void* const userData) const;
+	virtual void SerializeLow(dgSerialize callback, void* const userData) const;
 	virtual void CalcAABB(const dgMatrix& matrix, dgVector& p0, dgVector& p1) const;
 	virtual dgMatrix CalculateInertiaAndCenterOfMass(const dgMatrix& m_alignMatrix, const dgVector& localScale, const dgMatrix& matrix) const;
 
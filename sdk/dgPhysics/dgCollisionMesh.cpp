@@ -196,6 +196,14 @@ dgCollisionMesh::dgCollisionMesh(dgWorld* const world, dgCollisionID type)
 	SetCollisionBBox (dgVector (dgFloat32 (0.0f)), dgVector (dgFloat32 (0.0f)));
 }
 
+dgCollisionMesh::dgCollisionMesh (dgWorld* const world, const dgImageHeader* const header)
+	:dgCollision(world->GetAllocator(), header->m_signature, dgCollisionID (header->m_collisionId))
+{
+	m_rtti |= dgCollisionMesh_RTTI;
+	m_debugCallback = NULL;
+	SetCollisionBBox (dgVector (dgFloat32 (0.0f)), dgVector (dgFloat32 (0.0f)));
+}
+
 dgCollisionMesh::dgCollisionMesh (dgWorld* const world, dgDeserialize deserialization, void* const userData, dgInt32 revisionNumber)
 	:dgCollision(world, deserialization, userData, revisionNumber)
 {
@@ -293,6 +301,35 @@ void dgCollisionMesh::Serialize(dgSerialize callback, void* const userData) cons
 	dgAssert (0);
 }
 
+void dgCollisionMesh::SerializeImageHeader (dgSerialize callback, void* const userData) const
+{
+	dgImageHeader header;
+	memset (&header, 0, sizeof (header));
+	header.m_magic = DG_COLLISION_IMAGE_MAGIC;
+	header.m_version = DG_COLLISION_IMAGE_VERSION;
+	header.m_floatSize = sizeof (dgFloat32);
+	header.m_collisionId = m_collisionId;
+	header.m_sizeInBytes = GetImageSize();
+	header.m_signature = m_signature;
+	callback (userData, &header, sizeof (header));
+}
+
+const dgCollisionMesh::dgImageHeader* dgCollisionMesh::GetImageHeader (const void* const image, dgInt32 sizeInBytes)
+{
+	// the sections of the image are aligned relative to the header, so the header itself must be aligned
+	if (!image || (size_t (image) & 15) || (sizeInBytes < dgInt32 (sizeof (dgImageHeader)))) {
+		return NULL;
+	}
+	const dgImageHeader* const header = (const dgImageHeader*) image;
+	if ((header->m_magic != DG_COLLISION_IMAGE_MAGIC) || (header->m_version != DG_COLLISION_IMAGE_VERSION)) {
+		return NULL;
+	}
+	if ((header->m_floatSize != sizeof (dgFloat32)) || (header->m_sizeInBytes > sizeInBytes)) {
+		return NULL;
+	}
+	return header;
+}
+
 dgVector dgCollisionMesh::SupportVertex (const dgVector& dir, dgInt32* const vertexIndex) const
 {
 	dgAssert (0);
@@ -30,6 +30,8 @@
 
 #define DG_MAX_COLLIDING_FACES			512
 #define DG_MAX_COLLIDING_INDICES		(DG_MAX_COLLIDING_FACES * (4 * 2 + 3))
+#define DG_COLLISION_IMAGE_MAGIC		0x474d494e
+#define DG_COLLISION_IMAGE_VERSION		1
 
 
 class dgCollisionMesh;
@@ -165,10 +167,30 @@ class dgCollisionMesh: public dgCollision
 	}DG_GCC_VECTOR_ALIGMENT;
 
 
+	// header of the position independent image of a static mesh, the shape data follows the header.
+	// images are used in place, from read only memory that can be shared by many worlds and processes.
+	class dgImageHeader
+	{
+		public:
+		dgUnsigned32 m_magic;
+		dgInt32 m_version;
+		dgInt32 m_floatSize;
+		dgInt32 m_collisionId;
+		dgInt32 m_sizeInBytes;
+		dgUnsigned32 m_signature;
+		dgInt32 m_reserved[2];
+	};
+
 	dgCollisionMesh (dgWorld* const world, dgCollisionID type);
+	dgCollisionMesh (dgWorld* const world, const dgImageHeader* const header);
 	dgCollisionMesh (dgWorld* const world, dgDeserialize deserialization, void* const userData, dgInt32 revisionNumber);
 	virtual ~dgCollisionMesh();
 
+	// meshes without image support return zero
+	virtual dgInt32 GetImageSize () const {return 0;}
+	virtual void SerializeImage (dgSerialize callback, void* const userData) const {dgAssert (0);}
+	static const dgImageHeader* GetImageHeader (const void* const image, dgInt32 sizeInBytes);
+
 	virtual dgFloat32 GetVolume () const;
 	virtual dgFloat32 GetBoxMinRadius () const; 
 	virtual dgFloat32 GetBoxMaxRadius () const;
@@ -181,6 +203,7 @@ class dgCollisionMesh: public dgCollision
 
 	protected:
 	virtual void SetCollisionBBox (const dgVector& p0, const dgVector& p1);
+	void SerializeImageHeader (dgSerialize callback, void* const userData) const;
 
 	private:
 	virtual dgInt32 CalculateSignature () const;
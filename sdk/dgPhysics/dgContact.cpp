@@ -80,6 +80,8 @@ dgContact::dgContact(dgWorld* const world, const dgContactMaterial* const materi
 	,m_isNewContact(1)
 	,m_skeletonIntraCollision(1)
 	,m_skeletonSelftCollision(1)
+	,m_contactUpdated(0)
+	,m_activityChanged(0)
 {
 	dgAssert ((((dgUnsigned64) this) & 15) == 0);
 	m_maxDOF = 0;
@@ -87,7 +89,9 @@ dgContact::dgContact(dgWorld* const world, const dgContactMaterial* const materi
 	m_enableCollision = true;
 	m_constId = m_contactConstraint;
 
-	if (body0->m_invMass.m_w > dgFloat32(0.0f)) {
+	// the pair order must not depend on which body found the other in the broadphase
+	const bool body1IsDynamic = body1->m_invMass.m_w > dgFloat32(0.0f);
+	if ((body0->m_invMass.m_w > dgFloat32(0.0f)) && !(body1IsDynamic && (body1->m_uniqueID < body0->m_uniqueID))) {
 		m_body0 = body0;
 		m_body1 = body1;
 	} else {
@@ -117,6 +121,8 @@ dgContact::dgContact(dgContact* const clone)
 	,m_isNewContact(clone->m_isNewContact)
 	,m_skeletonIntraCollision(clone->m_skeletonIntraCollision)
 	,m_skeletonSelftCollision(clone->m_skeletonSelftCollision)
+	,m_contactUpdated(0)
+	,m_activityChanged(0)
 {
 	dgAssert((((dgUnsigned64) this) & 15) == 0);
 	m_body0 = clone->m_body0;
@@ -248,6 +248,8 @@ class dgContact: public dgConstraint, public dgList<dgContactMaterial>
 	dgUnsigned32 m_isNewContact				: 1;
 	dgUnsigned32 m_skeletonIntraCollision	: 1;
 	dgUnsigned32 m_skeletonSelftCollision	: 1;
+	dgUnsigned32 m_contactUpdated			: 1;
+	dgUnsigned32 m_activityChanged			: 1;
 
     friend class dgBody;
 	friend class dgWorld;
@@ -1328,9 +1328,51 @@ dgInt32 dgContactSolver::CalculateConvexCastContacts()
 }
 
 
+bool dgContactSolver::SeparatedByCachedAxis()
+{
+	// the separating vector of the last query is the first support direction of the closest simplex,
+	// the projection of that support point is a lower bound of the distance between the two shapes.
+	// if the shapes are still apart by more than the skin thickness there is nothing else to calculate,
+	// otherwise the support point is reused as the first vertex of the simplex.
+	const dgVector separatingVector (m_proxy->m_contactJoint->m_separtingVector);
+	SupportVertex (separatingVector, 0);
+	m_vertexIndex = 1;
+
+	// the support points are on the reduced shapes, project them back to the shape surfaces
+	// the same way CalculateClosestPoints does before measuring the gap.
+	const dgMatrix& matrix0 = m_instance0->m_globalMatrix;
+	const dgMatrix& matrix1 = m_instance1->m_globalMatrix;
+	const dgVector point0 (dgVector::m_half * (m_hullSum[0] + m_hullDiff[0]));
+	const dgVector point1 (dgVector::m_half * (m_hullSum[0] - m_hullDiff[0]));
+	const dgVector surfacePoint0 (matrix0.TransformVector(m_instance0->SupportVertexSpecialProjectPoint(matrix0.UntransformVector(point0), matrix0.UnrotateVector(separatingVector))));
+	const dgVector surfacePoint1 (matrix1.TransformVector(m_instance1->SupportVertexSpecialProjectPoint(matrix1.UntransformVector(point1), matrix1.UnrotateVector(separatingVector * dgVector::m_negOne))));
+
+	const dgFloat32 separation = separatingVector.DotProduct(surfacePoint1 - surfacePoint0).GetScalar() - m_proxy->m_skinThickness - DG_PENETRATION_TOL;
+	if (separation <= dgFloat32(1.0e-5f)) {
+		return false;
+	}
+
+	m_normal = separatingVector * dgVector::m_negOne;
+	m_closestPoint0 = surfacePoint0;
+	m_closestPoint1 = surfacePoint1;
+	m_proxy->m_normal = m_normal;
+	m_proxy->m_closestPointBody0 = m_closestPoint0;
+	m_proxy->m_closestPointBody1 = m_closestPoint1;
+	m_proxy->m_contactJoint->m_closestDistance = separation;
+	m_proxy->m_contactJoint->m_separationDistance = separation;
+	return true;
+}
+
 dgInt32 dgContactSolver::CalculateConvexToConvexContacts ()
 {
 	dgInt32 count = 0;
+	if (SeparatedByCachedAxis()) {
+		if (m_proxy->m_intersectionTestOnly) {
+			m_proxy->m_contactJoint->m_isActive = 0;
+		}
+		return count;
+	}
+
 	if (m_proxy->m_intersectionTestOnly) {
 		CalculateClosestPoints();
 		dgFloat32 penetration = m_normal.DotProduct(m_closestPoint1 - m_closestPoint0).GetScalar() - m_proxy->m_skinThickness - DG_PENETRATION_TOL;
@@ -101,6 +101,7 @@ class dgContactSolver: public dgDownHeap<dgMinkFace *, dgFloat32>
 	dgInt32 ConvexPolygonToLineIntersection(const dgVector& normal, dgInt32 count1, dgVector* const shape1, dgInt32 count2, dgVector* const shape2, dgVector* const contactOut, dgVector* const mem) const;
 	dgInt32 CalculateContacts (const dgVector& point0, const dgVector& point1, const dgVector& normal);
 	dgInt32 CalculateClosestSimplex ();
+	bool SeparatedByCachedAxis ();
 	dgInt32 CalculateIntersectingPlane(dgInt32 count);
 
 	dgVector m_normal;
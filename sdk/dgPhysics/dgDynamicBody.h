@@ -119,6 +119,7 @@ class dgDynamicBody : public dgBody
 	friend class dgCollisionDeformableMesh;
 	friend class dgCollisionDeformableSolidMesh;
 	friend class dgCollisionMassSpringDamperSystem;
+	friend class dgCollisionIncompressibleParticles;
 } DG_GCC_VECTOR_ALIGMENT;
 
 
@@ -275,6 +275,14 @@ dgCollisionInstance* dgWorld::CreateMassSpringDamperSystem (dgInt32 shapeID, dgI
 	return instance;
 }
 
+dgCollisionInstance* dgWorld::CreateIncompressibleParticles (dgInt32 shapeID, dgInt32 pointCount, const dgFloat32* const points, dgInt32 strideInBytes, dgFloat32 particleRadius, dgFloat32 restDensity, dgFloat32 viscosity)
+{
+	dgCollision* const collision = new (m_allocator) dgCollisionIncompressibleParticles(this, shapeID, pointCount, points, strideInBytes, particleRadius, restDensity, viscosity);
+	dgCollisionInstance* const instance = CreateInstance(collision, shapeID, dgGetIdentityMatrix());
+	collision->Release();
+	return instance;
+}
+
 dgCollisionInstance* dgWorld::CreateDeformableSolid (dgMeshEffect* const mesh, dgInt32 shapeID)
 {
 	dgAssert (m_allocator == mesh->GetAllocator());
@@ -315,6 +323,18 @@ dgCollisionInstance* dgWorld::CreateHeightField(
 	return instance;
 }
 
+dgCollisionInstance* dgWorld::CreateTiledHeightField(
+	dgInt32 tileCount_x, dgInt32 tileCount_z, dgInt32 tileSize, dgInt32 contructionMode, dgInt32 elevationDataType, 
+	dgFloat32 minElevation, dgFloat32 maxElevation, dgFloat32 verticalScale, dgFloat32 horizontalScale_x, dgFloat32 horizontalScale_z)
+{
+	dgCollision* const collision = new  (m_allocator) dgCollisionHeightField (this, tileCount_x, tileCount_z, tileSize, contructionMode, 
+																			  elevationDataType	? dgCollisionHeightField::m_unsigned16Bit : dgCollisionHeightField::m_float32Bit,	
+																			  minElevation, maxElevation, verticalScale, horizontalScale_x, horizontalScale_z);
+	dgCollisionInstance* const instance = CreateInstance (collision, 0, dgGetIdentityMatrix()); 
+	collision->Release();
+	return instance;
+}
+
 dgCollisionInstance* dgWorld::CreateInstance (const dgCollision* const child, dgInt32 shapeID, const dgMatrix& offsetMatrix)
 {
 	dgAssert (dgAbs (offsetMatrix[0].DotProduct(offsetMatrix[0]).GetScalar() - dgFloat32 (1.0f)) < dgFloat32 (1.0e-5f));
@@ -343,6 +363,63 @@ dgCollisionInstance* dgWorld::CreateCollisionFromSerialization (dgDeserialize de
 	return instance;
 }
 
+dgInt32 dgWorld::SerializeCollisionImage (dgCollisionInstance* const shape, dgSerialize serialization, void* const userData) const
+{
+	// only static meshes have a flat image that can be used in place
+	const dgCollision* const collision = shape->GetChildShape();
+	if (!collision->IsType (dgCollision::dgCollisionMesh_RTTI)) {
+		return 0;
+	}
+	const dgCollisionMesh* const mesh = (dgCollisionMesh*) collision;
+	const dgInt32 size = mesh->GetImageSize();
+	if (size) {
+		mesh->SerializeImage (serialization, userData);
+	}
+	return size;
+}
+
+dgCollisionInstance* dgWorld::CreateCollisionFromImage (const void* const image, dgInt32 sizeInBytes)
+{
+	const dgCollisionMesh::dgImageHeader* const header = dgCollisionMesh::GetImageHeader (image, sizeInBytes);
+	if (!header) {
+		return NULL;
+	}
+
+	bool mapped = false;
+	dgCollision* collision = NULL;
+	switch (header->m_collisionId) 
+	{
+		case m_boundingBoxHierachy:
+		{
+			dgCollisionBVH* const bvh = new  (m_allocator) dgCollisionBVH (this, header);
+			mapped = bvh->IsMapped();
+			collision = bvh;
+			break;
+		}
+
+		case m_heightField:
+		{
+			dgCollisionHeightField* const heightField = new  (m_allocator) dgCollisionHeightField (this, header);
+			mapped = heightField->IsMapped();
+			collision = heightField;
+			break;
+		}
+
+		default:
+			return NULL;
+	}
+
+	if (!mapped) {
+		collision->Release();
+		return NULL;
+	}
+
+	// mapped collisions are not cached
+	dgCollisionInstance* const instance = CreateInstance (collision, 0, dgGetIdentityMatrix()); 
+	collision->Release();
+	return instance;
+}
+
 dgContactMaterial* dgWorld::GetMaterial (dgUnsigned32 bodyGroupId0, dgUnsigned32 bodyGroupId1)	const
 {
 	if (bodyGroupId0 > bodyGroupId1) {
@@ -1965,6 +2042,107 @@ dgInt32 dgWorld::CalculateUserContacts(dgCollisionParamProxy& proxy) const
 }
  
 
+// sphere, capsule and box pairs with unit scale can be resolved by the plugin primitive contact kernel,
+// returns -1 when the kernel does not handle the pair so that the caller falls back to the contact solver.
+dgInt32 dgWorld::CalculatePrimitiveContacts(const dgWorldPlugin* const plugin, dgCollisionParamProxy& proxy) const
+{
+	const dgCollisionInstance* const instances[] = {proxy.m_instance0, proxy.m_instance1};
+
+	dgPluginPrimitivePair pair;
+	dgInt32* const types[] = {&pair.m_type0, &pair.m_type1};
+	dgVector* const sizes[] = {&pair.m_size0, &pair.m_size1};
+	for (dgInt32 i = 0; i < 2; i ++) {
+		const dgCollisionInstance* const instance = instances[i];
+		if (instance->GetScaleType() != dgCollisionInstance::m_unit) {
+			return -1;
+		}
+		// round shapes use the radius less the penetration tolerance, same as the contact solver surface points
+		const dgCollision* const shape = instance->GetChildShape();
+		switch (instance->GetCollisionPrimityType())
+		{
+			case m_sphereCollision:
+			{
+				const dgCollisionSphere* const sphere = (dgCollisionSphere*)shape;
+				*sizes[i] = dgVector (sphere->m_radius - DG_PENETRATION_TOL, dgFloat32 (0.0f), dgFloat32 (0.0f), dgFloat32 (0.0f));
+				break;
+			}
+			case m_capsuleCollision:
+			{
+				const dgCollisionCapsule* const capsule = (dgCollisionCapsule*)shape;
+				if (capsule->m_radio0 != capsule->m_radio1) {
+					return -1;
+				}
+				*sizes[i] = dgVector (capsule->m_radio0 - DG_PENETRATION_TOL, capsule->m_height, dgFloat32 (0.0f), dgFloat32 (0.0f));
+				break;
+			}
+			case m_boxCollision:
+			{
+				// boxes are reduced by the same tolerance as dgCollisionBox::SupportVertexSpecial
+				const dgCollisionBox* const box = (dgCollisionBox*)shape;
+				*sizes[i] = box->m_size[0] - box->m_penetrationTol;
+				break;
+			}
+			default:
+				return -1;
+		}
+		*types[i] = instance->GetCollisionPrimityType();
+	}
+	pair.m_matrix0 = proxy.m_instance0->m_globalMatrix;
+	pair.m_matrix1 = proxy.m_instance1->m_globalMatrix;
+
+	dgPluginPrimitiveContact closestPoints;
+	if (!plugin->CalculatePrimitiveContact(pair, closestPoints)) {
+		return -1;
+	}
+
+	// same conventions as dgContactSolver::CalculateConvexToConvexContacts
+	dgInt32 count = 0;
+	dgContact* const contactJoint = proxy.m_contactJoint;
+	const dgVector& normal = closestPoints.m_normal;
+	dgAssert(normal.m_w == dgFloat32(0.0f));
+	const dgFloat32 penetration = normal.DotProduct(closestPoints.m_point1 - closestPoints.m_point0).GetScalar() - proxy.m_skinThickness - DG_PENETRATION_TOL;
+	if (penetration <= dgFloat32(1.0e-5f)) {
+		contactJoint->m_isActive = 1;
+		if ((proxy.m_instance0->GetCollisionMode() & proxy.m_instance1->GetCollisionMode()) && proxy.m_maxContacts) {
+			count = 1;
+			dgContactPoint* const contactOut = proxy.m_contacts;
+			contactOut[0].m_point = dgVector::m_half * (closestPoints.m_point0 + closestPoints.m_point1);
+			contactOut[0].m_normal = normal * dgVector::m_negOne;
+			contactOut[0].m_penetration = -penetration;
+		}
+	}
+
+	contactJoint->m_separtingVector = normal;
+	contactJoint->m_closestDistance = penetration;
+	contactJoint->m_separationDistance = penetration;
+	proxy.m_normal = normal * dgVector::m_negOne;
+	proxy.m_closestPointBody0 = closestPoints.m_point0;
+	proxy.m_closestPointBody1 = closestPoints.m_point1;
+
+#ifdef _DEBUG
+	// the plugin must agree with the contact solver up to touching pairs, run the solver on a copy of the proxy and restore the joint
+	if (penetration <= dgFloat32(1.0e-5f)) {
+		dgContactPoint checkContacts[DG_MAX_CONTATCS];
+		dgCollisionParamProxy checkProxy(proxy);
+		checkProxy.m_contacts = checkContacts;
+		const dgInt32 isActive = contactJoint->m_isActive;
+		contactJoint->m_closestDistance = dgFloat32(1.0e10f);
+
+		dgContactSolver contactSolver(&checkProxy);
+		const dgInt32 checkCount = contactSolver.CalculateConvexToConvexContacts();
+		dgAssert(((checkCount > 0) == (count > 0)) || (dgAbs(penetration) < dgFloat32(1.0e-3f)));
+		dgAssert(dgAbs(contactJoint->m_closestDistance - penetration) < dgFloat32(1.0e-2f));
+		dgAssert(!checkCount || (checkContacts[0].m_normal.DotProduct(proxy.m_normal).GetScalar() > dgFloat32(0.99f)));
+
+		contactJoint->m_isActive = isActive;
+		contactJoint->m_separtingVector = normal;
+		contactJoint->m_closestDistance = penetration;
+		contactJoint->m_separationDistance = penetration;
+	}
+#endif
+	return count;
+}
+
 dgInt32 dgWorld::CalculateConvexToConvexContacts(dgCollisionParamProxy& proxy) const
 {
 	dgInt32 count = 0;
@@ -2048,11 +2226,21 @@ dgInt32 dgWorld::CalculateConvexToConvexContacts(dgCollisionParamProxy& proxy) c
 			}
 		}
 
-		dgContactSolver contactSolver(&proxy);
-		if (proxy.m_continueCollision) {
-			count = contactSolver.CalculateConvexCastContacts();
-		} else {
-			count = contactSolver.CalculateConvexToConvexContacts();
+		count = -1;
+		if (!(proxy.m_continueCollision || proxy.m_intersectionTestOnly)) {
+			const dgWorldPlugin* const plugin = GetKernelPlugin(dgWorldPlugin::m_primitiveContactKernel);
+			if (plugin) {
+				count = CalculatePrimitiveContacts(plugin, proxy);
+			}
+		}
+
+		if (count < 0) {
+			dgContactSolver contactSolver(&proxy);
+			if (proxy.m_continueCollision) {
+				count = contactSolver.CalculateConvexCastContacts();
+			} else {
+				count = contactSolver.CalculateConvexToConvexContacts();
+			}
 		}
 
 		proxy.m_closestPointBody0 += origin;
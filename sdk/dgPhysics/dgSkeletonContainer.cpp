@@ -379,6 +379,9 @@ dgSkeletonContainer::dgSkeletonContainer(dgWorld* const world, dgDynamicBody* co
 	,m_deltaForce(NULL)
 	,m_massMatrix11(NULL)
 	,m_massMatrix10(NULL)
+	,m_diagDamp(NULL)
+	,m_massMatrix10Index(NULL)
+	,m_massMatrix10Count(NULL)
 	,m_rightHandSide(NULL)
 	,m_leftHandSide(NULL)
 	,m_matrixRowsIndex(NULL)
@@ -653,10 +656,9 @@ void dgSkeletonContainer::InitLoopMassMatrix(const dgJointInfo* const jointInfoA
 	m_massMatrix11 = (dgFloat32*)&m_pairs[m_rowCount];
 	m_massMatrix10 = (dgFloat32*)&m_massMatrix11[m_auxiliaryRowCount * m_auxiliaryRowCount];
 	m_deltaForce = &m_massMatrix10[m_auxiliaryRowCount * primaryCount];
-
-	dgForcePair* const forcePair = dgAlloca(dgForcePair, m_nodeCount);
-	dgForcePair* const accelPair = dgAlloca(dgForcePair, m_nodeCount);
-	dgFloat32* const diagDamp = dgAlloca(dgFloat32, m_auxiliaryRowCount);
+	m_diagDamp = &m_deltaForce[m_auxiliaryRowCount * primaryCount];
+	m_massMatrix10Count = (dgInt16*)&m_diagDamp[m_auxiliaryRowCount];
+	m_massMatrix10Index = &m_massMatrix10Count[m_auxiliaryRowCount];
 
 	dgInt32 primaryIndex = 0;
 	dgInt32 auxiliaryIndex = 0;
@@ -712,13 +714,36 @@ void dgSkeletonContainer::InitLoopMassMatrix(const dgJointInfo* const jointInfoA
 	memset(m_massMatrix10, 0, primaryCount * m_auxiliaryRowCount * sizeof(dgFloat32));
 	memset(m_massMatrix11, 0, m_auxiliaryRowCount * m_auxiliaryRowCount * sizeof(dgFloat32));
 
-	CalculateLoopMassMatrixCoefficients(diagDamp);
+	CalculateLoopMassMatrixCoefficients(m_diagDamp);
+
+	// a loop row only couples with the primary rows of the joints sharing one of its bodies, 
+	// so the coupling block is kept as a sparse index list per row
+	for (dgInt32 i = 0; i < m_auxiliaryRowCount; i++) {
+		const dgFloat32* const matrixRow10 = &m_massMatrix10[i * primaryCount];
+		dgInt16* const indexList = &m_massMatrix10Index[i * primaryCount];
+
+		dgInt32 indexCount = 0;
+		for (dgInt32 k = 0; k < primaryCount; k++) {
+			indexList[indexCount] = dgInt16(k);
+			indexCount += (matrixRow10[k] != dgFloat32(0.0f)) ? 1 : 0;
+		}
+		m_massMatrix10Count[i] = dgInt16(indexCount);
+	}
+}
+
+void dgSkeletonContainer::CalculateLoopDeltaForces(dgInt32 firstRow, dgInt32 rowCount) const
+{
+	dgForcePair* const forcePair = dgAlloca(dgForcePair, m_nodeCount);
+	dgForcePair* const accelPair = dgAlloca(dgForcePair, m_nodeCount);
 
+	const dgInt32 primaryCount = m_rowCount - m_auxiliaryRowCount;
 	const dgSpatialVector zero (dgSpatialVector::m_zero);
 	accelPair[m_nodeCount - 1].m_body = zero;
 	accelPair[m_nodeCount - 1].m_joint = zero;
 
-	for (dgInt32 i = 0; i < m_auxiliaryRowCount; i++) {
+	// each row is an independent solve of the tree, rows can be done in any order 
+	const dgInt32 lastRow = dgMin (firstRow + rowCount, dgInt32 (m_auxiliaryRowCount));
+	for (dgInt32 i = firstRow; i < lastRow; i++) {
 		dgInt32 entry = 0;
 		dgInt32 startjoint = m_nodeCount;
 		const dgFloat32* const matrixRow10 = &m_massMatrix10[i * primaryCount];
@@ -755,25 +780,24 @@ void dgSkeletonContainer::InitLoopMassMatrix(const dgJointInfo* const jointInfoA
 			}
 		}
 	}
+}
 
-	dgInt16* const indexList = dgAlloca(dgInt16, primaryCount);
+void dgSkeletonContainer::FinalizeLoopMassMatrix()
+{
+	const dgInt32 primaryCount = m_rowCount - m_auxiliaryRowCount;
 	for (dgInt32 i = 0; i < m_auxiliaryRowCount; i++) {
 		const dgFloat32* const matrixRow10 = &m_massMatrix10[i * primaryCount];
 		const dgFloat32* const deltaForcePtr = &m_deltaForce[i * primaryCount];
+		const dgInt16* const indexList = &m_massMatrix10Index[i * primaryCount];
+		const dgInt32 indexCount = m_massMatrix10Count[i];
 		dgFloat32* const matrixRow11 = &m_massMatrix11[i * m_auxiliaryRowCount];
 
-		dgInt32 indexCount = 0;
-		for (dgInt32 k = 0; k < primaryCount; k++) {
-			indexList[indexCount] = dgInt16(k);
-			indexCount += (matrixRow10[k] != dgFloat32(0.0f)) ? 1 : 0;
-		}
-
 		dgFloat32 diagonal = matrixRow11[i];
 		for (dgInt32 k = 0; k < indexCount; k++) {
 			dgInt32 index = indexList[k];
 			diagonal += matrixRow10[index] * deltaForcePtr[index];
 		}
-		matrixRow11[i] = dgMax(diagonal, diagDamp[i]);
+		matrixRow11[i] = dgMax(diagonal, m_diagDamp[i]);
 
 		for (dgInt32 j = i + 1; j < m_auxiliaryRowCount; j++) {
 			dgFloat32 offDiagonal = matrixRow11[j];
@@ -794,7 +818,7 @@ void dgSkeletonContainer::InitLoopMassMatrix(const dgJointInfo* const jointInfoA
 //	}
 	if (m_auxiliaryRowCount < 256) {	
 		// the matrix is too big for factorization take you, do no both doing it
-		dgCholeskyApplyRegularizer(m_auxiliaryRowCount, m_massMatrix11, diagDamp);
+		dgCholeskyApplyRegularizer(m_auxiliaryRowCount, m_massMatrix11, m_diagDamp);
 	}
 }
 
@@ -1330,10 +1354,13 @@ void dgSkeletonContainer::SolveAuxiliary(const dgJointInfo* const jointInfoArray
 	}
 
 	for (dgInt32 i = 0; i < m_auxiliaryRowCount; i ++) {
-		dgFloat32* const matrixRow10 = &m_massMatrix10[i * primaryCount];
+		const dgFloat32* const matrixRow10 = &m_massMatrix10[i * primaryCount];
+		const dgInt16* const indexList = &m_massMatrix10Index[i * primaryCount];
+		const dgInt32 indexCount = m_massMatrix10Count[i];
 		dgFloat32 r = dgFloat32(0.0f);
-		for (dgInt32 j = 0; j < primaryCount; j++) {
-			r += matrixRow10[j] * f[j];
+		for (dgInt32 j = 0; j < indexCount; j++) {
+			const dgInt32 index = indexList[j];
+			r += matrixRow10[index] * f[index];
 		}
 		b[i] -= r;
 	}
@@ -1395,6 +1422,9 @@ dgInt8* dgSkeletonContainer::CalculateBufferSizeInBytes (const dgJointInfo* cons
 //	size += sizeof (dgFloat32) * auxiliaryRowCount * auxiliaryRowCount;		// matrixLowerTraingular [auxiliaryRowCount * auxiliaryRowCount]
 	size += sizeof (dgFloat32) * auxiliaryRowCount * (rowCount - auxiliaryRowCount);
 	size += sizeof (dgFloat32) * auxiliaryRowCount * (rowCount - auxiliaryRowCount);
+	size += sizeof (dgFloat32) * auxiliaryRowCount;											// diagDamp[auxiliaryRowCount]
+	size += sizeof (dgInt16) * auxiliaryRowCount;											// matrix10Count[auxiliaryRowCount]
+	size += sizeof (dgInt16) * auxiliaryRowCount * (rowCount - auxiliaryRowCount);			// matrix10Index[auxiliaryRowCount * primaryCount]
 	size = (size + 1024) & -0x10;
 	m_auxiliaryMemoryBuffer.ResizeIfNecessary((size + 1024) & -0x10);
 	return &m_auxiliaryMemoryBuffer[0];
@@ -1404,6 +1434,15 @@ dgInt8* dgSkeletonContainer::CalculateBufferSizeInBytes (const dgJointInfo* cons
 void dgSkeletonContainer::InitMassMatrix(const dgJointInfo* const jointInfoArray, const dgLeftHandSide* const leftHandSide, dgRightHandSide* const rightHandSide)
 {
 	D_TRACKTIME();
+	FactorizeMassMatrix(jointInfoArray, leftHandSide, rightHandSide);
+	if (m_auxiliaryRowCount) {
+		CalculateLoopDeltaForces(0, m_auxiliaryRowCount);
+		FinalizeLoopMassMatrix();
+	}
+}
+
+void dgSkeletonContainer::FactorizeMassMatrix(const dgJointInfo* const jointInfoArray, const dgLeftHandSide* const leftHandSide, dgRightHandSide* const rightHandSide)
+{
 	dgInt32 rowCount = 0;
 	dgInt32 auxiliaryCount = 0;
 	m_leftHandSide = leftHandSide;
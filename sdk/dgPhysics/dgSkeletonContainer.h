@@ -26,6 +26,9 @@
 #include "dgContact.h"
 #include "dgBilateralConstraint.h"
 
+// number of loop rows solved by one worker job when a skeleton is factorized in parallel
+#define DG_SKELETON_LOOP_ROWS_PER_JOB	16
+
 class dgDynamicBody;
 
 class dgSkeletonContainer
@@ -59,9 +62,16 @@ class dgSkeletonContainer
 
 	dgInt32 GetLru() const { return m_lru; }
 	void SetLru(dgInt32 lru) { m_lru = lru; }
+	dgInt32 GetRowCount() const { return m_rowCount; }
+	dgInt32 GetAuxiliaryRowCount() const { return m_auxiliaryRowCount; }
 
 	virtual void CalculateJointForce (dgJointInfo* const jointInfoArray, const dgBodyInfo* const bodyArray, dgJacobian* const internalForces);
 	virtual void InitMassMatrix (const dgJointInfo* const jointInfoArray, const dgLeftHandSide* const matrixRow, dgRightHandSide* const rightHandSide);
+
+	// InitMassMatrix in three steps, so that the loop rows of large skeletons can be spread over worker threads
+	void FactorizeMassMatrix (const dgJointInfo* const jointInfoArray, const dgLeftHandSide* const matrixRow, dgRightHandSide* const rightHandSide);
+	void CalculateLoopDeltaForces (dgInt32 firstRow, dgInt32 rowCount) const;
+	void FinalizeLoopMassMatrix ();
 	
 	private:
 	bool SanityCheck(const dgForcePair* const force, const dgForcePair* const accel) const;
@@ -89,6 +99,9 @@ class dgSkeletonContainer
 	dgFloat32* m_deltaForce;
 	dgFloat32* m_massMatrix11;
 	dgFloat32* m_massMatrix10;
+	dgFloat32* m_diagDamp;
+	dgInt16* m_massMatrix10Index;
+	dgInt16* m_massMatrix10Count;
 	dgRightHandSide* m_rightHandSide;
 	const dgLeftHandSide* m_leftHandSide;
 	dgInt32* m_matrixRowsIndex;
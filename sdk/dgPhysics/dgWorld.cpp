@@ -235,6 +235,7 @@ dgWorld::dgWorld(dgMemoryAllocator* const allocator)
 	,m_solverJacobiansMemory (allocator, 64)
 	,m_solverRightHandSideMemory (allocator, 64)
 	,m_solverForceAccumulatorMemory (allocator, 64)
+	,m_pendingTransforms (allocator, 64)
 //	,m_concurrentUpdate(false)
 {
 	//TestAStart();
@@ -251,6 +252,10 @@ dgWorld::dgWorld(dgMemoryAllocator* const allocator)
 	m_solverRightHandSideMemory.Resize(1024 * 64);
 	m_solverForceAccumulatorMemory.Resize(1024 * 32);
 
+	for (dgInt32 i = 0; i < DG_MAX_THREADS_HIVE_COUNT; i ++) {
+		m_stepAllocators[i] = new dgArenaMemoryAllocator(allocator);
+	}
+
 	m_savetimestep = dgFloat32 (0.0f);
 	m_allocator = allocator;
 
@@ -261,6 +266,19 @@ dgWorld::dgWorld(dgMemoryAllocator* const allocator)
 	m_onDeserializeJointCallback = NULL;	
 
 	m_inUpdate = 0;
+	m_statsLock = 0;
+	m_pendingTransformsCount = 0;
+	m_pendingTransformsIndex = 0;
+	m_pendingTransformsDone = 0;
+	m_pendingPostUpdate = 0;
+	m_pendingTimestep = dgFloat32 (0.0f);
+	m_pipelinedUpdate = false;
+	m_pipelinedStep = false;
+	m_deterministicMode = false;
+	memset (&m_stats, 0, sizeof (m_stats));
+	memset (&m_stepStats, 0, sizeof (m_stepStats));
+	memset (m_threadCounters, 0, sizeof (m_threadCounters));
+	m_substepSolverPasses = 0;
 	m_bodyGroupID = 0;
 	m_lastExecutionTime = 0;
 	
@@ -269,7 +287,7 @@ dgWorld::dgWorld(dgMemoryAllocator* const allocator)
 	m_delayDelateLock = 0;
 	m_clusterLRU = 0;
 
-	m_useParallelSolver = 1;
+	m_useParallelSolver = DG_PARALLEL_SOLVER_JACOBI;
 
 	m_solverIterations = DG_DEFAULT_SOLVER_ITERATION_COUNT;
 	m_dynamicsLru = 0;
@@ -347,6 +365,10 @@ dgWorld::~dgWorld()
 	DestroyBody (m_sentinelBody);
 
 	delete m_broadPhase;
+
+	for (dgInt32 i = 0; i < DG_MAX_THREADS_HIVE_COUNT; i ++) {
+		delete m_stepAllocators[i];
+	}
 }
 
 void dgWorld::DestroyAllBodies()
@@ -355,6 +377,10 @@ void dgWorld::DestroyAllBodies()
 
 	Sync();
 
+	// the bodies are going away, the pending transforms of the last step are dropped
+	m_pendingTransformsCount = 0;
+	m_pendingPostUpdate = 0;
+
 	dgInverseDynamicsList& ikList = *this;
 	for (dgInverseDynamicsList::dgListNode* ptr = ikList.GetFirst(); ptr; ptr = ptr->GetNext()) {
 		delete ptr->GetInfo();
@@ -422,12 +448,13 @@ void dgWorld::SetContactMergeTolerance(dgFloat32 tolerenace)
 
 void dgWorld::EnableParallelSolverOnLargeIsland(dgInt32 mode)
 {
-	m_useParallelSolver = mode ? 1 : 0;
+	// any other non zero mode keeps meaning the default parallel solver
+	m_useParallelSolver = (mode == DG_PARALLEL_SOLVER_GRAPH_COLORING) ? DG_PARALLEL_SOLVER_GRAPH_COLORING : (mode ? DG_PARALLEL_SOLVER_JACOBI : DG_PARALLEL_SOLVER_DISABLED);
 }
 
 dgInt32 dgWorld::GetParallelSolverOnLargeIsland() const
 {
-	return m_useParallelSolver ? 1 : 0;
+	return dgInt32 (m_useParallelSolver);
 }
 
 
@@ -547,6 +574,11 @@ dgKinematicBody* dgWorld::CreateKinematicBody (dgCollisionInstance* const collis
 
 void dgWorld::DestroyBody(dgBody* const body)
 {
+	if (m_pendingTransformsCount && !m_inUpdate) {
+		// the body may have a transform pending from the last pipelined step
+		FlushPendingTransforms();
+	}
+
 	for (dgListenerList::dgListNode* node = m_listeners.GetLast(); node; node = node->GetPrev()) {
 		dgListener& listener = node->GetInfo();
 		if (listener.m_onBodyDestroy) {
@@ -908,9 +940,19 @@ void dgWorld::StepDynamics (dgFloat32 timestep)
 	m_inUpdate ++;
 
 	D_TRACKTIME();
+	dgUnsigned64 time0 = dgGetTimeInMicrosenconds();
 	UpdateSkeletons();
+	dgUnsigned64 time1 = dgGetTimeInMicrosenconds();
+	m_stepStats.m_skeletonsTime += (time1 - time0) * dgFloat32 (1.0e-6f);
+
 	UpdateBroadphase(timestep);
+	time0 = dgGetTimeInMicrosenconds();
+	m_stepStats.m_broadPhaseTime += (time0 - time1) * dgFloat32 (1.0e-6f);
+
+	m_substepSolverPasses = 0;
 	UpdateDynamics (timestep);
+	m_stepStats.m_substeps ++;
+	m_stepStats.m_solverIterations += m_substepSolverPasses;
 
 	if (m_listeners.GetCount()) {
 		for (dgListenerList::dgListNode* node = m_listeners.GetFirst(); node; node = node->GetNext()) {
@@ -921,6 +963,13 @@ void dgWorld::StepDynamics (dgFloat32 timestep)
 		}
 	}
 
+	// if the application issued scene queries during the last frame, 
+	// rebuild the query tree now rather than on the first query of the next frame.
+	if (m_broadPhase->m_queryTreeIsUsed) {
+		m_broadPhase->UpdateQueryTree();
+		m_broadPhase->m_queryTreeIsUsed = 0;
+	}
+
 	m_inUpdate --;
 }
 
@@ -940,27 +989,121 @@ void dgWorld::Execute (dgInt32 threadID)
 	dgMutexThread::Execute (threadID);
 }
 
-void dgWorld::UpdateTransforms(dgBodyMasterList::dgListNode* node, dgInt32 threadID)
+void dgWorld::UpdateTransforms(dgInt32* const atomicIndex, dgInt32 threadID)
+{
+	// scan the packed state flags, only bodies that moved are touched
+	dgBodyMasterList* const masterList = this;
+	dgBody* const* const bodyArray = masterList->GetBodyArray();
+	const dgMatrix* const matrixArray = &masterList->m_bodyMatrix[0];
+	dgUnsigned8* const stateFlags = &masterList->m_bodyStateFlags[0];
+	const dgInt32 bodyCount = masterList->GetBodyArrayCount();
+	for (dgInt32 i = dgAtomicExchangeAndAdd(atomicIndex, DG_BODY_ARRAY_CHUNK_SIZE); i < bodyCount; i = dgAtomicExchangeAndAdd(atomicIndex, DG_BODY_ARRAY_CHUNK_SIZE)) {
+		const dgInt32 count = dgMin (bodyCount - i, DG_BODY_ARRAY_CHUNK_SIZE);
+		for (dgInt32 j = i; j < i + count; j ++) {
+			if (stateFlags[j] & DG_BODY_STATE_TRANSFORM_DIRTY) {
+				dgBody* const body = bodyArray[j];
+				dgAssert (body->m_transformIsDirty);
+				if (body->m_matrixUpdate) {
+					body->m_matrixUpdate (*body, matrixArray[j], threadID);
+				}
+				body->m_transformIsDirty = false;
+				stateFlags[j] &= ~DG_BODY_STATE_TRANSFORM_DIRTY;
+			}
+		}
+	}
+}
+
+void dgWorld::UpdateTransforms(void* const context, void* const atomicIndex, dgInt32 threadID)
 {
-	const dgInt32 threadsCount = GetThreadCount();
-	while (node) {
-		dgBody* const body = node->GetInfo().GetBody();
-		if (body->m_transformIsDirty && body->m_matrixUpdate) {
-			body->m_matrixUpdate (*body, body->m_matrix, threadID);
+	dgWorld* const world = (dgWorld*)context;
+	world->UpdateTransforms((dgInt32*) atomicIndex, threadID);
+}
+
+void dgWorld::CaptureTransforms(dgInt32* const atomicIndex, dgInt32 threadID)
+{
+	dgBodyMasterList* const masterList = this;
+	dgBody* const* const bodyArray = masterList->GetBodyArray();
+	const dgMatrix* const matrixArray = &masterList->m_bodyMatrix[0];
+	dgUnsigned8* const stateFlags = &masterList->m_bodyStateFlags[0];
+	const dgInt32 bodyCount = masterList->GetBodyArrayCount();
+	for (dgInt32 i = dgAtomicExchangeAndAdd(atomicIndex, DG_BODY_ARRAY_CHUNK_SIZE); i < bodyCount; i = dgAtomicExchangeAndAdd(atomicIndex, DG_BODY_ARRAY_CHUNK_SIZE)) {
+		const dgInt32 count = dgMin (bodyCount - i, DG_BODY_ARRAY_CHUNK_SIZE);
+		dgInt32 pendingCount = 0;
+		for (dgInt32 j = i; j < i + count; j ++) {
+			if (stateFlags[j] & DG_BODY_STATE_TRANSFORM_DIRTY) {
+				pendingCount += bodyArray[j]->m_matrixUpdate ? 1 : 0;
+			}
 		}
-		body->m_transformIsDirty = false;
 
-		for (dgInt32 i = 0; i < threadsCount; i++) {
-			node = node ? node->GetNext() : NULL;
+		// reserve the whole chunk at once rather than one entry at the time
+		dgInt32 index = pendingCount ? dgAtomicExchangeAndAdd(&m_pendingTransformsCount, pendingCount) : 0;
+		for (dgInt32 j = i; j < i + count; j ++) {
+			if (stateFlags[j] & DG_BODY_STATE_TRANSFORM_DIRTY) {
+				dgBody* const body = bodyArray[j];
+				dgAssert (body->m_transformIsDirty);
+				if (body->m_matrixUpdate) {
+					dgPendingTransform& entry = m_pendingTransforms[index];
+					entry.m_matrix = matrixArray[j];
+					entry.m_body = body;
+					index ++;
+				}
+				body->m_transformIsDirty = false;
+				stateFlags[j] &= ~DG_BODY_STATE_TRANSFORM_DIRTY;
+			}
 		}
 	}
 }
 
-void dgWorld::UpdateTransforms(void* const context, void* const nodePtr, dgInt32 threadID)
+void dgWorld::CaptureTransforms(void* const context, void* const atomicIndex, dgInt32 threadID)
 {
 	dgWorld* const world = (dgWorld*)context;
-	dgBodyMasterList::dgListNode* node = (dgBodyMasterList::dgListNode*) nodePtr;
-	world->UpdateTransforms(node, threadID);
+	world->CaptureTransforms((dgInt32*) atomicIndex, threadID);
+}
+
+void dgWorld::DispatchPendingTransforms(dgInt32 threadID)
+{
+	const dgInt32 count = m_pendingTransformsCount;
+	dgInt32 dispatched = 0;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&m_pendingTransformsIndex, DG_BODY_ARRAY_CHUNK_SIZE); i < count; i = dgAtomicExchangeAndAdd(&m_pendingTransformsIndex, DG_BODY_ARRAY_CHUNK_SIZE)) {
+		const dgInt32 chunk = dgMin (count - i, DG_BODY_ARRAY_CHUNK_SIZE);
+		for (dgInt32 j = 0; j < chunk; j ++) {
+			dgPendingTransform& entry = m_pendingTransforms[i + j];
+			entry.m_body->m_matrixUpdate (*entry.m_body, entry.m_matrix, threadID);
+		}
+		dispatched += chunk;
+	}
+
+	// the post update still follows the last transform callback, whichever thread issues it
+	if (m_pendingPostUpdate) {
+		const dgInt32 done = dgAtomicExchangeAndAdd(&m_pendingTransformsDone, dispatched) + dispatched;
+		if ((done == count) && dgInterlockedExchange(&m_pendingPostUpdate, 0)) {
+			m_onPostUpdateCallback (this, m_pendingTimestep);
+		}
+	}
+}
+
+void dgWorld::FlushPendingTransforms()
+{
+	if (m_pendingTransformsCount || m_pendingPostUpdate) {
+		DispatchPendingTransforms(0);
+		m_pendingTransformsCount = 0;
+		m_pendingPostUpdate = 0;
+	}
+}
+
+void dgWorld::SetPipelinedUpdate(bool state)
+{
+	Sync();
+	if (!state) {
+		FlushPendingTransforms();
+	}
+	m_pipelinedUpdate = state;
+}
+
+void dgWorld::SetDeterministicMode(bool state)
+{
+	Sync();
+	m_deterministicMode = state;
 }
 
 void dgWorld::RunStep ()
@@ -969,6 +1112,14 @@ void dgWorld::RunStep ()
 	
 	BeginSection();
 	dgUnsigned64 timeAcc = dgGetTimeInMicrosenconds();
+	memset (&m_stepStats, 0, sizeof (m_stepStats));
+	memset (m_threadCounters, 0, sizeof (m_threadCounters));
+	const dgInt32 stolenJobs = GetStolenJobsCount();
+
+	// recycle the transient memory of the previous update, the arenas keep the pages of the peak update.
+	for (dgInt32 i = 0; i < DG_MAX_THREADS_HIVE_COUNT; i ++) {
+		m_stepAllocators[i]->Reset();
+	}
 
 	dgFloat32 step = m_savetimestep / m_numberOfSubsteps;
 	for (dgUnsigned32 i = 0; i < m_numberOfSubsteps; i ++) {
@@ -983,23 +1134,62 @@ void dgWorld::RunStep ()
 		bodyList.DestroyBodies (*this);
 	}
 
-	const dgBodyMasterList* const masterList = this;
-	dgBodyMasterList::dgListNode* node = masterList->GetFirst();
+	dgInt32 atomicIndex = 0;
+	const dgUnsigned64 transformTime = dgGetTimeInMicrosenconds();
+	UpdateBodyArray();
 	const dgInt32 threadsCount = GetThreadCount();
-	for (dgInt32 i = 0; i < threadsCount; i++) {
-		QueueJob(UpdateTransforms, this, node, "dgWorld::UpdateTransforms");
-		node = node ? node->GetNext() : NULL;
-	}
-	SynchronizationBarrier();
+	if (m_pipelinedStep) {
+		// only copy the matrices here, the callbacks are dispatched by the next step
+		dgAssert (m_pendingTransformsIndex >= m_pendingTransformsCount);
+		const dgBodyMasterList* const masterList = this;
+		m_pendingTransforms.ResizeIfNecessary(masterList->GetBodyArrayCount());
+		m_pendingTransformsCount = 0;
+		m_pendingTransformsIndex = 0;
+		m_pendingTransformsDone = 0;
+		for (dgInt32 i = 0; i < threadsCount; i++) {
+			QueueStealableJob(CaptureTransforms, this, &atomicIndex, "dgWorld::CaptureTransforms");
+		}
+		SynchronizationBarrier();
+		m_pendingTimestep = m_savetimestep;
+		m_pendingPostUpdate = m_onPostUpdateCallback ? 1 : 0;
+		m_stepStats.m_transformsTime = (dgGetTimeInMicrosenconds() - transformTime) * dgFloat32 (1.0e-6f);
+	} else {
+		for (dgInt32 i = 0; i < threadsCount; i++) {
+			QueueStealableJob(UpdateTransforms, this, &atomicIndex, "dgWorld::UpdateTransforms");
+		}
+		SynchronizationBarrier();
+		m_stepStats.m_transformsTime = (dgGetTimeInMicrosenconds() - transformTime) * dgFloat32 (1.0e-6f);
 
-	if (m_onPostUpdateCallback) {
-		m_onPostUpdateCallback (this, m_savetimestep);
+		if (m_onPostUpdateCallback) {
+			m_onPostUpdateCallback (this, m_savetimestep);
+		}
 	}
 
 	m_lastExecutionTime = (dgGetTimeInMicrosenconds() - timeAcc) * dgFloat32 (1.0e-6f);
+
+	const dgBodyMasterList& masterList = *this;
+	m_stepStats.m_updateTime = m_lastExecutionTime;
+	m_stepStats.m_threads = threadsCount;
+	m_stepStats.m_bodies = masterList.GetCount() - 1;
+	m_stepStats.m_stolenJobs = GetStolenJobsCount() - stolenJobs;
+	for (dgInt32 i = 0; i < threadsCount; i ++) {
+		m_stepStats.m_pairsTested += m_threadCounters[i].m_pairsTested;
+		m_stepStats.m_narrowPhasePairs += m_threadCounters[i].m_narrowPhasePairs;
+	}
+	dgSpinLock(&m_statsLock);
+	m_stats = m_stepStats;
+	dgSpinUnlock(&m_statsLock);
+
 	EndSection();
 }
 
+void dgWorld::GetStats (dgWorldStats& stats)
+{
+	dgSpinLock(&m_statsLock);
+	stats = m_stats;
+	dgSpinUnlock(&m_statsLock);
+}
+
 void dgWorld::TickCallback(dgInt32 threadID)
 {
 	RunStep();
@@ -1007,7 +1197,9 @@ void dgWorld::TickCallback(dgInt32 threadID)
 
 void dgWorld::Update (dgFloat32 timestep)
 {
+	// a synchronous update has nothing to overlap the transform callbacks with, so it never defers them
 	m_savetimestep = timestep;
+	m_pipelinedStep = false;
 	#ifdef DG_USE_THREAD_EMULATION
 		dgFloatExceptions exception;
 		dgSetPrecisionDouble precision;
@@ -1017,6 +1209,7 @@ void dgWorld::Update (dgFloat32 timestep)
 		// this will run well on single core systems, since the two thread are mutually exclusive 
 		dgMutexThread::Tick();
 	#endif
+	FlushPendingTransforms();
 }
 
 void dgWorld::UpdateAsync (dgFloat32 timestep)
@@ -1025,12 +1218,20 @@ void dgWorld::UpdateAsync (dgFloat32 timestep)
 	#ifdef DG_USE_THREAD_EMULATION
 		Update(timestep);
 	#else
+		dgAsyncThread::Sync();
 		m_savetimestep = timestep;
+		m_pipelinedStep = m_pipelinedUpdate;
 		dgAsyncThread::Tick();
 		//Update(timestep);
 	#endif
 }
 
+void dgWorld::WaitForUpdateToFinish ()
+{
+	dgAsyncThread::Sync();
+	FlushPendingTransforms();
+}
+
 void dgWorld::SetCollisionInstanceConstructorDestructor (OnCollisionInstanceDuplicate constructor, OnCollisionInstanceDestroy destructor)
 {
 	m_onCollisionInstanceDestruction = destructor;
@@ -1243,8 +1444,7 @@ void dgWorld::UpdateSkeletons()
 		dgUnsigned32 lru = m_dynamicsLru;
 
 		dgBodyMasterList& masterList = *this;
-		m_solverJacobiansMemory.ResizeIfNecessary((2 * (masterList.m_constraintCount + 1024)) * sizeof (dgBilateralConstraint*));
-		dgBilateralConstraint** const jointList = (dgBilateralConstraint**)&m_solverJacobiansMemory[0];
+		dgBilateralConstraint** const jointList = GetStepAllocator(0)->AllocArray<dgBilateralConstraint*>(2 * (masterList.m_constraintCount + 1024));
 
 		dgInt32 jointCount = 0;
 		for (dgBodyMasterList::dgListNode* node = masterList.GetFirst(); node; node = node->GetNext()) {
@@ -1613,6 +1813,424 @@ void dgWorld::DeserializeScene(void* const userData, OnBodyDeserialize bodyCallb
 	}
 }
 
+// the state snapshot is a flat buffer with a header followed by the body, joint, contact and contact point records. 
+// records are copied with memcpy so the buffer does not need any particular alignment.
+#define DG_WORLD_STATE_MARKER	0x5453574e
+#define DG_WORLD_STATE_VERSION	1
+
+class dgWorldStateHeader
+{
+	public:
+	dgInt32 m_marker;
+	dgInt32 m_version;
+	dgInt32 m_sizeInBytes;
+	dgInt32 m_bodyCount;
+	dgInt32 m_jointCount;
+	dgInt32 m_contactCount;
+	dgInt32 m_contactPointCount;
+};
+
+DG_MSC_VECTOR_ALIGMENT
+class dgWorldBodyState
+{
+	public:
+	dgMatrix m_matrix;
+	dgMatrix m_invWorldInertiaMatrix;
+	dgQuaternion m_rotation;
+	dgVector m_veloc;
+	dgVector m_omega;
+	dgVector m_accel;
+	dgVector m_alpha;
+	dgVector m_gyroAlpha;
+	dgVector m_gyroTorque;
+	dgQuaternion m_gyroRotation;
+	dgVector m_impulseForce;
+	dgVector m_impulseTorque;
+	dgVector m_externalForce;
+	dgVector m_externalTorque;
+	dgVector m_savedExternalForce;
+	dgVector m_savedExternalTorque;
+	dgVector m_nodeMinBox;
+	dgVector m_nodeMaxBox;
+	dgInt32 m_uniqueID;
+	dgInt32 m_sleepingCounter;
+	dgUnsigned32 m_sleeping		: 1;
+	dgUnsigned32 m_resting		: 1;
+	dgUnsigned32 m_equilibrium	: 1;
+} DG_GCC_VECTOR_ALIGMENT;
+
+class dgWorldJointState
+{
+	public:
+	dgForceImpactPair m_jointForce[DG_BILATERAL_CONTRAINT_DOF];
+	dgFloat32 m_motorAcceleration[DG_BILATERAL_CONTRAINT_DOF];
+	dgInt32 m_body0;
+	dgInt32 m_body1;
+};
+
+DG_MSC_VECTOR_ALIGMENT
+class dgWorldContactState
+{
+	public:
+	dgVector m_positAcc;
+	dgQuaternion m_rotationAcc;
+	dgVector m_separtingVector;
+	dgFloat32 m_closestDistance;
+	dgFloat32 m_separationDistance;
+	dgFloat32 m_timeOfImpact;
+	dgFloat32 m_impulseSpeed;
+	dgInt32 m_body0;
+	dgInt32 m_body1;
+	dgInt32 m_pointCount;
+	dgUnsigned32 m_lruAge;
+	dgUnsigned32 m_maxDOF			: 6;
+	dgUnsigned32 m_isActive			: 1;
+	dgUnsigned32 m_isNewContact		: 1;
+} DG_GCC_VECTOR_ALIGMENT;
+
+dgInt32 dgWorld::GetStateSizeInBytes() const
+{
+	dgInt32 contactPointCount = 0;
+	const dgContactList& contactList = *this;
+	for (dgInt32 i = 0; i < contactList.m_contactCount; i ++) {
+		contactPointCount += contactList[i]->GetCount();
+	}
+
+	const dgBilateralConstraintList& jointList = *this;
+	return dgInt32 (sizeof (dgWorldStateHeader) + 
+					sizeof (dgWorldBodyState) * GetBodiesCount() + 
+					sizeof (dgWorldJointState) * jointList.GetCount() + 
+					sizeof (dgWorldContactState) * contactList.m_contactCount + 
+					sizeof (dgContactMaterial) * contactPointCount);
+}
+
+dgInt32 dgWorld::SaveState(void* const buffer, dgInt32 bufferSizeInBytes)
+{
+	Sync();
+
+	const dgInt32 sizeInBytes = GetStateSizeInBytes();
+	if (sizeInBytes > bufferSizeInBytes) {
+		return 0;
+	}
+
+	dgInt8* ptr = (dgInt8*)buffer + sizeof (dgWorldStateHeader);
+	dgInt32 bodyCount = 0;
+	const dgBodyMasterList& masterList = *this;
+	for (dgBodyMasterList::dgListNode* node = masterList.GetFirst()->GetNext(); node; node = node->GetNext()) {
+		dgBody* const body = node->GetInfo().GetBody();
+		body->m_serializedEnum = bodyCount;
+
+		dgWorldBodyState state;
+		memset (&state, 0, sizeof (state));
+		state.m_matrix = body->m_matrix;
+		state.m_invWorldInertiaMatrix = body->m_invWorldInertiaMatrix;
+		state.m_rotation = body->m_rotation;
+		state.m_veloc = body->m_veloc;
+		state.m_omega = body->m_omega;
+		state.m_accel = body->m_accel;
+		state.m_alpha = body->m_alpha;
+		state.m_gyroAlpha = body->m_gyroAlpha;
+		state.m_gyroTorque = body->m_gyroTorque;
+		state.m_gyroRotation = body->m_gyroRotation;
+		state.m_impulseForce = body->m_impulseForce;
+		state.m_impulseTorque = body->m_impulseTorque;
+		state.m_externalForce = dgVector::m_zero;
+		state.m_externalTorque = dgVector::m_zero;
+		state.m_savedExternalForce = dgVector::m_zero;
+		state.m_savedExternalTorque = dgVector::m_zero;
+		state.m_sleepingCounter = 0;
+		if (body->IsRTTIType(dgBody::m_dynamicBodyRTTI)) {
+			// the saved forces decide if a body is still in equilibrium on the next step
+			const dgDynamicBody* const dynamicBody = (dgDynamicBody*)body;
+			state.m_externalForce = dynamicBody->m_externalForce;
+			state.m_externalTorque = dynamicBody->m_externalTorque;
+			state.m_savedExternalForce = dynamicBody->m_savedExternalForce;
+			state.m_savedExternalTorque = dynamicBody->m_savedExternalTorque;
+			state.m_sleepingCounter = dynamicBody->m_sleepingCounter;
+		}
+		if (body->GetBroadPhase()) {
+			state.m_nodeMinBox = body->GetBroadPhase()->m_minBox;
+			state.m_nodeMaxBox = body->GetBroadPhase()->m_maxBox;
+		}
+		state.m_uniqueID = body->m_uniqueID;
+		state.m_sleeping = body->m_sleeping;
+		state.m_resting = body->m_resting;
+		state.m_equilibrium = body->m_equilibrium;
+		memcpy (ptr, &state, sizeof (state));
+		ptr += sizeof (state);
+		bodyCount ++;
+	}
+
+	const dgBilateralConstraintList& jointList = *this;
+	for (dgBilateralConstraintList::dgListNode* node = jointList.GetFirst(); node; node = node->GetNext()) {
+		const dgBilateralConstraint* const joint = node->GetInfo();
+		dgWorldJointState state;
+		memset (&state, 0, sizeof (state));
+		memcpy (state.m_jointForce, joint->m_jointForce, sizeof (state.m_jointForce));
+		memcpy (state.m_motorAcceleration, joint->m_motorAcceleration, sizeof (state.m_motorAcceleration));
+		state.m_body0 = joint->m_body0->m_serializedEnum;
+		state.m_body1 = joint->m_body1->m_serializedEnum;
+		memcpy (ptr, &state, sizeof (state));
+		ptr += sizeof (state);
+	}
+
+	// contacts are saved in the contact list order, so that a restored world solves them in the same order
+	dgInt32 contactPointCount = 0;
+	const dgUnsigned32 lru = GetBroadPhase()->GetLRU();
+	const dgContactList& contactList = *this;
+	for (dgInt32 i = 0; i < contactList.m_contactCount; i ++) {
+		const dgContact* const contact = contactList[i];
+		dgWorldContactState state;
+		memset (&state, 0, sizeof (state));
+		state.m_positAcc = contact->m_positAcc;
+		state.m_rotationAcc = contact->m_rotationAcc;
+		state.m_separtingVector = contact->m_separtingVector;
+		state.m_closestDistance = contact->m_closestDistance;
+		state.m_separationDistance = contact->m_separationDistance;
+		state.m_timeOfImpact = contact->m_timeOfImpact;
+		state.m_impulseSpeed = contact->m_impulseSpeed;
+		state.m_body0 = contact->m_body0->m_serializedEnum;
+		state.m_body1 = contact->m_body1->m_serializedEnum;
+		state.m_pointCount = contact->GetCount();
+		state.m_lruAge = lru - contact->m_broadphaseLru;
+		state.m_maxDOF = contact->m_maxDOF;
+		state.m_isActive = contact->m_isActive;
+		state.m_isNewContact = contact->m_isNewContact;
+		memcpy (ptr, &state, sizeof (state));
+		ptr += sizeof (state);
+		contactPointCount += state.m_pointCount;
+	}
+
+	for (dgInt32 i = 0; i < contactList.m_contactCount; i ++) {
+		const dgContact* const contact = contactList[i];
+		for (dgContact::dgListNode* node = contact->GetFirst(); node; node = node->GetNext()) {
+			memcpy (ptr, &node->GetInfo(), sizeof (dgContactMaterial));
+			ptr += sizeof (dgContactMaterial);
+		}
+	}
+	dgAssert ((ptr - (dgInt8*)buffer) == sizeInBytes);
+
+	for (dgBodyMasterList::dgListNode* node = masterList.GetFirst()->GetNext(); node; node = node->GetNext()) {
+		node->GetInfo().GetBody()->m_serializedEnum = -1;
+	}
+
+	dgWorldStateHeader header;
+	header.m_marker = DG_WORLD_STATE_MARKER;
+	header.m_version = DG_WORLD_STATE_VERSION;
+	header.m_sizeInBytes = sizeInBytes;
+	header.m_bodyCount = bodyCount;
+	header.m_jointCount = jointList.GetCount();
+	header.m_contactCount = contactList.m_contactCount;
+	header.m_contactPointCount = contactPointCount;
+	memcpy (buffer, &header, sizeof (header));
+	return sizeInBytes;
+}
+
+bool dgWorld::RestoreState(const void* const buffer, dgInt32 bufferSizeInBytes)
+{
+	Sync();
+
+	dgWorldStateHeader header;
+	if (bufferSizeInBytes < dgInt32 (sizeof (header))) {
+		return false;
+	}
+	memcpy (&header, buffer, sizeof (header));
+
+	const dgBodyMasterList& masterList = *this;
+	const dgBilateralConstraintList& jointList = *this;
+	if ((header.m_marker != DG_WORLD_STATE_MARKER) || (header.m_version != DG_WORLD_STATE_VERSION) || (header.m_sizeInBytes > bufferSizeInBytes) || 
+		(header.m_bodyCount != GetBodiesCount()) || (header.m_jointCount != jointList.GetCount()) || (header.m_contactCount < 0) || (header.m_contactPointCount < 0)) {
+		return false;
+	}
+
+	// the record counts must account for exactly the bytes the header claims
+	const dgInt64 expectedSizeInBytes = dgInt64 (sizeof (dgWorldStateHeader)) + 
+										dgInt64 (sizeof (dgWorldBodyState)) * header.m_bodyCount + 
+										dgInt64 (sizeof (dgWorldJointState)) * header.m_jointCount + 
+										dgInt64 (sizeof (dgWorldContactState)) * header.m_contactCount + 
+										dgInt64 (sizeof (dgContactMaterial)) * header.m_contactPointCount;
+	if (expectedSizeInBytes != dgInt64 (header.m_sizeInBytes)) {
+		return false;
+	}
+
+	// the snapshot can only be applied to the same bodies, in the same order, it was taken from
+	const dgInt8* const bodyStates = (dgInt8*)buffer + sizeof (dgWorldStateHeader);
+	dgStack<dgBody*> bodyArrayPool(header.m_bodyCount + 1);
+	dgBody** const bodyArray = &bodyArrayPool[0];
+	dgInt32 bodyCount = 0;
+	for (dgBodyMasterList::dgListNode* node = masterList.GetFirst()->GetNext(); node; node = node->GetNext()) {
+		dgBody* const body = node->GetInfo().GetBody();
+		dgWorldBodyState state;
+		memcpy (&state, bodyStates + sizeof (dgWorldBodyState) * bodyCount, sizeof (state));
+		if (state.m_uniqueID != body->m_uniqueID) {
+			return false;
+		}
+		bodyArray[bodyCount] = body;
+		bodyCount ++;
+	}
+
+	// all joint and contact records are validated before any state is modified, so a bad buffer leaves the world untouched
+	const dgInt8* const jointStates = bodyStates + sizeof (dgWorldBodyState) * header.m_bodyCount;
+	dgInt32 jointIndex = 0;
+	for (dgBilateralConstraintList::dgListNode* node = jointList.GetFirst(); node; node = node->GetNext()) {
+		const dgBilateralConstraint* const joint = node->GetInfo();
+		dgWorldJointState state;
+		memcpy (&state, jointStates + sizeof (dgWorldJointState) * jointIndex, sizeof (state));
+		jointIndex ++;
+		if ((state.m_body0 < 0) || (state.m_body0 >= bodyCount) || (state.m_body1 < 0) || (state.m_body1 >= bodyCount)) {
+			return false;
+		}
+		if ((bodyArray[state.m_body0] != joint->m_body0) || (bodyArray[state.m_body1] != joint->m_body1)) {
+			return false;
+		}
+	}
+
+	dgInt64 contactPointCount = 0;
+	const dgInt8* const contactStates = jointStates + sizeof (dgWorldJointState) * header.m_jointCount;
+	for (dgInt32 i = 0; i < header.m_contactCount; i ++) {
+		dgWorldContactState state;
+		memcpy (&state, contactStates + sizeof (dgWorldContactState) * i, sizeof (state));
+		if ((state.m_body0 < 0) || (state.m_body0 >= bodyCount) || (state.m_body1 < 0) || (state.m_body1 >= bodyCount) || (state.m_body0 == state.m_body1)) {
+			return false;
+		}
+		if (state.m_pointCount < 0) {
+			return false;
+		}
+		contactPointCount += state.m_pointCount;
+	}
+	if (contactPointCount != header.m_contactPointCount) {
+		return false;
+	}
+
+	if (m_pipelinedUpdate) {
+		FlushPendingTransforms();
+	}
+
+	const dgInt8* ptr = bodyStates;
+	for (dgInt32 i = 0; i < bodyCount; i ++) {
+		dgBody* const body = bodyArray[i];
+		dgWorldBodyState state;
+		memcpy (&state, ptr, sizeof (state));
+		ptr += sizeof (state);
+
+		body->m_matrix = state.m_matrix;
+		body->m_rotation = state.m_rotation;
+		body->m_veloc = state.m_veloc;
+		body->m_omega = state.m_omega;
+		body->m_accel = state.m_accel;
+		body->m_alpha = state.m_alpha;
+		body->m_gyroAlpha = state.m_gyroAlpha;
+		body->m_gyroTorque = state.m_gyroTorque;
+		body->m_gyroRotation = state.m_gyroRotation;
+		body->m_globalCentreOfMass = body->m_matrix.TransformVector(body->m_localCentreOfMass);
+		body->m_impulseForce = state.m_impulseForce;
+		body->m_impulseTorque = state.m_impulseTorque;
+		if (body->IsRTTIType(dgBody::m_dynamicBodyRTTI)) {
+			dgDynamicBody* const dynamicBody = (dgDynamicBody*)body;
+			dynamicBody->m_externalForce = state.m_externalForce;
+			dynamicBody->m_externalTorque = state.m_externalTorque;
+			dynamicBody->m_savedExternalForce = state.m_savedExternalForce;
+			dynamicBody->m_savedExternalTorque = state.m_savedExternalTorque;
+			dynamicBody->m_sleepingCounter = state.m_sleepingCounter;
+		}
+		// bodies in equilibrium keep the inertia of the last step they moved, so it is not recalculated
+		body->m_invWorldInertiaMatrix = state.m_invWorldInertiaMatrix;
+
+		// the broadphase only moves bodies that are not in equilibrium 
+		body->m_equilibrium = false;
+		body->UpdateCollisionMatrix(dgFloat32 (0.0f), 0);
+		GetBroadPhase()->RestoreBodyAABB(body, state.m_nodeMinBox, state.m_nodeMaxBox);
+		body->m_sleeping = state.m_sleeping;
+		body->m_resting = state.m_resting;
+		body->m_equilibrium = state.m_equilibrium;
+	}
+
+	for (dgBilateralConstraintList::dgListNode* node = jointList.GetFirst(); node; node = node->GetNext()) {
+		dgBilateralConstraint* const joint = node->GetInfo();
+		dgWorldJointState state;
+		memcpy (&state, ptr, sizeof (state));
+		ptr += sizeof (state);
+		memcpy (joint->m_jointForce, state.m_jointForce, sizeof (state.m_jointForce));
+		memcpy (joint->m_motorAcceleration, state.m_motorAcceleration, sizeof (state.m_motorAcceleration));
+	}
+
+	// contacts that do not exist in the snapshot are destroyed, the missing ones are recreated, 
+	// and the contact list is rebuilt in the snapshot order
+	dgBroadPhase* const broadPhase = GetBroadPhase();
+	dgContactList& contactList = *this;
+	for (dgInt32 i = 0; i < contactList.m_contactCount; i ++) {
+		contactList[i]->m_killContact = 1;
+	}
+
+	const dgUnsigned32 lru = broadPhase->GetLRU();
+	dgStack<dgContact*> contactArrayPool(header.m_contactCount + 1);
+	dgContact** const contactArray = &contactArrayPool[0];
+	const dgInt8* pointPtr = ptr + sizeof (dgWorldContactState) * header.m_contactCount;
+	for (dgInt32 i = 0; i < header.m_contactCount; i ++) {
+		dgWorldContactState state;
+		memcpy (&state, ptr, sizeof (state));
+		ptr += sizeof (state);
+
+		dgBody* const body0 = bodyArray[state.m_body0];
+		dgBody* const body1 = bodyArray[state.m_body1];
+		dgContact* contact = broadPhase->m_contactCache.FindContactJoint(body0, body1);
+		if (!contact) {
+			contact = broadPhase->RestoreContact(body0, body1);
+		}
+		dgAssert (contact->m_body0 == body0);
+		dgAssert (contact->m_body1 == body1);
+
+		contact->m_positAcc = state.m_positAcc;
+		contact->m_rotationAcc = state.m_rotationAcc;
+		contact->m_separtingVector = state.m_separtingVector;
+		contact->m_closestDistance = state.m_closestDistance;
+		contact->m_separationDistance = state.m_separationDistance;
+		contact->m_timeOfImpact = state.m_timeOfImpact;
+		contact->m_impulseSpeed = state.m_impulseSpeed;
+		contact->m_broadphaseLru = lru - state.m_lruAge;
+		contact->m_maxDOF = state.m_maxDOF;
+		contact->m_isActive = state.m_isActive;
+		contact->m_isNewContact = state.m_isNewContact;
+		contact->m_killContact = 0;
+
+		// reuse the contact point nodes, only the difference in count is allocated or released
+		dgContact::dgListNode* pointNode = contact->GetFirst();
+		for (dgInt32 j = 0; j < state.m_pointCount; j ++) {
+			if (!pointNode) {
+				pointNode = contact->Append();
+			}
+			memcpy (&pointNode->GetInfo(), pointPtr, sizeof (dgContactMaterial));
+			pointPtr += sizeof (dgContactMaterial);
+			pointNode = pointNode->GetNext();
+		}
+		while (pointNode) {
+			dgContact::dgListNode* const nextNode = pointNode->GetNext();
+			contact->Remove(pointNode);
+			pointNode = nextNode;
+		}
+		contactArray[i] = contact;
+	}
+
+	for (dgInt32 i = 0; i < contactList.m_contactCount; i ++) {
+		dgContact* const contact = contactList[i];
+		if (contact->m_killContact) {
+			broadPhase->m_contactCache.RemoveContactJoint(contact);
+			RemoveContact(contact);
+			delete contact;
+		}
+	}
+
+	contactList.ResizeIfNecessary(header.m_contactCount);
+	for (dgInt32 i = 0; i < header.m_contactCount; i ++) {
+		contactList[i] = contactArray[i];
+	}
+	contactList.m_contactCount = header.m_contactCount;
+	contactList.m_contactCountReset = header.m_contactCount;
+	broadPhase->m_contactCache.ReleaseRetiredTables();
+	dgAssert (broadPhase->SanityCheck());
+	return true;
+}
+
 void dgWorld::OnBodyDeserializeFromFile(dgBody& body, void* const userData, dgDeserialize deserializeCallback, void* const fileHandle)
 {
 }
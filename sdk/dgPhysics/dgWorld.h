@@ -40,6 +40,10 @@
 #define DG_SLEEP_ENTRIES					8
 #define DG_MAX_DESTROYED_BODIES_BY_FORCE	8
 
+#define DG_PARALLEL_SOLVER_DISABLED			0
+#define DG_PARALLEL_SOLVER_JACOBI			1
+#define DG_PARALLEL_SOLVER_GRAPH_COLORING	2
+
 class dgBody;
 class dgDynamicBody;
 class dgKinematicBody;
@@ -114,6 +118,49 @@ class dgSolverProgressiveSleepEntry
 	dgInt32 m_steps;
 };
 
+// timings in seconds and work counters of the last world update. 
+// timings and the work counters are accumulated over all substeps, 
+// population counts like bodies, contacts or islands are the values of the last substep.
+class dgWorldStats
+{
+	public:
+	dgFloat32 m_updateTime;
+	dgFloat32 m_skeletonsTime;
+	dgFloat32 m_broadPhaseTime;
+	dgFloat32 m_forceAndTorqueTime;
+	dgFloat32 m_collidingPairsTime;
+	dgFloat32 m_contactsTime;
+	dgFloat32 m_clustersTime;
+	dgFloat32 m_solverTime;
+	dgFloat32 m_transformsTime;
+
+	dgInt32 m_substeps;
+	dgInt32 m_threads;
+	dgInt32 m_bodies;
+	dgInt32 m_activeBodies;
+	dgInt32 m_pairsTested;
+	dgInt32 m_narrowPhasePairs;
+	dgInt32 m_newContacts;
+	dgInt32 m_contacts;
+	dgInt32 m_activeContacts;
+	dgInt32 m_contactPoints;
+	dgInt32 m_islands;
+	dgInt32 m_parallelIslands;
+	dgInt32 m_joints;
+	dgInt32 m_rows;
+	dgInt32 m_solverIterations;
+	dgInt32 m_stolenJobs;
+};
+
+// counters incremented from worker threads, padded to a cache line so threads do not share lines
+class dgWorldThreadCounters
+{
+	public:
+	dgInt32 m_pairsTested;
+	dgInt32 m_narrowPhasePairs;
+	dgInt32 m_pad[14];
+};
+
 class dgWorldThreadPool: public dgThreadHive
 {
 	public:
@@ -247,10 +294,12 @@ class dgWorld
 	~dgWorld();
 
 	dgFloat32 GetUpdateTime() const;
+	void GetStats (dgWorldStats& stats);
 	dgBroadPhase* GetBroadPhase() const;
 
 	dgInt32 GetSolverIterations() const;
 	void SetSolverIterations (dgInt32 mode);
+	void ReportSolverPasses (dgInt32 passes);
 
 	OnPostUpdateCallback GetPostUpdateCallback() const;
 	void SetPostUpdateCallback (OnPostUpdateCallback callback);
@@ -267,7 +316,16 @@ class dgWorld
 
 	void Update (dgFloat32 timestep);
 	void UpdateAsync (dgFloat32 timestep);
+	void WaitForUpdateToFinish ();
 	void StepDynamics (dgFloat32 timestep);
+	bool IsInUpdate () const;
+
+	bool GetPipelinedUpdate () const;
+	void SetPipelinedUpdate (bool state);
+	void FlushPendingTransforms ();
+
+	bool GetDeterministicMode () const;
+	void SetDeterministicMode (bool state);
 	
 	dgInt32 Collide (const dgCollisionInstance* const collisionA, const dgMatrix& matrixA, 
 					 const dgCollisionInstance* const collisionB, const dgMatrix& matrixB, 
@@ -344,10 +402,12 @@ class dgWorld
 
 	dgCollisionInstance* CreateDeformableSolid (dgMeshEffect* const mesh, dgInt32 shapeID);
 	dgCollisionInstance* CreateMassSpringDamperSystem (dgInt32 shapeID, dgInt32 pointCount, const dgFloat32* const points, dgInt32 srideInBytes, const dgFloat32* const pointsMass, dgInt32 linksCount, const dgInt32* const links, const dgFloat32* const linksSpring, const dgFloat32* const LinksDamper);
+	dgCollisionInstance* CreateIncompressibleParticles (dgInt32 shapeID, dgInt32 pointCount, const dgFloat32* const points, dgInt32 strideInBytes, dgFloat32 particleRadius, dgFloat32 restDensity, dgFloat32 viscosity);
 
 	dgCollisionInstance* CreateBVH ();	
 	dgCollisionInstance* CreateStaticUserMesh (const dgVector& boxP0, const dgVector& boxP1, const dgUserMeshCreation& data);
 	dgCollisionInstance* CreateHeightField (dgInt32 width, dgInt32 height, dgInt32 contructionMode, dgInt32 elevationDataType, const void* const elevationMap, const dgInt8* const atributeMap, dgFloat32 verticalScale, dgFloat32 horizontalScale_x, dgFloat32 horizontalScale_z);
+	dgCollisionInstance* CreateTiledHeightField (dgInt32 tileCount_x, dgInt32 tileCount_z, dgInt32 tileSize, dgInt32 contructionMode, dgInt32 elevationDataType, dgFloat32 minElevation, dgFloat32 maxElevation, dgFloat32 verticalScale, dgFloat32 horizontalScale_x, dgFloat32 horizontalScale_z);
 	dgCollisionInstance* CreateScene ();	
 
 	dgBroadPhaseAggregate* CreateAggreGate() const; 
@@ -371,6 +431,10 @@ class dgWorld
 	void SerializeScene(void* const userData, OnBodySerialize bodyCallback, dgSerialize serializeCallback, void* const serializeHandle) const;
 	void DeserializeScene(void* const userData, OnBodyDeserialize bodyCallback, dgDeserialize deserializeCallback, void* const serializeHandle);
 
+	dgInt32 GetStateSizeInBytes() const;
+	dgInt32 SaveState(void* const buffer, dgInt32 bufferSizeInBytes);
+	bool RestoreState(const void* const buffer, dgInt32 bufferSizeInBytes);
+
 	void SerializeBodyArray (void* const userData, OnBodySerialize bodyCallback, dgBody** const array, dgInt32 count, dgSerialize serializeCallback, void* const serializeHandle) const;
 	void DeserializeBodyArray (void* const userData, OnBodyDeserialize bodyCallback, dgTree<dgBody*, dgInt32>&bodyMap, dgDeserialize deserializeCallback, void* const serializeHandle);
 
@@ -379,6 +443,8 @@ class dgWorld
 
 	void SerializeCollision (dgCollisionInstance* const shape, dgSerialize deserialization, void* const userData) const;
 	dgCollisionInstance* CreateCollisionFromSerialization (dgDeserialize deserialization, void* const userData);
+	dgInt32 SerializeCollisionImage (dgCollisionInstance* const shape, dgSerialize serialization, void* const userData) const;
+	dgCollisionInstance* CreateCollisionFromImage (const void* const image, dgInt32 sizeInBytes);
 	void ReleaseCollision(const dgCollision* const collision);
 	
 	dgUpVectorConstraint* CreateUpVectorConstraint (const dgVector& pin, dgBody *body);
@@ -415,6 +481,7 @@ class dgWorld
 
 	dgDynamicBody* GetSentinelBody() const;
 	dgMemoryAllocator* GetAllocator() const;
+	dgArenaMemoryAllocator* GetStepAllocator(dgInt32 threadIndex) const;
 
 	dgInt32 GetBroadPhaseType() const;
 	void SetBroadPhaseType (dgInt32 type);
@@ -436,6 +503,13 @@ class dgWorld
 		dgFloat32 m_dist;
 	};
 
+	class dgPendingTransform
+	{
+		public:
+		dgMatrix m_matrix;
+		dgBody* m_body;
+	};
+
 	void RunStep ();
 	void CalculateContacts (dgBroadPhase::dgPair* const pair, dgInt32 threadIndex, bool ccdMode, bool intersectionTestOnly);
 
@@ -446,6 +520,7 @@ class dgWorld
 	dgInt32 CalculateUserContacts (dgCollisionParamProxy& proxy) const;
 	dgInt32 CalculateConvexToNonConvexContacts (dgCollisionParamProxy& proxy) const;
 	dgInt32 CalculateConvexToConvexContacts (dgCollisionParamProxy& proxy) const;
+	dgInt32 CalculatePrimitiveContacts (const dgWorldPlugin* const plugin, dgCollisionParamProxy& proxy) const;
 	dgInt32 PruneContactsByRank(dgInt32 count, dgCollisionParamProxy& proxy, dgInt32 maxCount) const;
 	
 	void PopulateContacts (dgBroadPhase::dgPair* const pair, dgInt32 threadIndex);	
@@ -478,13 +553,18 @@ class dgWorld
 	DG_INLINE dgBody* FindRoot(dgBody* const body) const;
 	DG_INLINE dgBody* FindRootAndSplit(dgBody* const body) const;
 	DG_INLINE void UnionSet(const dgConstraint* const joint) const;
+	DG_INLINE dgBody* ConcurrentFindRoot(dgBody* const body) const;
+	DG_INLINE void ConcurrentUnionSet(dgBody* const body0, dgBody* const body1) const;
 	
 	virtual void Execute (dgInt32 threadID);
 	virtual void TickCallback (dgInt32 threadID);
-	void UpdateTransforms(dgBodyMasterList::dgListNode* node, dgInt32 threadID);
+	void UpdateTransforms(dgInt32* const atomicIndex, dgInt32 threadID);
+	void CaptureTransforms(dgInt32* const atomicIndex, dgInt32 threadID);
+	void DispatchPendingTransforms(dgInt32 threadID);
 
 	static dgUnsigned32 dgApi GetPerformanceCount ();
-	static void UpdateTransforms(void* const context, void* const node, dgInt32 threadID);
+	static void UpdateTransforms(void* const context, void* const atomicIndex, dgInt32 threadID);
+	static void CaptureTransforms(void* const context, void* const atomicIndex, dgInt32 threadID);
 	static dgInt32 SortFaces (const dgAdressDistPair* const A, const dgAdressDistPair* const B, void* const context);
 	static dgInt32 CompareJointByInvMass (const dgBilateralConstraint* const jointA, const dgBilateralConstraint* const jointB, void* notUsed);
 
@@ -536,6 +616,31 @@ class dgWorld
 	dgArray<dgUnsigned8> m_solverJacobiansMemory;  
 	dgArray<dgUnsigned8> m_solverRightHandSideMemory;
 	dgArray<dgUnsigned8> m_solverForceAccumulatorMemory;
+
+	// pipelined update: the transform callbacks and the post update callback of an asynchronous step are
+	// dispatched during the force and torque phase of the next step, from a copy of the body matrices,
+	// or by the thread that waits for the update to finish, whichever comes first.
+	dgArray<dgPendingTransform> m_pendingTransforms;
+	dgInt32 m_pendingTransformsCount;
+	dgInt32 m_pendingTransformsIndex;
+	dgInt32 m_pendingTransformsDone;
+	dgInt32 m_pendingPostUpdate;
+	dgFloat32 m_pendingTimestep;
+	bool m_pipelinedUpdate;
+	bool m_pipelinedStep;
+
+	// deterministic mode: the result of a step does not depend on the number of threads
+	bool m_deterministicMode;
+
+	// per thread transient memory, all arenas are reset at the beginning of each update.
+	// index zero is also used by the serial portions of the update, since the calling thread does not run jobs.
+	dgArenaMemoryAllocator* m_stepAllocators[DG_MAX_THREADS_HIVE_COUNT];
+
+	dgWorldStats m_stats;
+	dgWorldStats m_stepStats;
+	dgWorldThreadCounters m_threadCounters[DG_MAX_THREADS_HIVE_COUNT];
+	dgInt32 m_substepSolverPasses;
+	dgInt32 m_statsLock;
 	
 	friend class dgBody;
 	friend class dgSolver;
@@ -569,6 +674,7 @@ class dgWorld
 	friend class dgCollisionDeformableSolidMesh;
 	friend class dgBroadPhaseApplyExternalForce;
 	friend class dgParallelSolverCalculateForces;
+	friend class dgCollisionIncompressibleParticles;
 	friend class dgCollisionMassSpringDamperSystem;
 	friend class dgParallelSolverJointAcceleration;
 	friend class dgParallelSolverBuildJacobianRows;
@@ -586,6 +692,13 @@ inline dgMemoryAllocator* dgWorld::GetAllocator() const
 	return m_allocator;
 }
 
+inline dgArenaMemoryAllocator* dgWorld::GetStepAllocator(dgInt32 threadIndex) const
+{
+	dgAssert (threadIndex >= 0);
+	dgAssert (threadIndex < DG_MAX_THREADS_HIVE_COUNT);
+	return m_stepAllocators[threadIndex];
+}
+
 inline dgBroadPhase* dgWorld::GetBroadPhase() const
 {
 	return m_broadPhase;
@@ -606,6 +719,21 @@ inline dgFloat32 dgWorld::GetUpdateTime() const
 	return m_lastExecutionTime;
 }
 
+inline bool dgWorld::IsInUpdate () const
+{
+	return m_inUpdate ? true : false;
+}
+
+inline bool dgWorld::GetPipelinedUpdate () const
+{
+	return m_pipelinedUpdate;
+}
+
+inline bool dgWorld::GetDeterministicMode () const
+{
+	return m_deterministicMode;
+}
+
 inline OnPostUpdateCallback dgWorld::GetPostUpdateCallback() const
 {
 	return m_onPostUpdateCallback;
@@ -631,6 +759,16 @@ inline dgInt32 dgWorld::GetSolverIterations() const
 	return m_solverIterations;
 }
 
+inline void dgWorld::ReportSolverPasses(dgInt32 passes)
+{
+	// islands are solved concurrently, the substep reports the passes of the slowest one
+	for (dgInt32 current = m_substepSolverPasses; passes > current; current = m_substepSolverPasses) {
+		if (dgAtomicCompareAndSwap(&m_substepSolverPasses, current, passes)) {
+			break;
+		}
+	}
+}
+
 DG_INLINE dgBody* dgWorld::FindRoot(dgBody* const body) const
 {
 	dgBody* node = body;
@@ -672,5 +810,40 @@ DG_INLINE void dgWorld::UnionSet(const dgConstraint* const joint) const
 	root0->m_disjointInfo.m_rowCount += joint->m_maxDOF;
 }
 
+// the concurrent version only links the sets, the set counters are accumulated in a separate pass.
+// path halving only ever writes an ancestor of the node, so paths stay valid for other threads
+DG_INLINE dgBody* dgWorld::ConcurrentFindRoot(dgBody* const body) const
+{
+	dgBody* node = body;
+	dgBody* parent = node->m_disjointInfo.m_parent;
+	while (parent != node) {
+		dgBody* const grandParent = parent->m_disjointInfo.m_parent;
+		if (grandParent != parent) {
+			node->m_disjointInfo.m_parent = grandParent;
+		}
+		node = grandParent;
+		parent = node->m_disjointInfo.m_parent;
+	}
+	return node;
+}
+
+// sets are linked by address, a root is always placed under a root with a lower address, so no cycle can form
+DG_INLINE void dgWorld::ConcurrentUnionSet(dgBody* const body0, dgBody* const body1) const
+{
+	for (;;) {
+		dgBody* root0 = ConcurrentFindRoot(body0);
+		dgBody* root1 = ConcurrentFindRoot(body1);
+		if (root0 == root1) {
+			break;
+		}
+		if (root0 < root1) {
+			dgSwap(root0, root1);
+		}
+		if (dgAtomicCompareAndSwap((void**)&root0->m_disjointInfo.m_parent, root0, root1)) {
+			break;
+		}
+	}
+}
+
 
 #endif
@@ -48,6 +48,25 @@ class dgWorldDynamicUpdateSyncDescriptor
 	
 	dgInt32 m_clusterCount;
 	dgInt32 m_firstCluster;
+	dgInt32 m_rowCount;
+	dgInt32 m_busyTime;
+};
+
+class dgClusterBuildDescriptor
+{
+	public:
+	dgClusterBuildDescriptor(dgJointInfo* const jointArray, dgInt32 count)
+		:m_jointArray(jointArray)
+		,m_clusterArray(NULL)
+		,m_count(count)
+		,m_atomicIndex(0)
+	{
+	}
+
+	dgJointInfo* m_jointArray;
+	const dgBodyCluster* m_clusterArray;
+	dgInt32 m_count;
+	dgInt32 m_atomicIndex;
 };
 
 
@@ -82,6 +101,9 @@ dgWorldDynamicUpdate::dgWorldDynamicUpdate(dgMemoryAllocator* const allocator)
 	,m_softBodiesCount(0)
 	,m_impulseLru(0)
 	,m_softBodyCriticalSectionLock(0)
+	,m_serialRowCost(dgFloat32 (0.0f))
+	,m_parallelRowCost(dgFloat32 (0.0f))
+	,m_parallelSolverProbe(0)
 {
 	m_parallelSolver.m_world = (dgWorld*) this;
 }
@@ -106,7 +128,9 @@ void dgWorldDynamicUpdate::UpdateDynamics(dgFloat32 timestep)
 	sentinelBody->m_equilibrium = 1;
 	sentinelBody->m_dynamicsLru = m_markLru;
 
+	const dgUnsigned64 clustersTime = dgGetTimeInMicrosenconds();
 	BuildClusters(timestep);
+	const dgUnsigned64 solverTime = dgGetTimeInMicrosenconds();
 	const dgInt32 threadCount = world->GetThreadCount();	
 
 	dgWorldDynamicUpdateSyncDescriptor descriptor;
@@ -117,16 +141,20 @@ void dgWorldDynamicUpdate::UpdateDynamics(dgFloat32 timestep)
 	descriptor.m_firstCluster = index;
 	descriptor.m_clusterCount = m_clusters - index;
 
-	dgInt32 useParallelSolver = world->m_useParallelSolver;
+	dgInt32 parallelClusters = 0;
+	dgInt32 useParallelSolver = world->m_useParallelSolver && !world->m_deterministicMode;
 //useParallelSolver = 0;
 	if (useParallelSolver) {
-		dgInt32 count = 0;
-		for (dgInt32 i = 0; (i < m_clusters) && (m_clusterData[index + i].m_jointCount >= DG_PARALLEL_JOINT_COUNT_CUT_OFF); i++) {
-			count++;
-		}
-		if (count) {
-			CalculateReactionForcesParallel(&m_clusterData[index], count, timestep);
-			index += count;
+		parallelClusters = CalculateParallelClustersCount(&m_clusterData[index], m_clusters - index);
+		if (parallelClusters) {
+			dgInt32 rowCount = 0;
+			for (dgInt32 i = 0; i < parallelClusters; i++) {
+				rowCount += m_clusterData[index + i].m_rowCount;
+			}
+			const dgUnsigned64 parallelTime = dgGetTimeInMicrosenconds();
+			CalculateReactionForcesParallel(&m_clusterData[index], parallelClusters, timestep);
+			UpdateSolverCost(m_parallelRowCost, dgGetTimeInMicrosenconds() - parallelTime, rowCount);
+			index += parallelClusters;
 		}
 	}
 
@@ -135,9 +163,10 @@ void dgWorldDynamicUpdate::UpdateDynamics(dgFloat32 timestep)
 		descriptor.m_firstCluster = index;
 		descriptor.m_clusterCount = m_clusters - index;
 		for (dgInt32 i = 0; i < threadCount; i ++) {
-			world->QueueJob (CalculateClusterReactionForcesKernel, &descriptor, world, "dgWorldDynamicUpdate::CalculateClusterReactionForces");
+			world->QueueStealableJob (CalculateClusterReactionForcesKernel, &descriptor, world, "dgWorldDynamicUpdate::CalculateClusterReactionForces");
 		}
 		world->SynchronizationBarrier();
+		UpdateSolverCost(m_serialRowCost, dgUnsigned64 (descriptor.m_busyTime), descriptor.m_rowCount);
 	}
 
 	dgBodyInfo* const bodyArrayPtr = &world->m_bodiesMemory[0];
@@ -152,9 +181,81 @@ void dgWorldDynamicUpdate::UpdateDynamics(dgFloat32 timestep)
 		IntegrateVelocity(cluster, DG_SOLVER_MAX_ERROR, timestep, 0);
 	}
 
+	dgWorldStats& stats = world->m_stepStats;
+	dgInt32 activeBodies = 0;
+	for (dgInt32 i = 0; i < m_clusters; i ++) {
+		const dgBodyCluster& cluster = m_clusterData[i];
+		activeBodies += cluster.m_bodyCount - 1;
+		stats.m_rows += cluster.m_rowCount;
+	}
+	stats.m_islands = m_clusters;
+	stats.m_parallelIslands = parallelClusters;
+	stats.m_joints = m_joints;
+	stats.m_activeBodies = activeBodies;
+
+	const dgUnsigned64 endTime = dgGetTimeInMicrosenconds();
+	stats.m_clustersTime += (solverTime - clustersTime) * dgFloat32 (1.0e-6f);
+	stats.m_solverTime += (endTime - solverTime) * dgFloat32 (1.0e-6f);
+
 	m_clusterData = NULL;
 }
 
+void dgWorldDynamicUpdate::UpdateSolverCost(dgFloat32& cost, dgUnsigned64 time, dgInt32 rowCount) const
+{
+	// blend the new sample into the running cost per row, timer resolution makes tiny samples useless
+	if (time && rowCount) {
+		const dgFloat32 sample = dgFloat32 (time) / rowCount;
+		cost = (cost > dgFloat32 (0.0f)) ? cost + (sample - cost) * DG_PARALLEL_SOLVER_COST_BLEND : sample;
+	}
+}
+
+dgInt32 dgWorldDynamicUpdate::CalculateParallelClustersCount(const dgBodyCluster* const clusterArray, dgInt32 clustersCount)
+{
+	dgInt32 count = 0;
+	m_parallelSolverProbe ++;
+	if ((m_serialRowCost == dgFloat32 (0.0f)) || (m_parallelRowCost == dgFloat32 (0.0f)) || (m_parallelSolverProbe >= DG_PARALLEL_SOLVER_PROBE_FRAMES)) {
+		// no cost estimate yet, or the parallel cost has gone stale; use the fixed cut off to measure it
+		for (; (count < clustersCount) && (clusterArray[count].m_jointCount >= DG_PARALLEL_JOINT_COUNT_CUT_OFF); count++);
+		if (!count && clustersCount && (clusterArray[0].m_jointCount >= DG_PARALLEL_MIN_JOINT_COUNT)) {
+			// no island reaches the cut off, time the largest one so the parallel cost is still measured
+			count = 1;
+		}
+		if (count && (count == clustersCount) && (m_serialRowCost == dgFloat32 (0.0f))) {
+			// leave the smallest island to the serial pass, so that its cost is measured too
+			count --;
+		}
+	} else {
+		// clusters are sorted by joint count, the serial pass can not finish before its largest island
+		// does, so keep moving the head of the list to the parallel solver while the estimate improves.
+		dgWorld* const world = (dgWorld*) this;
+		const dgFloat32 threadCount = dgFloat32 (world->GetThreadCount());
+
+		dgInt32 serialRows = 0;
+		for (dgInt32 i = 0; i < clustersCount; i++) {
+			serialRows += clusterArray[i].m_rowCount;
+		}
+
+		dgInt32 parallelRows = 0;
+		dgFloat32 largestRows = clustersCount ? dgFloat32 (clusterArray[0].m_rowCount) : dgFloat32 (0.0f);
+		dgFloat32 bestCost = m_serialRowCost * dgMax(largestRows, serialRows / threadCount);
+		for (dgInt32 i = 0; (i < clustersCount) && (clusterArray[i].m_jointCount >= DG_PARALLEL_MIN_JOINT_COUNT); i++) {
+			parallelRows += clusterArray[i].m_rowCount;
+			serialRows -= clusterArray[i].m_rowCount;
+			largestRows = ((i + 1) < clustersCount) ? dgFloat32 (clusterArray[i + 1].m_rowCount) : dgFloat32 (0.0f);
+			const dgFloat32 cost = m_parallelRowCost * parallelRows + m_serialRowCost * dgMax(largestRows, serialRows / threadCount);
+			if (cost < bestCost) {
+				bestCost = cost;
+				count = i + 1;
+			}
+		}
+	}
+
+	if (count) {
+		m_parallelSolverProbe = 0;
+	}
+	return count;
+}
+
 dgInt32 dgWorldDynamicUpdate::CompareKey(dgInt32 highA, dgInt32 lowA, dgInt32 highB, dgInt32 lowB)
 {
 	if (highA < highB) {
@@ -170,14 +271,19 @@ dgInt32 dgWorldDynamicUpdate::CompareKey(dgInt32 highA, dgInt32 lowA, dgInt32 hi
 	return 0;
 }
 
+// soft bodies clusters are sorted first, so that they can be integrated apart from the rigid body clusters
 dgInt32 dgWorldDynamicUpdate::CompareJointInfos(const dgJointInfo* const infoA, const dgJointInfo* const infoB, void*)
 {
-	return CompareKey(infoA->m_jointCount, infoA->m_setId, infoB->m_jointCount, infoB->m_setId);
+	const dgInt32 keyA = (!infoA->m_jointCount && infoA->m_body->m_collision->IsType(dgCollision::dgCollisionLumpedMass_RTTI)) ? DG_SOFT_BODY_CLUSTER_KEY : infoA->m_jointCount;
+	const dgInt32 keyB = (!infoB->m_jointCount && infoB->m_body->m_collision->IsType(dgCollision::dgCollisionLumpedMass_RTTI)) ? DG_SOFT_BODY_CLUSTER_KEY : infoB->m_jointCount;
+	return CompareKey(keyA, infoA->m_setId, keyB, infoB->m_setId);
 }
 
 dgInt32 dgWorldDynamicUpdate::CompareClusterInfos(const dgBodyCluster* const clusterA, const dgBodyCluster* const clusterB, void* notUsed)
 {
-	return CompareKey(clusterA->m_jointCount, clusterA->m_bodyStart, clusterB->m_jointCount, clusterB->m_bodyStart);
+	const dgInt32 keyA = clusterA->m_hasSoftBodies ? DG_SOFT_BODY_CLUSTER_KEY : clusterA->m_jointCount;
+	const dgInt32 keyB = clusterB->m_hasSoftBodies ? DG_SOFT_BODY_CLUSTER_KEY : clusterB->m_jointCount;
+	return CompareKey(keyA, clusterA->m_bodyStart, keyB, clusterB->m_bodyStart);
 }
 
 void dgWorldDynamicUpdate::BuildClusters(dgFloat32 timestep)
@@ -216,31 +322,7 @@ void dgWorldDynamicUpdate::BuildClusters(dgFloat32 timestep)
 	}
 
 	// form all disjoints sets
-	for (dgInt32 i = 0; i < jointCount; i ++) {
-		const dgConstraint* const joint = baseJointArray[i].m_joint;
-		dgBody* const body0 = joint->GetBody0();
-		dgBody* const body1 = joint->GetBody1(); 
-		const dgFloat32 invMass0 = body0->m_invMass.m_w;
-		const dgFloat32 invMass1 = body1->m_invMass.m_w;
-
-		dgInt32 resting = body0->m_equilibrium & body1->m_equilibrium;
-		body0->m_resting = resting | (invMass0 == dgFloat32(0.0f));
-		body1->m_resting = resting | (invMass1 == dgFloat32(0.0f));
-
-		if ((invMass0 > dgFloat32 (0.0f)) && (invMass1 > dgFloat32 (0.0f))) {
-			//dgAssert (body0->IsRTTIType(dgBody::m_dynamicBodyRTTI | dgBody::m_dynamicBodyAsymatric));
-			//dgAssert (body1->IsRTTIType(dgBody::m_dynamicBodyRTTI | dgBody::m_dynamicBodyAsymatric));
-			world->UnionSet(joint);
-		} else if (invMass1 == dgFloat32 (0.0f)) {
-			dgBody* const root = world->FindRootAndSplit(body0);
-			root->m_disjointInfo.m_jointCount += 1;
-			root->m_disjointInfo.m_rowCount += joint->m_maxDOF;
-		} else {
-			dgBody* const root = world->FindRootAndSplit(body1);
-			root->m_disjointInfo.m_jointCount += 1;
-			root->m_disjointInfo.m_rowCount += joint->m_maxDOF;
-		}
-	}
+	BuildDisjointSets(baseJointArray, jointCount);
 
 	// find and tag all sleeping disjoint sets, 
 	// and add single bodies as a set of zero joints and one body
@@ -278,7 +360,7 @@ void dgWorldDynamicUpdate::BuildClusters(dgFloat32 timestep)
 				cluster.m_bodyCount = 2;
 				cluster.m_jointCount = 0;
 				cluster.m_rowCount = 0;
-				cluster.m_hasSoftBodies = 0;
+				cluster.m_hasSoftBodies = body->m_collision->IsType(dgCollision::dgCollisionLumpedMass_RTTI) ? 1 : 0;
 				cluster.m_isContinueCollision = 0;
 				cluster.m_bodyStart = root->m_index;
 
@@ -325,8 +407,14 @@ void dgWorldDynamicUpdate::BuildClusters(dgFloat32 timestep)
 	m_clusterData = &world->m_clusterMemory[0];
 //	dgSort(augmentedJointArray, augmentedJointCount, CompareJointInfos);
 //	dgSort(m_clusterData, clustersCount, CompareClusterInfos);
-	dgParallelSort(*world, augmentedJointArray, augmentedJointCount, CompareJointInfos);
-	dgParallelSort(*world, m_clusterData, clustersCount, CompareClusterInfos);
+	if (world->m_deterministicMode) {
+		// the parallel sort splits the array by thread count, which changes the order of equal keys
+		dgSort(augmentedJointArray, augmentedJointCount, CompareJointInfos);
+		dgSort(m_clusterData, clustersCount, CompareClusterInfos);
+	} else {
+		dgParallelSort(*world, augmentedJointArray, augmentedJointCount, CompareJointInfos);
+		dgParallelSort(*world, m_clusterData, clustersCount, CompareClusterInfos);
+	}
 
 	dgInt32 rowStart = 0;
 	dgInt32 bodyStart = 0;
@@ -346,53 +434,18 @@ void dgWorldDynamicUpdate::BuildClusters(dgFloat32 timestep)
 	m_solverMemory.Init(world, rowStart, bodyStart);
 	world->m_bodiesMemory.ResizeIfNecessary(bodyStart);
 
-	rowStart = 0;
-	for (dgInt32 i = 0; i < clustersCount; i++) {
-		const dgBodyCluster& cluster = m_clusterData[i];
-		dgBodyInfo* const bodyArray = &world->m_bodiesMemory[cluster.m_bodyStart];
-		dgJointInfo* const jointSetArray = &augmentedJointArray[cluster.m_jointStart];
-		bodyArray[0].m_body = world->GetSentinelBody();
-
-		if (cluster.m_jointCount) {
-			dgInt32 bodyIndex = 1;
-			for (dgInt32 j = 0; j < cluster.m_jointCount; j++) {
-				dgJointInfo* const jointInfo = &jointSetArray[j];
-				dgConstraint* const joint = jointInfo->m_joint;
-				dgBody* const body0 = joint->m_body0;
-				dgBody* const body1 = joint->m_body1;
-
-				dgInt32 m0 = 0;
-				if (body0->GetInvMass().m_w != dgFloat32(0.0f)) {
-					if (body0->m_disjointInfo.m_rank >= 0) {
-						body0->m_disjointInfo.m_rank = -1;
-						body0->m_index = bodyIndex;
-						bodyArray[bodyIndex].m_body = body0;
-						bodyIndex++;
-						dgAssert(bodyIndex <= cluster.m_bodyCount);
-					}
-					m0 = body0->m_index;
-				}
-
-				dgInt32 m1 = 0;
-				if (body1->GetInvMass().m_w != dgFloat32(0.0f)) {
-					if (body1->m_disjointInfo.m_rank >= 0) {
-						body1->m_disjointInfo.m_rank = -1;
-						body1->m_index = bodyIndex;
-						bodyArray[bodyIndex].m_body = body1;
-						bodyIndex++;
-						dgAssert(bodyIndex <= cluster.m_bodyCount);
-					}
-					m1 = body1->m_index;
-				}
-				
-				jointInfo->m_m0 = m0;
-				jointInfo->m_m1 = m1;
-				jointInfo->m_pairStart = rowStart;
-				rowStart += jointInfo->m_pairCount; 
-			}
-		} else {
-			dgAssert(cluster.m_bodyCount == 2);
-			bodyArray[1].m_body = jointSetArray[0].m_body;
+	if ((clustersCount > 1) && (jointStart >= DG_PARALLEL_CLUSTER_BUILD_CUT_OFF) && (world->GetThreadCount() > 1)) {
+		// each body belongs to a single cluster, so clusters can be filled in any order
+		dgClusterBuildDescriptor descriptor(augmentedJointArray, clustersCount);
+		descriptor.m_clusterArray = m_clusterData;
+		const dgInt32 threadCount = world->GetThreadCount();
+		for (dgInt32 i = 0; i < threadCount; i++) {
+			world->QueueJob(BuildClusterBodyArrayKernel, &descriptor, world, "dgWorldDynamicUpdate::BuildClusterBodyArray");
+		}
+		world->SynchronizationBarrier();
+	} else {
+		for (dgInt32 i = 0; i < clustersCount; i++) {
+			BuildClusterBodyArray(&m_clusterData[i], augmentedJointArray);
 		}
 	}
 	
@@ -402,6 +455,229 @@ void dgWorldDynamicUpdate::BuildClusters(dgFloat32 timestep)
 	m_softBodiesCount = softBodiesCount;
 }
 
+void dgWorldDynamicUpdate::BuildClusterBodyArray(const dgBodyCluster* const cluster, dgJointInfo* const jointArray) const
+{
+	dgWorld* const world = (dgWorld*) this;
+	dgBodyInfo* const bodyArray = &world->m_bodiesMemory[cluster->m_bodyStart];
+	dgJointInfo* const jointSetArray = &jointArray[cluster->m_jointStart];
+	bodyArray[0].m_body = world->GetSentinelBody();
+
+	if (cluster->m_jointCount) {
+		dgInt32 bodyIndex = 1;
+		dgInt32 rowStart = cluster->m_rowStart;
+		for (dgInt32 j = 0; j < cluster->m_jointCount; j++) {
+			dgJointInfo* const jointInfo = &jointSetArray[j];
+			dgConstraint* const joint = jointInfo->m_joint;
+			dgBody* const body0 = joint->m_body0;
+			dgBody* const body1 = joint->m_body1;
+
+			dgInt32 m0 = 0;
+			if (body0->GetInvMass().m_w != dgFloat32(0.0f)) {
+				if (body0->m_disjointInfo.m_rank >= 0) {
+					body0->m_disjointInfo.m_rank = -1;
+					body0->m_index = bodyIndex;
+					bodyArray[bodyIndex].m_body = body0;
+					bodyIndex++;
+					dgAssert(bodyIndex <= cluster->m_bodyCount);
+				}
+				m0 = body0->m_index;
+			}
+
+			dgInt32 m1 = 0;
+			if (body1->GetInvMass().m_w != dgFloat32(0.0f)) {
+				if (body1->m_disjointInfo.m_rank >= 0) {
+					body1->m_disjointInfo.m_rank = -1;
+					body1->m_index = bodyIndex;
+					bodyArray[bodyIndex].m_body = body1;
+					bodyIndex++;
+					dgAssert(bodyIndex <= cluster->m_bodyCount);
+				}
+				m1 = body1->m_index;
+			}
+				
+			jointInfo->m_m0 = m0;
+			jointInfo->m_m1 = m1;
+			jointInfo->m_pairStart = rowStart;
+			rowStart += jointInfo->m_pairCount; 
+		}
+	} else {
+		dgAssert(cluster->m_bodyCount == 2);
+		bodyArray[1].m_body = jointSetArray[0].m_body;
+	}
+}
+
+void dgWorldDynamicUpdate::BuildClusterBodyArrayKernel(void* const context, void* const worldContext, dgInt32 threadID)
+{
+	D_TRACKTIME();
+	dgClusterBuildDescriptor* const descriptor = (dgClusterBuildDescriptor*)context;
+	dgWorld* const world = (dgWorld*)worldContext;
+	const dgInt32 count = descriptor->m_count;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, 1); i < count; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, 1)) {
+		world->BuildClusterBodyArray(&descriptor->m_clusterArray[i], descriptor->m_jointArray);
+	}
+}
+
+void dgWorldDynamicUpdate::BuildDisjointSets(dgJointInfo* const jointArray, dgInt32 jointCount) const
+{
+	dgWorld* const world = (dgWorld*) this;
+	const dgInt32 threadCount = world->GetThreadCount();
+	if ((jointCount < DG_PARALLEL_CLUSTER_BUILD_CUT_OFF) || (threadCount == 1)) {
+		for (dgInt32 i = 0; i < jointCount; i ++) {
+			const dgConstraint* const joint = jointArray[i].m_joint;
+			dgBody* const body0 = joint->GetBody0();
+			dgBody* const body1 = joint->GetBody1(); 
+			const dgFloat32 invMass0 = body0->m_invMass.m_w;
+			const dgFloat32 invMass1 = body1->m_invMass.m_w;
+
+			dgInt32 resting = body0->m_equilibrium & body1->m_equilibrium;
+			body0->m_resting = resting | (invMass0 == dgFloat32(0.0f));
+			body1->m_resting = resting | (invMass1 == dgFloat32(0.0f));
+
+			if ((invMass0 > dgFloat32 (0.0f)) && (invMass1 > dgFloat32 (0.0f))) {
+				world->UnionSet(joint);
+			} else if (invMass1 == dgFloat32 (0.0f)) {
+				dgBody* const root = world->FindRootAndSplit(body0);
+				root->m_disjointInfo.m_jointCount += 1;
+				root->m_disjointInfo.m_rowCount += joint->m_maxDOF;
+			} else {
+				dgBody* const root = world->FindRootAndSplit(body1);
+				root->m_disjointInfo.m_jointCount += 1;
+				root->m_disjointInfo.m_rowCount += joint->m_maxDOF;
+			}
+		}
+	} else {
+		// the sets are linked concurrently, then counted, then flatten so that the serial passes that follow 
+		// find every root in one step. the result is the same as the serial loop above.
+		dgClusterBuildDescriptor descriptor(jointArray, jointCount);
+		for (dgInt32 i = 0; i < threadCount; i++) {
+			world->QueueJob(UnionSetsKernel, &descriptor, world, "dgWorldDynamicUpdate::UnionSets");
+		}
+		world->SynchronizationBarrier();
+
+		descriptor.m_atomicIndex = 0;
+		for (dgInt32 i = 0; i < threadCount; i++) {
+			world->QueueJob(CountSetsKernel, &descriptor, world, "dgWorldDynamicUpdate::CountSets");
+		}
+		world->SynchronizationBarrier();
+
+		descriptor.m_atomicIndex = 0;
+		for (dgInt32 i = 0; i < threadCount; i++) {
+			world->QueueJob(FlattenSetsKernel, &descriptor, world, "dgWorldDynamicUpdate::FlattenSets");
+		}
+		world->SynchronizationBarrier();
+	}
+}
+
+void dgWorldDynamicUpdate::UnionSetsKernel(void* const context, void* const worldContext, dgInt32 threadID)
+{
+	D_TRACKTIME();
+	dgClusterBuildDescriptor* const descriptor = (dgClusterBuildDescriptor*)context;
+	dgWorld* const world = (dgWorld*)worldContext;
+	const dgJointInfo* const jointArray = descriptor->m_jointArray;
+	const dgInt32 count = descriptor->m_count;
+
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_CLUSTER_BUILD_JOINTS_PER_JOB); i < count; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_CLUSTER_BUILD_JOINTS_PER_JOB)) {
+		const dgInt32 lastJoint = dgMin(i + DG_CLUSTER_BUILD_JOINTS_PER_JOB, count);
+		for (dgInt32 j = i; j < lastJoint; j++) {
+			const dgConstraint* const joint = jointArray[j].m_joint;
+			dgBody* const body0 = joint->GetBody0();
+			dgBody* const body1 = joint->GetBody1();
+			const dgFloat32 invMass0 = body0->m_invMass.m_w;
+			const dgFloat32 invMass1 = body1->m_invMass.m_w;
+
+			// the serial loop lets the last joint of each body set its resting state, 
+			// so each dynamic body remembers the index of its last joint.
+			// static bodies are always resting.
+			if (invMass0 > dgFloat32(0.0f)) {
+				for (dgInt32 index = body0->m_index; (index < j) && !dgAtomicCompareAndSwap(&body0->m_index, index, j); index = body0->m_index);
+			} else {
+				body0->m_resting = 1;
+			}
+			if (invMass1 > dgFloat32(0.0f)) {
+				for (dgInt32 index = body1->m_index; (index < j) && !dgAtomicCompareAndSwap(&body1->m_index, index, j); index = body1->m_index);
+			} else {
+				body1->m_resting = 1;
+			}
+
+			if ((invMass0 > dgFloat32(0.0f)) && (invMass1 > dgFloat32(0.0f))) {
+				world->ConcurrentUnionSet(body0, body1);
+			}
+		}
+	}
+}
+
+void dgWorldDynamicUpdate::CountSetsKernel(void* const context, void* const worldContext, dgInt32 threadID)
+{
+	D_TRACKTIME();
+	dgClusterBuildDescriptor* const descriptor = (dgClusterBuildDescriptor*)context;
+	dgWorld* const world = (dgWorld*)worldContext;
+	const dgJointInfo* const jointArray = descriptor->m_jointArray;
+	const dgInt32 count = descriptor->m_count;
+
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_CLUSTER_BUILD_JOINTS_PER_JOB); i < count; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_CLUSTER_BUILD_JOINTS_PER_JOB)) {
+		const dgInt32 lastJoint = dgMin(i + DG_CLUSTER_BUILD_JOINTS_PER_JOB, count);
+		for (dgInt32 j = i; j < lastJoint; j++) {
+			const dgConstraint* const joint = jointArray[j].m_joint;
+			dgBody* const body0 = joint->GetBody0();
+			dgBody* const body1 = joint->GetBody1();
+			const dgFloat32 invMass0 = body0->m_invMass.m_w;
+			const dgFloat32 invMass1 = body1->m_invMass.m_w;
+			const dgInt32 resting = body0->m_equilibrium & body1->m_equilibrium;
+
+			dgBody* root = NULL;
+			if (invMass0 > dgFloat32(0.0f)) {
+				root = world->ConcurrentFindRoot(body0);
+				if (body0->m_index == j) {
+					// only the last joint of a body writes it, so each body is counted once
+					body0->m_resting = resting;
+					if (body0 != root) {
+						dgAtomicExchangeAndAdd(&root->m_disjointInfo.m_bodyCount, 1);
+					}
+				}
+			}
+			if (invMass1 > dgFloat32(0.0f)) {
+				root = world->ConcurrentFindRoot(body1);
+				if (body1->m_index == j) {
+					body1->m_resting = resting;
+					if (body1 != root) {
+						dgAtomicExchangeAndAdd(&root->m_disjointInfo.m_bodyCount, 1);
+					}
+				}
+			}
+
+			dgAssert(root);
+			dgAtomicExchangeAndAdd(&root->m_disjointInfo.m_jointCount, 1);
+			dgAtomicExchangeAndAdd(&root->m_disjointInfo.m_rowCount, joint->m_maxDOF);
+		}
+	}
+}
+
+void dgWorldDynamicUpdate::FlattenSetsKernel(void* const context, void* const worldContext, dgInt32 threadID)
+{
+	D_TRACKTIME();
+	dgClusterBuildDescriptor* const descriptor = (dgClusterBuildDescriptor*)context;
+	dgWorld* const world = (dgWorld*)worldContext;
+	const dgJointInfo* const jointArray = descriptor->m_jointArray;
+	const dgInt32 count = descriptor->m_count;
+
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_CLUSTER_BUILD_JOINTS_PER_JOB); i < count; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_CLUSTER_BUILD_JOINTS_PER_JOB)) {
+		const dgInt32 lastJoint = dgMin(i + DG_CLUSTER_BUILD_JOINTS_PER_JOB, count);
+		for (dgInt32 j = i; j < lastJoint; j++) {
+			const dgConstraint* const joint = jointArray[j].m_joint;
+			dgBody* const body0 = joint->GetBody0();
+			dgBody* const body1 = joint->GetBody1();
+			if (body0->m_invMass.m_w > dgFloat32(0.0f)) {
+				body0->m_disjointInfo.m_parent = world->ConcurrentFindRoot(body0);
+				body0->m_index = -1;
+			}
+			if (body1->m_invMass.m_w > dgFloat32(0.0f)) {
+				body1->m_disjointInfo.m_parent = world->ConcurrentFindRoot(body1);
+				body1->m_index = -1;
+			}
+		}
+	}
+}
+
 dgInt32 dgWorldDynamicUpdate::CompareBodyJacobianPair(const dgBodyJacobianPair* const infoA, const dgBodyJacobianPair* const infoB, void* notUsed)
 {
 	if (infoA->m_bodyIndex < infoB->m_bodyIndex) {
@@ -432,10 +708,19 @@ void dgWorldDynamicUpdate::CalculateClusterReactionForcesKernel (void* const con
 	dgInt32 count = descriptor->m_clusterCount;
 	dgBodyCluster* const clusters = &world->m_clusterData[descriptor->m_firstCluster];
 
+	dgInt32 rowCount = 0;
+	const dgUnsigned64 startTime = dgGetTimeInMicrosenconds();
 	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicCounter, 1); i < count; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicCounter, 1)) {
 		dgBodyCluster* const cluster = &clusters[i]; 
+		rowCount += cluster->m_rowCount;
 		world->ResolveClusterForces (cluster, threadID, timestep);
 	}
+
+	// busy time of this thread, measures the single thread cost of a row for the parallel cut off
+	if (rowCount) {
+		dgAtomicExchangeAndAdd(&descriptor->m_rowCount, rowCount);
+		dgAtomicExchangeAndAdd(&descriptor->m_busyTime, dgInt32 (dgGetTimeInMicrosenconds() - startTime));
+	}
 }
 
 dgInt32 dgWorldDynamicUpdate::GetJacobianDerivatives(dgContraintDescritor& constraintParam, dgJointInfo* const jointInfo, dgConstraint* const constraint, dgLeftHandSide* const leftHandSide, dgRightHandSide* const rightHandSide, dgInt32 rowCount) const
@@ -558,6 +843,28 @@ void dgWorldDynamicUpdate::IntegrateVelocity(const dgBodyCluster* const cluster,
 	const dgFloat32 accelFreeze = world->m_freezeAccel2 * ((cluster->m_jointCount <= DG_SMALL_ISLAND_COUNT) ? dgFloat32(0.009f) : dgFloat32(1.0f));
 	dgVector velocDragVect(velocityDragCoeff, velocityDragCoeff, velocityDragCoeff, dgFloat32(0.0f));
 
+	// let the plugin integrate the moving dynamic bodies in batches
+	const dgWorldPlugin* const plugin = world->GetKernelPlugin(dgWorldPlugin::m_integrateBodiesKernel);
+	if (plugin) {
+		dgInt32 batchCount = 0;
+		dgBody* batch[DG_PLUGIN_INTEGRATION_BATCH_SIZE];
+		for (dgInt32 i = 0; i < count; i++) {
+			dgBody* const body = bodyArray[i].m_body;
+			dgVector isMovingMask(body->m_veloc + body->m_omega + body->m_accel + body->m_alpha);
+			if (((isMovingMask.TestZero().GetSignMask() & 7) != 7) && body->IsRTTIType(dgBody::m_dynamicBodyRTTI)) {
+				batch[batchCount] = body;
+				batchCount++;
+				if (batchCount == DG_PLUGIN_INTEGRATION_BATCH_SIZE) {
+					plugin->IntegrateBodies(batch, batchCount, timestep);
+					batchCount = 0;
+				}
+			}
+		}
+		if (batchCount) {
+			plugin->IntegrateBodies(batch, batchCount, timestep);
+		}
+	}
+
 	bool stackSleeping = true;
 	dgInt32 sleepCounter = 10000;
 	for (dgInt32 i = 0; i < count; i++) {
@@ -568,7 +875,7 @@ void dgWorldDynamicUpdate::IntegrateVelocity(const dgBodyCluster* const cluster,
 		dgVector isMovingMask(body->m_veloc + body->m_omega + body->m_accel + body->m_alpha);
 		if ((isMovingMask.TestZero().GetSignMask() & 7) != 7) {
 			dgAssert(body->m_invMass.m_w);
-			if (body->IsRTTIType(dgBody::m_dynamicBodyRTTI)) {
+			if (!plugin && body->IsRTTIType(dgBody::m_dynamicBodyRTTI)) {
 				body->IntegrateVelocity(timestep);
 			}
 
@@ -670,4 +977,10 @@ void dgWorldDynamicUpdate::IntegrateVelocity(const dgBodyCluster* const cluster,
 			}
 		}
 	}
+
+	// publish the final state of the island bodies to the packed body arrays
+	dgBodyMasterList* const masterList = world;
+	for (dgInt32 i = 0; i < count; i++) {
+		masterList->UpdateBodyState(bodyArray[i].m_body);
+	}
 }
@@ -38,6 +38,12 @@
 
 #define DG_CCD_EXTRA_CONTACT_COUNT			(8 * 3)
 #define DG_PARALLEL_JOINT_COUNT_CUT_OFF		(64)
+#define DG_SOFT_BODY_CLUSTER_KEY			(0x7fffffff)
+#define DG_PARALLEL_CLUSTER_BUILD_CUT_OFF	(1024 * 2)
+#define DG_CLUSTER_BUILD_JOINTS_PER_JOB		(256)
+#define DG_PARALLEL_MIN_JOINT_COUNT			(8)
+#define DG_PARALLEL_SOLVER_PROBE_FRAMES		(64)
+#define DG_PARALLEL_SOLVER_COST_BLEND		dgFloat32 (0.25f)
 //#define DG_PARALLEL_JOINT_COUNT_CUT_OFF	(2)
 
 
@@ -56,6 +62,7 @@
 
 class dgBody;
 class dgDynamicBody;
+class dgClusterBuildDescriptor;
 class dgWorldDynamicUpdateSyncDescriptor;
 
 
@@ -248,8 +255,17 @@ class dgWorldDynamicUpdate
 	static dgInt32 CompareClusterInfos (const dgBodyCluster* const clusterA, const dgBodyCluster* const clusterB, void* notUsed);
 
 	void BuildClusters(dgFloat32 timestep);
+	void BuildDisjointSets(dgJointInfo* const jointArray, dgInt32 jointCount) const;
+	void BuildClusterBodyArray(const dgBodyCluster* const cluster, dgJointInfo* const jointArray) const;
+
+	static void UnionSetsKernel (void* const context, void* const worldContext, dgInt32 threadID);
+	static void CountSetsKernel (void* const context, void* const worldContext, dgInt32 threadID);
+	static void FlattenSetsKernel (void* const context, void* const worldContext, dgInt32 threadID);
+	static void BuildClusterBodyArrayKernel (void* const context, void* const worldContext, dgInt32 threadID);
 
 	dgBodyCluster MergeClusters(const dgBodyCluster* const clusterArray, dgInt32 clustersCount) const;
+	dgInt32 CalculateParallelClustersCount(const dgBodyCluster* const clusterArray, dgInt32 clustersCount);
+	void UpdateSolverCost(dgFloat32& cost, dgUnsigned64 time, dgInt32 rowCount) const;
 	dgInt32 SortClusters(const dgBodyCluster* const cluster, dgFloat32 timestep, dgInt32 threadID) const;
 	
 	static dgInt32 CompareBodyJacobianPair(const dgBodyJacobianPair* const infoA, const dgBodyJacobianPair* const infoB, void* notUsed);
@@ -288,6 +304,9 @@ class dgWorldDynamicUpdate
 	dgInt32 m_softBodiesCount;
 	mutable dgInt32 m_impulseLru;
 	mutable dgInt32 m_softBodyCriticalSectionLock;
+	dgFloat32 m_serialRowCost;
+	dgFloat32 m_parallelRowCost;
+	dgInt32 m_parallelSolverProbe;
 
 	static dgVector m_velocTol;
 
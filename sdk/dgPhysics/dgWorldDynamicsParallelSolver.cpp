@@ -201,8 +201,16 @@ void dgParallelBodySolver::InitWeights()
 			m_skeletonCount ++;
 		}
 	}
-	const dgInt32 conectivity = 7;
-	m_solverPasses += 2 * dgInt32(extraPasses) / conectivity + 1;
+
+	if (m_useGraphColoring) {
+		// joints of a color do not share bodies, so there are not forces to average
+		for (dgInt32 i = 0; i < bodyCount; i++) {
+			weight[i].m_weight = dgFloat32(1.0f);
+		}
+	} else {
+		const dgInt32 conectivity = 7;
+		m_solverPasses += 2 * dgInt32(extraPasses) / conectivity + 1;
+	}
 }
 
 void dgParallelBodySolver::InitBodyArray()
@@ -577,39 +585,43 @@ void dgParallelBodySolver::InitJacobianMatrix()
 	m_world->SynchronizationBarrier();
 
 #ifdef D_USE_SOA_SOLVER
-	dgJointInfo* const jointArray = m_jointArray;
-//	dgSort(jointArray, m_cluster->m_jointCount, CompareJointInfos);
-	dgParallelSort(*m_world, jointArray, m_cluster->m_jointCount, CompareJointInfos);
+	dgInt32 size = 0;
+	if (m_useGraphColoring) {
+		size = ColorJointGraph();
+	} else {
+		dgJointInfo* const jointArray = m_jointArray;
+//		dgSort(jointArray, m_cluster->m_jointCount, CompareJointInfos);
+		dgParallelSort(*m_world, jointArray, m_cluster->m_jointCount, CompareJointInfos);
 
-	const dgInt32 jointCount = m_jointCount * DG_WORK_GROUP_SIZE;
-	for (dgInt32 i = m_cluster->m_jointCount; i < jointCount; i++) {
-		memset(&jointArray[i], 0, sizeof(dgJointInfo));
-	}
+		const dgInt32 jointCount = m_jointCount * DG_WORK_GROUP_SIZE;
+		for (dgInt32 i = m_cluster->m_jointCount; i < jointCount; i++) {
+			memset(&jointArray[i], 0, sizeof(dgJointInfo));
+		}
 
-	dgInt32 size = 0;
-	for (dgInt32 i = 0; i < jointCount; i += DG_WORK_GROUP_SIZE) {
-		const dgConstraint* const joint1 = jointArray[i + DG_WORK_GROUP_SIZE - 1].m_joint;
-		if (joint1) {
-			if (!(joint1->m_body0->m_resting & joint1->m_body1->m_resting)) {
-				const dgConstraint* const joint0 = jointArray[i].m_joint;
-				if (joint0->m_body0->m_resting & joint0->m_body1->m_resting) {
-					SortWorkGroup(i);
+		for (dgInt32 i = 0; i < jointCount; i += DG_WORK_GROUP_SIZE) {
+			const dgConstraint* const joint1 = jointArray[i + DG_WORK_GROUP_SIZE - 1].m_joint;
+			if (joint1) {
+				if (!(joint1->m_body0->m_resting & joint1->m_body1->m_resting)) {
+					const dgConstraint* const joint0 = jointArray[i].m_joint;
+					if (joint0->m_body0->m_resting & joint0->m_body1->m_resting) {
+						SortWorkGroup(i);
+					}
 				}
-			}
-			for (dgInt32 j = 0; j < DG_WORK_GROUP_SIZE; j++) {
-				dgConstraint* const joint = jointArray[i + j].m_joint;
-				joint->m_index = i + j;
-			}
-		} else {
-			SortWorkGroup(i);
-			for (dgInt32 j = 0; j < DG_WORK_GROUP_SIZE; j ++) {
-				dgConstraint* const joint = jointArray[i + j].m_joint;
-				if (joint) {
+				for (dgInt32 j = 0; j < DG_WORK_GROUP_SIZE; j++) {
+					dgConstraint* const joint = jointArray[i + j].m_joint;
 					joint->m_index = i + j;
 				}
+			} else {
+				SortWorkGroup(i);
+				for (dgInt32 j = 0; j < DG_WORK_GROUP_SIZE; j ++) {
+					dgConstraint* const joint = jointArray[i + j].m_joint;
+					if (joint) {
+						joint->m_index = i + j;
+					}
+				}
 			}
+			size += jointArray[i].m_pairCount;
 		}
-		size += jointArray[i].m_pairCount;
 	}
 	m_massMatrix.ResizeIfNecessary(size);
 
@@ -621,6 +633,94 @@ void dgParallelBodySolver::InitJacobianMatrix()
 #endif
 }
 
+dgInt32 dgParallelBodySolver::ColorJointGraph()
+{
+	DG_TRACKTIME();
+	const dgInt32 jointCount = m_cluster->m_jointCount;
+	const dgInt32 bodyCount = m_cluster->m_bodyCount;
+	const dgJointInfo* const jointArray = m_jointArray;
+
+	dgArenaMemoryAllocator* const stepAllocator = m_world->GetStepAllocator(0);
+	dgInt32* const jointColor = stepAllocator->AllocArray<dgInt32>(jointCount);
+	dgUnsigned64* const bodyColors = stepAllocator->AllocArray<dgUnsigned64>(bodyCount);
+	memset(bodyColors, 0, bodyCount * sizeof(dgUnsigned64));
+
+	dgInt32 colorCount[DG_SOLVER_MAX_COLORS + 1];
+	dgInt32 colorStart[DG_SOLVER_MAX_COLORS + 1];
+	memset(colorCount, 0, sizeof(colorCount));
+
+	// greedy coloring, each joint takes the lowest color not used by any of its bodies.
+	// the static body (index zero) is never written by the solver, so it does not take colors
+	for (dgInt32 i = 0; i < jointCount; i++) {
+		const dgInt32 m0 = jointArray[i].m_m0;
+		const dgInt32 m1 = jointArray[i].m_m1;
+		const dgUnsigned64 freeColors = ~(bodyColors[m0] | bodyColors[m1]);
+		dgInt32 color = DG_SOLVER_MAX_COLORS;
+		if (freeColors) {
+			const dgUnsigned64 bit = freeColors & (~freeColors + 1);
+			for (color = 0; !(bit & (dgUnsigned64(1) << color)); color++);
+			if (m0) {
+				bodyColors[m0] |= bit;
+			}
+			if (m1) {
+				bodyColors[m1] |= bit;
+			}
+		}
+		jointColor[i] = color;
+		colorCount[color]++;
+	}
+
+	// each color is padded to whole work groups. joints that run out of colors may share 
+	// bodies, so they get a work group each and their color is solved by a single thread.
+	dgInt32 groupCount = 0;
+	m_colorCount = 0;
+	for (dgInt32 i = 0; i <= DG_SOLVER_MAX_COLORS; i++) {
+		colorStart[i] = groupCount * DG_WORK_GROUP_SIZE;
+		if (colorCount[i]) {
+			m_colorGroupStart[m_colorCount] = groupCount;
+			groupCount += (i == DG_SOLVER_MAX_COLORS) ? colorCount[i] : (colorCount[i] + DG_WORK_GROUP_SIZE - 1) / DG_WORK_GROUP_SIZE;
+			m_colorCount++;
+		}
+	}
+	m_colorGroupStart[m_colorCount] = groupCount;
+
+	const dgInt32 paddedCount = groupCount * DG_WORK_GROUP_SIZE;
+	m_coloredJointArray.ResizeIfNecessary(paddedCount);
+	dgJointInfo* const coloredJointArray = &m_coloredJointArray[0];
+	memset(coloredJointArray, 0, paddedCount * sizeof(dgJointInfo));
+
+	dgInt32 colorIndex[DG_SOLVER_MAX_COLORS + 1];
+	memcpy(colorIndex, colorStart, sizeof(colorIndex));
+	for (dgInt32 i = 0; i < jointCount; i++) {
+		const dgInt32 color = jointColor[i];
+		coloredJointArray[colorIndex[color]] = jointArray[i];
+		colorIndex[color] += (color == DG_SOLVER_MAX_COLORS) ? DG_WORK_GROUP_SIZE : 1;
+	}
+
+	for (dgInt32 i = 0; i < DG_SOLVER_MAX_COLORS; i++) {
+		if (colorCount[i] > 1) {
+			dgSort(&coloredJointArray[colorStart[i]], colorCount[i], CompareJointInfos);
+		}
+	}
+
+	m_jointCount = groupCount;
+	m_jointInfoCount = paddedCount;
+	m_jointArray = coloredJointArray;
+
+	dgInt32 size = 0;
+	for (dgInt32 i = 0; i < paddedCount; i += DG_WORK_GROUP_SIZE) {
+		SortWorkGroup(i);
+		for (dgInt32 j = 0; j < DG_WORK_GROUP_SIZE; j++) {
+			dgConstraint* const joint = coloredJointArray[i + j].m_joint;
+			if (joint) {
+				joint->m_index = i + j;
+			}
+		}
+		size += coloredJointArray[i].m_pairCount;
+	}
+	return size;
+}
+
 void dgParallelBodySolver::InitBodyArray(dgInt32 threadID)
 {
 	const dgBodyInfo* const bodyArray = m_bodyArray;
@@ -653,16 +753,18 @@ void dgParallelBodySolver::CalculateJointsAcceleration(dgInt32 threadID)
 	const dgLeftHandSide* const leftHandSide = &m_world->m_solverMemory.m_leftHandSizeBuffer[0];
 
 	const dgInt32 step = m_threadCounts;
-	const dgInt32 jointCount = m_cluster->m_jointCount;
+	const dgInt32 jointCount = m_jointInfoCount;
 	for (dgInt32 i = threadID; i < jointCount; i += step) {
 		dgJointInfo* const jointInfo = &m_jointArray[i];
 		dgConstraint* const constraint = jointInfo->m_joint;
-		const dgInt32 pairStart = jointInfo->m_pairStart;
-		joindDesc.m_rowsCount = jointInfo->m_pairCount;
-		joindDesc.m_leftHandSide = &leftHandSide[pairStart];
-		joindDesc.m_rightHandSide = &rightHandSide[pairStart];
+		if (constraint) {
+			const dgInt32 pairStart = jointInfo->m_pairStart;
+			joindDesc.m_rowsCount = jointInfo->m_pairCount;
+			joindDesc.m_leftHandSide = &leftHandSide[pairStart];
+			joindDesc.m_rightHandSide = &rightHandSide[pairStart];
 
-		constraint->JointAccelerations(&joindDesc);
+			constraint->JointAccelerations(&joindDesc);
+		}
 	}
 }
 
@@ -682,10 +784,10 @@ void dgParallelBodySolver::CalculateBodiesAcceleration(dgInt32 threadID)
 void dgParallelBodySolver::UpdateKinematicFeedback(dgInt32 threadID)
 {
 	const dgInt32 step = m_threadCounts;
-	const dgInt32 jointCount = m_cluster->m_jointCount;
+	const dgInt32 jointCount = m_jointInfoCount;
 	for (dgInt32 i = threadID; i < jointCount; i += step) {
 		dgJointInfo* const jointInfo = &m_jointArray[i];
-		if (jointInfo->m_joint->m_updaFeedbackCallback) {
+		if (jointInfo->m_joint && jointInfo->m_joint->m_updaFeedbackCallback) {
 			jointInfo->m_joint->m_updaFeedbackCallback(*jointInfo->m_joint, m_timestep, threadID);
 		}
 	}
@@ -725,20 +827,22 @@ void dgParallelBodySolver::UpdateForceFeedback(dgInt32 threadID)
 	dgInt32 hasJointFeeback = 0;
 
 	const dgInt32 step = m_threadCounts;
-	const dgInt32 jointCount = m_cluster->m_jointCount;
+	const dgInt32 jointCount = m_jointInfoCount;
 	for (dgInt32 i = threadID; i < jointCount; i += step) {
 		dgJointInfo* const jointInfo = &m_jointArray[i];
 		dgConstraint* const constraint = jointInfo->m_joint;
-		const dgInt32 first = jointInfo->m_pairStart;
-		const dgInt32 count = jointInfo->m_pairCount;
-
-		for (dgInt32 j = 0; j < count; j++) {
-			const dgRightHandSide* const rhs = &rightHandSide[j + first];
-			dgAssert(dgCheckFloat(rhs->m_force));
-			rhs->m_jointFeebackForce->m_force = rhs->m_force;
-			rhs->m_jointFeebackForce->m_impact = rhs->m_maxImpact * m_timestepRK;
+		if (constraint) {
+			const dgInt32 first = jointInfo->m_pairStart;
+			const dgInt32 count = jointInfo->m_pairCount;
+
+			for (dgInt32 j = 0; j < count; j++) {
+				const dgRightHandSide* const rhs = &rightHandSide[j + first];
+				dgAssert(dgCheckFloat(rhs->m_force));
+				rhs->m_jointFeebackForce->m_force = rhs->m_force;
+				rhs->m_jointFeebackForce->m_impact = rhs->m_maxImpact * m_timestepRK;
+			}
+			hasJointFeeback |= (constraint->m_updaFeedbackCallback ? 1 : 0);
 		}
-		hasJointFeeback |= (constraint->m_updaFeedbackCallback ? 1 : 0);
 	}
 	m_hasJointFeeback[threadID] = hasJointFeeback;
 }
@@ -825,29 +929,62 @@ void dgParallelBodySolver::CalculateJointsAcceleration()
 #endif
 }
 
+dgInt32 dgParallelBodySolver::CompareSkeletons(dgSkeletonContainer* const* const skeletonA, dgSkeletonContainer* const* const skeletonB, void* notUsed)
+{
+	// heavier skeletons go first so that the last job of each pass is a small one
+	const dgInt32 countA = (*skeletonA)->GetRowCount() + (*skeletonA)->GetAuxiliaryRowCount() * (*skeletonA)->GetJointCount();
+	const dgInt32 countB = (*skeletonB)->GetRowCount() + (*skeletonB)->GetAuxiliaryRowCount() * (*skeletonB)->GetJointCount();
+	if (countA < countB) {
+		return 1;
+	}
+	if (countA > countB) {
+		return -1;
+	}
+	return 0;
+}
+
 void dgParallelBodySolver::InitSkeletons(dgInt32 threadID)
 {
 	dgRightHandSide* const rightHandSide = &m_world->m_solverMemory.m_righHandSizeBuffer[0];
 	const dgLeftHandSide* const leftHandSide = &m_world->m_solverMemory.m_leftHandSizeBuffer[0];
 
 	const dgInt32 count = m_skeletonCount;
-	const dgInt32 threadCounts = m_world->GetThreadCount();
 	dgSkeletonContainer** const skeletonArray = &m_skeletonArray[0];
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&m_skeletonAtomicIndex, 1); i < count; i = dgAtomicExchangeAndAdd(&m_skeletonAtomicIndex, 1)) {
+		dgSkeletonContainer* const skeleton = skeletonArray[i];
+		skeleton->FactorizeMassMatrix(m_jointArray, leftHandSide, rightHandSide);
+	}
+}
+
+void dgParallelBodySolver::CalculateSkeletonsLoopForces(dgInt32 threadID)
+{
+	const dgInt32 count = m_skeletonLoopJobsCount;
+	const dgSkeletonLoopJob* const jobs = &m_skeletonLoopJobs[0];
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&m_skeletonAtomicIndex, 1); i < count; i = dgAtomicExchangeAndAdd(&m_skeletonAtomicIndex, 1)) {
+		const dgSkeletonLoopJob& job = jobs[i];
+		job.m_skeleton->CalculateLoopDeltaForces(job.m_firstRow, job.m_rowCount);
+	}
+}
 
-	for (dgInt32 i = threadID; i < count; i += threadCounts) {
+void dgParallelBodySolver::FinalizeSkeletons(dgInt32 threadID)
+{
+	const dgInt32 count = m_skeletonCount;
+	dgSkeletonContainer** const skeletonArray = &m_skeletonArray[0];
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&m_skeletonAtomicIndex, 1); i < count; i = dgAtomicExchangeAndAdd(&m_skeletonAtomicIndex, 1)) {
 		dgSkeletonContainer* const skeleton = skeletonArray[i];
-		skeleton->InitMassMatrix(m_jointArray, leftHandSide, rightHandSide);
+		if (skeleton->GetAuxiliaryRowCount()) {
+			skeleton->FinalizeLoopMassMatrix();
+		}
 	}
 }
 
 void dgParallelBodySolver::UpdateSkeletons(dgInt32 threadID)
 {
 	const dgInt32 count = m_skeletonCount;
-	const dgInt32 threadCounts = m_world->GetThreadCount();
 	dgSkeletonContainer** const skeletonArray = &m_skeletonArray[0];
 	dgJacobian* const internalForces = &m_world->m_solverMemory.m_internalForcesBuffer[0];
 
-	for (dgInt32 i = threadID; i < count; i += threadCounts) {
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&m_skeletonAtomicIndex, 1); i < count; i = dgAtomicExchangeAndAdd(&m_skeletonAtomicIndex, 1)) {
 		dgSkeletonContainer* const skeleton = skeletonArray[i];
 		skeleton->CalculateJointForce(m_jointArray, m_bodyArray, internalForces);
 	}
@@ -859,6 +996,18 @@ void dgParallelBodySolver::InitSkeletonsKernel(void* const context, void* const,
 	me->InitSkeletons(threadID);
 }
 
+void dgParallelBodySolver::CalculateSkeletonsLoopForcesKernel(void* const context, void* const, dgInt32 threadID)
+{
+	dgParallelBodySolver* const me = (dgParallelBodySolver*)context;
+	me->CalculateSkeletonsLoopForces(threadID);
+}
+
+void dgParallelBodySolver::FinalizeSkeletonsKernel(void* const context, void* const, dgInt32 threadID)
+{
+	dgParallelBodySolver* const me = (dgParallelBodySolver*)context;
+	me->FinalizeSkeletons(threadID);
+}
+
 void dgParallelBodySolver::UpdateSkeletonsKernel(void* const context, void* const, dgInt32 threadID)
 {
 	dgParallelBodySolver* const me = (dgParallelBodySolver*)context;
@@ -867,16 +1016,58 @@ void dgParallelBodySolver::UpdateSkeletonsKernel(void* const context, void* cons
 
 void dgParallelBodySolver::InitSkeletons()
 {
+	if (!m_skeletonCount) {
+		return;
+	}
+
 	const dgInt32 threadCounts = m_world->GetThreadCount();
+	m_skeletonAtomicIndex = 0;
 	for (dgInt32 i = 0; i < threadCounts; i++) {
 		m_world->QueueJob(InitSkeletonsKernel, this, NULL, "dgParallelBodySolver::InitSkeletonsKernel");
 	}
 	m_world->SynchronizationBarrier();
+
+	// row counts are only known after the factorization
+	dgSort(&m_skeletonArray[0], m_skeletonCount, CompareSkeletons);
+
+	// the loop rows of each skeleton are independent solves of its tree, 
+	// they are cut in small jobs so that one big skeleton does not run on a single thread.
+	m_skeletonLoopJobsCount = 0;
+	for (dgInt32 i = 0; i < m_skeletonCount; i++) {
+		dgSkeletonContainer* const skeleton = m_skeletonArray[i];
+		const dgInt32 auxiliaryRowCount = skeleton->GetAuxiliaryRowCount();
+		for (dgInt32 j = 0; j < auxiliaryRowCount; j += DG_SKELETON_LOOP_ROWS_PER_JOB) {
+			dgSkeletonLoopJob& job = m_skeletonLoopJobs[m_skeletonLoopJobsCount];
+			job.m_skeleton = skeleton;
+			job.m_firstRow = j;
+			job.m_rowCount = DG_SKELETON_LOOP_ROWS_PER_JOB;
+			m_skeletonLoopJobsCount++;
+		}
+	}
+
+	if (m_skeletonLoopJobsCount) {
+		m_skeletonAtomicIndex = 0;
+		for (dgInt32 i = 0; i < threadCounts; i++) {
+			m_world->QueueJob(CalculateSkeletonsLoopForcesKernel, this, NULL, "dgParallelBodySolver::CalculateSkeletonsLoopForces");
+		}
+		m_world->SynchronizationBarrier();
+
+		m_skeletonAtomicIndex = 0;
+		for (dgInt32 i = 0; i < threadCounts; i++) {
+			m_world->QueueJob(FinalizeSkeletonsKernel, this, NULL, "dgParallelBodySolver::FinalizeSkeletons");
+		}
+		m_world->SynchronizationBarrier();
+	}
 }
 
 void dgParallelBodySolver::UpdateSkeletons()
 {
+	if (!m_skeletonCount) {
+		return;
+	}
+
 	const dgInt32 threadCounts = m_world->GetThreadCount();
+	m_skeletonAtomicIndex = 0;
 	for (dgInt32 i = 0; i < threadCounts; i++) {
 		m_world->QueueJob(UpdateSkeletonsKernel, this, NULL, "dgParallelBodySolver::UpdateSkeletons");
 	}
@@ -886,19 +1077,9 @@ void dgParallelBodySolver::UpdateSkeletons()
 
 #ifdef D_USE_SOA_SOLVER
 
-dgFloat32 dgParallelBodySolver::CalculateJointForce(const dgJointInfo* const jointInfo, dgSolverSoaElement* const massMatrix, const dgJacobian* const internalForcesPtr) const
+DG_INLINE void dgParallelBodySolver::GatherBodyForces(const dgJointInfo* const jointInfo, const dgJacobian* const internalForcesPtr, dgWorkGroupVector6& forceM0, dgWorkGroupVector6& forceM1) const
 {
-	dgWorkGroupVector6 forceM0;
-	dgWorkGroupVector6 forceM1;
-	dgWorkGroupFloat weight0;
-	dgWorkGroupFloat weight1;
-	dgWorkGroupFloat preconditioner0;
-	dgWorkGroupFloat preconditioner1;
-	dgWorkGroupFloat accNorm(m_zero);
-	dgWorkGroupFloat normalForce[DG_CONSTRAINT_MAX_ROWS + 1];
-	const dgBodyProxy* const bodyProxyArray = m_bodyProxyArray;
 	const dgWorkGroupFloat* const internalForces = (dgWorkGroupFloat*)internalForcesPtr;
-
 	for (dgInt32 i = 0; i < DG_WORK_GROUP_SIZE; i++) {
 		const dgInt32 m0 = jointInfo[i].m_m0;
 		const dgInt32 m1 = jointInfo[i].m_m1;
@@ -916,30 +1097,13 @@ dgFloat32 dgParallelBodySolver::CalculateJointForce(const dgJointInfo* const joi
 		forceM1.m_angular.m_x[i] = internalForces[m1][4];
 		forceM1.m_angular.m_y[i] = internalForces[m1][5];
 		forceM1.m_angular.m_z[i] = internalForces[m1][6];
-
-		weight0[i] = bodyProxyArray[m0].m_weight;
-		weight1[i] = bodyProxyArray[m1].m_weight;
-
-		preconditioner0[i] = jointInfo[i].m_preconditioner0;
-		preconditioner1[i] = jointInfo[i].m_preconditioner1;
 	}
+}
 
-	forceM0.m_linear.m_x = forceM0.m_linear.m_x * preconditioner0;
-	forceM0.m_linear.m_y = forceM0.m_linear.m_y * preconditioner0;
-	forceM0.m_linear.m_z = forceM0.m_linear.m_z * preconditioner0;
-	forceM0.m_angular.m_x = forceM0.m_angular.m_x * preconditioner0;
-	forceM0.m_angular.m_y = forceM0.m_angular.m_y * preconditioner0;
-	forceM0.m_angular.m_z = forceM0.m_angular.m_z * preconditioner0;
-
-	forceM1.m_linear.m_x = forceM1.m_linear.m_x * preconditioner1;
-	forceM1.m_linear.m_y = forceM1.m_linear.m_y * preconditioner1;
-	forceM1.m_linear.m_z = forceM1.m_linear.m_z * preconditioner1;
-	forceM1.m_angular.m_x = forceM1.m_angular.m_x * preconditioner1;
-	forceM1.m_angular.m_y = forceM1.m_angular.m_y * preconditioner1;
-	forceM1.m_angular.m_z = forceM1.m_angular.m_z * preconditioner1;
-
-	preconditioner0 = preconditioner0 * weight0;
-	preconditioner1 = preconditioner1 * weight1;
+DG_INLINE dgFloat32 dgParallelBodySolver::SolveJointRows(const dgJointInfo* const jointInfo, dgSolverSoaElement* const massMatrix, dgWorkGroupVector6& forceM0, dgWorkGroupVector6& forceM1, const dgWorkGroupFloat& preconditioner0, const dgWorkGroupFloat& preconditioner1) const
+{
+	dgWorkGroupFloat accNorm(m_zero);
+	dgWorkGroupFloat normalForce[DG_CONSTRAINT_MAX_ROWS + 1];
 
 	const dgInt32 rowsCount = jointInfo->m_pairCount;
 	normalForce[0] = m_one;
@@ -1056,6 +1220,48 @@ dgFloat32 dgParallelBodySolver::CalculateJointForce(const dgJointInfo* const joi
 	return accNorm.AddHorizontal();
 }
 
+dgFloat32 dgParallelBodySolver::CalculateJointForce(const dgJointInfo* const jointInfo, dgSolverSoaElement* const massMatrix, const dgJacobian* const internalForces) const
+{
+	dgWorkGroupVector6 forceM0;
+	dgWorkGroupVector6 forceM1;
+	dgWorkGroupFloat weight0;
+	dgWorkGroupFloat weight1;
+	dgWorkGroupFloat preconditioner0;
+	dgWorkGroupFloat preconditioner1;
+	const dgBodyProxy* const bodyProxyArray = m_bodyProxyArray;
+
+	GatherBodyForces(jointInfo, internalForces, forceM0, forceM1);
+	for (dgInt32 i = 0; i < DG_WORK_GROUP_SIZE; i++) {
+		const dgInt32 m0 = jointInfo[i].m_m0;
+		const dgInt32 m1 = jointInfo[i].m_m1;
+
+		weight0[i] = bodyProxyArray[m0].m_weight;
+		weight1[i] = bodyProxyArray[m1].m_weight;
+
+		preconditioner0[i] = jointInfo[i].m_preconditioner0;
+		preconditioner1[i] = jointInfo[i].m_preconditioner1;
+	}
+
+	forceM0.m_linear.m_x = forceM0.m_linear.m_x * preconditioner0;
+	forceM0.m_linear.m_y = forceM0.m_linear.m_y * preconditioner0;
+	forceM0.m_linear.m_z = forceM0.m_linear.m_z * preconditioner0;
+	forceM0.m_angular.m_x = forceM0.m_angular.m_x * preconditioner0;
+	forceM0.m_angular.m_y = forceM0.m_angular.m_y * preconditioner0;
+	forceM0.m_angular.m_z = forceM0.m_angular.m_z * preconditioner0;
+
+	forceM1.m_linear.m_x = forceM1.m_linear.m_x * preconditioner1;
+	forceM1.m_linear.m_y = forceM1.m_linear.m_y * preconditioner1;
+	forceM1.m_linear.m_z = forceM1.m_linear.m_z * preconditioner1;
+	forceM1.m_angular.m_x = forceM1.m_angular.m_x * preconditioner1;
+	forceM1.m_angular.m_y = forceM1.m_angular.m_y * preconditioner1;
+	forceM1.m_angular.m_z = forceM1.m_angular.m_z * preconditioner1;
+
+	preconditioner0 = preconditioner0 * weight0;
+	preconditioner1 = preconditioner1 * weight1;
+
+	return SolveJointRows(jointInfo, massMatrix, forceM0, forceM1, preconditioner0, preconditioner1);
+}
+
 void dgParallelBodySolver::CalculateJointsForce(dgInt32 threadID)
 {
 	const dgInt32* const soaRowStart = m_soaRowStart;
@@ -1169,6 +1375,100 @@ void dgParallelBodySolver::CalculateJointsForce(dgInt32 threadID)
 	m_accelNorm[threadID] = accNorm;
 }
 
+void dgParallelBodySolver::CalculateJointsForceColored(dgInt32 threadID)
+{
+	const dgInt32* const soaRowStart = m_soaRowStart;
+	const dgBodyInfo* const bodyArray = m_bodyArray;
+	dgJacobian* const internalForces = &m_world->m_solverMemory.m_internalForcesBuffer[0];
+	dgRightHandSide* const rightHandSide = &m_world->m_solverMemory.m_righHandSizeBuffer[0];
+	dgSolverSoaElement* const massMatrix = &m_massMatrix[0];
+	dgFloat32 accNorm = dgFloat32(0.0f);
+
+	// joints of the same color do not share bodies, so each work group reads 
+	// and writes the body forces in place, the same as the sequential solver.
+	const dgInt32 firstGroup = m_colorFirstGroup;
+	const dgInt32 groupCount = m_colorGroupCount;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&m_colorAtomicIndex, 1); i < groupCount; i = dgAtomicExchangeAndAdd(&m_colorAtomicIndex, 1)) {
+		const dgInt32 group = firstGroup + i;
+		const dgInt32 rowStart = soaRowStart[group];
+		const dgJointInfo* const jointInfo = &m_jointArray[group * DG_WORK_GROUP_SIZE];
+
+		bool isSleeping = true;
+		for (dgInt32 j = 0; (j < DG_WORK_GROUP_SIZE) && isSleeping; j++) {
+			const dgBody* const body0 = bodyArray[jointInfo[j].m_m0].m_body;
+			const dgBody* const body1 = bodyArray[jointInfo[j].m_m1].m_body;
+			isSleeping &= body0->m_resting;
+			isSleeping &= body1->m_resting;
+		}
+
+		if (!isSleeping) {
+			dgWorkGroupVector6 forceM0;
+			dgWorkGroupVector6 forceM1;
+			dgWorkGroupFloat preconditioner0;
+			dgWorkGroupFloat preconditioner1;
+
+			GatherBodyForces(jointInfo, internalForces, forceM0, forceM1);
+			for (dgInt32 j = 0; j < DG_WORK_GROUP_SIZE; j++) {
+				preconditioner0[j] = jointInfo[j].m_preconditioner0;
+				preconditioner1[j] = jointInfo[j].m_preconditioner1;
+			}
+			accNorm += SolveJointRows(jointInfo, &massMatrix[rowStart], forceM0, forceM1, preconditioner0, preconditioner1);
+
+			for (dgInt32 j = 0; j < DG_WORK_GROUP_SIZE; j++) {
+				const dgJointInfo* const joint = &jointInfo[j];
+				if (joint->m_joint) {
+					const dgInt32 rowCount = joint->m_pairCount;
+					const dgInt32 rowStartBase = joint->m_pairStart;
+					for (dgInt32 k = 0; k < rowCount; k++) {
+						const dgSolverSoaElement* const row = &massMatrix[rowStart + k];
+						rightHandSide[k + rowStartBase].m_force = row->m_force[j];
+						rightHandSide[k + rowStartBase].m_maxImpact = dgMax(dgAbs(row->m_force[j]), rightHandSide[k + rowStartBase].m_maxImpact);
+					}
+
+					const dgInt32 m0 = joint->m_m0;
+					const dgInt32 m1 = joint->m_m1;
+					if (m0) {
+						internalForces[m0].m_linear = dgVector(forceM0.m_linear.m_x[j], forceM0.m_linear.m_y[j], forceM0.m_linear.m_z[j], dgFloat32(0.0f));
+						internalForces[m0].m_angular = dgVector(forceM0.m_angular.m_x[j], forceM0.m_angular.m_y[j], forceM0.m_angular.m_z[j], dgFloat32(0.0f));
+					}
+					if (m1) {
+						internalForces[m1].m_linear = dgVector(forceM1.m_linear.m_x[j], forceM1.m_linear.m_y[j], forceM1.m_linear.m_z[j], dgFloat32(0.0f));
+						internalForces[m1].m_angular = dgVector(forceM1.m_angular.m_x[j], forceM1.m_angular.m_y[j], forceM1.m_angular.m_z[j], dgFloat32(0.0f));
+					}
+				}
+			}
+		}
+	}
+	m_accelNorm[threadID] += accNorm;
+}
+
+void dgParallelBodySolver::CalculateJointsForceColoredKernel(void* const context, void* const, dgInt32 threadID)
+{
+	dgParallelBodySolver* const me = (dgParallelBodySolver*)context;
+	me->CalculateJointsForceColored(threadID);
+}
+
+void dgParallelBodySolver::CalculateJointsForceColored()
+{
+	for (dgInt32 i = 0; i < m_threadCounts; i++) {
+		m_accelNorm[i] = dgFloat32(0.0f);
+	}
+
+	for (dgInt32 i = 0; i < m_colorCount; i++) {
+		m_colorAtomicIndex = 0;
+		m_colorFirstGroup = m_colorGroupStart[i];
+		m_colorGroupCount = m_colorGroupStart[i + 1] - m_colorFirstGroup;
+
+		// the groups of the overflow color may share bodies
+		const bool isOverflow = (i == DG_SOLVER_MAX_COLORS);
+		const dgInt32 jobs = isOverflow ? 1 : dgMin(m_threadCounts, m_colorGroupCount);
+		for (dgInt32 j = 0; j < jobs; j++) {
+			m_world->QueueJob(CalculateJointsForceColoredKernel, this, NULL, "dgParallelBodySolver::CalculateJointsForceColored");
+		}
+		m_world->SynchronizationBarrier();
+	}
+}
+
 #else
 
 void dgParallelBodySolver::CalculateJointsForce(dgInt32 threadID)
@@ -1338,19 +1638,30 @@ void dgParallelBodySolver::CalculateForces()
 	const dgInt32 threadCounts = m_world->GetThreadCount();
 
 	InitSkeletons();
+	dgInt32 executedPasses = 0;
 	for (dgInt32 step = 0; step < 4; step++) {
 		CalculateJointsAcceleration();
 		dgFloat32 accNorm = DG_SOLVER_MAX_ERROR * dgFloat32(2.0f);
 		for (dgInt32 k = 0; (k < passes) && (accNorm > DG_SOLVER_MAX_ERROR); k++) {
+#ifdef D_USE_SOA_SOLVER
+			if (m_useGraphColoring) {
+				CalculateJointsForceColored();
+			} else {
+				CalculateJointsForce();
+			}
+#else
 			CalculateJointsForce();
+#endif
 			accNorm = dgFloat32(0.0f);
 			for (dgInt32 i = 0; i < threadCounts; i++) {
 				accNorm = dgMax(accNorm, m_accelNorm[i]);
 			}
+			executedPasses ++;
 		}
 		UpdateSkeletons();
 		IntegrateBodiesVelocity();
 	}
+	m_world->ReportSolverPasses(executedPasses);
 
 	UpdateForceFeedback();
 
@@ -1380,9 +1691,19 @@ void dgParallelBodySolver::CalculateJointForces(const dgBodyCluster& cluster, dg
 	m_solverPasses = m_world->GetSolverIterations();
 	m_threadCounts = m_world->GetThreadCount();
 	m_jointCount = ((m_cluster->m_jointCount + DG_WORK_GROUP_SIZE - 1) & -dgInt32(DG_WORK_GROUP_SIZE - 1)) / DG_WORK_GROUP_SIZE;
+	m_jointInfoCount = m_cluster->m_jointCount;
+
+#ifdef D_USE_SOA_SOLVER
+	m_useGraphColoring = (m_world->m_useParallelSolver == DG_PARALLEL_SOLVER_GRAPH_COLORING) ? 1 : 0;
+#else
+	m_useGraphColoring = 0;
+#endif
 
-	m_soaRowStart = dgAlloca(dgInt32, m_jointCount);
-	m_bodyProxyArray = dgAlloca(dgBodyProxy, cluster.m_bodyCount);
+	// padding each color to whole work groups can add up to a group per color, and a group per overflow joint
+	// the solver runs from the serial part of the update, its scratch goes in the serial step arena
+	dgArenaMemoryAllocator* const stepAllocator = m_world->GetStepAllocator(0);
+	m_soaRowStart = stepAllocator->AllocArray<dgInt32>(m_useGraphColoring ? m_cluster->m_jointCount + DG_SOLVER_MAX_COLORS + 1 : m_jointCount);
+	m_bodyProxyArray = stepAllocator->AllocArray<dgBodyProxy>(cluster.m_bodyCount);
 
 	InitWeights();
 	InitBodyArray();
@@ -30,6 +30,7 @@ class dgBodyCluster;
 class dgSkeletonContainer;
 
 #define DG_WORK_GROUP_SIZE	8 
+#define DG_SOLVER_MAX_COLORS	64
 
 DG_MSC_VECTOR_ALIGMENT
 class dgWorkGroupFloat
@@ -205,6 +206,14 @@ class dgParallelBodySolver
 		dgInt32 m_lock;
 	};
 
+	class dgSkeletonLoopJob
+	{
+		public:
+		dgSkeletonContainer* m_skeleton;
+		dgInt32 m_firstRow;
+		dgInt32 m_rowCount;
+	};
+
 	~dgParallelBodySolver() {}
 	dgParallelBodySolver(dgMemoryAllocator* const allocator);
 
@@ -219,6 +228,7 @@ class dgParallelBodySolver
 	void InitJacobianMatrix();
 	void UpdateForceFeedback();
 	void CalculateJointsForce();
+	void CalculateJointsForceColored();
 	void IntegrateBodiesVelocity();
 	void UpdateKinematicFeedback();
 	void CalculateJointsAcceleration();
@@ -227,10 +237,13 @@ class dgParallelBodySolver
 	void InitBodyArray(dgInt32 threadID);
 	void InitSkeletons(dgInt32 threadID);
 	void UpdateSkeletons(dgInt32 threadID);
+	void FinalizeSkeletons(dgInt32 threadID);
+	void CalculateSkeletonsLoopForces(dgInt32 threadID);
 	void InitJacobianMatrix(dgInt32 threadID);
 	void UpdateForceFeedback(dgInt32 threadID);
 	void TransposeMassMatrix(dgInt32 threadID);
 	void CalculateJointsForce(dgInt32 threadID);
+	void CalculateJointsForceColored(dgInt32 threadID);
 	void UpdateRowAcceleration(dgInt32 threadID);
 	void IntegrateBodiesVelocity(dgInt32 threadID);
 	void UpdateKinematicFeedback(dgInt32 threadID);
@@ -240,10 +253,13 @@ class dgParallelBodySolver
 	static void InitSkeletonsKernel(void* const context, void* const, dgInt32 threadID);
 	static void InitBodyArrayKernel(void* const context, void* const, dgInt32 threadID);
 	static void UpdateSkeletonsKernel(void* const context, void* const, dgInt32 threadID);
+	static void FinalizeSkeletonsKernel(void* const context, void* const, dgInt32 threadID);
+	static void CalculateSkeletonsLoopForcesKernel(void* const context, void* const, dgInt32 threadID);
 	static void InitJacobianMatrixKernel(void* const context, void* const, dgInt32 threadID);
 	static void UpdateForceFeedbackKernel(void* const context, void* const, dgInt32 threadID);
 	static void TransposeMassMatrixKernel(void* const context, void* const, dgInt32 threadID);
 	static void CalculateJointsForceKernel(void* const context, void* const, dgInt32 threadID);
+	static void CalculateJointsForceColoredKernel(void* const context, void* const, dgInt32 threadID);
 	static void UpdateRowAccelerationKernel(void* const context, void* const, dgInt32 threadID);
 	static void IntegrateBodiesVelocityKernel(void* const context, void* const, dgInt32 threadID);
 	static void UpdateKinematicFeedbackKernel(void* const context, void* const, dgInt32 threadID);
@@ -251,8 +267,12 @@ class dgParallelBodySolver
 	static void CalculateJointsAccelerationKernel(void* const context, void* const, dgInt32 threadID);
 
 	static dgInt32 CompareJointInfos(const dgJointInfo* const infoA, const dgJointInfo* const infoB, void* notUsed);
+	static dgInt32 CompareSkeletons(dgSkeletonContainer* const* const skeletonA, dgSkeletonContainer* const* const skeletonB, void* notUsed);
 
+	dgInt32 ColorJointGraph();
 	dgFloat32 CalculateJointForce(const dgJointInfo* const jointInfo, dgSolverSoaElement* const massMatrix, const dgJacobian* const internalForces) const;
+	DG_INLINE void GatherBodyForces(const dgJointInfo* const jointInfo, const dgJacobian* const internalForces, dgWorkGroupVector6& forceM0, dgWorkGroupVector6& forceM1) const;
+	DG_INLINE dgFloat32 SolveJointRows(const dgJointInfo* const jointInfo, dgSolverSoaElement* const massMatrix, dgWorkGroupVector6& forceM0, dgWorkGroupVector6& forceM1, const dgWorkGroupFloat& preconditioner0, const dgWorkGroupFloat& preconditioner1) const;
 	DG_INLINE void SortWorkGroup (dgInt32 base) const; 
 	DG_INLINE void TransposeRow (dgSolverSoaElement* const row, const dgJointInfo* const jointInfoArray, dgInt32 index);
 	DG_INLINE void BuildJacobianMatrix(dgJointInfo* const jointInfo, dgLeftHandSide* const leftHandSide, dgRightHandSide* const righHandSide, dgJacobian* const internalForces);
@@ -272,13 +292,23 @@ class dgParallelBodySolver
 	dgFloat32 m_accelNorm[DG_MAX_THREADS_HIVE_COUNT];
 	dgInt32 m_hasJointFeeback[DG_MAX_THREADS_HIVE_COUNT];
 	dgArray<dgSkeletonContainer*> m_skeletonArray; 
+	dgArray<dgSkeletonLoopJob> m_skeletonLoopJobs; 
 
 	dgInt32 m_jointCount;
+	dgInt32 m_jointInfoCount;
 	dgInt32 m_solverPasses;
 	dgInt32 m_threadCounts;
 	dgInt32 m_soaRowsCount;
 	dgInt32 m_skeletonCount;
+	dgInt32 m_skeletonLoopJobsCount;
+	dgInt32 m_skeletonAtomicIndex;
 	dgInt32 m_jacobianMatrixRowAtomicIndex;
+	dgInt32 m_useGraphColoring;
+	dgInt32 m_colorCount;
+	dgInt32 m_colorFirstGroup;
+	dgInt32 m_colorGroupCount;
+	dgInt32 m_colorAtomicIndex;
+	dgInt32 m_colorGroupStart[DG_SOLVER_MAX_COLORS + 2];
 	dgInt32* m_soaRowStart;
 	dgInt32* m_bodyRowStart;
 
@@ -287,6 +317,7 @@ class dgParallelBodySolver
 	dgWorkGroupFloat m_zero;
 
 	dgArray<dgSolverSoaElement> m_massMatrix;
+	dgArray<dgJointInfo> m_coloredJointArray;
 	friend class dgWorldDynamicUpdate;
 };
 
@@ -303,19 +334,30 @@ DG_INLINE dgParallelBodySolver::dgParallelBodySolver(dgMemoryAllocator* const al
 	,m_invTimestepRK(dgFloat32(0.0f))
 	,m_firstPassCoef(dgFloat32(0.0f))
 	,m_skeletonArray(allocator)
+	,m_skeletonLoopJobs(allocator)
 	,m_jointCount(0)
+	,m_jointInfoCount(0)
 	,m_solverPasses(0)
 	,m_threadCounts(0)
 	,m_soaRowsCount(0)
 	,m_skeletonCount(0)
+	,m_skeletonLoopJobsCount(0)
+	,m_skeletonAtomicIndex(0)
 	,m_jacobianMatrixRowAtomicIndex(0)
+	,m_useGraphColoring(0)
+	,m_colorCount(0)
+	,m_colorFirstGroup(0)
+	,m_colorGroupCount(0)
+	,m_colorAtomicIndex(0)
 	,m_soaRowStart(NULL)
 	,m_bodyRowStart(NULL)
 	,m_massMatrix(allocator)
+	,m_coloredJointArray(allocator)
 	,m_one(dgFloat32 (1.0f))
 	,m_zero(dgFloat32 (0.0f))
 {
 	m_skeletonArray[32] = NULL;
+	m_skeletonLoopJobs[32].m_skeleton = NULL;
 }
 
 #endif
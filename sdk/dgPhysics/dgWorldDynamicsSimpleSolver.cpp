@@ -514,10 +514,12 @@ dgInt32 dgWorldDynamicUpdate::SortClusters(const dgBodyCluster* const cluster, d
 	const dgInt32 bodyCount = cluster->m_bodyCount;
 	const dgInt32 jointCount = cluster->m_jointCount;
 
-	dgJointInfo* const tmpInfoList = dgAlloca(dgJointInfo, cluster->m_jointCount);
-	dgJointInfo** queueBuffer = dgAlloca(dgJointInfo*, cluster->m_jointCount * 2 + 1024 * 8);
-	dgBodyJacobianPair* const bodyJoint = dgAlloca(dgBodyJacobianPair, cluster->m_jointCount * 2);
-	dgInt32* const bodyJointList = dgAlloca(dgInt32, bodyCount + 1);
+	// scratch grows with the island, take it from this thread step arena rather than the worker stack
+	dgArenaMemoryAllocator* const stepAllocator = world->GetStepAllocator(threadID);
+	dgJointInfo* const tmpInfoList = stepAllocator->AllocArray<dgJointInfo>(cluster->m_jointCount);
+	dgJointInfo** queueBuffer = stepAllocator->AllocArray<dgJointInfo*>(cluster->m_jointCount * 2 + 1024 * 8);
+	dgBodyJacobianPair* const bodyJoint = stepAllocator->AllocArray<dgBodyJacobianPair>(cluster->m_jointCount * 2);
+	dgInt32* const bodyJointList = stepAllocator->AllocArray<dgInt32>(bodyCount + 1);
 
 	dgQueue<dgJointInfo*> queue(queueBuffer, cluster->m_jointCount * 2 + 1024 * 8);
 	dgFloat32 heaviestMass = dgFloat32(1.0e20f);
@@ -1294,6 +1296,7 @@ void dgWorldDynamicUpdate::CalculateClusterReactionForces(const dgBodyCluster* c
 
 	const dgInt32 passes = world->m_solverIterations;
 	const dgFloat32 maxAccNorm = DG_SOLVER_MAX_ERROR * DG_SOLVER_MAX_ERROR;
+	dgInt32 executedPasses = 0;
 	for (dgInt32 step = 0; step < derivativesEvaluationsRK4; step++) {
 
 		for (dgInt32 i = 0; i < jointCount; i++) {
@@ -1320,6 +1323,7 @@ void dgWorldDynamicUpdate::CalculateClusterReactionForces(const dgBodyCluster* c
 					accNorm += accel2;
 				}
 			}
+			executedPasses ++;
 		}
 		for (dgInt32 j = 0; j < skeletonCount; j++) {
 			skeletonArray[j]->CalculateJointForce(constraintArray, bodyArray, internalForces);
@@ -1365,6 +1369,7 @@ void dgWorldDynamicUpdate::CalculateClusterReactionForces(const dgBodyCluster* c
 
 	dgInt32 hasJointFeeback = 0;
 	if (timestepRK != dgFloat32(0.0f)) {
+		world->ReportSolverPasses(executedPasses);
 		for (dgInt32 i = 0; i < jointCount; i++) {
 			dgJointInfo* const jointInfo = &constraintArray[i];
 			dgConstraint* const constraint = jointInfo->m_joint;
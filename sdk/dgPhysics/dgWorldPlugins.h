@@ -22,15 +22,54 @@
 #ifndef _DG_WORLD_PLUGINS_H_
 #define _DG_WORLD_PLUGINS_H_
 
+class dgBody;
 class dgWorld;
 class dgBodyInfo;
 class dgJointInfo;
 class dgBodyCluster;
 
+// maximum number of boxes a plugin is asked to test against a single box in one overlap kernel call
+#define DG_PLUGIN_OVERLAP_BATCH_SIZE	32
+
+// maximum number of bodies handed to the integration kernel in one call
+#define DG_PLUGIN_INTEGRATION_BATCH_SIZE	64
+
+// two convex primitives in global space as seen by the primitive contact kernel.
+// m_size is the radius for spheres, (radius, half height) for capsules and the half extents for boxes,
+// capsules axis is the matrix front vector.
+DG_MSC_VECTOR_ALIGMENT
+class dgPluginPrimitivePair
+{
+	public:
+	dgMatrix m_matrix0;
+	dgMatrix m_matrix1;
+	dgVector m_size0;
+	dgVector m_size1;
+	dgInt32 m_type0;
+	dgInt32 m_type1;
+} DG_GCC_VECTOR_ALIGMENT;
+
+// closest points of a primitive pair, the normal is the unit vector pointing from shape0 to shape1
+DG_MSC_VECTOR_ALIGMENT
+class dgPluginPrimitiveContact
+{
+	public:
+	dgVector m_point0;
+	dgVector m_point1;
+	dgVector m_normal;
+} DG_GCC_VECTOR_ALIGMENT;
+
 
 class dgWorldPlugin
 {
 	public:
+	enum dgKernels
+	{
+		m_overlapKernel = 1<<0,
+		m_primitiveContactKernel = 1<<1,
+		m_integrateBodiesKernel = 1<<2,
+	};
+
 	dgWorldPlugin(dgWorld* const world, dgMemoryAllocator* const allocator);
 	virtual ~dgWorldPlugin();
 
@@ -38,6 +77,19 @@ class dgWorldPlugin
 	virtual dgInt32 GetScore() const = 0;
 	virtual void CalculateJointForces(const dgBodyCluster& cluster, dgBodyInfo* const bodyArray, dgJointInfo* const jointArray, dgFloat32 timestep) = 0;
 
+	// optional kernels, a plugin reports the ones it implements in the mask returned by GetKernels.
+	// the world only calls a kernel the plugin reports, all kernels must be thread safe.
+	virtual dgInt32 GetKernels() const;
+
+	// returns a bit mask with bit i set if box i overlaps box (boxP0, boxP1), count <= DG_PLUGIN_OVERLAP_BATCH_SIZE
+	virtual dgUnsigned32 CalculateOverlaps(const dgVector* const minBox, const dgVector* const maxBox, const dgVector& boxP0, const dgVector& boxP1, dgInt32 count) const;
+
+	// calculates the closest points of a primitive pair, returns false if the plugin does not handle the pair
+	virtual bool CalculatePrimitiveContact(const dgPluginPrimitivePair& pair, dgPluginPrimitiveContact& contact) const;
+
+	// same as calling dgBody::IntegrateVelocity on each body of the array
+	virtual void IntegrateBodies(dgBody** const bodyArray, dgInt32 count, dgFloat32 timestep) const;
+
 	protected:
 	dgWorld* m_world;
 	dgMemoryAllocator* m_allocator;
@@ -79,6 +131,7 @@ class dgWorldPluginList: public dgList<dgWorldPluginModulePair>
 	dgListNode* GetNextPlugin(dgListNode* const plugin);
 	const char* GetPluginId(dgListNode* const plugin);
 	void SelectPlugin(dgListNode* const plugin);
+	dgWorldPlugin* GetKernelPlugin(dgInt32 kernel) const;
 
 	private:
 	void LoadVisualStudioPlugins(const char* const path);
@@ -99,5 +152,38 @@ inline dgWorldPlugin::~dgWorldPlugin()
 {
 }
 
+inline dgInt32 dgWorldPlugin::GetKernels() const
+{
+	return 0;
+}
+
+inline dgUnsigned32 dgWorldPlugin::CalculateOverlaps(const dgVector* const minBox, const dgVector* const maxBox, const dgVector& boxP0, const dgVector& boxP1, dgInt32 count) const
+{
+	dgAssert(0);
+	return 0;
+}
+
+inline bool dgWorldPlugin::CalculatePrimitiveContact(const dgPluginPrimitivePair& pair, dgPluginPrimitiveContact& contact) const
+{
+	return false;
+}
+
+inline void dgWorldPlugin::IntegrateBodies(dgBody** const bodyArray, dgInt32 count, dgFloat32 timestep) const
+{
+	dgAssert(0);
+}
+
+// returns the selected plugin if it implements the kernel, NULL otherwise
+inline dgWorldPlugin* dgWorldPluginList::GetKernelPlugin(dgInt32 kernel) const
+{
+	if (m_currentPlugin) {
+		dgWorldPlugin* const plugin = m_currentPlugin->GetInfo().m_plugin;
+		if (plugin->GetKernels() & kernel) {
+			return plugin;
+		}
+	}
+	return NULL;
+}
+
 
 #endif